@@ -2,10 +2,15 @@
 #include "externels/imgui/imgui.h"
 #include "externels/imgui/imgui_impl_dx12.h"
 #include "externels/imgui/imgui_impl_win32.h"
+#include "Logger.h"
+#include <chrono>
+#include <exception>
+#include <format>
 
 void GameScene::Initialize() {
 
-	ModelManager::GetInstance()->LoadModel("Resources/Model/obj", "stage.obj");
+	// ステージのモデルはワーカースレッドで読み込み、読み終わったら使う
+	stageModel = ModelManager::GetInstance()->LoadModelAsync("Resources/Model/obj", "stage.obj");
 
 	camera = new Camera();
 	camera->SetRotate(Vector3(0.36f, 0.0f, 0.0f));
@@ -17,7 +22,6 @@ void GameScene::Initialize() {
 
 	object3d = new Object3d();
 	object3d->Initialize();
-	object3d->SetModel("stage.obj");
 
 	sprite = new Sprite();
 	sprite->Initialize("Resources/Debug/white1x1.png");
@@ -37,7 +41,21 @@ void GameScene::Initialize() {
 
 void GameScene::Update() {
 
+	// ステージのモデルを読み終えたらセットする(成功しても失敗しても一度だけ見て、以降は待たない)
+	if (stageModel.valid() && stageModel.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		try {
+			stageModel.get();
+			object3d->SetModel("stage.obj");
+		} catch (const std::exception& e) {
+			Logger::Log(std::format("GameScene: failed to load stage.obj ({})\n", e.what()));
+		}
+		stageModel = {};
+	}
+
 	ImGui::Begin("State");
+	if (ModelManager::GetInstance()->GetLoadingCount() > 0) {
+		ImGui::Text("Loading models: %zu", ModelManager::GetInstance()->GetLoadingCount());
+	}
 	if (ImGui::TreeNode("Camera")) {
 		ImGui::DragFloat3("Tranlate", &cameraTransform.translate.x, 0.1f);
 		ImGui::DragFloat3("Rotate", &cameraTransform.rotate.x, 0.1f);
@@ -104,7 +122,9 @@ void GameScene::Update() {
 	camera->SetRotate(cameraTransform.rotate);
 	camera->Update();
 	object3d->SetTransform(modelTransform);
-	object3d->SetEnableLighting(enableLighting);
+	if (object3d->GetModel()) {
+		object3d->SetEnableLighting(enableLighting);
+	}
 	object3d->Update();
 	aabb = object3d->GetAABB();
 	sprite->SetTransform(transformSprite);
@@ -8,6 +8,7 @@
 #include "WireFrameObjectBase.h"
 #include "Sprite.h"
 #include "AABB.h"
+#include <future>
 
 #pragma once
 
@@ -38,6 +39,8 @@ public:
 
 private:
 	Object3d* object3d = nullptr;
+	// 非同期で読み込んでいるステージのモデル
+	std::shared_future<Model*> stageModel;
 
 	Sprite* sprite = nullptr;
 
@@ -9,6 +9,8 @@ void MyGame::Initialize() {
 	winApp = new WinApp();
 	winApp->Initialize();
 
+	ThreadPool::GetInstance()->Initialize();
+
 	directxBase = new DirectXBase();
 	directxBase->Initialize(winApp);
 
@@ -28,6 +30,8 @@ void MyGame::Initialize() {
 
 	Input::GetInstance()->Initialize(winApp);
 
+	CollisionManager::GetInstance()->Initialize();
+
 	//// ↓---- シーンの初期化 ----↓ ////
 
 	gameScene = new GameScene();
@@ -47,8 +51,14 @@ void MyGame::Update() {
 	ImGui_ImplWin32_NewFrame();
 	ImGui::NewFrame();
 
+	// ワーカースレッドで読み終わったモデルのResourceを作る(シーンからはこのフレームで使える)
+	ModelManager::GetInstance()->Update();
+
 	gameScene->Update();
 
+	// シーンで更新したAABBから衝突ペアを求める(結果は次のフレームで使う)
+	CollisionManager::GetInstance()->Update();
+
 	if (gameScene->isFinished())
 	{
 		finished = true;
@@ -94,6 +104,10 @@ void MyGame::Finalize() {
 
 	Input::GetInstance()->Finalize();
 
+	CollisionManager::GetInstance()->Finalize();
+
+	ThreadPool::GetInstance()->Finalize();
+
 	//// ↓---- シーンの解放 ----↓ ////
 
 	gameScene->Finalize();
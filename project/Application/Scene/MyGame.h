@@ -10,6 +10,8 @@
 #include "ModelManager.h"
 #include "WireFrameObjectBase.h"
 #include "Light.h"
+#include "CollisionManager.h"
+#include "ThreadPool.h"
 
 #include "algorithm"
 #include "externels/imgui/imgui.h"
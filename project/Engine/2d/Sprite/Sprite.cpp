@@ -122,20 +122,21 @@ void Sprite::Update() {
 
 
 
-	Matrix4x4 uvTransformMatrix = MakeScaleMatrix(uvTransform.scale);
-	uvTransformMatrix = Multiply(uvTransformMatrix, MakeRotateZMatrix(uvTransform.rotate.z));
-	uvTransformMatrix = Multiply(uvTransformMatrix, MakeTranslateMatrix(uvTransform.translate));
-	materialData->uvTransform = uvTransformMatrix;
+	// UVはZ軸回転のみなのでQuaternionで直接組み立てる
+	Quaternion uvRotate = MakeRotateAxisAngleQuaternion({0.0f, 0.0f, 1.0f}, uvTransform.rotate.z);
+	materialData->uvTransform = MakeAffineMatrix(uvTransform.scale, uvRotate, uvTransform.translate);
 
 	// ゲームの処理
 	//  Sprite用のWorldViewProjectionMatrixを作る
 	//  SpriteのTransform処理
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-	Matrix4x4 viewMatrix = MakeIdentity4x4();
+	Quaternion rotate = MakeRotateAxisAngleQuaternion({0.0f, 0.0f, 1.0f}, transform.rotate.z);
+	Matrix3x4 worldMatrix = MakeAffineMatrix3x4(transform.scale, rotate, transform.translate);
+	// viewMatrixは単位行列なので掛けない
 	Matrix4x4 projectionMatrix = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
-	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, Multiply(viewMatrix, projectionMatrix));
+	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, projectionMatrix);
 	transformationMatrixData->WVP = worldViewProjectionMatrix;
 	transformationMatrixData->World = worldMatrix;
+	transformationMatrixData->WorldInverseTranspose = MakeNormalMatrix(worldMatrix);
 }
 
 void Sprite::TriangleUpdate() {
@@ -208,20 +209,21 @@ void Sprite::TriangleUpdate() {
 
 
 
-	Matrix4x4 uvTransformMatrix = MakeScaleMatrix(uvTransform.scale);
-	uvTransformMatrix = Multiply(uvTransformMatrix, MakeRotateZMatrix(uvTransform.rotate.z));
-	uvTransformMatrix = Multiply(uvTransformMatrix, MakeTranslateMatrix(uvTransform.translate));
-	materialData->uvTransform = uvTransformMatrix;
+	// UVはZ軸回転のみなのでQuaternionで直接組み立てる
+	Quaternion uvRotate = MakeRotateAxisAngleQuaternion({0.0f, 0.0f, 1.0f}, uvTransform.rotate.z);
+	materialData->uvTransform = MakeAffineMatrix(uvTransform.scale, uvRotate, uvTransform.translate);
 
 	// ゲームの処理
 	//  Sprite用のWorldViewProjectionMatrixを作る
 	//  SpriteのTransform処理
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-	Matrix4x4 viewMatrix = MakeIdentity4x4();
+	Quaternion rotate = MakeRotateAxisAngleQuaternion({0.0f, 0.0f, 1.0f}, transform.rotate.z);
+	Matrix3x4 worldMatrix = MakeAffineMatrix3x4(transform.scale, rotate, transform.translate);
+	// viewMatrixは単位行列なので掛けない
 	Matrix4x4 projectionMatrix = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
-	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, Multiply(viewMatrix, projectionMatrix));
+	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, projectionMatrix);
 	transformationMatrixData->WVP = worldViewProjectionMatrix;
 	transformationMatrixData->World = worldMatrix;
+	transformationMatrixData->WorldInverseTranspose = MakeNormalMatrix(worldMatrix);
 }
 
 void Sprite::ChangeTexture(std::string textureFilePath) { 
@@ -286,7 +288,8 @@ void Sprite::SetMaterial() {
 void Sprite::SetTransformatinMatrix() {
 	// 単位行列を書き込んでおく
 	transformationMatrixData->WVP = MakeIdentity4x4();
-	transformationMatrixData->World = MakeIdentity4x4();
+	transformationMatrixData->World = MakeMatrix3x4(MakeIdentity4x4());
+	transformationMatrixData->WorldInverseTranspose = MakeMatrix3x4(MakeIdentity4x4());
 }
 
 void Sprite::SetIsFlip(const bool& FlipX, const bool& FlipY) {
@@ -53,7 +53,8 @@ private:
 
 	struct TransformationMatrix {
 		Matrix4x4 WVP;
-		Matrix4x4 World;
+		Matrix3x4 World;
+		Matrix3x4 WorldInverseTranspose;
 	};
 
 	// VertexResourceを作成する
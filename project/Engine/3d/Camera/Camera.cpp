@@ -9,7 +9,7 @@ Camera::Camera()
 	, nearClipDistance(0.1f)
 	, farClipDistance(100.0f)
 	, worldMatrix(MakeAffineMatrix(transform.scale, transform.rotate, transform.translate))
-	, viewMatrix(Inverse(worldMatrix))
+	, viewMatrix(InverseRigid(worldMatrix))
 	, projectionMatrix(MakePrespectiveFovMatrix(fovY, aspect, nearClipDistance, farClipDistance))
 	, viewProjectionMatrix(Multiply(viewMatrix, projectionMatrix)) 
 {}
@@ -17,11 +17,20 @@ Camera::Camera()
 void Camera::Update() {
 
 	worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+	// スケールが1なら回転と平行移動だけなので転置で逆行列が求まる
+	MatrixClass worldClass = MatrixClass::Affine;
+	if (transform.scale.x == 1.0f && transform.scale.y == 1.0f && transform.scale.z == 1.0f) {
+		worldClass = MatrixClass::Rigid;
+	}
 	if (isParent)
 	{
 		worldMatrix = Multiply(worldMatrix, parent);
+		// 親の方が一般的な行列なら親に合わせる
+		if (parentClass > worldClass) {
+			worldClass = parentClass;
+		}
 	}
-	viewMatrix = Inverse(worldMatrix);
+	viewMatrix = Inverse(worldMatrix, worldClass);
 	projectionMatrix = MakePrespectiveFovMatrix(fovY, aspect, nearClipDistance, farClipDistance);
 	// ここがエラーの可能性あり
 	viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
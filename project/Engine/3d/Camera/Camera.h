@@ -17,10 +17,7 @@ public:
 	void Update();
 
 	// Getter
-	const Matrix4x4& GetWorldMatrix() const { 
-		Matrix4x4 world = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-		return world; 
-	}
+	const Matrix4x4& GetWorldMatrix() const { return worldMatrix; }
 	// Getter
 	const Matrix4x4& GetViewMatrix() const { return viewMatrix; }
 	// Getter
@@ -51,6 +48,7 @@ public:
 	// Setter(Parent)
 	void SetParent(const Matrix4x4& worldMatrix) { 
 		parent = worldMatrix; 
+		parentClass = ClassifyMatrix(worldMatrix);
 		isParent = true;
 	}
 	// Delete Parent(Parent 解除)
@@ -64,6 +62,8 @@ private:
 	Matrix4x4 viewMatrix;
 
 	Matrix4x4 parent;
+	// 親の行列の種類(逆行列の求め方を選ぶのに使う)
+	MatrixClass parentClass = MatrixClass::General;
 	bool isParent = false;
 
 	Matrix4x4 projectionMatrix;
@@ -0,0 +1,404 @@
+#include "MeshOptimizer.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+// ハッシュ表の空き
+constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+// 頂点のハッシュ(4バイトずつ混ぜる。MurmurHash2と同じ混ぜ方)
+uint32_t HashVertex(const uint8_t* vertex, size_t vertexStride) {
+	constexpr uint32_t m = 0x5bd1e995;
+	constexpr int r = 24;
+	uint32_t h = 0;
+	for (size_t i = 0; i < vertexStride; i += 4) {
+		uint32_t k;
+		std::memcpy(&k, vertex + i, sizeof(k));
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h *= m;
+		h ^= k;
+	}
+	h ^= h >> 13;
+	h *= m;
+	h ^= h >> 15;
+	return h;
+}
+
+} // namespace
+
+size_t GenerateVertexRemap(uint32_t* remap, const void* vertices, size_t vertexCount, size_t vertexStride) {
+	assert(vertexStride > 0 && vertexStride % 4 == 0);
+	assert(vertexCount < kEmpty);
+	const uint8_t* bytes = static_cast<const uint8_t*>(vertices);
+
+	// 開番地法のハッシュ表(まとめた後の頂点の代表になる元の頂点の番号を入れる。半分以上空くようにする)
+	size_t tableSize = 1;
+	while (tableSize < vertexCount * 2) {
+		tableSize *= 2;
+	}
+	std::vector<uint32_t> table(tableSize, kEmpty);
+	const size_t mask = tableSize - 1;
+
+	uint32_t uniqueCount = 0;
+	for (size_t i = 0; i < vertexCount; i++) {
+		const uint8_t* vertex = bytes + i * vertexStride;
+		size_t slot = HashVertex(vertex, vertexStride) & mask;
+		// 同じ頂点か空きが見つかるまで隣を調べる
+		while (table[slot] != kEmpty && std::memcmp(bytes + static_cast<size_t>(table[slot]) * vertexStride, vertex, vertexStride) != 0) {
+			slot = (slot + 1) & mask;
+		}
+		if (table[slot] == kEmpty) {
+			table[slot] = static_cast<uint32_t>(i);
+			remap[i] = uniqueCount++;
+		} else {
+			remap[i] = remap[table[slot]];
+		}
+	}
+	return uniqueCount;
+}
+
+void RemapVertexBuffer(void* destination, const void* vertices, size_t vertexCount, size_t vertexStride, const uint32_t* remap) {
+	const uint8_t* source = static_cast<const uint8_t*>(vertices);
+	uint8_t* target = static_cast<uint8_t*>(destination);
+	for (size_t i = 0; i < vertexCount; i++) {
+		// 同じ番号には同じ内容が入るので、何度書いてもよい
+		std::memcpy(target + static_cast<size_t>(remap[i]) * vertexStride, source + i * vertexStride, vertexStride);
+	}
+}
+
+uint32_t GetIndexSize(size_t vertexCount) {
+	return vertexCount <= std::numeric_limits<uint16_t>::max() + size_t(1) ? 2 : 4;
+}
+
+void WriteIndexBuffer(void* destination, const uint32_t* indices, size_t indexCount, uint32_t indexSize) {
+	if (indexSize == 4) {
+		std::memcpy(destination, indices, sizeof(uint32_t) * indexCount);
+		return;
+	}
+	assert(indexSize == 2);
+	uint16_t* target = static_cast<uint16_t*>(destination);
+	for (size_t i = 0; i < indexCount; i++) {
+		assert(indices[i] <= std::numeric_limits<uint16_t>::max());
+		target[i] = static_cast<uint16_t>(indices[i]);
+	}
+}
+
+void ReadIndexBuffer(uint32_t* destination, const void* indices, size_t indexCount, uint32_t indexSize) {
+	if (indexSize == 4) {
+		std::memcpy(destination, indices, sizeof(uint32_t) * indexCount);
+		return;
+	}
+	assert(indexSize == 2);
+	const uint16_t* source = static_cast<const uint16_t*>(indices);
+	for (size_t i = 0; i < indexCount; i++) {
+		destination[i] = source[i];
+	}
+}
+
+namespace {
+
+// FIFOの頂点キャッシュ(入った時刻を覚えておき、cacheSize個より前に入ったものは追い出されたとみなす)
+class VertexCacheSimulator {
+public:
+	VertexCacheSimulator(size_t vertexCount, uint32_t cacheSize) : timestamps(vertexCount, 0), cacheSize(cacheSize), time(cacheSize + 1) {}
+
+	// 頂点を使う。キャッシュに無ければ入れてtrueを返す
+	bool Miss(uint32_t vertex) {
+		if (time - timestamps[vertex] > cacheSize) {
+			timestamps[vertex] = time++;
+			return true;
+		}
+		return false;
+	}
+
+	// 全て追い出す
+	void Clear() { time += cacheSize + 1; }
+
+private:
+	std::vector<uint32_t> timestamps;
+	uint32_t cacheSize;
+	uint32_t time;
+};
+
+// 頂点ごとの、使っている三角形の一覧(offsets[v]からcounts[v]個)
+struct TriangleAdjacency {
+	std::vector<uint32_t> counts;
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> triangles;
+};
+
+TriangleAdjacency BuildTriangleAdjacency(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+	TriangleAdjacency adjacency;
+	adjacency.counts.assign(vertexCount, 0);
+	adjacency.offsets.assign(vertexCount, 0);
+	adjacency.triangles.resize(indexCount);
+	for (size_t i = 0; i < indexCount; i++) {
+		assert(indices[i] < vertexCount);
+		adjacency.counts[indices[i]]++;
+	}
+	uint32_t offset = 0;
+	for (size_t v = 0; v < vertexCount; v++) {
+		adjacency.offsets[v] = offset;
+		offset += adjacency.counts[v];
+	}
+	// offsetsを書き込み位置として使ってから戻す
+	for (size_t i = 0; i < indexCount; i++) {
+		adjacency.triangles[adjacency.offsets[indices[i]]++] = static_cast<uint32_t>(i / 3);
+	}
+	for (size_t v = 0; v < vertexCount; v++) {
+		adjacency.offsets[v] -= adjacency.counts[v];
+	}
+	return adjacency;
+}
+
+Vector3 LoadPosition(const uint8_t* positions, size_t positionStride, uint32_t vertex) {
+	float position[3];
+	std::memcpy(position, positions + static_cast<size_t>(vertex) * positionStride, sizeof(position));
+	return { position[0], position[1], position[2] };
+}
+
+} // namespace
+
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	VertexCacheStatistics statistics{};
+	VertexCacheSimulator cache(vertexCount, cacheSize);
+	for (size_t i = 0; i < indexCount; i++) {
+		assert(indices[i] < vertexCount);
+		statistics.verticesTransformed += cache.Miss(indices[i]) ? 1 : 0;
+	}
+	statistics.acmr = indexCount ? static_cast<float>(statistics.verticesTransformed) / static_cast<float>(indexCount / 3) : 0.0f;
+	statistics.atvr = vertexCount ? static_cast<float>(statistics.verticesTransformed) / static_cast<float>(vertexCount) : 0.0f;
+	return statistics;
+}
+
+void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	assert(indexCount % 3 == 0);
+	if (indexCount == 0) {
+		return;
+	}
+	// destinationとindicesが同じでもよいように、元のインデックスを取っておく
+	const std::vector<uint32_t> source(indices, indices + indexCount);
+	const TriangleAdjacency adjacency = BuildTriangleAdjacency(source.data(), indexCount, vertexCount);
+
+	// まだ出していない三角形の数(頂点ごと)
+	std::vector<uint32_t> liveTriangles = adjacency.counts;
+	// キャッシュに入った時刻(Tipsifyはこの時刻から残っているかを見積もる)
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	std::vector<bool> emitted(indexCount / 3, false);
+	// 行き止まりになったときに戻る頂点の候補
+	std::vector<uint32_t> deadEnds;
+	std::vector<uint32_t> candidates;
+
+	uint32_t time = cacheSize + 1;
+	// 行き止まりで候補も無いときに、頂点を先頭から順に探す位置
+	uint32_t cursor = 1;
+	size_t outputCount = 0;
+	int64_t fanning = 0;
+	while (fanning >= 0) {
+		// 中心の頂点を使うまだ出していない三角形を全て出す
+		candidates.clear();
+		const uint32_t center = static_cast<uint32_t>(fanning);
+		for (uint32_t k = 0; k < adjacency.counts[center]; k++) {
+			const uint32_t triangle = adjacency.triangles[adjacency.offsets[center] + k];
+			if (emitted[triangle]) {
+				continue;
+			}
+			emitted[triangle] = true;
+			for (uint32_t corner = 0; corner < 3; corner++) {
+				const uint32_t vertex = source[triangle * 3 + corner];
+				destination[outputCount++] = vertex;
+				deadEnds.push_back(vertex);
+				candidates.push_back(vertex);
+				liveTriangles[vertex]--;
+				if (time - timestamps[vertex] > cacheSize) {
+					timestamps[vertex] = time++;
+				}
+			}
+		}
+
+		// 次の中心は、残りの三角形を出してもキャッシュから追い出されない頂点のうち一番古いもの
+		fanning = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t vertex : candidates) {
+			if (liveTriangles[vertex] == 0) {
+				continue;
+			}
+			int64_t priority = 0;
+			if (time - timestamps[vertex] + 2 * liveTriangles[vertex] <= cacheSize) {
+				priority = time - timestamps[vertex];
+			}
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				fanning = vertex;
+			}
+		}
+		if (fanning >= 0) {
+			continue;
+		}
+		// 候補が無ければ、最近使った頂点から三角形が残っているものを探す
+		while (!deadEnds.empty()) {
+			const uint32_t vertex = deadEnds.back();
+			deadEnds.pop_back();
+			if (liveTriangles[vertex] > 0) {
+				fanning = vertex;
+				break;
+			}
+		}
+		// それも無ければ頂点を順に探す(見つからなければ終わり)
+		while (fanning < 0 && cursor < vertexCount) {
+			if (liveTriangles[cursor] > 0) {
+				fanning = cursor;
+			}
+			cursor++;
+		}
+	}
+	// 最後は全ての頂点を順に探すので、出していない三角形は残らない
+	assert(outputCount == indexCount);
+
+	// 元からキャッシュに当たりやすい順になっていることもあるので、良くならなければ元の順に戻す
+	const VertexCacheStatistics before = AnalyzeVertexCache(source.data(), indexCount, vertexCount, cacheSize);
+	const VertexCacheStatistics after = AnalyzeVertexCache(destination, indexCount, vertexCount, cacheSize);
+	if (after.verticesTransformed >= before.verticesTransformed) {
+		std::copy(source.begin(), source.end(), destination);
+	}
+}
+
+void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const void* positions, size_t vertexCount, size_t positionStride,
+	float threshold, uint32_t cacheSize) {
+	assert(indexCount % 3 == 0);
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+	const std::vector<uint32_t> source(indices, indices + indexCount);
+
+	// 3頂点ともキャッシュに無い三角形から、新しいまとまりが始まる(Tipsifyが行き止まりで飛んだ所)
+	std::vector<uint32_t> hardBoundaries;
+	VertexCacheSimulator cache(vertexCount, cacheSize);
+	for (size_t t = 0; t < triangleCount; t++) {
+		uint32_t misses = 0;
+		for (size_t corner = 0; corner < 3; corner++) {
+			misses += cache.Miss(source[t * 3 + corner]) ? 1 : 0;
+		}
+		if (t == 0 || misses == 3) {
+			hardBoundaries.push_back(static_cast<uint32_t>(t));
+		}
+	}
+	hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+	// 大きなまとまりは、そこまでのACMRがまとまり全体のthreshold倍以下になる所でさらに区切る
+	// 区切った所でキャッシュが空になったとみなしても、全体のキャッシュの効きはほとんど落ちない
+	std::vector<uint32_t> clusters;
+	for (size_t c = 0; c + 1 < hardBoundaries.size(); c++) {
+		const uint32_t start = hardBoundaries[c];
+		const uint32_t end = hardBoundaries[c + 1];
+		cache.Clear();
+		uint32_t clusterMisses = 0;
+		for (uint32_t t = start; t < end; t++) {
+			for (size_t corner = 0; corner < 3; corner++) {
+				clusterMisses += cache.Miss(source[t * 3 + corner]) ? 1 : 0;
+			}
+		}
+		const float clusterACMR = static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+		clusters.push_back(start);
+		cache.Clear();
+		uint32_t misses = 0;
+		uint32_t clusterStart = start;
+		for (uint32_t t = start; t < end; t++) {
+			for (size_t corner = 0; corner < 3; corner++) {
+				misses += cache.Miss(source[t * 3 + corner]) ? 1 : 0;
+			}
+			const uint32_t count = t + 1 - clusterStart;
+			// 小さすぎるまとまりは作らない(並べ替えの効果より、キャッシュを空にする損の方が大きい)
+			if (t + 1 < end && count >= cacheSize && static_cast<float>(misses) / static_cast<float>(count) <= clusterACMR * threshold) {
+				clusters.push_back(t + 1);
+				clusterStart = t + 1;
+				misses = 0;
+				cache.Clear();
+			}
+		}
+	}
+	clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+	// まとまりごとの中心と向き(面積で重みを付ける)
+	const uint8_t* positionBytes = static_cast<const uint8_t*>(positions);
+	const size_t clusterCount = clusters.size() - 1;
+	std::vector<Vector3> centroids(clusterCount, Vector3{});
+	std::vector<Vector3> normals(clusterCount, Vector3{});
+	Vector3 meshCentroid{};
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusterCount; c++) {
+		float clusterArea = 0.0f;
+		for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++) {
+			const Vector3 p0 = LoadPosition(positionBytes, positionStride, source[t * 3 + 0]);
+			const Vector3 p1 = LoadPosition(positionBytes, positionStride, source[t * 3 + 1]);
+			const Vector3 p2 = LoadPosition(positionBytes, positionStride, source[t * 3 + 2]);
+			// 外積の長さは面積の2倍(向きが逆でも表裏はそろうので、長さをそのまま重みにする)
+			const Vector3 normal = Cross(p1 - p0, p2 - p0);
+			const float area = Length(normal);
+			centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+			normals[c] += normal;
+			clusterArea += area;
+		}
+		meshCentroid += centroids[c];
+		meshArea += clusterArea;
+		if (clusterArea > 0.0f) {
+			centroids[c] = centroids[c] * (1.0f / clusterArea);
+		}
+		const float normalLength = Length(normals[c]);
+		if (normalLength > 0.0f) {
+			normals[c] = normals[c] * (1.0f / normalLength);
+		}
+	}
+	if (meshArea > 0.0f) {
+		meshCentroid = meshCentroid * (1.0f / meshArea);
+	}
+
+	// 中心から見て外側を向いているまとまりほど手前にあることが多いので先に描く
+	std::vector<float> sortKeys(clusterCount);
+	std::vector<uint32_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++) {
+		sortKeys[c] = Dot(centroids[c] - meshCentroid, normals[c]);
+		order[c] = static_cast<uint32_t>(c);
+	}
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	size_t outputCount = 0;
+	for (uint32_t c : order) {
+		const size_t begin = static_cast<size_t>(clusters[c]) * 3;
+		const size_t end = static_cast<size_t>(clusters[c + 1]) * 3;
+		std::copy(source.begin() + begin, source.begin() + end, destination + outputCount);
+		outputCount += end - begin;
+	}
+
+	// まとまりの境目でキャッシュに残っていた頂点を使えなくなるので、全体でthreshold倍より悪くなったら元の順に戻す
+	const VertexCacheStatistics before = AnalyzeVertexCache(source.data(), indexCount, vertexCount, cacheSize);
+	const VertexCacheStatistics after = AnalyzeVertexCache(destination, indexCount, vertexCount, cacheSize);
+	if (static_cast<float>(after.verticesTransformed) > static_cast<float>(before.verticesTransformed) * threshold) {
+		std::copy(source.begin(), source.end(), destination);
+	}
+}
+
+size_t OptimizeVertexFetch(void* destination, uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexStride) {
+	std::vector<uint32_t> remap(vertexCount, kEmpty);
+	const uint8_t* source = static_cast<const uint8_t*>(vertices);
+	uint8_t* target = static_cast<uint8_t*>(destination);
+	uint32_t nextVertex = 0;
+	for (size_t i = 0; i < indexCount; i++) {
+		const uint32_t vertex = indices[i];
+		assert(vertex < vertexCount);
+		if (remap[vertex] == kEmpty) {
+			std::memcpy(target + static_cast<size_t>(nextVertex) * vertexStride, source + static_cast<size_t>(vertex) * vertexStride, vertexStride);
+			remap[vertex] = nextVertex++;
+		}
+		indices[i] = remap[vertex];
+	}
+	return nextVertex;
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// メッシュの最適化(読み込み時に1回だけ行う)
+// D3D12に依存しないので、ベンチマークからも使える
+//
+// 読み込み時は次の順に行う
+//   1. WeldVertices         同じ頂点をまとめてインデックスを作る
+//   2. OptimizeVertexCache  頂点キャッシュに当たりやすい三角形の順にする(Tipsify)
+//   3. OptimizeOverdraw     キャッシュの効きをほぼ保ったまま、外側を向いた部分から描く順にする
+//   4. OptimizeVertexFetch  頂点を使われる順に並べ替える(頂点の読み込みをメモリ上で連続させる)
+
+/// <summary>
+/// 同じ頂点を1つにまとめる番号を作る(頂点の溶接)
+/// 頂点はバイト単位で比べる(位置・UV・法線が全て同じものだけをまとめる)
+/// まとめた後の頂点は、元の頂点で最初に出てきた順に並ぶ
+/// </summary>
+/// <param name="remap">元の頂点ごとのまとめた後の頂点の番号(vertexCount個書く)</param>
+/// <param name="vertices">頂点</param>
+/// <param name="vertexCount">頂点の数</param>
+/// <param name="vertexStride">頂点1個のバイト数(4の倍数)</param>
+/// <returns>まとめた後の頂点の数</returns>
+size_t GenerateVertexRemap(uint32_t* remap, const void* vertices, size_t vertexCount, size_t vertexStride);
+
+// remapに従って頂点を並べ替える(destinationにはまとめた後の頂点の数だけ書く)
+void RemapVertexBuffer(void* destination, const void* vertices, size_t vertexCount, size_t vertexStride, const uint32_t* remap);
+
+// インデックス1個のバイト数(全ての番号が16ビットに収まれば2、そうでなければ4)
+uint32_t GetIndexSize(size_t vertexCount);
+
+// インデックスをindexSizeバイトの形にして書く
+void WriteIndexBuffer(void* destination, const uint32_t* indices, size_t indexCount, uint32_t indexSize);
+
+// indexSizeバイトのインデックスを32ビットにして読む
+void ReadIndexBuffer(uint32_t* destination, const void* indices, size_t indexCount, uint32_t indexSize);
+
+/// <summary>
+/// 三角形ごとに3つずつ並んだ頂点を、同じ頂点をまとめた頂点とインデックスにする
+/// </summary>
+/// <param name="triangleVertices">三角形ごとに3つずつ並んだ頂点</param>
+/// <param name="vertices">まとめた後の頂点</param>
+/// <param name="indices">三角形ごとに3つずつ並んだ、まとめた後の頂点の番号</param>
+template<typename Vertex>
+void WeldVertices(const std::vector<Vertex>& triangleVertices, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+	indices.resize(triangleVertices.size());
+	const size_t vertexCount = GenerateVertexRemap(indices.data(), triangleVertices.data(), triangleVertices.size(), sizeof(Vertex));
+	vertices.resize(vertexCount);
+	RemapVertexBuffer(vertices.data(), triangleVertices.data(), triangleVertices.size(), sizeof(Vertex), indices.data());
+}
+
+// 頂点キャッシュの大きさの既定値(最近のGPUのFIFOに近い値)
+constexpr uint32_t kDefaultVertexCacheSize = 16;
+
+// 頂点キャッシュを調べた結果
+struct VertexCacheStatistics {
+	// 頂点シェーダーを実行した回数(キャッシュに無かった回数)
+	uint32_t verticesTransformed;
+	// 三角形1個あたりの実行回数(ACMR。0.5に近いほどよい、3が最悪)
+	float acmr;
+	// 頂点1個あたりの実行回数(ATVR。1が最良)
+	float atvr;
+};
+
+/// <summary>
+/// 頂点キャッシュを真似して、頂点シェーダーの実行回数を数える(GPUを使わずに並べ替えの効果を測る)
+/// </summary>
+/// <param name="indices">三角形ごとに3つずつ並んだ頂点の番号</param>
+/// <param name="indexCount">インデックスの数</param>
+/// <param name="vertexCount">頂点の数</param>
+/// <param name="cacheSize">FIFOキャッシュの大きさ</param>
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+/// <summary>
+/// 頂点キャッシュに当たりやすい三角形の順にする(Tipsify。Sander, Nehab, Barczak 2007)
+/// 最近使った頂点を囲む三角形を扇状にまとめて出し、次の中心はキャッシュに残っている頂点から選ぶ
+/// 三角形の中の頂点の順(表裏)は変えない
+/// 並べ替えても頂点シェーダーの実行回数が減らないときは、元の順のままにする
+/// </summary>
+/// <param name="destination">並べ替えたインデックス(indicesと同じでもよい)</param>
+/// <param name="indices">三角形ごとに3つずつ並んだ頂点の番号</param>
+/// <param name="indexCount">インデックスの数</param>
+/// <param name="vertexCount">頂点の数</param>
+/// <param name="cacheSize">FIFOキャッシュの大きさ</param>
+void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+/// <summary>
+/// 外側を向いた部分から描く順にして、重ね塗り(オーバードロー)を減らす
+/// OptimizeVertexCacheの結果をキャッシュの効きが落ちにくい所で区切り、区切りごとに並べ替える
+/// 全体のACMRが元のthreshold倍より悪くなるときは、元の順のままにする
+/// </summary>
+/// <param name="destination">並べ替えたインデックス(indicesと同じでもよい)</param>
+/// <param name="indices">OptimizeVertexCacheで並べ替えたインデックス</param>
+/// <param name="indexCount">インデックスの数</param>
+/// <param name="positions">頂点の位置(先頭のfloat3を使う)</param>
+/// <param name="vertexCount">頂点の数</param>
+/// <param name="positionStride">頂点1個のバイト数</param>
+/// <param name="threshold">区切りごとのACMRが全体の何倍まで悪くなってよいか(1以上)</param>
+/// <param name="cacheSize">FIFOキャッシュの大きさ</param>
+void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const void* positions, size_t vertexCount, size_t positionStride,
+	float threshold = 1.05f, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+/// <summary>
+/// 頂点を最初に使われる順に並べ替えて、インデックスを書き換える
+/// どの三角形にも使われていない頂点は消える
+/// </summary>
+/// <param name="destination">並べ替えた頂点(verticesとは別の領域)</param>
+/// <param name="indices">書き換えるインデックス</param>
+/// <param name="indexCount">インデックスの数</param>
+/// <param name="vertices">頂点</param>
+/// <param name="vertexCount">頂点の数</param>
+/// <param name="vertexStride">頂点1個のバイト数</param>
+/// <returns>並べ替えた後の頂点の数</returns>
+size_t OptimizeVertexFetch(void* destination, uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexStride);
+
+// WeldVerticesの後の2〜4をまとめて行う(頂点の先頭は位置のfloat3であること)
+template<typename Vertex>
+void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, uint32_t cacheSize = kDefaultVertexCacheSize) {
+	OptimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size(), cacheSize);
+	OptimizeOverdraw(indices.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex), 1.05f, cacheSize);
+	std::vector<Vertex> fetchOrdered(vertices.size());
+	fetchOrdered.resize(OptimizeVertexFetch(fetchOrdered.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), sizeof(Vertex)));
+	vertices.swap(fetchOrdered);
+}
@@ -0,0 +1,180 @@
+#include "VertexFormat.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+Vector3 LoadFloat3(const uint8_t* source) {
+	float value[3];
+	std::memcpy(value, source, sizeof(value));
+	return { value[0], value[1], value[2] };
+}
+
+// -1〜1を符号付き16ビットの正規化整数にする
+int16_t ToSnorm16(float value) {
+	return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+} // namespace
+
+uint32_t GetPositionSize(VertexPositionFormat format) {
+	return format == VertexPositionFormat::kFloat3 ? sizeof(float) * 3 : sizeof(uint16_t) * 4;
+}
+
+uint32_t GetAttributeSize() {
+	return sizeof(uint16_t) * 2 + sizeof(int16_t) * 2;
+}
+
+uint32_t GetVertexSize(const VertexFormat& format) {
+	return GetPositionSize(format.position) + GetAttributeSize();
+}
+
+Matrix3x4 MakeDequantizeMatrix(VertexPositionFormat format, const AABB& bounds) {
+	if (format == VertexPositionFormat::kFloat3) {
+		return MakeAffineMatrix3x4({ 1.0f, 1.0f, 1.0f }, MakeRotateQuaternion({ 0.0f, 0.0f, 0.0f }), { 0.0f, 0.0f, 0.0f });
+	}
+	// 0〜1に量子化しているので、大きさで拡大してminだけ動かす
+	return MakeAffineMatrix3x4(bounds.max - bounds.min, MakeRotateQuaternion({ 0.0f, 0.0f, 0.0f }), bounds.min);
+}
+
+void EncodePositions(void* destination, size_t destinationStride, const void* positions, size_t sourceStride, size_t vertexCount,
+	VertexPositionFormat format, const AABB& bounds) {
+	const uint8_t* source = static_cast<const uint8_t*>(positions);
+	uint8_t* target = static_cast<uint8_t*>(destination);
+	if (format == VertexPositionFormat::kFloat3) {
+		for (size_t i = 0; i < vertexCount; i++) {
+			std::memcpy(target + i * destinationStride, source + i * sourceStride, sizeof(float) * 3);
+		}
+		return;
+	}
+
+	// 大きさが0の軸(平面のモデルなど)は0で割らないようにする
+	const Vector3 extent = bounds.max - bounds.min;
+	const float scale[3] = {
+		extent.x > 0.0f ? 65535.0f / extent.x : 0.0f,
+		extent.y > 0.0f ? 65535.0f / extent.y : 0.0f,
+		extent.z > 0.0f ? 65535.0f / extent.z : 0.0f,
+	};
+	const float minimum[3] = { bounds.min.x, bounds.min.y, bounds.min.z };
+	for (size_t i = 0; i < vertexCount; i++) {
+		float position[3];
+		std::memcpy(position, source + i * sourceStride, sizeof(position));
+		uint16_t quantized[4] = {};
+		for (size_t axis = 0; axis < 3; axis++) {
+			const float value = std::clamp((position[axis] - minimum[axis]) * scale[axis], 0.0f, 65535.0f);
+			quantized[axis] = static_cast<uint16_t>(std::lround(value));
+		}
+		std::memcpy(target + i * destinationStride, quantized, sizeof(quantized));
+	}
+}
+
+void EncodeAttributes(void* destination, size_t destinationStride, const void* texcoords, const void* normals, size_t sourceStride, size_t vertexCount) {
+	const uint8_t* texcoordBytes = static_cast<const uint8_t*>(texcoords);
+	const uint8_t* normalBytes = static_cast<const uint8_t*>(normals);
+	uint8_t* target = static_cast<uint8_t*>(destination);
+	for (size_t i = 0; i < vertexCount; i++) {
+		float texcoord[2];
+		std::memcpy(texcoord, texcoordBytes + i * sourceStride, sizeof(texcoord));
+		uint16_t attribute[4];
+		attribute[0] = FloatToHalf(texcoord[0]);
+		attribute[1] = FloatToHalf(texcoord[1]);
+		int16_t normal[2];
+		EncodeOctahedral(LoadFloat3(normalBytes + i * sourceStride), normal);
+		std::memcpy(&attribute[2], normal, sizeof(normal));
+		std::memcpy(target + i * destinationStride, attribute, sizeof(attribute));
+	}
+}
+
+uint16_t FloatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	const uint32_t exponent = (bits >> 23) & 0xFF;
+	uint32_t mantissa = bits & 0x7FFFFF;
+
+	// NaNと無限大
+	if (exponent == 0xFF) {
+		return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+	}
+	const int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+	// 大きすぎる値は無限大
+	if (halfExponent >= 0x1F) {
+		return static_cast<uint16_t>(sign | 0x7C00);
+	}
+	// 小さい値は非正規化数(小さすぎれば0)
+	if (halfExponent <= 0) {
+		if (halfExponent < -10) {
+			return static_cast<uint16_t>(sign);
+		}
+		mantissa |= 0x800000;
+		const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+		uint32_t half = mantissa >> shift;
+		// 偶数への丸め
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1))) {
+			half++;
+		}
+		return static_cast<uint16_t>(sign | half);
+	}
+	uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+	// 偶数への丸め(繰り上がりで指数が増えても、そのまま正しい値になる)
+	const uint32_t remainder = mantissa & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+		half++;
+	}
+	return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t value) {
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1F;
+	const uint32_t mantissa = value & 0x3FF;
+	uint32_t bits;
+	if (exponent == 0x1F) {
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	} else if (exponent != 0) {
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	} else {
+		// 非正規化数は2^-24の倍数
+		const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+		return sign ? -magnitude : magnitude;
+	}
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]) {
+	const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+	if (length <= 0.0f) {
+		// 長さ0の法線は+Zにしておく
+		encoded[0] = 0;
+		encoded[1] = 0;
+		return;
+	}
+	float x = normal.x / length;
+	float y = normal.y / length;
+	// 下半分は外側に折り返す
+	if (normal.z < 0.0f) {
+		const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+	encoded[0] = ToSnorm16(x);
+	encoded[1] = ToSnorm16(y);
+}
+
+Vector3 DecodeOctahedral(const int16_t encoded[2]) {
+	// R16G16_SNORMと同じく-32768は-1として読む
+	const float x = std::max(static_cast<float>(encoded[0]) / 32767.0f, -1.0f);
+	const float y = std::max(static_cast<float>(encoded[1]) / 32767.0f, -1.0f);
+	Vector3 normal{ x, y, 1.0f - std::abs(x) - std::abs(y) };
+	const float t = std::max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return Normalize(normal);
+}
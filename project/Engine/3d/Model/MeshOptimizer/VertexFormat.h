@@ -0,0 +1,75 @@
+#pragma once
+#include "AABB.h"
+#include "Matrix3x4.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+
+// GPUに送る頂点の形式
+// CPU側(当たり判定など)はfloatのまま持ち、アップロード用のバッファに書くときだけ詰める
+//
+// 位置      float3(12バイト) か、境界のAABBを基準に16ビットに量子化したもの(8バイト。4つ目は詰め物)
+// UV        半精度float2(4バイト)
+// 法線      八面体に写して16ビットの符号付き正規化整数2つにしたもの(4バイト)
+//
+// splitPositionStreamなら位置だけを別のストリーム(スロット0)に置き、UVと法線をスロット1に置く
+// 深度や影のパスはスロット0だけを読めばよい
+
+// 頂点の位置の形式
+enum class VertexPositionFormat : uint32_t {
+	kFloat3,
+	kUnorm16,
+};
+
+struct VertexFormat {
+	VertexPositionFormat position = VertexPositionFormat::kUnorm16;
+	// 位置だけを別のストリームに分けるか
+	bool splitPositionStream = true;
+};
+
+// 位置1個のバイト数
+uint32_t GetPositionSize(VertexPositionFormat format);
+// UVと法線1組のバイト数
+uint32_t GetAttributeSize();
+// 頂点1個のバイト数(分けている場合は両方のストリームの合計)
+uint32_t GetVertexSize(const VertexFormat& format);
+
+/// <summary>
+/// 量子化した位置を元の位置に戻す行列(ワールド行列の前に掛ける。float3の場合は単位行列)
+/// </summary>
+/// <param name="format">位置の形式</param>
+/// <param name="bounds">量子化に使った境界のAABB</param>
+Matrix3x4 MakeDequantizeMatrix(VertexPositionFormat format, const AABB& bounds);
+
+/// <summary>
+/// 位置を詰めて書く
+/// </summary>
+/// <param name="destination">書き込む先</param>
+/// <param name="destinationStride">書き込む先の頂点1個のバイト数</param>
+/// <param name="positions">位置(先頭のfloat3を使う)</param>
+/// <param name="sourceStride">元の頂点1個のバイト数</param>
+/// <param name="vertexCount">頂点の数</param>
+/// <param name="format">位置の形式</param>
+/// <param name="bounds">量子化の基準にする境界のAABB(全ての位置を含むこと)</param>
+void EncodePositions(void* destination, size_t destinationStride, const void* positions, size_t sourceStride, size_t vertexCount,
+	VertexPositionFormat format, const AABB& bounds);
+
+/// <summary>
+/// UVと法線を詰めて書く(半精度のUV、八面体の法線の順)
+/// </summary>
+/// <param name="destination">書き込む先</param>
+/// <param name="destinationStride">書き込む先の頂点1個のバイト数</param>
+/// <param name="texcoords">UV(先頭のfloat2を使う)</param>
+/// <param name="normals">法線(先頭のfloat3を使う。正規化されていなくてもよい)</param>
+/// <param name="sourceStride">元の頂点1個のバイト数</param>
+/// <param name="vertexCount">頂点の数</param>
+void EncodeAttributes(void* destination, size_t destinationStride, const void* texcoords, const void* normals, size_t sourceStride, size_t vertexCount);
+
+// 半精度floatへの変換(最も近い値に丸める)
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+// 法線を八面体に写して16ビット2つにする(シェーダーではR16G16_SNORMとして読んで戻す)
+void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]);
+Vector3 DecodeOctahedral(const int16_t encoded[2]);
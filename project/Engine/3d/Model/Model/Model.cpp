@@ -3,25 +3,67 @@
 #include "DirectXBase.h"
 #include "kMath.h"
 #include "TextureManager.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "Logger.h"
+
+#include <cstring>
+#include <format>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
 void Model::Initialize(std::string directoryPath, std::string filename, bool enableLighting) {
-	// モデル読み込み
-	modelData = LoadModelFile(directoryPath, filename);
+	Load(directoryPath, filename, ModelBase::GetInstance()->GetVertexFormat());
+	CreateResources(enableLighting);
+}
+
+void Model::Load(const std::string& directoryPath, const std::string& filename, const VertexFormat& format) {
+	// モデル読み込み(変換済みのキャッシュがあればassimpを通さずに読む)
+	const std::string filePath = directoryPath + "/" + filename;
+	MeshCache meshCache;
+	if (meshCache.Open(filePath, sizeof(VertexData))) {
+		modelData = LoadModelCache(meshCache);
+		// 境界ボリュームはキャッシュに入っているものを使い、BVHはモデルごとに1回だけ求める
+		CreateCollisionData(&meshCache.GetBounds());
+	} else {
+		modelData = LoadModelFile(directoryPath, filename);
+		CreateCollisionData(nullptr);
+		// 次の起動からはキャッシュを使う(書き出せなくても読み込みは続ける)
+		WriteModelCache(filePath);
+	}
 
+	// GPUに送る形に詰めるところまではここで行い、CreateResourcesではコピーするだけにする
+	vertexFormat = format;
+	positionDequantize = MakeDequantizeMatrix(vertexFormat.position, boundingVolume.aabb);
+	indexSize = GetIndexSize(modelData.vertices.size());
+	EncodeUploadData(meshCache);
+	meshCache.Close();
+}
+
+void Model::CreateResources(bool enableLighting) {
 	// Resourceの作成
 	CreateVertexResource();
+	CreateIndexResource();
 	CreateMaterialResouce();
 
 	// BufferResourceの作成
 	CreateVertexBufferView();
+	CreateIndexBufferView();
 
-	// VertexResourceにデータを書き込むためのアドレスを取得してvertexDataに割り当てる
-	vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
-	std::memcpy(vertexData, modelData.vertices.data(), sizeof(VertexData) * modelData.vertices.size()); // 頂点データをリソースにコピー
+	// VertexResourceとIndexResourceに詰めておいたデータをコピーする
+	void* vertexData = nullptr;
+	vertexResource->Map(0, nullptr, &vertexData);
+	std::memcpy(vertexData, vertexUploadData.data(), vertexUploadData.size());
+	vertexResource->Unmap(0, nullptr);
+	void* indexData = nullptr;
+	indexResource->Map(0, nullptr, &indexData);
+	std::memcpy(indexData, indexUploadData.data(), indexUploadData.size());
+	indexResource->Unmap(0, nullptr);
+	// コピーした後は要らないので解放する
+	std::vector<uint8_t>().swap(vertexUploadData);
+	std::vector<uint8_t>().swap(indexUploadData);
 	//  書き込むためのアドレスを取得
 	materialResource->Map(0, nullptr, reinterpret_cast<void**>(&materialData));
 
@@ -43,7 +85,14 @@ void Model::Initialize(std::string directoryPath, std::string filename, bool ena
 
 void Model::SetIA() {
 	// ModelTerrain
-	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView); // VBVを設定
+	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->IASetVertexBuffers(0, vertexBufferViewCount, vertexBufferViews); // VBVを設定
+	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->IASetIndexBuffer(&indexBufferView); // IBVを設定
+}
+
+void Model::SetIAPositionOnly() {
+	assert(vertexFormat.splitPositionStream); // 位置を分けていなければ使えない
+	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferViews[0]); // 位置のVBVだけを設定
+	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->IASetIndexBuffer(&indexBufferView); // IBVを設定
 }
 
 void Model::Draw() {
@@ -53,7 +102,7 @@ void Model::Draw() {
 
 	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(modelData.material.textureIndex));
 
-	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->DrawInstanced(UINT(modelData.vertices.size()), 1, 0, 0);
+	ModelBase::GetInstance()->GetDxBase()->GetCommandList()->DrawIndexedInstanced(UINT(modelData.indices.size()), 1, 0, 0, 0);
 }
 
 MaterialData Model::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
@@ -86,7 +135,7 @@ MaterialData Model::LoadMaterialTemplateFile(const std::string& directoryPath, c
 	return materialData;
 }
 
-// マルチスレッド化予定
+// ワーカースレッドから呼ばれるので、シングルトンなどの共有のデータには触らない
 ModelData Model::LoadModelFile(const std::string& directoryPath, const std::string& filename) {
 	ModelData modelData;            // 構築するModelData
 	Assimp::Importer importer;
@@ -94,6 +143,16 @@ ModelData Model::LoadModelFile(const std::string& directoryPath, const std::stri
 	const aiScene* scene = importer.ReadFile(filePath.c_str(), aiProcess_FlipWindingOrder | aiProcess_FlipUVs | aiProcess_Triangulate);
 	assert(scene->HasMeshes()); // メッシュが無いのは対応しない
 
+	// 頂点を1つずつ足すと何度も確保し直すので、先に全ての面の分を確保しておく
+	// 面ごとに頂点を並べてから、最後に同じ頂点をまとめてインデックスを作る
+	size_t vertexCount = 0;
+	for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+	{
+		vertexCount += static_cast<size_t>(scene->mMeshes[meshIndex]->mNumFaces) * 3;
+	}
+	std::vector<VertexData> triangleVertices;
+	triangleVertices.reserve(vertexCount);
+
 	for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
 	{
 		aiMesh* mesh = scene->mMeshes[meshIndex];
@@ -119,11 +178,23 @@ ModelData Model::LoadModelFile(const std::string& directoryPath, const std::stri
 				// aiProcess_MakeLeftHandedはz*=-1で、右手->左手に変換するので手動で対処
 				vertex.position.x *= -1.0f;
 				vertex.normal.x *= -1.0f;
-				modelData.vertices.push_back(vertex);
+				triangleVertices.push_back(vertex);
 			}
 
 		}
 	}
+	WeldVertices(triangleVertices, modelData.vertices, modelData.indices);
+	// 頂点キャッシュ・オーバードロー・頂点の読み込みの順に最適化する(結果はキャッシュに書き出すので、読み込み直すときは行わない)
+	const VertexCacheStatistics beforeCache = AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+	OptimizeMesh(modelData.vertices, modelData.indices);
+	const VertexCacheStatistics afterCache = AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+
+	// まとめた結果(頂点数とメモリがどれだけ減ったか、頂点キャッシュがどれだけ効くようになったか)
+	const size_t beforeBytes = sizeof(VertexData) * triangleVertices.size();
+	const size_t afterBytes = sizeof(VertexData) * modelData.vertices.size() + GetIndexSize(modelData.vertices.size()) * modelData.indices.size();
+	Logger::Log(std::format("Model: {} vertices {} -> {}, memory {} -> {} bytes, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}\n", filePath,
+		triangleVertices.size(), modelData.vertices.size(), beforeBytes, afterBytes, beforeCache.acmr, afterCache.acmr, beforeCache.atvr, afterCache.atvr));
+
 	for (uint32_t materialIndex = 0; materialIndex < scene->mNumMaterials; ++materialIndex)
 	{
 		aiMaterial* material = scene->mMaterials[materialIndex];
@@ -212,16 +283,113 @@ ModelData Model::LoadModelFile(const std::string& directoryPath, const std::stri
 	//return modelData;
 }
 
+ModelData Model::LoadModelCache(const MeshCache& meshCache) {
+	ModelData modelData;
+	// 頂点は変換済みの形なので、まとめてコピーする
+	const VertexData* vertices = static_cast<const VertexData*>(meshCache.GetVertices());
+	modelData.vertices.assign(vertices, vertices + meshCache.GetVertexCount());
+	modelData.indices.resize(meshCache.GetIndexCount());
+	ReadIndexBuffer(modelData.indices.data(), meshCache.GetIndices(), modelData.indices.size(), meshCache.GetIndexSize());
+	modelData.material.textureFilePath = meshCache.GetMaterialCount() > 0 ? std::string(meshCache.GetTextureFilePath(0)) : "Resources/Debug/white1x1.png";
+	return modelData;
+}
+
+void Model::WriteModelCache(const std::string& filePath) const {
+	MeshCacheSource source;
+	source.vertices = modelData.vertices.data();
+	source.vertexStride = sizeof(VertexData);
+	source.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+	// インデックスはGPUに送る形(16ビットか32ビット)で書き出す
+	const uint32_t cacheIndexSize = GetIndexSize(modelData.vertices.size());
+	std::vector<uint8_t> indices(static_cast<size_t>(cacheIndexSize) * modelData.indices.size());
+	WriteIndexBuffer(indices.data(), modelData.indices.data(), modelData.indices.size(), cacheIndexSize);
+	source.indices = indices.data();
+	source.indexSize = cacheIndexSize;
+	source.indexCount = static_cast<uint32_t>(modelData.indices.size());
+	source.bounds = boundingVolume;
+	source.textureFilePaths.push_back(modelData.material.textureFilePath);
+	MeshCache::Write(filePath, source);
+}
+
+void Model::EncodeUploadData(const MeshCache& meshCache) {
+	// 位置を分ける場合も1つのリソースにまとめ、UVと法線は16バイト境界から置く
+	const size_t vertexCount = modelData.vertices.size();
+	const size_t positionStride = vertexFormat.splitPositionStream ? GetPositionSize(vertexFormat.position) : GetVertexSize(vertexFormat);
+	if (vertexFormat.splitPositionStream) {
+		attributeOffset = (positionStride * vertexCount + 15) & ~size_t(15);
+		vertexUploadData.resize(attributeOffset + static_cast<size_t>(GetAttributeSize()) * vertexCount);
+	} else {
+		attributeOffset = 0;
+		vertexUploadData.resize(positionStride * vertexCount);
+	}
+	// 頂点データをGPUに送る形に詰める(キャッシュがあれば割り当てたファイルから直接読む)
+	const VertexData* vertices = meshCache.IsOpen() ? static_cast<const VertexData*>(meshCache.GetVertices()) : modelData.vertices.data();
+	EncodePositions(vertexUploadData.data(), positionStride, &vertices->position, sizeof(VertexData), vertexCount, vertexFormat.position, boundingVolume.aabb);
+	// UVと法線は、分けていれば位置の後ろのブロックに、分けていなければ位置のすぐ後ろに書く
+	uint8_t* attributeData = vertexFormat.splitPositionStream ? vertexUploadData.data() + attributeOffset : vertexUploadData.data() + GetPositionSize(vertexFormat.position);
+	const size_t attributeStride = vertexFormat.splitPositionStream ? GetAttributeSize() : positionStride;
+	EncodeAttributes(attributeData, attributeStride, &vertices->texcoord, &vertices->normal, sizeof(VertexData), vertexCount);
+	// インデックスも同じようにする(キャッシュは同じ形で書き出しているのでそのままコピーできる)
+	indexUploadData.resize(static_cast<size_t>(indexSize) * modelData.indices.size());
+	if (meshCache.IsOpen() && meshCache.GetIndexSize() == indexSize) {
+		std::memcpy(indexUploadData.data(), meshCache.GetIndices(), indexUploadData.size());
+	} else {
+		WriteIndexBuffer(indexUploadData.data(), modelData.indices.data(), modelData.indices.size(), indexSize);
+	}
+}
+
 void Model::CreateVertexResource() {
-	// 頂点リソースの作成
-	vertexResource = ModelBase::GetInstance()->GetDxBase()->CreateBufferResource(sizeof(VertexData) * modelData.vertices.size());
+	// 頂点リソースの作成(大きさはEncodeUploadDataで詰めたデータと同じ)
+	vertexResource = ModelBase::GetInstance()->GetDxBase()->CreateBufferResource(vertexUploadData.size());
+}
+
+void Model::CreateIndexResource() {
+	// インデックスリソースの作成
+	indexResource = ModelBase::GetInstance()->GetDxBase()->CreateBufferResource(indexUploadData.size());
 }
 
 void Model::CreateVertexBufferView() {
 	// 頂点バッファビューを作成する
-	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-	vertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * modelData.vertices.size()); // 使用するリソースのサイズは頂点サイズ
-	vertexBufferView.StrideInBytes = sizeof(VertexData);                                 // １頂点あたりのサイズ
+	const UINT vertexCount = UINT(modelData.vertices.size());
+	if (vertexFormat.splitPositionStream) {
+		// スロット0は位置だけ、スロット1はUVと法線
+		vertexBufferViews[0].BufferLocation = vertexResource->GetGPUVirtualAddress();
+		vertexBufferViews[0].StrideInBytes = GetPositionSize(vertexFormat.position);                 // １頂点あたりのサイズ
+		vertexBufferViews[0].SizeInBytes = vertexBufferViews[0].StrideInBytes * vertexCount;         // 使用するリソースのサイズは頂点サイズ
+		vertexBufferViews[1].BufferLocation = vertexResource->GetGPUVirtualAddress() + attributeOffset;
+		vertexBufferViews[1].StrideInBytes = GetAttributeSize();
+		vertexBufferViews[1].SizeInBytes = vertexBufferViews[1].StrideInBytes * vertexCount;
+		vertexBufferViewCount = 2;
+	} else {
+		vertexBufferViews[0].BufferLocation = vertexResource->GetGPUVirtualAddress();
+		vertexBufferViews[0].StrideInBytes = GetVertexSize(vertexFormat);                            // １頂点あたりのサイズ
+		vertexBufferViews[0].SizeInBytes = vertexBufferViews[0].StrideInBytes * vertexCount;         // 使用するリソースのサイズは頂点サイズ
+		vertexBufferViewCount = 1;
+	}
+}
+
+void Model::CreateIndexBufferView() {
+	// インデックスバッファビューを作成する
+	indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
+	indexBufferView.SizeInBytes = UINT(indexSize * modelData.indices.size());       // 使用するリソースのサイズはインデックスサイズ
+	indexBufferView.Format = indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT; // １インデックスあたりのサイズ
+}
+
+void Model::CreateCollisionData(const BoundingVolume* bounds) {
+	std::vector<Vector3> positions;
+	positions.reserve(modelData.vertices.size());
+	for (const VertexData& vertex : modelData.vertices) {
+		positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+	}
+	boundingVolume = bounds ? *bounds : ComputeBoundingVolume(positions.data(), positions.size());
+	convexHull.Build(positions.data(), positions.size());
+	// BVHは三角形ごとに3つずつ並んだ頂点から作る
+	std::vector<Vector3> trianglePositions;
+	trianglePositions.reserve(modelData.indices.size());
+	for (uint32_t index : modelData.indices) {
+		trianglePositions.push_back(positions[index]);
+	}
+	triangleBVH.Build(trianglePositions.data(), trianglePositions.size());
 }
 
 void Model::CreateMaterialResouce() { 
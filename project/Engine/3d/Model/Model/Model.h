@@ -8,9 +8,15 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix4x4.h"
+#include "BoundingVolume.h"
+#include "TriangleBVH.h"
+#include "ConvexHull.h"
+#include "VertexFormat.h"
 
 #pragma once
 
+class MeshCache;
+
 struct VertexData {
 	Vector4 position;
 	Vector2 texcoord;
@@ -32,20 +38,37 @@ struct MaterialData {
 };
 
 struct ModelData {
+	// 同じ頂点をまとめた頂点
 	std::vector<VertexData> vertices;
+	// 三角形ごとに3つずつ並んだ頂点の番号
+	std::vector<uint32_t> indices;
 	MaterialData material;
 };
 
 class Model {
 public:
 
-	// 初期化
+	// 初期化(LoadとCreateResourcesを続けて行う)
 	void Initialize(std::string directoryPath, std::string filename, bool enableLighting);
+
+	/// <summary>
+	/// モデルファイルを読み、GPUに送る形に詰めるところまで行う
+	/// D3D12を使わないので、ワーカースレッドから呼んでよい(同じModelを同時に触らないこと)
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリのパス</param>
+	/// <param name="filename">モデルファイルの名前</param>
+	/// <param name="format">GPUに送る頂点の形式</param>
+	void Load(const std::string& directoryPath, const std::string& filename, const VertexFormat& format);
+
+	// Resourceを作って、Loadで詰めたデータをコピーする(描画と同じスレッドから呼ぶ)
+	void CreateResources(bool enableLighting);
 	
 	// 更新
 	void Draw();
 
 	void SetIA();
+	// 位置のストリームだけを設定する(深度・影のパス用。VertexFormat::splitPositionStreamの場合だけ使える)
+	void SetIAPositionOnly();
 
 	// Getter(Color)
 	const Vector4& GetColor() const { return materialData->color; }
@@ -57,8 +80,20 @@ public:
 	const float& GetShininess() const { return materialData->shininess; }
 	// Getter(ModelData)
 	const ModelData& GetModelData() const { return modelData;}
-	// Getter(ModelData vertices)
+	// Getter(ModelData vertices。同じ頂点はまとめてあるので、三角形はGetIndicesでたどる)
 	const std::vector<VertexData>& GetVertices() const { return modelData.vertices; }
+	// Getter(ModelData indices)
+	const std::vector<uint32_t>& GetIndices() const { return modelData.indices; }
+	// Getter(ローカル座標の境界ボリューム。読み込み時に求めたもの)
+	const BoundingVolume& GetBoundingVolume() const { return boundingVolume; }
+	// Getter(ローカル座標の三角形のBVH。レイキャストなどに使う)
+	const TriangleBVH& GetTriangleBVH() const { return triangleBVH; }
+	// Getter(ローカル座標の凸包。平面だけのモデルなど、作れなければIsValidがfalse)
+	const ConvexHull& GetConvexHull() const { return convexHull; }
+	// GPUに送った頂点の位置が量子化されているか
+	bool IsPositionQuantized() const { return vertexFormat.position != VertexPositionFormat::kFloat3; }
+	// Getter(量子化した位置をローカル座標に戻す行列。ワールド行列の前に掛ける)
+	const Matrix3x4& GetPositionDequantize() const { return positionDequantize; }
 
 	// Setter(Color)
 	void SetColor(const Vector4& color) { materialData->color = color; }
@@ -71,16 +106,39 @@ public:
 
 private:
 
-	// 頂点データのバッファリソース
+	// 頂点データのバッファリソース(GPUに送る形に詰めたもの)
 	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource;
-	// 頂点データのバッファリソース内のデータを指すポインタ
-	VertexData* vertexData = nullptr;
+	// バッファリソースの使い道を指定するバッファビュー(位置を分けていれば位置とUV・法線の2つ)
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferViews[2] = {};
+	UINT vertexBufferViewCount = 0;
+	// UVと法線のブロックのリソースの先頭からの位置(位置を分けている場合)
+	size_t attributeOffset = 0;
+	// GPUに送る頂点の形式(読み込み時のModelBaseの設定)
+	VertexFormat vertexFormat;
+	// 量子化した位置を戻す行列
+	Matrix3x4 positionDequantize{};
+
+	// インデックスのバッファリソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource;
 	// バッファリソースの使い道を指定するバッファビュー
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
+	D3D12_INDEX_BUFFER_VIEW indexBufferView;
+	// インデックス1個のバイト数(頂点が65536個以下なら2)
+	uint32_t indexSize = 0;
+
+	// GPUに送る形に詰めた頂点とインデックス(Resourceにコピーするまでの間だけ持つ)
+	std::vector<uint8_t> vertexUploadData;
+	std::vector<uint8_t> indexUploadData;
 
 	// Objファイルのデータ
 	ModelData modelData;
 
+	// 頂点を囲む境界ボリューム
+	BoundingVolume boundingVolume;
+	// 三角形のBVH
+	TriangleBVH triangleBVH;
+	// 頂点を囲む凸包(頂点数を減らしたもの)
+	ConvexHull convexHull;
+
 	// マテリアルのバッファリソース
 	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource;
 	// マテリアルバッファリソース内のデータを指すポインタ
@@ -91,12 +149,26 @@ private:
 	static MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& fileName);
 	// .objファイルの読み取り
 	static ModelData LoadModelFile(const std::string& directoryPath, const std::string& fileName);
+	// 変換済みのキャッシュ(MeshCache)の読み取り
+	static ModelData LoadModelCache(const MeshCache& meshCache);
+	// 読み込んだモデルをキャッシュに書き出す(境界ボリュームを求めた後に呼ぶ)
+	void WriteModelCache(const std::string& filePath) const;
+
+	// 頂点とインデックスをGPUに送る形に詰める(キャッシュが開いていればそこから読む)
+	void EncodeUploadData(const MeshCache& meshCache);
 
 	// VertexResourceを作成する
 	void CreateVertexResource();
+	// IndexResourceを作成する
+	void CreateIndexResource();
 	// MaterialResourceを作成する
 	void CreateMaterialResouce();
 
 	// VertexBufferViewを作成する(値を設定するだけ)
 	void CreateVertexBufferView();
+	// IndexBufferViewを作成する(値を設定するだけ)
+	void CreateIndexBufferView();
+
+	// 頂点から境界ボリュームと三角形のBVHを求める(boundsがあれば境界ボリュームはそれを使う)
+	void CreateCollisionData(const BoundingVolume* bounds);
 };
@@ -1,4 +1,5 @@
 #pragma once
+#include "VertexFormat.h"
 
 class DirectXBase;
 
@@ -27,6 +28,13 @@ public:
 
 	DirectXBase* GetDxBase() const { return directxBase_; }
 
+	// Getter(GPUに送る頂点の形式)
+	const VertexFormat& GetVertexFormat() const { return vertexFormat; }
+	// Setter(GPUに送る頂点の形式。Object3dBase::Initializeとモデルの読み込みより前に設定する)
+	void SetVertexFormat(const VertexFormat& format) { vertexFormat = format; }
+
 private:
 	DirectXBase* directxBase_;
+
+	VertexFormat vertexFormat;
 };
@@ -36,7 +36,8 @@ void Object3d::Initialize() {
 
 	// 単位行列を書き込んでおく
 	transformationMatrix->WVP = MakeIdentity4x4();
-	transformationMatrix->World = MakeIdentity4x4();
+	transformationMatrix->World = MakeMatrix3x4(MakeIdentity4x4());
+	transformationMatrix->WorldInverseTranspose = MakeMatrix3x4(MakeIdentity4x4());
 
 	//// 平行光源にデータを書き込む
 	//directionalLightData->color = {1.0f, 1.0f, 1.0f, 1.0f};
@@ -72,15 +73,9 @@ void Object3d::Initialize() {
         {0.0f, 0.0f, 0.0f}
     };
 
-	first = {
-		{0.0f, 0.0f, 0.0f},
-		{0.0f, 0.0f, 0.0f}
-	};
+	localBounds = ComputeBoundingVolume(nullptr, 0);
 
-	aabb = {
-		{0.0f, 0.0f, 0.0f},
-		{0.0f, 0.0f, 0.0f}
-	};
+	UpdateBounds(MakeAffineMatrix3x4(transform.scale, MakeRotateQuaternion(transform.rotate), transform.translate));
 
 	SetAxisAngle({0.0f, 1.0f, 0.0f});
 
@@ -96,29 +91,45 @@ void Object3d::Initialize() {
 void Object3d::Update() {
 
 	// 3DのTransform処理
-	worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-	worldMatrix = Multiply(worldMatrix, rotateQuaternionMatrix);
+	// 任意軸回転は平行移動の後に掛かるので、回転と座標の両方に適用してから行列を一度で組み立てる
+	Quaternion rotate = Multiply(rotateQuaternion, MakeRotateQuaternion(transform.rotate));
+	// 4列目は常に(0,0,0,1)なのでMatrix3x4で計算する
+	Matrix3x4 world = MakeAffineMatrix3x4(transform.scale, rotate, RotateVector(transform.translate, rotateQuaternion));
+
+	// スケールが1なら法線用の行列はWorldと同じになる
+	MatrixClass worldClass = MatrixClass::Affine;
+	if (transform.scale.x == 1.0f && transform.scale.y == 1.0f && transform.scale.z == 1.0f) {
+		worldClass = MatrixClass::Rigid;
+	}
 
 	if (isParent)
 	{
-		worldMatrix = Multiply(worldMatrix, parent);
+		world = Multiply(world, parent);
+		if (parentClass > worldClass) {
+			worldClass = parentClass;
+		}
+	}
+	worldMatrix = MakeMatrix4x4(world);
+
+	// 頂点の位置が量子化されていれば、戻す行列を先に掛ける(法線用の行列には掛けない)
+	Matrix3x4 positionWorld = world;
+	if (model_ && model_->IsPositionQuantized()) {
+		positionWorld = Multiply(model_->GetPositionDequantize(), world);
 	}
 
 	Matrix4x4 worldViewProjectionMatrix;
 	if (camera) {
 		const Matrix4x4& viewProjectionMatrix = camera->GetViewProjectionMatrix();
-		worldViewProjectionMatrix = Multiply(worldMatrix, viewProjectionMatrix);
+		worldViewProjectionMatrix = Multiply(positionWorld, viewProjectionMatrix);
 	} else {
-		worldViewProjectionMatrix = worldMatrix;
+		worldViewProjectionMatrix = MakeMatrix4x4(positionWorld);
 	}
 	
 	transformationMatrix->WVP = worldViewProjectionMatrix;
-	transformationMatrix->World = worldMatrix;
+	transformationMatrix->World = positionWorld;
+	transformationMatrix->WorldInverseTranspose = MakeNormalMatrix(world, worldClass);
 
-	Vector3 worldPos = { worldMatrix.m[3][0], worldMatrix.m[3][1], worldMatrix.m[3][2] };
-
-	aabb.min = first.min + worldPos;
-	aabb.max = first.max + worldPos;
+	UpdateBounds(world);
 }
 
 void Object3d::Draw() {
@@ -217,24 +228,26 @@ void Object3d::SetShininess(const float& shininess) {
 }
 
 void Object3d::CreateAABB() {
-	const std::vector<VertexData> vData = model_->GetVertices();
-	
-	for (VertexData vertices : vData)
-	{
-		first.min.x = std::min(first.min.x, vertices.position.x);
-		first.min.y = std::min(first.min.y, vertices.position.y);
-		first.min.z = std::min(first.min.z, vertices.position.z);
-
-		first.max.x = std::max(first.max.x, vertices.position.x);
-		first.max.y = std::max(first.max.y, vertices.position.y);
-		first.max.z = std::max(first.max.z, vertices.position.z);
+	if (model_) {
+		localBounds = model_->GetBoundingVolume();
 	}
 }
 
-const bool& Object3d::CheckCollision(Object3d* object) const {
+void Object3d::UpdateBounds(const Matrix3x4& world) {
+	// 頂点はOBBから求めたAABBにもAABBから求めたAABBにも含まれるので、2つの重なりを使う
+	const AABB fromOBB = TransformAABB(localBounds.obb, world);
+	const AABB fromAABB = TransformAABB(localBounds.aabb, world);
+	aabb.min = { std::max(fromOBB.min.x, fromAABB.min.x), std::max(fromOBB.min.y, fromAABB.min.y), std::max(fromOBB.min.z, fromAABB.min.z) };
+	aabb.max = { std::min(fromOBB.max.x, fromAABB.max.x), std::min(fromOBB.max.y, fromAABB.max.y), std::min(fromOBB.max.z, fromAABB.max.z) };
+
+	obb = TransformOBB(localBounds.obb, world);
+	boundingSphere = TransformSphere(localBounds.sphere, world);
+}
+
+bool Object3d::CheckCollision(Object3d* object) const {
 	return CollisionAABB(aabb, object->GetAABB());
 }
 
-//const bool& Object3d::CheckCollisionSphere(const Sphere& sphere) const {
-//	return CollisionAABBSphere(aabb, sphere);
-//}
\ No newline at end of file
+bool Object3d::CheckCollisionSphere(const Sphere& sphere) const {
+	return ::CheckCollision(aabb, sphere);
+}
\ No newline at end of file
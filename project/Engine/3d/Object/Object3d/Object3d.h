@@ -6,8 +6,12 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix4x4.h"
+#include "Matrix3x4.h"
 #include "Transform.h"
 #include "AABB.h"
+#include "Sphere.h"
+#include "OBB.h"
+#include "BoundingVolume.h"
 #include "kMath.h"
 #include "Quaternion.h"
 
@@ -42,7 +46,8 @@ public: // メンバ関数
 
 	// Parentを登録(子)
 	void SetParent(const Matrix4x4& worldMatrix) { 
-		parent = worldMatrix; 
+		parent = MakeMatrix3x4(worldMatrix); 
+		parentClass = ClassifyMatrix(worldMatrix);
 		isParent = true;
 	}
 
@@ -59,9 +64,13 @@ private:
 
 	//float angle = 0.0f;
 
-	Matrix4x4 rotateQuaternionMatrix;
+	// 任意軸回転
+	Quaternion rotateQuaternion;
 
-	Matrix4x4 parent;
+	// 親のワールド行列(アフィン行列であること)
+	Matrix3x4 parent;
+	// 親の行列の種類(法線用の行列の求め方を選ぶのに使う)
+	MatrixClass parentClass = MatrixClass::General;
 	bool isParent = false;
 	//Transform* parent = nullptr;
 
@@ -75,7 +84,8 @@ private:
 
 	struct TransformationMatrix {
 		Matrix4x4 WVP;
-		Matrix4x4 World;
+		Matrix3x4 World;
+		Matrix3x4 WorldInverseTranspose;
 	};
 
 	// 座標変換リソースのバッファリソース
@@ -106,11 +116,15 @@ private:
 
 	// 衝突判定に必要
 
-	// Getterに返すようのAABB(座標を更新する)
+	// Getterに返すようのAABB(回転・スケールも反映したワールド座標)
 	AABB aabb;
+	// ワールド座標のOBB
+	OBB obb;
+	// ワールド座標の境界球
+	Sphere boundingSphere;
 
-	// 初期位置のAABB
-	AABB first;
+	// モデルのローカル座標の境界ボリューム(SetModelでモデルからコピーする)
+	BoundingVolume localBounds;
 
 	Matrix4x4 worldMatrix;
 
@@ -136,6 +150,12 @@ public:
 	const float& GetShininess() const;
 	// Getter(AABB)
 	const AABB& GetAABB() const { return aabb; }
+	// Getter(OBB)
+	const OBB& GetOBB() const { return obb; }
+	// Getter(境界球)
+	const Sphere& GetBoundingSphere() const { return boundingSphere; }
+	// Getter(Model)
+	Model* GetModel() const { return model_; }
 	// Getter(worldMatrix)
 	const Matrix4x4& GetWorldMatrix() const { return worldMatrix; }
 
@@ -162,14 +182,15 @@ public:
 	// 任意軸回転の軸を指定の回転角に変更
 	void SetAxisAngle(const Vector3& rotate) { axisAngle = Normalize(rotate); }
 	// 任意軸回転の回転量を設定
-	void SetQuaternionAngle(const float& angle) { rotateQuaternionMatrix = MakeRotateAxisAngle(axisAngle, angle); }
+	void SetQuaternionAngle(const float& angle) { rotateQuaternion = MakeRotateAxisAngleQuaternion(axisAngle, angle); }
 
 
 public:
 	// 衝突チェック(AABBとAABB)
-	const bool& CheckCollision(Object3d* object) const;
+	bool CheckCollision(Object3d* object) const;
 
-	//const bool& CheckCollisionSphere(const Sphere& sphere) const;
+	// 衝突チェック(AABBと球)
+	bool CheckCollisionSphere(const Sphere& sphere) const;
 
 private:
 
@@ -186,6 +207,9 @@ private:
 	// CameraResourceを作る
 	void CreateCameraResource();
 
-	// AABBをモデルを参照して自動的に作成
+	// 境界ボリュームをモデルからコピーする(モデルの読み込み時に求めてあるので頂点は見ない)
 	void CreateAABB();
+
+	// ワールド行列から境界ボリュームを更新する
+	void UpdateBounds(const Matrix3x4& world);
 };
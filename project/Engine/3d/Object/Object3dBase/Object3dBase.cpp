@@ -1,6 +1,8 @@
 #include "DirectXBase.h"
 #include "Logger.h"
 #include "Object3dBase.h"
+#include "ModelBase.h"
+#include "VertexFormat.h"
 #include <cassert>
 
 using namespace Microsoft::WRL;
@@ -85,18 +87,24 @@ void Object3dBase::CreateRootSignature() {
 	// バイナリをもとに作成
 	hr = directxBase_->GetDevice()->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
 	assert(SUCCEEDED(hr));
-	// InputLayout
+	// InputLayout(モデルの頂点の形式に合わせる。VertexFormat.hを参照)
+	const VertexFormat& vertexFormat = ModelBase::GetInstance()->GetVertexFormat();
+	// 位置だけを分けている場合は、UVと法線をスロット1から読む
+	const UINT attributeSlot = vertexFormat.splitPositionStream ? 1 : 0;
 	inputElementDescs[0].SemanticName = "POSITION";
 	inputElementDescs[0].SemanticIndex = 0;
-	inputElementDescs[0].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	inputElementDescs[0].Format = vertexFormat.position == VertexPositionFormat::kFloat3 ? DXGI_FORMAT_R32G32B32_FLOAT : DXGI_FORMAT_R16G16B16A16_UNORM;
+	inputElementDescs[0].InputSlot = 0;
 	inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 	inputElementDescs[1].SemanticName = "TEXCOORD";
 	inputElementDescs[1].SemanticIndex = 0;
-	inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	inputElementDescs[1].Format = DXGI_FORMAT_R16G16_FLOAT;     // 半精度
+	inputElementDescs[1].InputSlot = attributeSlot;
 	inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 	inputElementDescs[2].SemanticName = "NORMAL";
 	inputElementDescs[2].SemanticIndex = 0;
-	inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	inputElementDescs[2].Format = DXGI_FORMAT_R16G16_SNORM;     // 八面体に写した法線(VSで戻す)
+	inputElementDescs[2].InputSlot = attributeSlot;
 	inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 	inputLayoutDesc.pInputElementDescs = inputElementDescs;
 	inputLayoutDesc.NumElements = _countof(inputElementDescs);
@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+// 時間を計測するサンプル数(最速のものを使う)
+constexpr int kSampleCount = 5;
+
+using Clock = std::chrono::steady_clock;
+
+// iterations回呼んだときの時間(秒)
+double TimeCalls(const Benchmark::Function& function, size_t iterations) {
+	const Clock::time_point start = Clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		function();
+	}
+	const Clock::time_point end = Clock::now();
+	return std::chrono::duration<double>(end - start).count();
+}
+
+} // namespace
+
+void Benchmark::Add(const std::string& name, size_t opsPerCall, Function function, ErrorFunction error, double tolerance) {
+	cases.push_back(Case{ name, std::max<size_t>(opsPerCall, 1), std::move(function), std::move(error), tolerance, false });
+}
+
+void Benchmark::AddSection(const std::string& title) {
+	cases.push_back(Case{ title, 0, nullptr, nullptr, kNoTolerance, true });
+}
+
+void Benchmark::Run() {
+	results.clear();
+	std::printf("%-48s %12s %14s %12s\n", "name", "ns/op", "Mops/s", "max error");
+	// 見出しは計測するものがある場合だけ表示する
+	const Case* section = nullptr;
+	for (const Case& benchmarkCase : cases) {
+		if (benchmarkCase.isSection) {
+			section = &benchmarkCase;
+			continue;
+		}
+		if (!filter.empty() && benchmarkCase.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		if (checkOnly && !benchmarkCase.error) {
+			continue;
+		}
+		if (section) {
+			std::printf("\n[%s]\n", section->name.c_str());
+			section = nullptr;
+		}
+		Result result = Measure(benchmarkCase);
+		// 時間を計測していない場合は時間の列を空ける
+		char time[2][32] = { "-", "-" };
+		if (!checkOnly) {
+			std::snprintf(time[0], sizeof(time[0]), "%.3f", result.nsPerOp);
+			std::snprintf(time[1], sizeof(time[1]), "%.3f", result.opsPerSecond * 1.0e-6);
+		}
+		if (result.maxError < 0.0) {
+			std::printf("%-48s %12s %14s %12s\n", result.name.c_str(), time[0], time[1], "-");
+		} else if (result.isFailed) {
+			std::printf("%-48s %12s %14s %12.3g  FAILED (tolerance %.3g)\n", result.name.c_str(), time[0], time[1], result.maxError, benchmarkCase.tolerance);
+		} else {
+			std::printf("%-48s %12s %14s %12.3g\n", result.name.c_str(), time[0], time[1], result.maxError);
+		}
+		std::fflush(stdout);
+		results.push_back(result);
+	}
+}
+
+size_t Benchmark::GetFailureCount() const {
+	return static_cast<size_t>(std::count_if(results.begin(), results.end(), [](const Result& result) { return result.isFailed; }));
+}
+
+Benchmark::Result Benchmark::Measure(const Case& benchmarkCase) const {
+	Result result{ benchmarkCase.name, 0.0, 0.0, -1.0, false };
+	if (benchmarkCase.error) {
+		result.maxError = benchmarkCase.error();
+		// NaNも失敗にする
+		result.isFailed = !(result.maxError <= benchmarkCase.tolerance);
+	}
+	if (checkOnly) {
+		return result;
+	}
+
+	// 1サンプルがminTime/kSampleCount以上になるまで回数を増やす
+	const double sampleTime = minTime / kSampleCount;
+	size_t iterations = 1;
+	double elapsed = TimeCalls(benchmarkCase.function, iterations);
+	while (elapsed < sampleTime) {
+		const double scale = elapsed > 0.0 ? std::min(sampleTime / elapsed * 1.2, 10.0) : 10.0;
+		iterations = std::max(iterations + 1, static_cast<size_t>(iterations * scale));
+		elapsed = TimeCalls(benchmarkCase.function, iterations);
+	}
+
+	// 最速のサンプルを採用する
+	double best = elapsed;
+	for (int i = 1; i < kSampleCount; i++) {
+		best = std::min(best, TimeCalls(benchmarkCase.function, iterations));
+	}
+
+	const double ops = static_cast<double>(iterations) * static_cast<double>(benchmarkCase.opsPerCall);
+	result.nsPerOp = best * 1.0e9 / ops;
+	result.opsPerSecond = ops / best;
+	return result;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// マイクロベンチマーク
+// 計測する処理を登録してRunでまとめて計測し、ns/opとスループットを表示する
+// 標準ライブラリ以外に依存しないので、Engine/MathとEngine/Collisionだけで単体ビルドできる
+class Benchmark {
+public:
+	// 計測する処理
+	using Function = std::function<void()>;
+	// 参照実装との最大誤差を返す処理
+	using ErrorFunction = std::function<double()>;
+
+	// 誤差を表示するだけで、許容値と比べない場合の許容値
+	static constexpr double kNoTolerance = std::numeric_limits<double>::infinity();
+
+	// 計測結果
+	struct Result {
+		std::string name;
+		double nsPerOp;
+		double opsPerSecond;
+		// 参照実装との最大誤差(負なら未計測)。1より大きい値は相対誤差で比べる
+		double maxError;
+		// 最大誤差が許容値を超えたか
+		bool isFailed;
+	};
+
+	/// <summary>
+	/// 計測する処理を追加
+	/// </summary>
+	/// <param name="name">表示名</param>
+	/// <param name="opsPerCall">functionを1回呼んだときに処理する件数</param>
+	/// <param name="function">計測する処理</param>
+	/// <param name="error">参照実装との最大誤差を返す処理(計測前に1回だけ呼ぶ)</param>
+	/// <param name="tolerance">最大誤差の許容値(超えたら失敗にする)</param>
+	void Add(const std::string& name, size_t opsPerCall, Function function, ErrorFunction error = nullptr, double tolerance = kNoTolerance);
+
+	// 区切りの見出しを追加
+	void AddSection(const std::string& title);
+
+	// 1件あたりの計測時間(秒)
+	void SetMinTime(double seconds) { minTime = seconds; }
+
+	// 名前にfilterを含むものだけ計測する(空なら全て)
+	void SetFilter(const std::string& filter) { this->filter = filter; }
+
+	// trueなら時間は計測せず、誤差を求めるものだけ誤差を調べる
+	void SetCheckOnly(bool checkOnly) { this->checkOnly = checkOnly; }
+
+	// 登録した処理を全て計測して表示する
+	void Run();
+
+	// Getter(計測結果)
+	const std::vector<Result>& GetResults() const { return results; }
+	// 最大誤差が許容値を超えたものの数
+	size_t GetFailureCount() const;
+
+private:
+	struct Case {
+		std::string name;
+		size_t opsPerCall;
+		Function function;
+		ErrorFunction error;
+		double tolerance;
+		// 見出しの場合はtrue
+		bool isSection;
+	};
+
+	// 1件分を計測する
+	Result Measure(const Case& benchmarkCase) const;
+
+	std::vector<Case> cases;
+	std::vector<Result> results;
+	double minTime = 0.2;
+	std::string filter;
+	bool checkOnly = false;
+};
+
+// 計算結果を最適化で消されないようにする
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+	static volatile const void* sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
@@ -0,0 +1,59 @@
+// kMath/当たり判定/メッシュの読み込みのベンチマーク
+// エンジン本体とは別の実行ファイルなので、Engine/BlackBox/Benchmarkの.cppは全てプロジェクトのビルドから除外している
+// プラットフォームに依存しないEngine/Math、Engine/Collision(CollisionManager.cpp以外)、Engine/LoadManager/MeshCache、Engine/3d/Model/MeshOptimizerとThreadPoolだけでビルドできる
+//
+// ビルド(projectディレクトリにkMathBenchmarkができる)
+//   Windows      Engine/BlackBox/Benchmark/BuildBenchmark.bat(開発者コマンドプロンプトで実行)
+//   Linuxなど    Engine/BlackBox/Benchmark/BuildBenchmark.sh
+//
+// 使い方
+//   kMathBenchmark [--filter 文字列] [--min-time 秒] [--check]
+//   --checkは時間を計測せず、SIMD版などの誤差が許容値に収まっているかだけを調べる
+//   許容値を超えたものが1つでもあれば終了コードは1になる
+#include "Benchmark.h"
+#include "BenchmarkSuite.h"
+#include "kMathSimd.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+	Benchmark benchmark;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			benchmark.SetFilter(argv[++i]);
+		} else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+			benchmark.SetMinTime(std::atof(argv[++i]));
+		} else if (std::strcmp(argv[i], "--check") == 0) {
+			benchmark.SetCheckOnly(true);
+		} else {
+			std::printf("usage: %s [--filter name] [--min-time seconds] [--check]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	static const char* const kSimdLevelNames[] = { "Scalar", "SSE4.1", "AVX2" };
+	std::printf("SIMD level: %s\n", kSimdLevelNames[static_cast<int>(DetectSimdLevel())]);
+
+	ThreadPool::GetInstance()->Initialize();
+	std::printf("Worker threads: %zu\n", ThreadPool::GetInstance()->GetThreadCount());
+
+	AddMathBenchmarks(benchmark);
+	AddBroadPhaseBenchmarks(benchmark);
+	AddNarrowPhaseBenchmarks(benchmark);
+	AddBoundingVolumeBenchmarks(benchmark);
+	AddRaycastBenchmarks(benchmark);
+	AddContactBenchmarks(benchmark);
+	AddMeshBenchmarks(benchmark);
+	benchmark.Run();
+
+	ThreadPool::GetInstance()->Finalize();
+
+	const size_t failureCount = benchmark.GetFailureCount();
+	if (failureCount > 0) {
+		std::printf("\n%zu benchmark(s) exceeded the error tolerance\n", failureCount);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+class Benchmark;
+
+// kMath(行列、Quaternion、ベクトル、三角関数)のベンチマークを登録
+void AddMathBenchmarks(Benchmark& benchmark);
+
+// 当たり判定のベンチマークを登録(分野ごとに分けている。共有するデータはCollisionBenchmarkData.h)
+// AABB単体とまとめての判定、ブロードフェーズ
+void AddBroadPhaseBenchmarks(Benchmark& benchmark);
+// 形状ごとのナローフェーズ、連続的な判定、凸包(GJK/EPA)
+void AddNarrowPhaseBenchmarks(Benchmark& benchmark);
+// 頂点とワールド行列からの境界ボリューム
+void AddBoundingVolumeBenchmarks(Benchmark& benchmark);
+// 三角形のBVH、SceneBVH、HeightFieldへのレイキャスト
+void AddRaycastBenchmarks(Benchmark& benchmark);
+// ContactCacheと、スレッドの数ごとの1フレーム分の処理(ワーカースレッドを作り直すので当たり判定の最後に登録する)
+void AddContactBenchmarks(Benchmark& benchmark);
+
+// メッシュの最適化と読み込み(テキストの.objとMeshCache)のベンチマークを登録
+void AddMeshBenchmarks(Benchmark& benchmark);
@@ -0,0 +1,142 @@
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+#include "CollisionBenchmarkData.h"
+#include "BoundingVolume.h"
+#include "kMath.h"
+#include "kMathSimd.h"
+#include "AABB.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Model.hのVertexDataと同じレイアウト(Model.hはD3D12に依存するので使わない)
+struct VertexData {
+	Vector4 position;
+	Vector2 texcoord;
+	Vector3 normal;
+};
+
+// 原点付近にばらまいた頂点
+std::shared_ptr<std::vector<VertexData>> CreateVertices(size_t count) {
+	std::mt19937 random(6789);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	auto vertices = std::make_shared<std::vector<VertexData>>();
+	for (size_t i = 0; i < count; i++) {
+		const Vector3 position = RandomVector(random, unit);
+		vertices->push_back(VertexData{ { position.x, position.y, position.z, 1.0f }, { 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } });
+	}
+	return vertices;
+}
+
+// Object3d::CreateAABBと同じ処理(頂点配列をコピーしてから最小値・最大値を求める)
+AABB ComputeBoundsLegacy(const std::vector<VertexData>& vertices) {
+	const std::vector<VertexData> vData = vertices;
+	AABB result = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+	for (VertexData v : vData) {
+		result.min.x = std::min(result.min.x, v.position.x);
+		result.min.y = std::min(result.min.y, v.position.y);
+		result.min.z = std::min(result.min.z, v.position.z);
+		result.max.x = std::max(result.max.x, v.position.x);
+		result.max.y = std::max(result.max.y, v.position.y);
+		result.max.z = std::max(result.max.z, v.position.z);
+	}
+	return result;
+}
+
+// コピーせずに最初の頂点から求める
+AABB ComputeBounds(const std::vector<VertexData>& vertices) {
+	if (vertices.empty()) {
+		return AABB{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+	}
+	const Vector4& first = vertices.front().position;
+	AABB result = { { first.x, first.y, first.z }, { first.x, first.y, first.z } };
+	for (const VertexData& v : vertices) {
+		result.min.x = std::min(result.min.x, v.position.x);
+		result.min.y = std::min(result.min.y, v.position.y);
+		result.min.z = std::min(result.min.z, v.position.z);
+		result.max.x = std::max(result.max.x, v.position.x);
+		result.max.y = std::max(result.max.y, v.position.y);
+		result.max.z = std::max(result.max.z, v.position.z);
+	}
+	return result;
+}
+
+} // namespace
+
+void AddBoundingVolumeBenchmarks(Benchmark& benchmark) {
+	constexpr size_t kVertexCount = 100000;
+	std::shared_ptr<std::vector<VertexData>> vertices = CreateVertices(kVertexCount);
+
+	benchmark.AddSection("Vertex bounds");
+
+	benchmark.Add("CreateAABB (copy vertices, 100k)", kVertexCount,
+		[vertices]() {
+			AABB bounds = ComputeBoundsLegacy(*vertices);
+			DoNotOptimize(bounds);
+		});
+	benchmark.Add("CreateAABB (no copy, 100k)", kVertexCount,
+		[vertices]() {
+			AABB bounds = ComputeBounds(*vertices);
+			DoNotOptimize(bounds);
+		});
+
+	// モデルの読み込み時に1回だけ行う処理(AABB・球・主成分分析のOBB)
+	auto positions = std::make_shared<std::vector<Vector3>>();
+	for (const VertexData& vertex : *vertices) {
+		positions->push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+	}
+	benchmark.Add("ComputeBoundingVolume (100k)", kVertexCount,
+		[positions]() {
+			BoundingVolume bounds = ComputeBoundingVolume(positions->data(), positions->size());
+			DoNotOptimize(bounds);
+		});
+
+	// 毎フレームObject3d::Updateで行う処理(ワールド行列からAABBを求める)
+	constexpr size_t kObjectCount = 10000;
+	auto worlds = std::make_shared<std::vector<Matrix3x4>>();
+	{
+		std::mt19937 random(1357);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+		std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+		for (size_t i = 0; i < kObjectCount; i++) {
+			worlds->push_back(MakeAffineMatrix3x4({ scale(random), scale(random), scale(random) },
+				MakeRotateQuaternion({ angle(random), angle(random), angle(random) }), { position(random), position(random), position(random) }));
+		}
+	}
+	const BoundingVolume kLocalBounds = ComputeBoundingVolume(positions->data(), positions->size());
+	auto worldAABBs = std::make_shared<std::vector<AABB>>(kObjectCount);
+	benchmark.Add("AABB translate only (10k objects)", kObjectCount,
+		[worlds, worldAABBs, kLocalBounds]() {
+			for (size_t i = 0; i < worlds->size(); i++) {
+				const Matrix3x4& world = (*worlds)[i];
+				const Vector3 worldPos = { world.m[0][3], world.m[1][3], world.m[2][3] };
+				(*worldAABBs)[i] = AABB{ kLocalBounds.aabb.min + worldPos, kLocalBounds.aabb.max + worldPos };
+			}
+			DoNotOptimize(worldAABBs->data());
+		});
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41 }) {
+		if (level > DetectSimdLevel()) {
+			continue;
+		}
+		const std::string suffix = level == SimdLevel::Scalar ? " [Scalar]" : " [SSE4.1]";
+		benchmark.Add("TransformAABB from OBB (10k objects)" + suffix, kObjectCount,
+			[worlds, worldAABBs, kLocalBounds, level]() {
+				if (GetSimdLevel() != level) {
+					SetSimdLevel(level);
+				}
+				for (size_t i = 0; i < worlds->size(); i++) {
+					(*worldAABBs)[i] = TransformAABB(kLocalBounds.obb, (*worlds)[i]);
+				}
+				DoNotOptimize(worldAABBs->data());
+			});
+	}
+	SetSimdLevel(DetectSimdLevel());
+}
@@ -0,0 +1,279 @@
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+#include "CollisionBenchmarkData.h"
+#include "CollisionManager.h"
+#include "BroadPhase.h"
+#include "SpatialHashGrid.h"
+#include "DynamicAABBTree.h"
+#include "AABBBatch.h"
+#include "kMathSimd.h"
+#include "AABB.h"
+#include "Vector3.h"
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 範囲内にばらまいたAABB
+std::shared_ptr<std::vector<AABB>> CreateAABBs(size_t count) {
+	std::mt19937 random(6789);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> extent(0.25f, 2.0f);
+	auto aabbs = std::make_shared<std::vector<AABB>>();
+	for (size_t i = 0; i < count; i++) {
+		aabbs->push_back(RandomAABB(random, position, extent));
+	}
+	return aabbs;
+}
+
+// ペアの求め方
+struct PairMethod {
+	const char* name;
+	BroadPhaseType type;
+	// 全ペアをCollisionAABBで調べる(ブロードフェーズを使わない)
+	bool isAllPairs;
+	// DynamicAABBTree、SpatialHashGridを並列に処理する
+	bool isParallel;
+};
+
+// 動き続けるAABBの配置
+struct MovingSceneSettings {
+	// AABBの大きさ(半分)の範囲
+	float minExtent;
+	float maxExtent;
+	// 1個あたりの間隔(数が変わっても密度が同じになるように範囲を広げる)
+	float spacing;
+	// 1フレームに動く最大距離
+	float speed;
+};
+
+// 動き続けるAABBの集まり(ブロードフェーズの計測用)
+struct MovingScene {
+	std::vector<AABB> aabbs;
+	std::vector<Vector3> velocities;
+	// 動ける範囲(原点中心の立方体の半分の大きさ)
+	float halfSize = 0.0f;
+
+	// 全ペアを調べる場合はnullptr
+	std::unique_ptr<BroadPhase> broadPhase;
+	std::vector<ProxyHandle> proxies;
+	std::vector<ProxyPair> pairs;
+
+	MovingScene(size_t count, const PairMethod& method, const MovingSceneSettings& settings) {
+		std::mt19937 random(2468);
+		halfSize = settings.spacing * std::cbrt(static_cast<float>(count));
+		std::uniform_real_distribution<float> position(-halfSize, halfSize);
+		std::uniform_real_distribution<float> extent(settings.minExtent, settings.maxExtent);
+		std::uniform_real_distribution<float> speed(-settings.speed, settings.speed);
+
+		if (!method.isAllPairs) {
+			broadPhase = CreateBroadPhase(method.type);
+			if (method.type == BroadPhaseType::DynamicAABBTree) {
+				static_cast<DynamicAABBTree*>(broadPhase.get())->SetParallel(method.isParallel);
+			} else if (method.type == BroadPhaseType::SpatialHashGrid) {
+				static_cast<SpatialHashGrid*>(broadPhase.get())->SetParallel(method.isParallel);
+			}
+		}
+		for (size_t i = 0; i < count; i++) {
+			aabbs.push_back(RandomAABB(random, position, extent));
+			velocities.push_back(RandomVector(random, speed));
+			proxies.push_back(broadPhase ? broadPhase->CreateProxy(aabbs.back(), nullptr) : static_cast<ProxyHandle>(i));
+		}
+	}
+
+	// 1フレーム分動かしてペアを求める
+	void Step() {
+		for (size_t i = 0; i < aabbs.size(); i++) {
+			AABB& aabb = aabbs[i];
+			Vector3& velocity = velocities[i];
+			// 範囲の端で跳ね返る
+			if (aabb.min.x < -halfSize || aabb.max.x > halfSize) { velocity.x = aabb.min.x < -halfSize ? std::fabs(velocity.x) : -std::fabs(velocity.x); }
+			if (aabb.min.y < -halfSize || aabb.max.y > halfSize) { velocity.y = aabb.min.y < -halfSize ? std::fabs(velocity.y) : -std::fabs(velocity.y); }
+			if (aabb.min.z < -halfSize || aabb.max.z > halfSize) { velocity.z = aabb.min.z < -halfSize ? std::fabs(velocity.z) : -std::fabs(velocity.z); }
+			aabb.min += velocity;
+			aabb.max += velocity;
+			if (broadPhase) {
+				broadPhase->MoveProxy(proxies[i], aabb);
+			}
+		}
+		if (broadPhase) {
+			broadPhase->ComputePairs(pairs);
+		} else {
+			ComputeAllPairs(pairs);
+		}
+	}
+
+	// 全ペアをCollisionAABBで調べる
+	void ComputeAllPairs(std::vector<ProxyPair>& result) const {
+		result.clear();
+		for (size_t i = 0; i < aabbs.size(); i++) {
+			for (size_t j = i + 1; j < aabbs.size(); j++) {
+				if (CollisionAABB(aabbs[i], aabbs[j])) {
+					ProxyHandle a = proxies[i];
+					ProxyHandle b = proxies[j];
+					result.push_back(a < b ? ProxyPair{ a, b } : ProxyPair{ b, a });
+				}
+			}
+		}
+	}
+
+	// 全ペアを調べた結果と食い違っているペアの数
+	size_t CountMismatches() const {
+		std::vector<ProxyPair> expected;
+		ComputeAllPairs(expected);
+		std::vector<ProxyPair> actual = pairs;
+		std::sort(expected.begin(), expected.end());
+		std::sort(actual.begin(), actual.end());
+		std::vector<ProxyPair> difference;
+		std::set_symmetric_difference(expected.begin(), expected.end(), actual.begin(), actual.end(), std::back_inserter(difference));
+		return difference.size();
+	}
+};
+
+// 1フレーム分(全オブジェクトの移動とペアの計算)の計測を追加する。ns/opはオブジェクト1個あたり
+// checkCount以下の数なら、全ペアを調べた結果と比べる(誤差は60フレーム分の食い違ったペアの数)
+void AddMovingScene(Benchmark& benchmark, const std::string& label, size_t count, const PairMethod& method, const MovingSceneSettings& settings, size_t checkCount) {
+	const std::string name = std::string(method.name) + " frame (" + std::to_string(count / 1000) + "k " + label + ")";
+	Benchmark::ErrorFunction error = nullptr;
+	if (count <= checkCount && !method.isAllPairs) {
+		error = [count, method, settings]() {
+			MovingScene check(count, method, settings);
+			size_t mismatches = 0;
+			for (int frame = 0; frame < 60; frame++) {
+				check.Step();
+				mismatches += check.CountMismatches();
+			}
+			return static_cast<double>(mismatches);
+		};
+	}
+	// 計測しない場合に作らなくて済むように、最初に呼ばれたときに作る
+	auto scene = std::make_shared<std::unique_ptr<MovingScene>>();
+	benchmark.Add(name, count,
+		[scene, count, method, settings]() {
+			if (!*scene) {
+				*scene = std::make_unique<MovingScene>(count, method, settings);
+			}
+			(*scene)->Step();
+			DoNotOptimize((*scene)->pairs.size());
+		},
+		error);
+}
+
+} // namespace
+
+void AddBroadPhaseBenchmarks(Benchmark& benchmark) {
+	constexpr size_t kAABBCount = 1000;
+	std::shared_ptr<std::vector<AABB>> aabbs = CreateAABBs(kAABBCount);
+
+	benchmark.AddSection("AABB");
+
+	// 全ペアをCollisionAABBで調べる(Object3d::CheckCollisionを全組み合わせで呼ぶのと同じ)
+	benchmark.Add("CollisionAABB all pairs (1k objects)", kAABBCount * (kAABBCount - 1) / 2,
+		[aabbs]() {
+			size_t hitCount = 0;
+			for (size_t i = 0; i < aabbs->size(); i++) {
+				for (size_t j = i + 1; j < aabbs->size(); j++) {
+					if (CollisionAABB((*aabbs)[i], (*aabbs)[j])) {
+						hitCount++;
+					}
+				}
+			}
+			DoNotOptimize(hitCount);
+		});
+
+	benchmark.AddSection("AABB batch");
+
+	// 1個のAABBと10k個のAABBをまとめて判定する(範囲内のオブジェクトを探す処理)
+	constexpr size_t kBatchCount = 10000;
+	std::shared_ptr<std::vector<AABB>> batchAABBs = CreateAABBs(kBatchCount);
+	auto soa = std::make_shared<AABBSoA>();
+	for (const AABB& aabb : *batchAABBs) {
+		soa->PushBack(aabb);
+	}
+	const AABB kQueryAABB = { { -20.0f, -20.0f, -20.0f }, { 20.0f, 20.0f, 20.0f } };
+	auto indices = std::make_shared<std::vector<uint32_t>>(kBatchCount);
+	auto masks = std::make_shared<std::vector<uint64_t>>();
+
+	benchmark.Add("CollisionAABB loop (AoS, 10k)", kBatchCount,
+		[batchAABBs, indices, kQueryAABB]() {
+			size_t hitCount = 0;
+			for (size_t i = 0; i < batchAABBs->size(); i++) {
+				if (CollisionAABB((*batchAABBs)[i], kQueryAABB)) {
+					(*indices)[hitCount++] = static_cast<uint32_t>(i);
+				}
+			}
+			DoNotOptimize(hitCount);
+		});
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+		if (level > DetectSimdLevel()) {
+			continue;
+		}
+		static const char* const kLevelNames[] = { "Scalar", "SSE4.1", "AVX2" };
+		const std::string suffix = std::string(" [") + kLevelNames[static_cast<int>(level)] + "]";
+		// 全ての要素の番号が一致しているか(誤差は食い違った要素の数。1つでも違えば失敗)
+		auto error = [batchAABBs, soa, kQueryAABB, level]() {
+			SetSimdLevel(level);
+			std::vector<uint32_t> result;
+			CollisionAABBIndices(kQueryAABB, *soa, result);
+			std::vector<uint32_t> expected;
+			for (size_t i = 0; i < batchAABBs->size(); i++) {
+				if (CollisionAABB((*batchAABBs)[i], kQueryAABB)) {
+					expected.push_back(static_cast<uint32_t>(i));
+				}
+			}
+			std::vector<uint32_t> difference;
+			std::set_symmetric_difference(expected.begin(), expected.end(), result.begin(), result.end(), std::back_inserter(difference));
+			return static_cast<double>(difference.size());
+		};
+		benchmark.Add("CollisionAABBIndices (SoA, 10k)" + suffix, kBatchCount,
+			[soa, indices, kQueryAABB, level]() {
+				if (GetSimdLevel() != level) {
+					SetSimdLevel(level);
+				}
+				DoNotOptimize(CollisionAABBIndices(kQueryAABB, *soa, indices->data()));
+			},
+			error, 0.0);
+		benchmark.Add("CollisionAABBMask (SoA, 10k)" + suffix, kBatchCount,
+			[soa, masks, kQueryAABB, level]() {
+				if (GetSimdLevel() != level) {
+					SetSimdLevel(level);
+				}
+				DoNotOptimize(CollisionAABBMask(kQueryAABB, *soa, *masks));
+			});
+	}
+
+	benchmark.AddSection("BroadPhase");
+
+	const PairMethod kAllPairs = { "CollisionAABB all pairs", BroadPhaseType::DynamicAABBTree, true, false };
+	const PairMethod kTree = { "DynamicAABBTree", BroadPhaseType::DynamicAABBTree, false, false };
+	const PairMethod kTreeParallel = { "DynamicAABBTree parallel", BroadPhaseType::DynamicAABBTree, false, true };
+	const PairMethod kSweepAndPrune = { "SweepAndPrune", BroadPhaseType::SweepAndPrune, false, false };
+	const PairMethod kGrid = { "SpatialHashGrid", BroadPhaseType::SpatialHashGrid, false, false };
+	const PairMethod kGridParallel = { "SpatialHashGrid parallel", BroadPhaseType::SpatialHashGrid, false, true };
+
+	// 大きさのばらついたオブジェクトが少しずつ動く
+	const MovingSceneSettings kSlowScene = { 0.25f, 1.0f, 5.0f, 0.05f };
+	for (size_t count : { size_t(1000), size_t(10000), size_t(100000) }) {
+		for (const PairMethod& method : { kTree, kSweepAndPrune, kGrid }) {
+			AddMovingScene(benchmark, "moving", count, method, kSlowScene, 1000);
+		}
+	}
+
+	// 同じくらいの大きさの小さなオブジェクトが密集して速く動く(弾幕)
+	const MovingSceneSettings kBulletScene = { 0.1f, 0.2f, 1.5f, 0.2f };
+	for (size_t count : { size_t(2000), size_t(10000), size_t(50000) }) {
+		for (const PairMethod& method : { kAllPairs, kTree, kTreeParallel, kSweepAndPrune, kGrid, kGridParallel }) {
+			// 全ペアは時間がかかりすぎるので10kまで
+			if (method.isAllPairs && count > 10000) {
+				continue;
+			}
+			AddMovingScene(benchmark, "bullets", count, method, kBulletScene, 2000);
+		}
+	}
+}
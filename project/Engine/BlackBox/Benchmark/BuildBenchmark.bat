@@ -0,0 +1,21 @@
+@echo off
+rem Builds the standalone benchmark (kMathBenchmark.exe) with MSVC.
+rem Run from a Visual Studio Developer Command Prompt (x64). Extra cl options can be passed as arguments.
+rem The exe is written to the project directory. Run it from there, because it reads models from Resources.
+setlocal
+cd /d "%~dp0..\..\.."
+if not exist BenchmarkBuild mkdir BenchmarkBuild
+
+cl /nologo /std:c++20 /O2 /EHsc /utf-8 /W3 ^
+	/IEngine\Math /IEngine\Collision /IEngine\Core\ThreadPool /IEngine\BlackBox\Benchmark ^
+	/IEngine\LoadManager\MeshCache /IEngine\3d\Model\MeshOptimizer ^
+	Engine\BlackBox\Benchmark\*.cpp Engine\Math\*.cpp Engine\Core\ThreadPool\ThreadPool.cpp ^
+	Engine\LoadManager\MeshCache\MappedFile.cpp Engine\LoadManager\MeshCache\MeshCache.cpp ^
+	Engine\3d\Model\MeshOptimizer\MeshOptimizer.cpp Engine\3d\Model\MeshOptimizer\VertexFormat.cpp ^
+	Engine\Collision\AABBBatch.cpp Engine\Collision\BVH.cpp Engine\Collision\BoundingVolume.cpp ^
+	Engine\Collision\BroadPhase.cpp Engine\Collision\ContactCache.cpp Engine\Collision\ContinuousCollision.cpp ^
+	Engine\Collision\ConvexCollision.cpp Engine\Collision\ConvexHull.cpp Engine\Collision\DynamicAABBTree.cpp ^
+	Engine\Collision\HeightField.cpp Engine\Collision\NarrowPhase.cpp Engine\Collision\SceneBVH.cpp ^
+	Engine\Collision\SpatialHashGrid.cpp Engine\Collision\SweepAndPrune.cpp Engine\Collision\TriangleBVH.cpp ^
+	%* /FoBenchmarkBuild\ /Fe:kMathBenchmark.exe
+exit /b %errorlevel%
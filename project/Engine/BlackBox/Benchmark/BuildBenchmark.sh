@@ -0,0 +1,24 @@
+#!/bin/sh
+# ベンチマーク(kMathBenchmark)のビルド。Linux/macOSなどでg++かclang++を使う
+# Windowsの場合はBuildBenchmark.batを使う
+#
+# 使い方(どこから実行してもよい。CXXでコンパイラ、引数で追加のオプションを指定できる)
+#   Engine/BlackBox/Benchmark/BuildBenchmark.sh [オプション...]
+# projectディレクトリにkMathBenchmarkができる。Resourcesのモデルを読むので、projectディレクトリで実行する
+set -e
+cd "$(dirname "$0")/../../.."
+
+CXX="${CXX:-g++}"
+
+"$CXX" -std=c++20 -O2 \
+	-IEngine/Math -IEngine/Collision -IEngine/Core/ThreadPool -IEngine/BlackBox/Benchmark \
+	-IEngine/LoadManager/MeshCache -IEngine/3d/Model/MeshOptimizer \
+	Engine/BlackBox/Benchmark/*.cpp Engine/Math/*.cpp Engine/Core/ThreadPool/ThreadPool.cpp \
+	Engine/LoadManager/MeshCache/MappedFile.cpp Engine/LoadManager/MeshCache/MeshCache.cpp \
+	Engine/3d/Model/MeshOptimizer/MeshOptimizer.cpp Engine/3d/Model/MeshOptimizer/VertexFormat.cpp \
+	Engine/Collision/AABBBatch.cpp Engine/Collision/BVH.cpp Engine/Collision/BoundingVolume.cpp \
+	Engine/Collision/BroadPhase.cpp Engine/Collision/ContactCache.cpp Engine/Collision/ContinuousCollision.cpp \
+	Engine/Collision/ConvexCollision.cpp Engine/Collision/ConvexHull.cpp Engine/Collision/DynamicAABBTree.cpp \
+	Engine/Collision/HeightField.cpp Engine/Collision/NarrowPhase.cpp Engine/Collision/SceneBVH.cpp \
+	Engine/Collision/SpatialHashGrid.cpp Engine/Collision/SweepAndPrune.cpp Engine/Collision/TriangleBVH.cpp \
+	-pthread "$@" -o kMathBenchmark
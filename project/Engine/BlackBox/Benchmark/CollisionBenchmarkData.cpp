@@ -0,0 +1,133 @@
+#include "CollisionBenchmarkData.h"
+#include "kMath.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// OBJファイルから三角形の頂点だけを読む(多角形は扇状に分ける。ModelManagerはD3D12に依存するので使わない)
+std::vector<Vector3> LoadObjPositions(const std::string& filePath) {
+	std::vector<Vector3> positions;
+	std::vector<Vector3> result;
+	std::ifstream file(filePath);
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream s(line);
+		std::string identifier;
+		s >> identifier;
+		if (identifier == "v") {
+			Vector3 position;
+			s >> position.x >> position.y >> position.z;
+			positions.push_back(position);
+		} else if (identifier == "f") {
+			std::vector<size_t> indices;
+			std::string definition;
+			while (s >> definition) {
+				indices.push_back(std::stoul(definition.substr(0, definition.find('/'))) - 1);
+			}
+			// 頂点が書かれていないファイル(goal.objなど)の面は飛ばす
+			if (std::any_of(indices.begin(), indices.end(), [&positions](size_t index) { return index >= positions.size(); })) {
+				continue;
+			}
+			for (size_t i = 1; i + 1 < indices.size(); i++) {
+				result.push_back(positions[indices[0]]);
+				result.push_back(positions[indices[i]]);
+				result.push_back(positions[indices[i + 1]]);
+			}
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+Vector3 RandomVector(std::mt19937& random, std::uniform_real_distribution<float>& distribution) {
+	const float x = distribution(random);
+	const float y = distribution(random);
+	const float z = distribution(random);
+	return { x, y, z };
+}
+
+Vector3 RandomDirection(std::mt19937& random) {
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	// 球の中の点を選んでから長さを1にする(立方体のままだと角の向きに偏る)
+	Vector3 direction;
+	do {
+		direction = RandomVector(random, unit);
+	} while (Dot(direction, direction) < 1.0e-2f || Dot(direction, direction) > 1.0f);
+	return Normalize(direction);
+}
+
+AABB RandomAABB(std::mt19937& random, std::uniform_real_distribution<float>& position, std::uniform_real_distribution<float>& extent) {
+	const Vector3 center = RandomVector(random, position);
+	const Vector3 half = RandomVector(random, extent);
+	return AABB{ center - half, center + half };
+}
+
+OBB RandomOBB(std::mt19937& random, const Vector3& center, const Vector3& size) {
+	std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+	const Quaternion rotate = MakeRotateQuaternion(RandomVector(random, angle));
+	OBB obb;
+	obb.center = center;
+	obb.orientation[0] = RotateVector({ 1.0f, 0.0f, 0.0f }, rotate);
+	obb.orientation[1] = RotateVector({ 0.0f, 1.0f, 0.0f }, rotate);
+	obb.orientation[2] = RotateVector({ 0.0f, 0.0f, 1.0f }, rotate);
+	obb.size = size;
+	return obb;
+}
+
+std::shared_ptr<MeshData> CreateMeshData(const std::string& filePath, size_t rayCount) {
+	auto data = std::make_shared<MeshData>();
+	data->positions = LoadObjPositions(filePath);
+	if (data->positions.empty()) {
+		return nullptr;
+	}
+	data->bvh.Build(data->positions.data(), data->positions.size());
+
+	std::mt19937 random(97531);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> distance(0.1f, 1.0f);
+	const AABB& bounds = data->bvh.GetBounds();
+	const Vector3 center = (bounds.min + bounds.max) * 0.5f;
+	const float size = Length(bounds.max - bounds.min);
+	for (size_t i = 0; i < rayCount; i++) {
+		const Vector3 origin = center + RandomDirection(random) * (size * distance(random));
+		const Vector3 target = center + RandomVector(random, unit) * (size * 0.3f);
+		data->rays.push_back(Ray{ origin, Normalize(target - origin), size * 2.0f });
+	}
+	data->castRadius = size * 0.02f;
+	return data;
+}
+
+bool RaycastBruteForce(const std::vector<Vector3>& positions, const Matrix3x4* world, const Ray& ray, float radius, float& distance) {
+	Ray limited = ray;
+	bool isHit = false;
+	for (size_t i = 0; i + 2 < positions.size(); i += 3) {
+		Triangle triangle = { { positions[i], positions[i + 1], positions[i + 2] } };
+		if (world) {
+			for (Vector3& vertex : triangle.vertices) {
+				vertex = MatrixTransform(vertex, *world);
+			}
+		}
+		float t;
+		const bool hit = radius > 0.0f ? SphereCastTriangle(limited, radius, triangle, t) : RaycastTriangle(limited, triangle, t);
+		if (hit) {
+			limited.maxDistance = t;
+			isHit = true;
+		}
+	}
+	distance = limited.maxDistance;
+	return isHit;
+}
+
+bool CollideSphereBVH(const MeshData& mesh, const Sphere& sphere, std::vector<uint32_t>& triangles, float& depth) {
+	mesh.bvh.Overlap(sphere, triangles);
+	float closest = sphere.radius;
+	for (uint32_t index : triangles) {
+		const Triangle triangle = { { mesh.positions[index * 3], mesh.positions[index * 3 + 1], mesh.positions[index * 3 + 2] } };
+		closest = std::min(closest, Length(sphere.center - ClosestPointOnTriangle(sphere.center, triangle)));
+	}
+	depth = sphere.radius - closest;
+	return !triangles.empty();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "TriangleBVH.h"
+#include "AABB.h"
+#include "OBB.h"
+#include "Matrix3x4.h"
+#include "Ray.h"
+#include "Sphere.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// 当たり判定のベンチマーク(BroadPhaseBenchmark.cppなど)で共有する、形状やモデルの作り方と参照実装
+
+// 3成分とも同じ分布から取ったベクトル
+Vector3 RandomVector(std::mt19937& random, std::uniform_real_distribution<float>& distribution);
+
+// 長さ1のランダムな向き
+Vector3 RandomDirection(std::mt19937& random);
+
+// 中心と大きさ(半分)をそれぞれの分布から取ったAABB
+AABB RandomAABB(std::mt19937& random, std::uniform_real_distribution<float>& position, std::uniform_real_distribution<float>& extent);
+
+// 中心と大きさ(半分)を指定して、向きだけをランダムにしたOBB
+OBB RandomOBB(std::mt19937& random, const Vector3& center, const Vector3& size);
+
+// レイキャストなどで使うモデルとレイ
+struct MeshData {
+	std::vector<Vector3> positions;
+	TriangleBVH bvh;
+	// モデルの周りから中心付近に向けたレイ
+	std::vector<Ray> rays;
+	float castRadius;
+};
+
+/// <summary>
+/// OBJファイルを読んでBVHを作り、モデルに向けたレイを用意する
+/// </summary>
+/// <param name="filePath">projectディレクトリからのパス</param>
+/// <param name="rayCount">レイの数</param>
+/// <returns>モデル(読み込めなければnullptr)</returns>
+std::shared_ptr<MeshData> CreateMeshData(const std::string& filePath, size_t rayCount);
+
+// 全ての三角形を調べる(BVHの結果を確かめる参照実装)。worldがnullptrならモデルの座標のまま調べる
+bool RaycastBruteForce(const std::vector<Vector3>& positions, const Matrix3x4* world, const Ray& ray, float radius, float& distance);
+
+// 三角形のBVHで球と一番深く当たっている三角形を求める(HeightFieldや凸包の結果を確かめる参照実装。中心が面より上にある場合)
+bool CollideSphereBVH(const MeshData& mesh, const Sphere& sphere, std::vector<uint32_t>& triangles, float& depth);
@@ -0,0 +1,253 @@
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+#include "CollisionBenchmarkData.h"
+#include "BroadPhase.h"
+#include "NarrowPhase.h"
+#include "ContactCache.h"
+#include "ThreadPool.h"
+#include "kMath.h"
+#include "AABB.h"
+#include "Vector3.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// ほとんど止まっているシーン(OBBのペアをブロードフェーズで求めておく)
+struct ContactScene {
+	std::vector<OBB> obbs;
+	std::vector<ProxyPair> pairs;
+	// オブジェクトごとの動いたかどうか
+	std::vector<uint8_t> isMoved;
+	ContactCache cache;
+};
+
+std::shared_ptr<ContactScene> CreateContactScene(size_t count, float movedRate) {
+	std::mt19937 random(3141);
+	std::uniform_real_distribution<float> position(-30.0f, 30.0f);
+	std::uniform_real_distribution<float> extent(0.25f, 2.0f);
+	std::uniform_real_distribution<float> rate(0.0f, 1.0f);
+
+	auto data = std::make_shared<ContactScene>();
+	std::unique_ptr<BroadPhase> broadPhase = CreateBroadPhase(BroadPhaseType::DynamicAABBTree);
+	// ハンドルは連番とは限らないので、userDataにOBBの番号を入れておく
+	for (size_t i = 0; i < count; i++) {
+		const Vector3 center = RandomVector(random, position);
+		const Vector3 size = RandomVector(random, extent);
+		data->obbs.push_back(RandomOBB(random, center, size));
+		broadPhase->CreateProxy(MakeAABB(data->obbs.back()), reinterpret_cast<void*>(i));
+		data->isMoved.push_back(rate(random) < movedRate ? 1 : 0);
+	}
+	broadPhase->ComputePairs(data->pairs);
+	for (ProxyPair& pair : data->pairs) {
+		pair.a = static_cast<ProxyHandle>(reinterpret_cast<uintptr_t>(broadPhase->GetUserData(pair.a)));
+		pair.b = static_cast<ProxyHandle>(reinterpret_cast<uintptr_t>(broadPhase->GetUserData(pair.b)));
+		if (pair.b < pair.a) {
+			std::swap(pair.a, pair.b);
+		}
+	}
+	std::sort(data->pairs.begin(), data->pairs.end());
+	return data;
+}
+
+// キャッシュの接触しているペアの数と、全てのペアを判定し直した場合の数の差
+double CountContactMismatches(ContactScene& data) {
+	size_t touching = 0;
+	for (const ProxyPair& pair : data.pairs) {
+		Contact contact;
+		touching += CheckCollision(data.obbs[pair.a], data.obbs[pair.b], contact) ? 1 : 0;
+	}
+	const size_t cached = data.cache.GetEnterEvents().size() + data.cache.GetStayEvents().size();
+	return std::fabs(static_cast<double>(cached) - static_cast<double>(touching));
+}
+
+// 動いたオブジェクトの割合ごとにキャッシュの更新を計測する
+void AddContactCache(Benchmark& benchmark, size_t count, float movedRate) {
+	std::shared_ptr<ContactScene> data = CreateContactScene(count, movedRate);
+	auto update = [data]() {
+		data->cache.Update(data->pairs.data(), data->pairs.size(),
+			[&](ProxyHandle proxy) { return data->isMoved[proxy] != 0; },
+			[&](ProxyHandle a, ProxyHandle b, Contact& contact) { return CheckCollision(data->obbs[a], data->obbs[b], contact); });
+	};
+	const std::string name = "ContactCache update (" + std::to_string(static_cast<int>(movedRate * 100.0f)) + "% moved, " + std::to_string(data->pairs.size()) + " pairs)";
+	// 誤差の欄は接触しているペアの数の差
+	benchmark.Add(name, data->pairs.size(),
+		[data, update]() {
+			update();
+			DoNotOptimize(data->cache.GetStayEvents().data());
+		},
+		[data, update]() {
+			update();
+			update();
+			return CountContactMismatches(*data);
+		});
+}
+
+// ワーカースレッドの数を変える(呼び出し元を含めたスレッドの数で指定する)
+void SetThreadCount(size_t threadCount) {
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	if (threadPool->GetThreadCount() + 1 == threadCount) {
+		return;
+	}
+	threadPool->Finalize();
+	if (threadCount > 1) {
+		ThreadPool::GetInstance()->Initialize(threadCount - 1);
+	}
+}
+
+// 全てのオブジェクトが動き続けるシーン(ブロードフェーズからContactCacheまでを1フレーム分まとめて計測する)
+struct PipelineScene {
+	std::vector<OBB> obbs;
+	std::vector<Vector3> velocities;
+	float halfSize = 0.0f;
+
+	std::unique_ptr<BroadPhase> broadPhase;
+	std::vector<ProxyHandle> proxies;
+	// ハンドルからOBBの番号を引く
+	std::vector<uint32_t> proxyIndices;
+	std::vector<ProxyPair> pairs;
+	ContactCache cache;
+
+	PipelineScene(size_t count, BroadPhaseType type) {
+		std::mt19937 random(1357);
+		halfSize = 2.5f * std::cbrt(static_cast<float>(count));
+		std::uniform_real_distribution<float> position(-halfSize, halfSize);
+		std::uniform_real_distribution<float> extent(0.25f, 1.0f);
+		std::uniform_real_distribution<float> speed(-0.05f, 0.05f);
+
+		broadPhase = CreateBroadPhase(type);
+		for (size_t i = 0; i < count; i++) {
+			const Vector3 center = RandomVector(random, position);
+			const Vector3 size = RandomVector(random, extent);
+			obbs.push_back(RandomOBB(random, center, size));
+			velocities.push_back(RandomVector(random, speed));
+			const ProxyHandle proxy = broadPhase->CreateProxy(MakeAABB(obbs.back()), nullptr);
+			proxies.push_back(proxy);
+			if (proxyIndices.size() <= static_cast<size_t>(proxy)) {
+				proxyIndices.resize(proxy + 1);
+			}
+			proxyIndices[proxy] = static_cast<uint32_t>(i);
+		}
+	}
+
+	// 1フレーム分動かして、ペアと接触の状態の変化を求める
+	void Step() {
+		for (size_t i = 0; i < obbs.size(); i++) {
+			Vector3& center = obbs[i].center;
+			Vector3& velocity = velocities[i];
+			// 範囲の端で跳ね返る
+			if (std::fabs(center.x) > halfSize) { velocity.x = center.x < 0.0f ? std::fabs(velocity.x) : -std::fabs(velocity.x); }
+			if (std::fabs(center.y) > halfSize) { velocity.y = center.y < 0.0f ? std::fabs(velocity.y) : -std::fabs(velocity.y); }
+			if (std::fabs(center.z) > halfSize) { velocity.z = center.z < 0.0f ? std::fabs(velocity.z) : -std::fabs(velocity.z); }
+			center += velocity;
+			broadPhase->MoveProxy(proxies[i], MakeAABB(obbs[i]));
+		}
+		broadPhase->ComputePairs(pairs);
+		SortProxyPairs(pairs);
+		cache.Update(pairs.data(), pairs.size(),
+			[](ProxyHandle) { return true; },
+			[this](ProxyHandle a, ProxyHandle b, Contact& contact) { return CheckCollision(obbs[proxyIndices[a]], obbs[proxyIndices[b]], contact); });
+	}
+};
+
+// 順番まで含めて食い違っている要素の数(接触情報はビット単位で比べる)
+size_t CountEventMismatches(const std::vector<ContactEvent>& expected, const std::vector<ContactEvent>& actual) {
+	size_t mismatches = std::max(expected.size(), actual.size()) - std::min(expected.size(), actual.size());
+	for (size_t i = 0; i < std::min(expected.size(), actual.size()); i++) {
+		if (!(expected[i].pair == actual[i].pair) || std::memcmp(&expected[i].contact, &actual[i].contact, sizeof(Contact)) != 0) {
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+size_t CountPairMismatches(const std::vector<ProxyPair>& expected, const std::vector<ProxyPair>& actual) {
+	size_t mismatches = std::max(expected.size(), actual.size()) - std::min(expected.size(), actual.size());
+	for (size_t i = 0; i < std::min(expected.size(), actual.size()); i++) {
+		if (!(expected[i] == actual[i])) {
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+// スレッドの数ごとに1フレーム分の処理を計測する。ns/opはオブジェクト1個あたり
+// 誤差の欄は1スレッドで求めた結果と順番まで含めて食い違ったペアとイベントの数(10フレーム分)
+void AddPipeline(Benchmark& benchmark, const std::string& label, size_t count, BroadPhaseType type, size_t threadCount) {
+	const std::string name = "Pipeline " + label + " (" + std::to_string(count / 1000) + "k OBBs, " + std::to_string(threadCount) + (threadCount == 1 ? " thread)" : " threads)");
+	auto scene = std::make_shared<std::unique_ptr<PipelineScene>>();
+	benchmark.Add(name, count,
+		[scene, count, type, threadCount]() {
+			SetThreadCount(threadCount);
+			if (!*scene) {
+				*scene = std::make_unique<PipelineScene>(count, type);
+			}
+			(*scene)->Step();
+			DoNotOptimize((*scene)->cache.GetStayEvents().data());
+		},
+		[count, type, threadCount]() {
+			PipelineScene expected(count, type);
+			PipelineScene actual(count, type);
+			size_t mismatches = 0;
+			for (int frame = 0; frame < 10; frame++) {
+				SetThreadCount(1);
+				expected.Step();
+				SetThreadCount(threadCount);
+				actual.Step();
+				mismatches += CountPairMismatches(expected.pairs, actual.pairs);
+				mismatches += CountEventMismatches(expected.cache.GetEnterEvents(), actual.cache.GetEnterEvents());
+				mismatches += CountEventMismatches(expected.cache.GetStayEvents(), actual.cache.GetStayEvents());
+				mismatches += CountEventMismatches(expected.cache.GetExitEvents(), actual.cache.GetExitEvents());
+			}
+			return static_cast<double>(mismatches);
+		});
+}
+
+} // namespace
+
+void AddContactBenchmarks(Benchmark& benchmark) {
+	benchmark.AddSection("ContactCache");
+
+	// 1万個のOBBのうち動いたものを含むペアだけナローフェーズをやり直す(全て判定し直す場合と比べる)
+	{
+		std::shared_ptr<ContactScene> scene = CreateContactScene(10000, 1.0f);
+		benchmark.Add("Narrowphase all pairs (" + std::to_string(scene->pairs.size()) + " pairs)", scene->pairs.size(),
+			[scene]() {
+				size_t touching = 0;
+				for (const ProxyPair& pair : scene->pairs) {
+					Contact contact;
+					touching += CheckCollision(scene->obbs[pair.a], scene->obbs[pair.b], contact) ? 1 : 0;
+				}
+				DoNotOptimize(touching);
+			});
+		for (float movedRate : { 0.0f, 0.05f, 1.0f }) {
+			AddContactCache(benchmark, 10000, movedRate);
+		}
+	}
+
+	benchmark.AddSection("Pipeline scaling");
+
+	// ブロードフェーズ、ペアの整列、ナローフェーズ(ContactCache)をスレッドの数を変えて計測する
+	// ワーカースレッドを作り直すので最後に置く
+	{
+		const size_t hardwareCount = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+		std::vector<size_t> threadCounts;
+		for (size_t threadCount = 1; threadCount < hardwareCount; threadCount *= 2) {
+			threadCounts.push_back(threadCount);
+		}
+		threadCounts.push_back(hardwareCount);
+		for (size_t threadCount : threadCounts) {
+			AddPipeline(benchmark, "DynamicAABBTree", 20000, BroadPhaseType::DynamicAABBTree, threadCount);
+		}
+		for (size_t threadCount : threadCounts) {
+			AddPipeline(benchmark, "SpatialHashGrid", 20000, BroadPhaseType::SpatialHashGrid, threadCount);
+		}
+	}
+}
@@ -0,0 +1,544 @@
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+#include "kMath.h"
+#include "kMathBatch.h"
+#include "kMathSimd.h"
+#include "kMathTrig.h"
+#include "VectorSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 1回の呼び出しで処理する件数
+constexpr size_t kCount = 1024;
+
+// ベンチマークで使うデータ
+struct MathData {
+	std::vector<Matrix4x4> general;
+	std::vector<Matrix4x4> affine;
+	std::vector<Matrix4x4> rigid;
+	std::vector<Matrix3x4> affine3x4;
+	std::vector<Transform> transforms;
+	std::vector<Quaternion> quaternions;
+	std::vector<Vector3> vectors;
+	std::vector<Vector3> velocities;
+	std::vector<float> angles;
+	Matrix4x4 viewProjection;
+
+	std::vector<Matrix4x4> outMatrices;
+	std::vector<Matrix3x4> outMatrices3x4;
+	std::vector<Quaternion> outQuaternions;
+	std::vector<Vector3> outVectors;
+	std::vector<float> outSin;
+	std::vector<float> outCos;
+};
+
+std::shared_ptr<MathData> CreateMathData() {
+	std::mt19937 random(12345);
+	std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	auto data = std::make_shared<MathData>();
+	for (size_t i = 0; i < kCount; i++) {
+		Transform transform{
+			{ scale(random), scale(random), scale(random) },
+			{ angle(random), angle(random), angle(random) },
+			{ position(random), position(random), position(random) },
+		};
+		data->transforms.push_back(transform);
+		data->affine.push_back(MakeAffineMatrix(transform.scale, transform.rotate, transform.translate));
+		data->rigid.push_back(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, transform.rotate, transform.translate));
+		data->affine3x4.push_back(MakeMatrix3x4(data->affine.back()));
+
+		Matrix4x4 general = data->affine.back();
+		general.m[0][3] = unit(random) * 0.5f;
+		general.m[1][3] = unit(random) * 0.5f;
+		general.m[2][3] = unit(random) * 0.5f;
+		data->general.push_back(general);
+
+		data->quaternions.push_back(MakeRotateQuaternion(transform.rotate));
+		data->vectors.push_back({ position(random), position(random), position(random) });
+		data->velocities.push_back({ unit(random), unit(random), unit(random) });
+		data->angles.push_back(angle(random) * 4.0f);
+	}
+	Matrix4x4 view = InverseRigid(MakeAffineMatrix(Vector3{ 1.0f, 1.0f, 1.0f }, Vector3{ 0.3f, 0.2f, 0.0f }, Vector3{ 0.0f, 5.0f, -20.0f }));
+	data->viewProjection = Multiply(view, MakePrespectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+
+	data->outMatrices.resize(kCount);
+	data->outMatrices3x4.resize(kCount);
+	data->outQuaternions.resize(kCount);
+	data->outVectors.resize(kCount);
+	data->outSin.resize(kCount);
+	data->outCos.resize(kCount);
+	return data;
+}
+
+// SIMD版・まとめて処理する版と参照実装の誤差の許容値(超えたらベンチマークの終了コードを1にする)
+// 積と座標変換は足す順が変わるだけなので小さく、逆行列は行列式で割る分だけ大きくする
+constexpr double kMultiplyTolerance = 1.0e-5;
+constexpr double kInverseTolerance = 5.0e-4;
+// sin/cosを使うもの(Fastは|x| <= 100で5e-6程度)
+constexpr double kSinCosTolerance = 1.0e-6;
+constexpr double kFastSinCosTolerance = 1.0e-5;
+
+double GetSinCosTolerance(SinCosPrecision precision) {
+	return precision == SinCosPrecision::Accurate ? kSinCosTolerance : kFastSinCosTolerance;
+}
+
+// SIMDレベルが違う場合だけ切り替える
+void UseSimdLevel(SimdLevel level) {
+	if (GetSimdLevel() != level) {
+		SetSimdLevel(level);
+	}
+}
+
+const char* GetSimdLevelName(SimdLevel level) {
+	switch (level) {
+	case SimdLevel::SSE41:
+		return "SSE4.1";
+	case SimdLevel::AVX2:
+		return "AVX2";
+	default:
+		return "Scalar";
+	}
+}
+
+// 誤差(1より大きい値は相対誤差にする)
+double Difference(float value, float expected) {
+	return std::fabs(static_cast<double>(value) - expected) / std::max(1.0, std::fabs(static_cast<double>(expected)));
+}
+
+double MaxError(const Matrix4x4& a, const Matrix4x4& b) {
+	double error = 0.0;
+	for (int r = 0; r < 4; r++) {
+		for (int c = 0; c < 4; c++) {
+			error = std::max(error, Difference(a.m[r][c], b.m[r][c]));
+		}
+	}
+	return error;
+}
+
+double MaxError(const Vector3& a, const Vector3& b) {
+	return std::max({ Difference(a.x, b.x), Difference(a.y, b.y), Difference(a.z, b.z) });
+}
+
+double MaxError(const Quaternion& a, const Quaternion& b) {
+	return std::max({ Difference(a.x, b.x), Difference(a.y, b.y), Difference(a.z, b.z), Difference(a.w, b.w) });
+}
+
+// 以前のMakeAffineMatrix(回転行列を3つ作って掛け合わせる)
+Matrix4x4 MakeAffineMatrixLegacy(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
+	Matrix4x4 rotateMatrix = MultiplyScalar(MakeRotateXMatrix(rotate.x), MultiplyScalar(MakeRotateYMatrix(rotate.y), MakeRotateZMatrix(rotate.z)));
+	return MultiplyScalar(MultiplyScalar(MakeScaleMatrix(scale), rotateMatrix), MakeTranslateMatrix(translate));
+}
+
+void AddMatrixBenchmarks(Benchmark& benchmark, const std::shared_ptr<MathData>& data) {
+	benchmark.AddSection("Matrix4x4");
+
+	for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 }) {
+		if (level > DetectSimdLevel()) {
+			continue;
+		}
+		const std::string suffix = std::string(" (") + GetSimdLevelName(level) + ")";
+		benchmark.Add("Multiply" + suffix, kCount,
+			[data, level]() {
+				UseSimdLevel(level);
+				for (size_t i = 0; i < kCount; i++) {
+					data->outMatrices[i] = Multiply(data->general[i], data->viewProjection);
+				}
+				DoNotOptimize(data->outMatrices);
+			},
+			[data, level]() {
+				UseSimdLevel(level);
+				double error = 0.0;
+				for (size_t i = 0; i < kCount; i++) {
+					error = std::max(error, MaxError(Multiply(data->general[i], data->viewProjection), MultiplyScalar(data->general[i], data->viewProjection)));
+				}
+				return error;
+			}, kMultiplyTolerance);
+		benchmark.Add("Inverse" + suffix, kCount,
+			[data, level]() {
+				UseSimdLevel(level);
+				for (size_t i = 0; i < kCount; i++) {
+					data->outMatrices[i] = Inverse(data->general[i]);
+				}
+				DoNotOptimize(data->outMatrices);
+			},
+			[data, level]() {
+				UseSimdLevel(level);
+				double error = 0.0;
+				for (size_t i = 0; i < kCount; i++) {
+					error = std::max(error, MaxError(Inverse(data->general[i]), InverseScalar(data->general[i])));
+				}
+				return error;
+			}, kInverseTolerance);
+		benchmark.Add("MultiplyMatrices batch" + suffix, kCount,
+			[data, level]() {
+				UseSimdLevel(level);
+				MultiplyMatrices(data->general.data(), data->viewProjection, kCount, data->outMatrices.data());
+				DoNotOptimize(data->outMatrices);
+			},
+			[data, level]() {
+				UseSimdLevel(level);
+				MultiplyMatrices(data->general.data(), data->viewProjection, kCount, data->outMatrices.data());
+				double error = 0.0;
+				for (size_t i = 0; i < kCount; i++) {
+					error = std::max(error, MaxError(data->outMatrices[i], MultiplyScalar(data->general[i], data->viewProjection)));
+				}
+				return error;
+			}, kMultiplyTolerance);
+	}
+
+	benchmark.Add("InverseAffine", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outMatrices[i] = InverseAffine(data->affine[i]);
+			}
+			DoNotOptimize(data->outMatrices);
+		},
+		[data]() {
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				error = std::max(error, MaxError(InverseAffine(data->affine[i]), InverseScalar(data->affine[i])));
+			}
+			return error;
+		}, kInverseTolerance);
+	benchmark.Add("InverseRigid", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outMatrices[i] = InverseRigid(data->rigid[i]);
+			}
+			DoNotOptimize(data->outMatrices);
+		},
+		[data]() {
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				error = std::max(error, MaxError(InverseRigid(data->rigid[i]), InverseScalar(data->rigid[i])));
+			}
+			return error;
+		}, kInverseTolerance);
+	benchmark.Add("ClassifyMatrix", kCount,
+		[data]() {
+			int count = 0;
+			for (size_t i = 0; i < kCount; i++) {
+				count += static_cast<int>(ClassifyMatrix(data->affine[i]));
+			}
+			DoNotOptimize(count);
+		});
+	benchmark.Add("MakeNormalMatrix", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outMatrices[i] = MakeNormalMatrix(data->affine[i]);
+			}
+			DoNotOptimize(data->outMatrices);
+		});
+
+	benchmark.AddSection("Matrix3x4");
+	benchmark.Add("Multiply(Matrix3x4, Matrix3x4)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outMatrices3x4[i] = Multiply(data->affine3x4[i], data->affine3x4[kCount - 1 - i]);
+			}
+			DoNotOptimize(data->outMatrices3x4);
+		},
+		[data]() {
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				Matrix4x4 expected = MultiplyScalar(data->affine[i], data->affine[kCount - 1 - i]);
+				error = std::max(error, MaxError(MakeMatrix4x4(Multiply(data->affine3x4[i], data->affine3x4[kCount - 1 - i])), expected));
+			}
+			return error;
+		}, kMultiplyTolerance);
+	benchmark.Add("Multiply(Matrix3x4, Matrix4x4)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outMatrices[i] = Multiply(data->affine3x4[i], data->viewProjection);
+			}
+			DoNotOptimize(data->outMatrices);
+		},
+		[data]() {
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				error = std::max(error, MaxError(Multiply(data->affine3x4[i], data->viewProjection), MultiplyScalar(data->affine[i], data->viewProjection)));
+			}
+			return error;
+		}, kMultiplyTolerance);
+	benchmark.Add("Inverse(Matrix3x4)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outMatrices3x4[i] = Inverse(data->affine3x4[i]);
+			}
+			DoNotOptimize(data->outMatrices3x4);
+		},
+		[data]() {
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				error = std::max(error, MaxError(MakeMatrix4x4(Inverse(data->affine3x4[i])), InverseScalar(data->affine[i])));
+			}
+			return error;
+		}, kInverseTolerance);
+}
+
+void AddTransformBenchmarks(Benchmark& benchmark, const std::shared_ptr<MathData>& data) {
+	benchmark.AddSection("Transform");
+
+	benchmark.Add("MakeAffineMatrix (legacy S*Rx*Ry*Rz*T)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				const Transform& t = data->transforms[i];
+				data->outMatrices[i] = MakeAffineMatrixLegacy(t.scale, t.rotate, t.translate);
+			}
+			DoNotOptimize(data->outMatrices);
+		});
+	benchmark.Add("MakeAffineMatrix (Euler)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				const Transform& t = data->transforms[i];
+				data->outMatrices[i] = MakeAffineMatrix(t.scale, t.rotate, t.translate);
+			}
+			DoNotOptimize(data->outMatrices);
+		},
+		[data]() {
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				const Transform& t = data->transforms[i];
+				error = std::max(error, MaxError(MakeAffineMatrix(t.scale, t.rotate, t.translate), MakeAffineMatrixLegacy(t.scale, t.rotate, t.translate)));
+			}
+			return error;
+		}, kSinCosTolerance);
+	benchmark.Add("MakeAffineMatrix (Quaternion)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				const Transform& t = data->transforms[i];
+				data->outMatrices[i] = MakeAffineMatrix(t.scale, data->quaternions[i], t.translate);
+			}
+			DoNotOptimize(data->outMatrices);
+		});
+	benchmark.Add("MakeAffineMatrix3x4 (Quaternion)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				const Transform& t = data->transforms[i];
+				data->outMatrices3x4[i] = MakeAffineMatrix3x4(t.scale, data->quaternions[i], t.translate);
+			}
+			DoNotOptimize(data->outMatrices3x4);
+		});
+	for (SinCosPrecision precision : { SinCosPrecision::Accurate, SinCosPrecision::Fast }) {
+		const std::string suffix = precision == SinCosPrecision::Accurate ? " (Accurate)" : " (Fast)";
+		benchmark.Add("MakeAffineMatrices batch" + suffix, kCount,
+			[data, precision]() {
+				MakeAffineMatrices(data->transforms.data(), kCount, data->outMatrices.data(), precision);
+				DoNotOptimize(data->outMatrices);
+			},
+			[data, precision]() {
+				MakeAffineMatrices(data->transforms.data(), kCount, data->outMatrices.data(), precision);
+				double error = 0.0;
+				for (size_t i = 0; i < kCount; i++) {
+					const Transform& t = data->transforms[i];
+					error = std::max(error, MaxError(data->outMatrices[i], MakeAffineMatrixLegacy(t.scale, t.rotate, t.translate)));
+				}
+				return error;
+			}, GetSinCosTolerance(precision));
+	}
+
+	// Object3d::Updateと同じ計算(World、WVP、AABBの移動)
+	benchmark.Add("Object3d::Update (legacy)", kCount,
+		[data]() {
+			const Matrix4x4 axisAngle = MakeRotateAxisAngle({ 0.0f, 1.0f, 0.0f }, 0.5f);
+			for (size_t i = 0; i < kCount; i++) {
+				const Transform& t = data->transforms[i];
+				Matrix4x4 world = MultiplyScalar(MakeAffineMatrixLegacy(t.scale, t.rotate, t.translate), axisAngle);
+				data->outMatrices[i] = MultiplyScalar(world, data->viewProjection);
+				data->outVectors[i] = data->vectors[i] + Vector3{ world.m[3][0], world.m[3][1], world.m[3][2] };
+			}
+			DoNotOptimize(data->outMatrices);
+			DoNotOptimize(data->outVectors);
+		});
+	benchmark.Add("Object3d::Update (current)", kCount,
+		[data]() {
+			const Quaternion axisAngle = MakeRotateAxisAngleQuaternion({ 0.0f, 1.0f, 0.0f }, 0.5f);
+			for (size_t i = 0; i < kCount; i++) {
+				const Transform& t = data->transforms[i];
+				Quaternion rotate = Multiply(axisAngle, MakeRotateQuaternion(t.rotate));
+				Matrix3x4 world = MakeAffineMatrix3x4(t.scale, rotate, RotateVector(t.translate, axisAngle));
+				data->outMatrices[i] = Multiply(world, data->viewProjection);
+				data->outMatrices3x4[i] = MakeNormalMatrix(world);
+				data->outVectors[i] = data->vectors[i] + Vector3{ world.m[0][3], world.m[1][3], world.m[2][3] };
+			}
+			DoNotOptimize(data->outMatrices);
+			DoNotOptimize(data->outMatrices3x4);
+			DoNotOptimize(data->outVectors);
+		});
+}
+
+void AddTrigBenchmarks(Benchmark& benchmark, const std::shared_ptr<MathData>& data) {
+	benchmark.AddSection("SinCos");
+
+	benchmark.Add("std::sin + std::cos", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outSin[i] = std::sin(data->angles[i]);
+				data->outCos[i] = std::cos(data->angles[i]);
+			}
+			DoNotOptimize(data->outSin);
+			DoNotOptimize(data->outCos);
+		});
+	for (SinCosPrecision precision : { SinCosPrecision::Accurate, SinCosPrecision::Fast }) {
+		const std::string suffix = precision == SinCosPrecision::Accurate ? " (Accurate)" : " (Fast)";
+		auto error = [data, precision]() {
+			SinCos(data->angles.data(), kCount, data->outSin.data(), data->outCos.data(), precision);
+			double result = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				const double angle = data->angles[i];
+				result = std::max({ result, std::fabs(data->outSin[i] - std::sin(angle)), std::fabs(data->outCos[i] - std::cos(angle)) });
+			}
+			return result;
+		};
+		benchmark.Add("SinCos scalar" + suffix, kCount,
+			[data, precision]() {
+				for (size_t i = 0; i < kCount; i++) {
+					SinCos(data->angles[i], data->outSin[i], data->outCos[i], precision);
+				}
+				DoNotOptimize(data->outSin);
+				DoNotOptimize(data->outCos);
+			});
+		benchmark.Add("SinCos batch" + suffix, kCount,
+			[data, precision]() {
+				SinCos(data->angles.data(), kCount, data->outSin.data(), data->outCos.data(), precision);
+				DoNotOptimize(data->outSin);
+				DoNotOptimize(data->outCos);
+			},
+			error, GetSinCosTolerance(precision));
+	}
+}
+
+void AddVectorBenchmarks(Benchmark& benchmark, const std::shared_ptr<MathData>& data) {
+	benchmark.AddSection("Vector");
+
+	benchmark.Add("Normalize(Vector3)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outVectors[i] = Normalize(data->vectors[i]);
+			}
+			DoNotOptimize(data->outVectors);
+		});
+	benchmark.Add("Vector3 operators (p + v * dt)", kCount,
+		[data]() {
+			const float deltaTime = 1.0f / 60.0f;
+			for (size_t i = 0; i < kCount; i++) {
+				data->outVectors[i] = data->vectors[i] + data->velocities[i] * deltaTime;
+			}
+			DoNotOptimize(data->outVectors);
+		});
+	benchmark.Add("Float4 (p + v * dt)", kCount,
+		[data]() {
+			const Float4 deltaTime = SplatFloat4(1.0f / 60.0f);
+			for (size_t i = 0; i < kCount; i++) {
+				data->outVectors[i] = StoreVector3(MultiplyAdd(LoadFloat4(data->velocities[i]), deltaTime, LoadFloat4(data->vectors[i])));
+			}
+			DoNotOptimize(data->outVectors);
+		});
+	benchmark.Add("MatrixTransform loop", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outVectors[i] = MatrixTransform(data->vectors[i], data->affine[0]);
+			}
+			DoNotOptimize(data->outVectors);
+		});
+	benchmark.Add("TransformPoints batch (AoS)", kCount,
+		[data]() {
+			TransformPoints(data->vectors.data(), kCount, data->affine[0], data->outVectors.data());
+			DoNotOptimize(data->outVectors);
+		},
+		[data]() {
+			TransformPoints(data->vectors.data(), kCount, data->affine[0], data->outVectors.data());
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				error = std::max(error, MaxError(data->outVectors[i], MatrixTransformScalar(data->vectors[i], data->affine[0])));
+			}
+			return error;
+		}, kMultiplyTolerance);
+}
+
+void AddQuaternionBenchmarks(Benchmark& benchmark, const std::shared_ptr<MathData>& data) {
+	benchmark.AddSection("Quaternion");
+
+	benchmark.Add("Multiply(Quaternion)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outQuaternions[i] = Multiply(data->quaternions[i], data->quaternions[kCount - 1 - i]);
+			}
+			DoNotOptimize(data->outQuaternions);
+		});
+	benchmark.Add("RotateVector", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outVectors[i] = RotateVector(data->vectors[i], data->quaternions[i]);
+			}
+			DoNotOptimize(data->outVectors);
+		});
+	benchmark.Add("MakeRotateQuaternion", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outQuaternions[i] = MakeRotateQuaternion(data->transforms[i].rotate);
+			}
+			DoNotOptimize(data->outQuaternions);
+		});
+	benchmark.Add("MakeRotateQuaternions batch", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outVectors[i] = data->transforms[i].rotate;
+			}
+			MakeRotateQuaternions(data->outVectors.data(), kCount, data->outQuaternions.data());
+			DoNotOptimize(data->outQuaternions);
+		},
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outVectors[i] = data->transforms[i].rotate;
+			}
+			MakeRotateQuaternions(data->outVectors.data(), kCount, data->outQuaternions.data());
+			double error = 0.0;
+			for (size_t i = 0; i < kCount; i++) {
+				error = std::max(error, MaxError(data->outQuaternions[i], MakeRotateQuaternion(data->transforms[i].rotate)));
+			}
+			return error;
+		}, kSinCosTolerance);
+	benchmark.Add("MakeRotateMatrix(Quaternion)", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outMatrices[i] = MakeRotateMatrix(data->quaternions[i]);
+			}
+			DoNotOptimize(data->outMatrices);
+		});
+	benchmark.Add("Slerp", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outQuaternions[i] = Slerp(data->quaternions[i], data->quaternions[kCount - 1 - i], 0.3f);
+			}
+			DoNotOptimize(data->outQuaternions);
+		});
+	benchmark.Add("Nlerp", kCount,
+		[data]() {
+			for (size_t i = 0; i < kCount; i++) {
+				data->outQuaternions[i] = Nlerp(data->quaternions[i], data->quaternions[kCount - 1 - i], 0.3f);
+			}
+			DoNotOptimize(data->outQuaternions);
+		});
+}
+
+} // namespace
+
+void AddMathBenchmarks(Benchmark& benchmark) {
+	std::shared_ptr<MathData> data = CreateMathData();
+	AddMatrixBenchmarks(benchmark, data);
+	AddTransformBenchmarks(benchmark, data);
+	AddTrigBenchmarks(benchmark, data);
+	AddVectorBenchmarks(benchmark, data);
+	AddQuaternionBenchmarks(benchmark, data);
+}
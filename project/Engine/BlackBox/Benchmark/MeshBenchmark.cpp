@@ -0,0 +1,506 @@
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include "VertexFormat.h"
+#include "kMath.h"
+#include "BoundingVolume.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <algorithm>
+#include <cmath>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Model.hのVertexDataと同じレイアウト(Model.hはD3D12に依存するので使わない)
+struct VertexData {
+	Vector4 position;
+	Vector2 texcoord;
+	Vector3 normal;
+};
+
+// テキストの.objから頂点を作る(assimpはベンチマークのビルドに入っていないので、代わりにModel::LoadModelFileと同じ形を作る)
+std::vector<VertexData> LoadObjVertices(const std::string& filePath) {
+	std::vector<Vector3> positions;
+	std::vector<Vector2> texcoords;
+	std::vector<Vector3> normals;
+	std::vector<VertexData> vertices;
+	std::ifstream file(filePath);
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream s(line);
+		std::string identifier;
+		s >> identifier;
+		if (identifier == "v") {
+			Vector3 position;
+			s >> position.x >> position.y >> position.z;
+			positions.push_back(position);
+		} else if (identifier == "vt") {
+			Vector2 texcoord;
+			s >> texcoord.x >> texcoord.y;
+			texcoords.push_back({ texcoord.x, 1.0f - texcoord.y });
+		} else if (identifier == "vn") {
+			Vector3 normal;
+			s >> normal.x >> normal.y >> normal.z;
+			normals.push_back(normal);
+		} else if (identifier == "f") {
+			std::vector<VertexData> face;
+			std::string definition;
+			bool isValid = true;
+			while (s >> definition) {
+				// 位置/UV/法線の番号(省略されていれば0)
+				size_t index[3] = {};
+				std::istringstream v(definition);
+				std::string element;
+				for (size_t i = 0; i < 3 && std::getline(v, element, '/'); i++) {
+					index[i] = element.empty() ? 0 : std::stoul(element);
+				}
+				if (index[0] == 0 || index[0] > positions.size() || index[1] > texcoords.size() || index[2] > normals.size()) {
+					isValid = false;
+					break;
+				}
+				const Vector3& position = positions[index[0] - 1];
+				const Vector2 texcoord = index[1] ? texcoords[index[1] - 1] : Vector2{};
+				const Vector3 normal = index[2] ? normals[index[2] - 1] : Vector3{};
+				// 右手系から左手系への変換
+				face.push_back({ { -position.x, position.y, position.z, 1.0f }, texcoord, { -normal.x, normal.y, normal.z } });
+			}
+			if (!isValid) {
+				continue;
+			}
+			// 三角形に分割して、巻き順を逆にする
+			for (size_t i = 1; i + 1 < face.size(); i++) {
+				vertices.push_back(face[0]);
+				vertices.push_back(face[i + 1]);
+				vertices.push_back(face[i]);
+			}
+		}
+	}
+	return vertices;
+}
+
+BoundingVolume ComputeBounds(const std::vector<VertexData>& vertices) {
+	std::vector<Vector3> positions;
+	positions.reserve(vertices.size());
+	for (const VertexData& vertex : vertices) {
+		positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+	}
+	return ComputeBoundingVolume(positions.data(), positions.size());
+}
+
+// 1モデル分のデータ
+struct MeshLoadData {
+	std::string sourcePath;
+	// アップロード用のバッファの代わり
+	std::vector<VertexData> uploadBuffer;
+	std::vector<uint8_t> uploadIndexBuffer;
+};
+
+std::string FormatKiloBytes(size_t bytes) {
+	char text[32];
+	std::snprintf(text, sizeof(text), "%.1f KB", static_cast<double>(bytes) / 1024.0);
+	return text;
+}
+
+// 頂点の溶接(頂点数とメモリの減り方を名前に入れる)
+void AddWeld(Benchmark& benchmark, const std::string& name) {
+	auto triangleVertices = std::make_shared<std::vector<VertexData>>(LoadObjVertices(std::string("Resources/Model/obj/") + name + ".obj"));
+	if (triangleVertices->empty()) {
+		return;
+	}
+	std::vector<VertexData> vertices;
+	std::vector<uint32_t> indices;
+	WeldVertices(*triangleVertices, vertices, indices);
+	const size_t beforeBytes = sizeof(VertexData) * triangleVertices->size();
+	const size_t afterBytes = sizeof(VertexData) * vertices.size() + GetIndexSize(vertices.size()) * indices.size();
+
+	// 誤差はインデックスでたどった頂点が元の頂点と違う数
+	benchmark.Add("Weld " + name + " (" + std::to_string(triangleVertices->size()) + " -> " + std::to_string(vertices.size()) + " vertices, " +
+			FormatKiloBytes(beforeBytes) + " -> " + FormatKiloBytes(afterBytes) + ")",
+		triangleVertices->size(),
+		[triangleVertices]() {
+			std::vector<VertexData> vertices;
+			std::vector<uint32_t> indices;
+			WeldVertices(*triangleVertices, vertices, indices);
+			DoNotOptimize(vertices[0]);
+			DoNotOptimize(indices[0]);
+		},
+		[triangleVertices, vertices, indices]() {
+			double mismatch = 0.0;
+			for (size_t i = 0; i < triangleVertices->size(); i++) {
+				mismatch += std::memcmp(&vertices[indices[i]], &(*triangleVertices)[i], sizeof(VertexData)) != 0 ? 1.0 : 0.0;
+			}
+			return mismatch;
+		});
+}
+
+// 三角形を頂点の中身で比べられる形にする(表裏を変えずに、一番小さい頂点から始まるように回す)
+std::vector<std::array<uint32_t, 3>> CanonicalTriangles(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices,
+	std::map<std::string, uint32_t>& vertexIds) {
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		std::array<uint32_t, 3> triangle;
+		for (size_t corner = 0; corner < 3; corner++) {
+			const std::string bytes(reinterpret_cast<const char*>(&vertices[indices[i + corner]]), sizeof(VertexData));
+			triangle[corner] = vertexIds.emplace(bytes, static_cast<uint32_t>(vertexIds.size())).first->second;
+		}
+		std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+		triangles.push_back(triangle);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+std::string FormatCacheStatistics(const VertexCacheStatistics& before, const VertexCacheStatistics& after) {
+	char text[96];
+	std::snprintf(text, sizeof(text), "ACMR %.3f -> %.3f, ATVR %.3f -> %.3f", before.acmr, after.acmr, before.atvr, after.atvr);
+	return text;
+}
+
+// 頂点キャッシュの最適化(ACMR/ATVRの変わり方を名前に入れる。1件は三角形1個)
+void AddVertexCache(Benchmark& benchmark, const std::string& name) {
+	const std::vector<VertexData> triangleVertices = LoadObjVertices(std::string("Resources/Model/obj/") + name + ".obj");
+	if (triangleVertices.empty()) {
+		return;
+	}
+	auto vertices = std::make_shared<std::vector<VertexData>>();
+	auto indices = std::make_shared<std::vector<uint32_t>>();
+	WeldVertices(triangleVertices, *vertices, *indices);
+	const size_t triangleCount = indices->size() / 3;
+	const VertexCacheStatistics before = AnalyzeVertexCache(indices->data(), indices->size(), vertices->size());
+
+	std::vector<uint32_t> tipsify(indices->size());
+	OptimizeVertexCache(tipsify.data(), indices->data(), indices->size(), vertices->size());
+	const VertexCacheStatistics afterTipsify = AnalyzeVertexCache(tipsify.data(), tipsify.size(), vertices->size());
+
+	std::vector<VertexData> optimizedVertices = *vertices;
+	std::vector<uint32_t> optimizedIndices = *indices;
+	OptimizeMesh(optimizedVertices, optimizedIndices);
+	const VertexCacheStatistics afterMesh = AnalyzeVertexCache(optimizedIndices.data(), optimizedIndices.size(), optimizedVertices.size());
+
+	benchmark.Add("Tipsify " + name + " (" + FormatCacheStatistics(before, afterTipsify) + ")", triangleCount,
+		[vertices, indices]() {
+			std::vector<uint32_t> destination(indices->size());
+			OptimizeVertexCache(destination.data(), indices->data(), indices->size(), vertices->size());
+			DoNotOptimize(destination[0]);
+		});
+
+	// 誤差は並べ替えの前後で違う三角形の数(オーバードローと頂点の並べ替えまで含めて、三角形の集まりと表裏が変わらないこと)
+	benchmark.Add("Optimize mesh " + name + " (" + FormatCacheStatistics(before, afterMesh) + ")", triangleCount,
+		[vertices, indices]() {
+			std::vector<VertexData> destinationVertices = *vertices;
+			std::vector<uint32_t> destinationIndices = *indices;
+			OptimizeMesh(destinationVertices, destinationIndices);
+			DoNotOptimize(destinationVertices[0]);
+			DoNotOptimize(destinationIndices[0]);
+		},
+		[vertices, indices, optimizedVertices, optimizedIndices]() {
+			std::map<std::string, uint32_t> vertexIds;
+			const auto expected = CanonicalTriangles(*vertices, *indices, vertexIds);
+			const auto actual = CanonicalTriangles(optimizedVertices, optimizedIndices, vertexIds);
+			if (expected.size() != actual.size()) {
+				return static_cast<double>(expected.size());
+			}
+			double mismatch = 0.0;
+			for (size_t i = 0; i < expected.size(); i++) {
+				mismatch += expected[i] != actual[i] ? 1.0 : 0.0;
+			}
+			return mismatch;
+		});
+}
+
+// GPUに送る頂点の形式(1件は頂点1個)
+void AddVertexFormat(Benchmark& benchmark, const std::string& name) {
+	const std::vector<VertexData> triangleVertices = LoadObjVertices(std::string("Resources/Model/obj/") + name + ".obj");
+	if (triangleVertices.empty()) {
+		return;
+	}
+	auto vertices = std::make_shared<std::vector<VertexData>>();
+	std::vector<uint32_t> indices;
+	WeldVertices(triangleVertices, *vertices, indices);
+	const AABB bounds = ComputeBounds(*vertices).aabb;
+	const size_t vertexCount = vertices->size();
+
+	struct FormatCase {
+		const char* label;
+		VertexPositionFormat position;
+	};
+	for (const FormatCase& formatCase : { FormatCase{ "float3", VertexPositionFormat::kFloat3 }, FormatCase{ "unorm16", VertexPositionFormat::kUnorm16 } }) {
+		const VertexPositionFormat format = formatCase.position;
+		const uint32_t positionSize = GetPositionSize(format);
+		const size_t vertexSize = positionSize + GetAttributeSize();
+		auto buffer = std::make_shared<std::vector<uint8_t>>(vertexSize * vertexCount);
+		const std::string label = std::string("Encode ") + formatCase.label + " " + name + " (" + std::to_string(sizeof(VertexData)) + " -> " +
+			std::to_string(vertexSize) + " bytes/vertex, " + FormatKiloBytes(sizeof(VertexData) * vertexCount) + " -> " + FormatKiloBytes(vertexSize * vertexCount) + ")";
+
+		// 位置とUV・法線を分けて書く(Model::Initializeと同じ)。誤差は戻した位置の最大誤差
+		benchmark.Add(label, vertexCount,
+			[vertices, buffer, bounds, format, positionSize]() {
+				const size_t vertexCount = vertices->size();
+				EncodePositions(buffer->data(), positionSize, &(*vertices)[0].position, sizeof(VertexData), vertexCount, format, bounds);
+				EncodeAttributes(buffer->data() + positionSize * vertexCount, GetAttributeSize(), &(*vertices)[0].texcoord, &(*vertices)[0].normal, sizeof(VertexData), vertexCount);
+				DoNotOptimize((*buffer)[0]);
+			},
+			[vertices, bounds, format, positionSize]() {
+				const size_t vertexCount = vertices->size();
+				std::vector<uint8_t> encoded(positionSize * vertexCount);
+				EncodePositions(encoded.data(), positionSize, &(*vertices)[0].position, sizeof(VertexData), vertexCount, format, bounds);
+				const Matrix3x4 dequantize = MakeDequantizeMatrix(format, bounds);
+				double maxError = 0.0;
+				for (size_t i = 0; i < vertexCount; i++) {
+					Vector3 decoded;
+					if (format == VertexPositionFormat::kFloat3) {
+						std::memcpy(&decoded, &encoded[i * positionSize], sizeof(decoded));
+					} else {
+						uint16_t quantized[4];
+						std::memcpy(quantized, &encoded[i * positionSize], sizeof(quantized));
+						decoded = MatrixTransform(Vector3{ quantized[0] / 65535.0f, quantized[1] / 65535.0f, quantized[2] / 65535.0f }, dequantize);
+					}
+					const Vector4& position = (*vertices)[i].position;
+					maxError = std::max(maxError, static_cast<double>(Length(decoded - Vector3{ position.x, position.y, position.z })));
+				}
+				return maxError;
+			});
+	}
+
+	// 誤差は戻した法線の最大の角度(度)
+	benchmark.Add("Octahedral normals " + name + " (12 -> 4 bytes)", vertexCount,
+		[vertices]() {
+			int16_t encoded[2] = {};
+			int32_t sum = 0;
+			for (const VertexData& vertex : *vertices) {
+				EncodeOctahedral(vertex.normal, encoded);
+				sum += encoded[0] + encoded[1];
+			}
+			DoNotOptimize(sum);
+		},
+		[vertices]() {
+			double maxAngle = 0.0;
+			for (const VertexData& vertex : *vertices) {
+				int16_t encoded[2];
+				EncodeOctahedral(vertex.normal, encoded);
+				const float cosine = std::clamp(Dot(Normalize(vertex.normal), DecodeOctahedral(encoded)), -1.0f, 1.0f);
+				maxAngle = std::max(maxAngle, std::acos(static_cast<double>(cosine)) * 180.0 / 3.14159265358979);
+			}
+			return maxAngle;
+		});
+}
+
+void AddMeshLoad(Benchmark& benchmark, const std::string& name, const std::filesystem::path& directory) {
+	// 元のファイルを一時ディレクトリにコピーして、キャッシュはそこに作る(Resourcesを汚さない)
+	const std::string resourcePath = std::string("Resources/Model/obj/") + name + ".obj";
+	auto data = std::make_shared<MeshLoadData>();
+	data->sourcePath = (directory / (name + ".obj")).string();
+	std::error_code error;
+	std::filesystem::copy_file(resourcePath, data->sourcePath, std::filesystem::copy_options::overwrite_existing, error);
+	if (error) {
+		return;
+	}
+
+	std::vector<VertexData> triangleVertices = LoadObjVertices(data->sourcePath);
+	if (triangleVertices.empty()) {
+		return;
+	}
+	std::vector<VertexData> vertices;
+	std::vector<uint32_t> indices;
+	WeldVertices(triangleVertices, vertices, indices);
+	OptimizeMesh(vertices, indices);
+	const uint32_t indexSize = GetIndexSize(vertices.size());
+	data->uploadIndexBuffer.resize(static_cast<size_t>(indexSize) * indices.size());
+	WriteIndexBuffer(data->uploadIndexBuffer.data(), indices.data(), indices.size(), indexSize);
+
+	MeshCacheSource source;
+	source.vertices = vertices.data();
+	source.vertexStride = sizeof(VertexData);
+	source.vertexCount = static_cast<uint32_t>(vertices.size());
+	source.indices = data->uploadIndexBuffer.data();
+	source.indexSize = indexSize;
+	source.indexCount = static_cast<uint32_t>(indices.size());
+	source.bounds = ComputeBounds(vertices);
+	source.textureFilePaths.push_back("Resources/Debug/white1x1.png");
+	if (!MeshCache::Write(data->sourcePath, source)) {
+		return;
+	}
+	data->uploadBuffer.resize(vertices.size());
+
+	const std::string suffix = " (" + name + ", " + std::to_string(vertices.size()) + " vertices)";
+
+	// 読み込みから溶接・最適化して境界ボリュームを求め、アップロード用のバッファにコピーするまで(1回の読み込みを1件とする)
+	benchmark.Add("Load OBJ text" + suffix, 1,
+		[data]() {
+			std::vector<VertexData> vertices;
+			std::vector<uint32_t> indices;
+			WeldVertices(LoadObjVertices(data->sourcePath), vertices, indices);
+			OptimizeMesh(vertices, indices);
+			BoundingVolume bounds = ComputeBounds(vertices);
+			std::memcpy(data->uploadBuffer.data(), vertices.data(), sizeof(VertexData) * vertices.size());
+			WriteIndexBuffer(data->uploadIndexBuffer.data(), indices.data(), indices.size(), GetIndexSize(vertices.size()));
+			DoNotOptimize(bounds);
+			DoNotOptimize(data->uploadBuffer[0]);
+			DoNotOptimize(data->uploadIndexBuffer[0]);
+		});
+
+	// 誤差はテキストから読んだ頂点・インデックスと違うバイト数
+	benchmark.Add("Load MeshCache" + suffix, 1,
+		[data]() {
+			MeshCache meshCache;
+			if (!meshCache.Open(data->sourcePath, sizeof(VertexData))) {
+				return;
+			}
+			// Model::Initializeと同じく、CPU側の頂点とアップロード用のバッファの両方にコピーする
+			const VertexData* vertices = static_cast<const VertexData*>(meshCache.GetVertices());
+			std::vector<VertexData> modelVertices(vertices, vertices + meshCache.GetVertexCount());
+			std::vector<uint32_t> modelIndices(meshCache.GetIndexCount());
+			ReadIndexBuffer(modelIndices.data(), meshCache.GetIndices(), modelIndices.size(), meshCache.GetIndexSize());
+			std::memcpy(data->uploadBuffer.data(), vertices, sizeof(VertexData) * meshCache.GetVertexCount());
+			std::memcpy(data->uploadIndexBuffer.data(), meshCache.GetIndices(), static_cast<size_t>(meshCache.GetIndexSize()) * meshCache.GetIndexCount());
+			BoundingVolume bounds = meshCache.GetBounds();
+			DoNotOptimize(bounds);
+			DoNotOptimize(modelVertices[0]);
+			DoNotOptimize(modelIndices[0]);
+			DoNotOptimize(data->uploadBuffer[0]);
+			DoNotOptimize(data->uploadIndexBuffer[0]);
+		},
+		[data, vertices]() {
+			MeshCache meshCache;
+			if (!meshCache.Open(data->sourcePath, sizeof(VertexData)) || meshCache.GetVertexCount() != vertices.size() ||
+				meshCache.GetIndexSize() * meshCache.GetIndexCount() != data->uploadIndexBuffer.size()) {
+				return static_cast<double>(sizeof(VertexData) * vertices.size() + data->uploadIndexBuffer.size());
+			}
+			const uint8_t* expected = reinterpret_cast<const uint8_t*>(vertices.data());
+			const uint8_t* actual = static_cast<const uint8_t*>(meshCache.GetVertices());
+			double mismatch = 0.0;
+			for (size_t i = 0; i < sizeof(VertexData) * vertices.size(); i++) {
+				mismatch += expected[i] != actual[i] ? 1.0 : 0.0;
+			}
+			const uint8_t* actualIndices = static_cast<const uint8_t*>(meshCache.GetIndices());
+			for (size_t i = 0; i < data->uploadIndexBuffer.size(); i++) {
+				mismatch += data->uploadIndexBuffer[i] != actualIndices[i] ? 1.0 : 0.0;
+			}
+			return mismatch;
+		});
+}
+
+// Model::Loadと同じく、読み込みからGPUに送る形に詰めるところまで行う(ワーカースレッドで行う部分)
+std::vector<uint8_t> LoadUploadData(const std::string& filePath) {
+	std::vector<VertexData> vertices;
+	std::vector<uint32_t> indices;
+	WeldVertices(LoadObjVertices(filePath), vertices, indices);
+	OptimizeMesh(vertices, indices);
+	const BoundingVolume bounds = ComputeBounds(vertices);
+	const VertexFormat format;
+	const size_t positionSize = GetPositionSize(format.position);
+	const size_t attributeOffset = (positionSize * vertices.size() + 15) & ~size_t(15);
+	const uint32_t indexSize = GetIndexSize(vertices.size());
+	std::vector<uint8_t> uploadData(attributeOffset + GetAttributeSize() * vertices.size() + indexSize * indices.size());
+	EncodePositions(uploadData.data(), positionSize, &vertices[0].position, sizeof(VertexData), vertices.size(), format.position, bounds.aabb);
+	EncodeAttributes(uploadData.data() + attributeOffset, GetAttributeSize(), &vertices[0].texcoord, &vertices[0].normal, sizeof(VertexData), vertices.size());
+	WriteIndexBuffer(uploadData.data() + attributeOffset + GetAttributeSize() * vertices.size(), indices.data(), indices.size(), indexSize);
+	return uploadData;
+}
+
+void AddAsyncMeshLoad(Benchmark& benchmark, const std::vector<std::string>& names) {
+	auto filePaths = std::make_shared<std::vector<std::string>>();
+	for (const std::string& name : names) {
+		filePaths->push_back(std::string("Resources/Model/obj/") + name + ".obj");
+	}
+	auto expected = std::make_shared<std::vector<std::vector<uint8_t>>>();
+	for (const std::string& filePath : *filePaths) {
+		expected->push_back(LoadUploadData(filePath));
+		if (expected->back().empty()) {
+			return;
+		}
+	}
+
+	// 1件はモデル1個
+	const std::string suffix = " (" + std::to_string(filePaths->size()) + " models)";
+	benchmark.Add("Load models in order" + suffix, filePaths->size(),
+		[filePaths]() {
+			for (const std::string& filePath : *filePaths) {
+				std::vector<uint8_t> uploadData = LoadUploadData(filePath);
+				DoNotOptimize(uploadData[0]);
+			}
+		});
+
+	// ModelManager::LoadModelAsyncと同じく1モデルずつワーカースレッドに積み、呼び出し元は待つだけ
+	// 誤差は順番に読んだ結果と違うバイト数
+	auto loadAsync = [filePaths]() {
+		std::vector<std::future<std::vector<uint8_t>>> futures;
+		for (const std::string& filePath : *filePaths) {
+			futures.push_back(ThreadPool::GetInstance()->Submit([filePath]() { return LoadUploadData(filePath); }));
+		}
+		std::vector<std::vector<uint8_t>> results;
+		for (std::future<std::vector<uint8_t>>& future : futures) {
+			results.push_back(future.get());
+		}
+		return results;
+	};
+	benchmark.Add("Load models on ThreadPool" + suffix, filePaths->size(),
+		[loadAsync]() {
+			std::vector<std::vector<uint8_t>> results = loadAsync();
+			DoNotOptimize(results[0][0]);
+		},
+		[loadAsync, expected]() {
+			const std::vector<std::vector<uint8_t>> results = loadAsync();
+			double mismatch = 0.0;
+			for (size_t i = 0; i < results.size(); i++) {
+				if (results[i].size() != (*expected)[i].size()) {
+					mismatch += static_cast<double>((*expected)[i].size());
+					continue;
+				}
+				for (size_t j = 0; j < results[i].size(); j++) {
+					mismatch += results[i][j] != (*expected)[i][j] ? 1.0 : 0.0;
+				}
+			}
+			return mismatch;
+		});
+}
+
+} // namespace
+
+void AddMeshBenchmarks(Benchmark& benchmark) {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "kMathBenchmarkMeshCache";
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	if (error) {
+		return;
+	}
+
+	// Resourcesの全てのモデル
+	benchmark.AddSection("Vertex welding");
+	for (const char* name : { "teapot", "terrain", "Player", "plane", "starResult", "block", "multiMesh", "axis", "multiMaterial", "box", "stage" }) {
+		AddWeld(benchmark, name);
+	}
+
+	benchmark.AddSection("Vertex cache");
+	for (const char* name : { "teapot", "terrain", "starResult", "box", "stage" }) {
+		AddVertexCache(benchmark, name);
+	}
+
+	benchmark.AddSection("Vertex format");
+	for (const char* name : { "teapot", "terrain", "starResult" }) {
+		AddVertexFormat(benchmark, name);
+	}
+
+	benchmark.AddSection("Mesh load");
+	for (const char* name : { "teapot", "terrain", "starResult" }) {
+		AddMeshLoad(benchmark, name, directory);
+	}
+
+	benchmark.AddSection("Async mesh load");
+	AddAsyncMeshLoad(benchmark, { "teapot", "terrain", "starResult", "box", "stage", "Player", "block" });
+}
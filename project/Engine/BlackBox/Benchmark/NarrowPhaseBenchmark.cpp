@@ -0,0 +1,479 @@
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+#include "CollisionBenchmarkData.h"
+#include "CollisionManager.h"
+#include "BroadPhase.h"
+#include "NarrowPhase.h"
+#include "SceneBVH.h"
+#include "ContinuousCollision.h"
+#include "ConvexHull.h"
+#include "ConvexCollision.h"
+#include "kMath.h"
+#include "AABB.h"
+#include "Vector3.h"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ナローフェーズで使う形状(近くにばらまいて半分くらいが当たるようにする)
+struct ShapeData {
+	std::vector<AABB> aabbs;
+	std::vector<Sphere> spheres;
+	std::vector<OBB> obbs;
+	std::vector<Plane> planes;
+	std::vector<Collider> colliders;
+	std::vector<ProxyPair> pairs;
+};
+
+std::shared_ptr<ShapeData> CreateShapeData(size_t count) {
+	std::mt19937 random(2468);
+	std::uniform_real_distribution<float> position(-1.5f, 1.5f);
+	std::uniform_real_distribution<float> extent(0.25f, 1.0f);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	auto data = std::make_shared<ShapeData>();
+	for (size_t i = 0; i < count; i++) {
+		// 同じ中心と大きさで、形状ごとに当たり方を比べられるようにする
+		const Vector3 center = RandomVector(random, position);
+		const Vector3 half = RandomVector(random, extent);
+		data->aabbs.push_back(AABB{ center - half, center + half });
+		data->spheres.push_back(Sphere{ center, extent(random) });
+		data->obbs.push_back(RandomOBB(random, center, half));
+		data->planes.push_back(Plane{ RandomDirection(random), unit(random) });
+	}
+	for (size_t i = 0; i < count; i++) {
+		switch (i % 4) {
+		case 0: data->colliders.push_back(data->aabbs[i]); break;
+		case 1: data->colliders.push_back(data->spheres[i]); break;
+		case 2: data->colliders.push_back(data->obbs[i]); break;
+		default: data->colliders.push_back(data->planes[i]); break;
+		}
+		data->pairs.push_back(ProxyPair{ static_cast<ProxyHandle>(i), static_cast<ProxyHandle>((i * 7 + 1) % count) });
+	}
+	return data;
+}
+
+// aとbの配列を先頭から順に判定する(衝突情報あり・なしの2つを登録する)
+template<typename A, typename B>
+void AddNarrowPhasePair(Benchmark& benchmark, const std::string& name, const std::shared_ptr<ShapeData>& data, const std::vector<A> ShapeData::* a, const std::vector<B> ShapeData::* b) {
+	const size_t count = (data.get()->*a).size();
+	benchmark.Add(name, count,
+		[data, a, b]() {
+			const std::vector<A>& shapesA = data.get()->*a;
+			const std::vector<B>& shapesB = data.get()->*b;
+			size_t hitCount = 0;
+			for (size_t i = 0; i < shapesA.size(); i++) {
+				hitCount += CheckCollision(shapesA[i], shapesB[shapesA.size() - 1 - i]) ? 1 : 0;
+			}
+			DoNotOptimize(hitCount);
+		});
+	benchmark.Add(name + " contact", count,
+		[data, a, b]() {
+			const std::vector<A>& shapesA = data.get()->*a;
+			const std::vector<B>& shapesB = data.get()->*b;
+			float depth = 0.0f;
+			for (size_t i = 0; i < shapesA.size(); i++) {
+				Contact contact;
+				if (CheckCollision(shapesA[i], shapesB[shapesA.size() - 1 - i], contact)) {
+					depth += contact.depth;
+				}
+			}
+			DoNotOptimize(depth);
+		});
+}
+
+// 形状を平行移動する
+void Translate(AABB& aabb, const Vector3& offset) {
+	aabb.min += offset;
+	aabb.max += offset;
+}
+
+void Translate(Sphere& sphere, const Vector3& offset) {
+	sphere.center += offset;
+}
+
+// 動く形状と止まっている形状の連続的な判定を先頭から順に行う
+template<typename A, typename B>
+void AddSweepPair(Benchmark& benchmark, const std::string& name, const std::shared_ptr<ShapeData>& data, const std::shared_ptr<std::vector<Vector3>>& displacements,
+	const std::vector<A> ShapeData::* a, const std::vector<B> ShapeData::* b, bool (*sweep)(const A&, const Vector3&, const B&, float&, Vector3&), bool (*overlap)(const A&, const B&)) {
+	const size_t count = (data.get()->*a).size();
+	benchmark.Add(name, count,
+		[data, displacements, a, b, sweep]() {
+			const std::vector<A>& shapesA = data.get()->*a;
+			const std::vector<B>& shapesB = data.get()->*b;
+			float sum = 0.0f;
+			for (size_t i = 0; i < shapesA.size(); i++) {
+				float toi;
+				Vector3 normal;
+				if (sweep(shapesA[i], (*displacements)[i], shapesB[shapesA.size() - 1 - i], toi, normal)) {
+					sum += toi;
+				}
+			}
+			DoNotOptimize(sum);
+		},
+		// 誤差の欄は、移動を細かく区切って離散的に判定した場合(参照実装)とのtoiの差の最大値
+		[data, displacements, a, b, sweep, overlap]() {
+			constexpr int kSteps = 1000;
+			const std::vector<A>& shapesA = data.get()->*a;
+			const std::vector<B>& shapesB = data.get()->*b;
+			double maxError = 0.0;
+			for (size_t i = 0; i < shapesA.size(); i += 10) {
+				const B& target = shapesB[shapesA.size() - 1 - i];
+				int step = 0;
+				for (; step <= kSteps; step++) {
+					A moved = shapesA[i];
+					Translate(moved, (*displacements)[i] * (static_cast<float>(step) / kSteps));
+					if (overlap(moved, target)) {
+						break;
+					}
+				}
+				float toi;
+				Vector3 normal;
+				// かすっただけの場合は参照実装の刻みで見逃すので、両方当たったものだけを比べる
+				if (step <= kSteps && sweep(shapesA[i], (*displacements)[i], target, toi, normal)) {
+					maxError = std::max(maxError, std::fabs(static_cast<double>(toi) - static_cast<double>(step) / kSteps));
+				}
+			}
+			return maxError;
+		});
+}
+
+// 部屋(stage.obj)の中を飛ぶ弾
+struct ProjectileData {
+	std::shared_ptr<MeshData> stage;
+	SceneBVH scene;
+	// 前のフレームの位置から今の位置への移動(maxDistanceが1フレームの移動量)
+	std::vector<Ray> moves;
+	std::vector<SceneHit> hits;
+	float radius;
+};
+
+std::shared_ptr<ProjectileData> CreateProjectileData(const std::shared_ptr<MeshData>& stage, size_t count) {
+	auto data = std::make_shared<ProjectileData>();
+	data->stage = stage;
+	data->scene.AddInstance(&stage->bvh, MakeMatrix3x4(MakeIdentity4x4()));
+	data->scene.Build();
+
+	// 60fpsで秒速120～480(1フレームで壁の厚さ1より大きく動く)
+	std::mt19937 random(4321);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> speed(2.0f, 8.0f);
+	const AABB& bounds = stage->bvh.GetBounds();
+	const Vector3 center = (bounds.min + bounds.max) * 0.5f;
+	const Vector3 half = (bounds.max - bounds.min) * 0.45f;
+	for (size_t i = 0; i < count; i++) {
+		const Vector3 origin = center + Vector3{ half.x * unit(random), half.y * unit(random), half.z * unit(random) };
+		const Vector3 direction = Normalize(Vector3{ unit(random), unit(random) * 0.2f, unit(random) });
+		data->moves.push_back(Ray{ origin, direction, speed(random) });
+	}
+	data->hits.resize(count);
+	data->radius = 0.25f;
+	return data;
+}
+
+// 移動後の位置だけで判定した場合にすり抜けた弾の数
+double CountTunneledProjectiles(const ProjectileData& data) {
+	size_t tunneled = 0;
+	std::vector<SceneOverlap> overlaps;
+	for (const Ray& move : data.moves) {
+		SceneHit hit;
+		data.scene.Overlap(Sphere{ move.origin + move.direction * move.maxDistance, data.radius }, overlaps);
+		if (overlaps.empty() && data.scene.SphereCast(move, data.radius, hit)) {
+			tunneled++;
+		}
+	}
+	return static_cast<double>(tunneled);
+}
+
+// 弾ごとの連続的な判定を総当たりと比べて、結果が違った弾の数を返す
+double CountProjectileMismatches(const ProjectileData& data, const std::vector<SceneHit>& hits) {
+	size_t mismatches = 0;
+	for (size_t i = 0; i < data.moves.size(); i++) {
+		float expected;
+		const bool isExpected = RaycastBruteForce(data.stage->positions, nullptr, data.moves[i], data.radius, expected);
+		const bool isHit = hits[i].instance != SceneBVH::kNoInstance;
+		if (isHit != isExpected || (isHit && std::fabs(hits[i].hit.distance - expected) > 1.0e-3f)) {
+			mismatches++;
+		}
+	}
+	return static_cast<double>(mismatches);
+}
+
+// 弾の数ごとに、移動後の位置だけで判定する場合と連続的な判定を比べる
+void AddProjectiles(Benchmark& benchmark, const std::shared_ptr<MeshData>& stage, size_t count) {
+	std::shared_ptr<ProjectileData> data = CreateProjectileData(stage, count);
+	const std::string suffix = " (" + std::to_string(count) + " projectiles)";
+
+	// 誤差の欄はすり抜けた弾の数
+	auto overlaps = std::make_shared<std::vector<SceneOverlap>>();
+	benchmark.Add("Projectiles discrete" + suffix, count,
+		[data, overlaps]() {
+			size_t hitCount = 0;
+			for (const Ray& move : data->moves) {
+				data->scene.Overlap(Sphere{ move.origin + move.direction * move.maxDistance, data->radius }, *overlaps);
+				hitCount += overlaps->empty() ? 0 : 1;
+			}
+			DoNotOptimize(hitCount);
+		},
+		[data]() { return CountTunneledProjectiles(*data); });
+
+	// 誤差の欄は総当たりと結果が違った弾の数
+	benchmark.Add("Projectiles CCD" + suffix, count,
+		[data]() {
+			for (size_t i = 0; i < data->moves.size(); i++) {
+				data->scene.SphereCast(data->moves[i], data->radius, data->hits[i]);
+			}
+			DoNotOptimize(data->hits.data());
+		},
+		[data]() {
+			for (size_t i = 0; i < data->moves.size(); i++) {
+				data->scene.SphereCast(data->moves[i], data->radius, data->hits[i]);
+			}
+			return CountProjectileMismatches(*data, data->hits);
+		});
+	benchmark.Add("Projectiles CCD batch" + suffix, count,
+		[data]() {
+			DoNotOptimize(data->scene.SphereCast(data->moves.data(), data->moves.size(), data->radius, data->hits.data()));
+		});
+}
+
+// モデルの凸包と、その周りに置いた形状
+struct ConvexData {
+	std::shared_ptr<MeshData> mesh;
+	ConvexHull hull;
+	// 凸包のワールド行列(原点に置く)
+	Matrix3x4 world;
+	std::vector<Sphere> spheres;
+	std::vector<AABB> boxes;
+	std::vector<OBB> obbs;
+	// 凸包同士の判定で使う、もう1つの凸包のワールド行列
+	std::vector<Matrix3x4> worlds;
+};
+
+std::shared_ptr<ConvexData> CreateConvexData(const std::shared_ptr<MeshData>& mesh, size_t count) {
+	auto data = std::make_shared<ConvexData>();
+	data->mesh = mesh;
+	if (!data->hull.Build(mesh->positions.data(), mesh->positions.size())) {
+		return nullptr;
+	}
+	data->world = MakeMatrix3x4(MakeIdentity4x4());
+	std::mt19937 random(2468);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> size(0.05f, 0.3f);
+	std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+	const AABB& bounds = data->hull.GetBounds();
+	const Vector3 center = (bounds.min + bounds.max) * 0.5f;
+	const Vector3 half = (bounds.max - bounds.min) * 0.5f;
+	const float extent = Length(half);
+	auto randomPoint = [&]() {
+		return center + Vector3{ half.x * unit(random), half.y * unit(random), half.z * unit(random) } * 1.3f;
+	};
+	for (size_t i = 0; i < count; i++) {
+		data->spheres.push_back(Sphere{ randomPoint(), extent * size(random) });
+		const Vector3 boxHalf = Vector3{ size(random), size(random), size(random) } * extent;
+		const Vector3 boxCenter = randomPoint();
+		data->boxes.push_back(AABB{ boxCenter - boxHalf, boxCenter + boxHalf });
+		const Vector3 obbCenter = randomPoint();
+		data->obbs.push_back(RandomOBB(random, obbCenter, boxHalf));
+		const float scale = 0.3f + size(random);
+		const Quaternion rotate = MakeRotateQuaternion(RandomVector(random, angle));
+		const Vector3 translate = randomPoint();
+		data->worlds.push_back(MakeAffineMatrix3x4({ scale, scale, scale }, rotate, translate));
+	}
+	return data;
+}
+
+// 凸包の面から求めた球のめり込み量(GJK/EPAの結果を確かめる参照実装)
+bool CollideSphereHullBruteForce(const ConvexHull& hull, const Sphere& sphere, float& depth) {
+	if (hull.Contains(sphere.center)) {
+		float inside = std::numeric_limits<float>::max();
+		for (const Plane& plane : hull.GetPlanes()) {
+			inside = std::min(inside, plane.distance - Dot(plane.normal, sphere.center));
+		}
+		depth = sphere.radius + inside;
+		return true;
+	}
+	const std::vector<Vector3>& vertices = hull.GetVertices();
+	const std::vector<uint32_t>& indices = hull.GetIndices();
+	float closest = std::numeric_limits<float>::max();
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const Triangle triangle = { { vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]] } };
+		closest = std::min(closest, Length(sphere.center - ClosestPointOnTriangle(sphere.center, triangle)));
+	}
+	depth = sphere.radius - closest;
+	return closest < sphere.radius;
+}
+
+// 凸包の作成と、GJK/EPAでの当たり判定を三角形のBVHと比べる
+void AddConvexHull(Benchmark& benchmark, const std::string& label, const std::shared_ptr<MeshData>& mesh) {
+	constexpr size_t kContactCount = 10000;
+	std::shared_ptr<ConvexData> data = CreateConvexData(mesh, kContactCount);
+	if (!data) {
+		return;
+	}
+	const std::string vertexCount = std::to_string(data->hull.GetVertices().size());
+
+	benchmark.Add("ConvexHull build (" + label + ", " + vertexCount + " verts)", mesh->positions.size(),
+		[mesh]() {
+			ConvexHull hull;
+			DoNotOptimize(hull.Build(mesh->positions.data(), mesh->positions.size()));
+		});
+
+	// 誤差の欄は凸包の面から求めためり込み量との差の最大値(当たったかが違えばkContactCount)
+	benchmark.Add("Sphere contact BVH (10k, " + label + ")", kContactCount,
+		[data]() {
+			std::vector<uint32_t> triangles;
+			float sum = 0.0f;
+			for (const Sphere& sphere : data->spheres) {
+				float depth;
+				if (CollideSphereBVH(*data->mesh, sphere, triangles, depth)) {
+					sum += depth;
+				}
+			}
+			DoNotOptimize(sum);
+		});
+	benchmark.Add("Sphere contact GJK/EPA (10k, " + label + ")", kContactCount,
+		[data]() {
+			const ConvexHullCollider collider{ &data->hull, data->world };
+			float sum = 0.0f;
+			for (const Sphere& sphere : data->spheres) {
+				Contact contact;
+				if (CheckCollision(collider, sphere, contact)) {
+					sum += contact.depth;
+				}
+			}
+			DoNotOptimize(sum);
+		},
+		[data]() {
+			const ConvexHullCollider collider{ &data->hull, data->world };
+			const float tolerance = Length(data->hull.GetBounds().max - data->hull.GetBounds().min) * 1.0e-3f;
+			double maxError = 0.0;
+			for (const Sphere& sphere : data->spheres) {
+				float expected;
+				const bool isExpected = CollideSphereHullBruteForce(data->hull, sphere, expected);
+				Contact contact;
+				const bool isHit = CheckCollision(collider, sphere, contact);
+				if (isHit != isExpected) {
+					// 接しているだけのものは数えない
+					if (std::fabs(expected) > tolerance) {
+						return static_cast<double>(kContactCount);
+					}
+					continue;
+				}
+				if (isHit) {
+					maxError = std::max(maxError, static_cast<double>(std::fabs(contact.depth - expected)));
+				}
+			}
+			return maxError;
+		});
+
+	benchmark.Add("AABB overlap BVH (10k, " + label + ")", kContactCount,
+		[data]() {
+			std::vector<uint32_t> triangles;
+			size_t hits = 0;
+			for (const AABB& box : data->boxes) {
+				data->mesh->bvh.Overlap(box, triangles);
+				hits += triangles.empty() ? 0 : 1;
+			}
+			DoNotOptimize(hits);
+		});
+	benchmark.Add("AABB overlap GJK (10k, " + label + ")", kContactCount,
+		[data]() {
+			const ConvexHullCollider collider{ &data->hull, data->world };
+			size_t hits = 0;
+			for (const AABB& box : data->boxes) {
+				hits += CheckCollision(collider, box) ? 1 : 0;
+			}
+			DoNotOptimize(hits);
+		});
+	benchmark.Add("OBB contact GJK/EPA (10k, " + label + ")", kContactCount,
+		[data]() {
+			const ConvexHullCollider collider{ &data->hull, data->world };
+			float sum = 0.0f;
+			for (const OBB& obb : data->obbs) {
+				Contact contact;
+				if (CheckCollision(collider, obb, contact)) {
+					sum += contact.depth;
+				}
+			}
+			DoNotOptimize(sum);
+		});
+	benchmark.Add("Hull-hull contact GJK/EPA (10k, " + label + ")", kContactCount,
+		[data]() {
+			const ConvexHullCollider collider{ &data->hull, data->world };
+			float sum = 0.0f;
+			for (const Matrix3x4& world : data->worlds) {
+				Contact contact;
+				if (CheckCollision(collider, ConvexHullCollider{ &data->hull, world }, contact)) {
+					sum += contact.depth;
+				}
+			}
+			DoNotOptimize(sum);
+		});
+}
+
+} // namespace
+
+void AddNarrowPhaseBenchmarks(Benchmark& benchmark) {
+	benchmark.AddSection("NarrowPhase");
+
+	// 形状の組み合わせごとに1万回ずつ判定する
+	constexpr size_t kShapeCount = 10000;
+	std::shared_ptr<ShapeData> shapes = CreateShapeData(kShapeCount);
+	AddNarrowPhasePair(benchmark, "AABB-Sphere (10k)", shapes, &ShapeData::aabbs, &ShapeData::spheres);
+	AddNarrowPhasePair(benchmark, "AABB-OBB (10k)", shapes, &ShapeData::aabbs, &ShapeData::obbs);
+	AddNarrowPhasePair(benchmark, "AABB-Plane (10k)", shapes, &ShapeData::aabbs, &ShapeData::planes);
+	AddNarrowPhasePair(benchmark, "Sphere-Sphere (10k)", shapes, &ShapeData::spheres, &ShapeData::spheres);
+	AddNarrowPhasePair(benchmark, "Sphere-OBB (10k)", shapes, &ShapeData::spheres, &ShapeData::obbs);
+	AddNarrowPhasePair(benchmark, "Sphere-Plane (10k)", shapes, &ShapeData::spheres, &ShapeData::planes);
+	AddNarrowPhasePair(benchmark, "OBB-OBB (10k)", shapes, &ShapeData::obbs, &ShapeData::obbs);
+	AddNarrowPhasePair(benchmark, "OBB-Plane (10k)", shapes, &ShapeData::obbs, &ShapeData::planes);
+
+	// 種類の混ざったコライダーのペアをまとめて判定する(ブロードフェーズの後に呼ぶ処理)
+	auto contacts = std::make_shared<std::vector<ContactPair>>();
+	benchmark.Add("CheckCollisions (Collider pairs, 10k)", kShapeCount,
+		[shapes, contacts]() {
+			DoNotOptimize(CheckCollisions(shapes->colliders.data(), shapes->pairs.data(), shapes->pairs.size(), *contacts));
+		});
+
+	benchmark.AddSection("Continuous");
+
+	// 形状の組み合わせごとに1万回ずつ、1フレームの移動の間に最初に当たる時刻を求める
+	auto displacements = std::make_shared<std::vector<Vector3>>();
+	{
+		std::mt19937 random(1122);
+		std::uniform_real_distribution<float> unit(-3.0f, 3.0f);
+		for (size_t i = 0; i < kShapeCount; i++) {
+			displacements->push_back(RandomVector(random, unit));
+		}
+	}
+	AddSweepPair<AABB, AABB>(benchmark, "SweepAABB (10k)", shapes, displacements, &ShapeData::aabbs, &ShapeData::aabbs, SweepAABB, CollisionAABB);
+	AddSweepPair<Sphere, Sphere>(benchmark, "SweepSphere-Sphere (10k)", shapes, displacements, &ShapeData::spheres, &ShapeData::spheres, SweepSphere, CheckCollision);
+	AddSweepPair<Sphere, AABB>(benchmark, "SweepSphere-AABB (10k)", shapes, displacements, &ShapeData::spheres, &ShapeData::aabbs, SweepSphere, CheckCollision);
+	AddSweepPair<Sphere, OBB>(benchmark, "SweepSphere-OBB (10k)", shapes, displacements, &ShapeData::spheres, &ShapeData::obbs, SweepSphere, CheckCollision);
+
+	// 部屋の中を飛ぶ弾(CollisionManagerで速いオブジェクトとして登録した場合の処理)
+	// projectディレクトリで実行したときにモデルを読み込む(無ければ飛ばす)
+	std::shared_ptr<MeshData> stage = CreateMeshData("Resources/Model/obj/stage.obj", 0);
+	if (stage) {
+		for (size_t count : { 100, 500, 2000 }) {
+			AddProjectiles(benchmark, stage, count);
+		}
+	}
+
+	benchmark.AddSection("ConvexHull");
+
+	// 凸包で当たり判定をするモデル(goal.objのように読み込めないものは飛ばす)。三角形のBVHと比べる
+	for (const char* name : { "Player", "goal", "block", "teapot" }) {
+		std::shared_ptr<MeshData> mesh = CreateMeshData(std::string("Resources/Model/obj/") + name + ".obj", 0);
+		if (mesh) {
+			AddConvexHull(benchmark, name, mesh);
+		}
+	}
+}
@@ -0,0 +1,399 @@
+#include "BenchmarkSuite.h"
+#include "Benchmark.h"
+#include "CollisionBenchmarkData.h"
+#include "NarrowPhase.h"
+#include "TriangleBVH.h"
+#include "SceneBVH.h"
+#include "HeightField.h"
+#include "kMath.h"
+#include "AABB.h"
+#include "Vector3.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// BVHと総当たりで結果が違ったレイの数
+double CountRaycastMismatches(const MeshData& data, float radius) {
+	size_t mismatches = 0;
+	const float tolerance = data.bvh.GetBounds().max.x - data.bvh.GetBounds().min.x;
+	for (const Ray& ray : data.rays) {
+		float expected;
+		const bool isExpected = RaycastBruteForce(data.positions, nullptr, ray, radius, expected);
+		RaycastHit hit;
+		const bool isHit = radius > 0.0f ? data.bvh.SphereCast(ray, radius, hit) : data.bvh.Raycast(ray, hit);
+		if (isHit != isExpected || (isHit && std::fabs(hit.distance - expected) > tolerance * 1.0e-4f)) {
+			mismatches++;
+		}
+	}
+	return static_cast<double>(mismatches);
+}
+
+// モデルごとにBVHの構築・レイキャスト・スフィアキャスト・重なりを計測する
+void AddMeshRaycast(Benchmark& benchmark, const std::string& label, const std::shared_ptr<MeshData>& data) {
+	const size_t triangleCount = data->bvh.GetTriangleCount();
+	const std::string suffix = " (" + label + ", " + std::to_string(triangleCount) + " tris)";
+
+	benchmark.Add("TriangleBVH build" + suffix, triangleCount,
+		[data]() {
+			TriangleBVH bvh;
+			bvh.Build(data->positions.data(), data->positions.size());
+			DoNotOptimize(bvh.GetNodeCount());
+		});
+
+	benchmark.Add("Raycast brute force" + suffix, data->rays.size(),
+		[data]() {
+			float sum = 0.0f;
+			for (const Ray& ray : data->rays) {
+				float distance;
+				if (RaycastBruteForce(data->positions, nullptr, ray, 0.0f, distance)) {
+					sum += distance;
+				}
+			}
+			DoNotOptimize(sum);
+		});
+	// 誤差の欄は総当たりと結果が違ったレイの数
+	benchmark.Add("Raycast BVH" + suffix, data->rays.size(),
+		[data]() {
+			float sum = 0.0f;
+			for (const Ray& ray : data->rays) {
+				RaycastHit hit;
+				if (data->bvh.Raycast(ray, hit)) {
+					sum += hit.distance;
+				}
+			}
+			DoNotOptimize(sum);
+		},
+		[data]() { return CountRaycastMismatches(*data, 0.0f); });
+
+	benchmark.Add("SphereCast brute force" + suffix, data->rays.size(),
+		[data]() {
+			float sum = 0.0f;
+			for (const Ray& ray : data->rays) {
+				float distance;
+				if (RaycastBruteForce(data->positions, nullptr, ray, data->castRadius, distance)) {
+					sum += distance;
+				}
+			}
+			DoNotOptimize(sum);
+		});
+	benchmark.Add("SphereCast BVH" + suffix, data->rays.size(),
+		[data]() {
+			float sum = 0.0f;
+			for (const Ray& ray : data->rays) {
+				RaycastHit hit;
+				if (data->bvh.SphereCast(ray, data->castRadius, hit)) {
+					sum += hit.distance;
+				}
+			}
+			DoNotOptimize(sum);
+		},
+		[data]() { return CountRaycastMismatches(*data, data->castRadius); });
+
+	// レイの終点に置いた球と重なる三角形を求める
+	auto overlaps = std::make_shared<std::vector<uint32_t>>();
+	benchmark.Add("Overlap sphere BVH" + suffix, data->rays.size(),
+		[data, overlaps]() {
+			size_t total = 0;
+			for (const Ray& ray : data->rays) {
+				data->bvh.Overlap(Sphere{ ray.origin + ray.direction * (ray.maxDistance * 0.25f), data->castRadius * 2.0f }, *overlaps);
+				total += overlaps->size();
+			}
+			DoNotOptimize(total);
+		});
+}
+
+// 複数のモデルを配置したシーンにまとめてレイを飛ばす
+struct SceneData {
+	std::vector<std::shared_ptr<MeshData>> meshes;
+	std::vector<size_t> meshIndices;
+	std::vector<Matrix3x4> worlds;
+	SceneBVH scene;
+	std::vector<Ray> rays;
+	std::vector<SceneHit> hits;
+};
+
+std::shared_ptr<SceneData> CreateSceneData(const std::vector<std::shared_ptr<MeshData>>& meshes, size_t instanceCount, size_t rayCount) {
+	auto data = std::make_shared<SceneData>();
+	data->meshes = meshes;
+	std::mt19937 random(8642);
+	std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+	std::uniform_real_distribution<float> scale(0.3f, 2.0f);
+	std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> height(-50.0f, 50.0f);
+	for (size_t i = 0; i < instanceCount; i++) {
+		const size_t meshIndex = i % meshes.size();
+		const Matrix3x4 world = MakeAffineMatrix3x4({ scale(random), scale(random), scale(random) },
+			MakeRotateQuaternion({ angle(random), angle(random), angle(random) }), { position(random), height(random), position(random) });
+		data->meshIndices.push_back(meshIndex);
+		data->worlds.push_back(world);
+		data->scene.AddInstance(&meshes[meshIndex]->bvh, world);
+	}
+	data->scene.Build();
+
+	// インスタンスの近くを狙う
+	std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+	for (size_t i = 0; i < rayCount; i++) {
+		const Vector3 origin = { position(random) * 1.25f, height(random) * 1.25f, position(random) * 1.25f };
+		const Vector3 target = MatrixTransform(Vector3{ offset(random), offset(random), offset(random) }, data->worlds[i % instanceCount]);
+		data->rays.push_back(Ray{ origin, Normalize(target - origin), 1000.0f });
+	}
+	data->hits.resize(rayCount);
+	return data;
+}
+
+// シーンの結果を全インスタンスの総当たりと比べて、違ったレイの数を返す(時間がかかるので先頭の一部だけ調べる)
+double CountSceneMismatches(SceneData& data, float radius, size_t checkCount) {
+	size_t mismatches = 0;
+	for (size_t i = 0; i < std::min(checkCount, data.rays.size()); i++) {
+		float expected = data.rays[i].maxDistance;
+		bool isExpected = false;
+		for (size_t k = 0; k < data.worlds.size(); k++) {
+			Ray limited = data.rays[i];
+			limited.maxDistance = expected;
+			float distance;
+			if (RaycastBruteForce(data.meshes[data.meshIndices[k]]->positions, &data.worlds[k], limited, radius, distance)) {
+				expected = distance;
+				isExpected = true;
+			}
+		}
+		SceneHit hit;
+		const bool isHit = radius > 0.0f ? data.scene.SphereCast(data.rays[i], radius, hit) : data.scene.Raycast(data.rays[i], hit);
+		if (isHit != isExpected || (isHit && std::fabs(hit.hit.distance - expected) > 1.0e-2f)) {
+			mismatches++;
+		}
+	}
+	return static_cast<double>(mismatches);
+}
+
+// 地形の上を動き回るキャラクターやパーティクルの位置
+struct GroundData {
+	std::shared_ptr<MeshData> mesh;
+	HeightField heightField;
+	std::vector<Vector3> points;
+	std::vector<Sphere> spheres;
+	std::vector<AABB> boxes;
+	std::vector<float> heights;
+};
+
+std::shared_ptr<GroundData> CreateGroundData(const std::shared_ptr<MeshData>& mesh, size_t count) {
+	auto data = std::make_shared<GroundData>();
+	data->mesh = mesh;
+	if (!data->heightField.BuildFromMesh(mesh->positions.data(), mesh->positions.size())) {
+		return nullptr;
+	}
+	std::mt19937 random(8642);
+	const AABB& bounds = data->heightField.GetBounds();
+	std::uniform_real_distribution<float> x(bounds.min.x, bounds.max.x);
+	std::uniform_real_distribution<float> z(bounds.min.z, bounds.max.z);
+	std::uniform_real_distribution<float> offset(-0.2f, 0.5f);
+	std::uniform_real_distribution<float> size(0.1f, 0.5f);
+	for (size_t i = 0; i < count; i++) {
+		const Vector3 point{ x(random), 0.0f, z(random) };
+		float height;
+		data->heightField.GetHeight(point.x, point.z, height);
+		data->points.push_back(point);
+		data->spheres.push_back(Sphere{ { point.x, height + offset(random), point.z }, size(random) });
+		const Vector3 half{ size(random), size(random), size(random) };
+		const Vector3 center{ point.x, height + half.y + offset(random), point.z };
+		data->boxes.push_back(AABB{ center - half, center + half });
+	}
+	data->heights.resize(count);
+	return data;
+}
+
+// 真下に飛ばしたレイで求めた高さとの差の最大値
+double MeasureGroundHeightError(const GroundData& data) {
+	const float top = data.heightField.GetBounds().max.y + 1.0f;
+	double maxError = 0.0;
+	for (size_t i = 0; i < data.points.size(); i++) {
+		RaycastHit hit;
+		if (!data.mesh->bvh.Raycast(Ray{ { data.points[i].x, top, data.points[i].z }, { 0.0f, -1.0f, 0.0f }, top - data.heightField.GetBounds().min.y + 1.0f }, hit)) {
+			return static_cast<double>(data.points.size());
+		}
+		maxError = std::max(maxError, static_cast<double>(std::fabs(top - hit.distance - data.heights[i])));
+	}
+	return maxError;
+}
+
+// 地形の高さの取得、レイキャスト、球・AABBとの判定を三角形のBVHと比べる
+void AddHeightField(Benchmark& benchmark, const std::shared_ptr<MeshData>& mesh) {
+	std::shared_ptr<GroundData> data = CreateGroundData(mesh, 100000);
+	if (!data) {
+		return;
+	}
+	const std::string size = std::to_string(data->heightField.GetCountX()) + "x" + std::to_string(data->heightField.GetCountZ());
+
+	benchmark.Add("HeightField build from mesh (terrain " + size + ")", mesh->positions.size() / 3,
+		[mesh]() {
+			HeightField heightField;
+			DoNotOptimize(heightField.BuildFromMesh(mesh->positions.data(), mesh->positions.size()));
+		});
+
+	// 10万点の地面の高さ(キャラクターやパーティクルを地面に沿わせる)。誤差の欄は真下へのレイキャストとの差
+	benchmark.Add("Ground height BVH raycast (100k, terrain)", data->points.size(),
+		[data]() {
+			const float top = data->heightField.GetBounds().max.y + 1.0f;
+			for (size_t i = 0; i < data->points.size(); i++) {
+				RaycastHit hit;
+				data->mesh->bvh.Raycast(Ray{ { data->points[i].x, top, data->points[i].z }, { 0.0f, -1.0f, 0.0f }, 1000.0f }, hit);
+				data->heights[i] = top - hit.distance;
+			}
+			DoNotOptimize(data->heights.data());
+		});
+	benchmark.Add("Ground height HeightField (100k, terrain)", data->points.size(),
+		[data]() {
+			for (size_t i = 0; i < data->points.size(); i++) {
+				data->heightField.GetHeight(data->points[i].x, data->points[i].z, data->heights[i]);
+			}
+			DoNotOptimize(data->heights.data());
+		},
+		[data]() {
+			for (size_t i = 0; i < data->points.size(); i++) {
+				data->heightField.GetHeight(data->points[i].x, data->points[i].z, data->heights[i]);
+			}
+			return MeasureGroundHeightError(*data);
+		});
+
+	// 誤差の欄は総当たりと結果が違ったレイの数
+	benchmark.Add("Raycast HeightField (terrain)", mesh->rays.size(),
+		[data]() {
+			float sum = 0.0f;
+			for (const Ray& ray : data->mesh->rays) {
+				RaycastHit hit;
+				if (data->heightField.Raycast(ray, hit)) {
+					sum += hit.distance;
+				}
+			}
+			DoNotOptimize(sum);
+		},
+		[data]() {
+			const MeshData& mesh = *data->mesh;
+			const float tolerance = (mesh.bvh.GetBounds().max.x - mesh.bvh.GetBounds().min.x) * 1.0e-4f;
+			size_t mismatches = 0;
+			for (const Ray& ray : mesh.rays) {
+				float expected;
+				const bool isExpected = RaycastBruteForce(mesh.positions, nullptr, ray, 0.0f, expected);
+				RaycastHit hit;
+				const bool isHit = data->heightField.Raycast(ray, hit);
+				if (isHit != isExpected || (isHit && std::fabs(hit.distance - expected) > tolerance)) {
+					mismatches++;
+				}
+			}
+			return static_cast<double>(mismatches);
+		});
+
+	// 地面付近の1万個の球。誤差の欄は三角形のBVHで求めためり込み量との差の最大値(中心が面より上の球)
+	constexpr size_t kContactCount = 10000;
+	benchmark.Add("Sphere contact BVH (10k, terrain)", kContactCount,
+		[data]() {
+			std::vector<uint32_t> triangles;
+			float sum = 0.0f;
+			for (size_t i = 0; i < kContactCount; i++) {
+				float depth;
+				if (CollideSphereBVH(*data->mesh, data->spheres[i], triangles, depth)) {
+					sum += depth;
+				}
+			}
+			DoNotOptimize(sum);
+		});
+	benchmark.Add("Sphere contact HeightField (10k, terrain)", kContactCount,
+		[data]() {
+			float sum = 0.0f;
+			for (size_t i = 0; i < kContactCount; i++) {
+				Contact contact;
+				if (data->heightField.CheckCollision(data->spheres[i], contact)) {
+					sum += contact.depth;
+				}
+			}
+			DoNotOptimize(sum);
+		},
+		[data]() {
+			std::vector<uint32_t> triangles;
+			double maxError = 0.0;
+			for (size_t i = 0; i < kContactCount; i++) {
+				const Sphere& sphere = data->spheres[i];
+				float height;
+				data->heightField.GetHeight(sphere.center.x, sphere.center.z, height);
+				if (sphere.center.y < height) {
+					continue;
+				}
+				float expected = 0.0f;
+				const bool isExpected = CollideSphereBVH(*data->mesh, sphere, triangles, expected);
+				Contact contact;
+				const bool isHit = data->heightField.CheckCollision(sphere, contact);
+				if (isHit != isExpected) {
+					return static_cast<double>(kContactCount);
+				}
+				if (isHit) {
+					maxError = std::max(maxError, static_cast<double>(std::fabs(contact.depth - expected)));
+				}
+			}
+			return maxError;
+		});
+	benchmark.Add("AABB contact HeightField (10k, terrain)", kContactCount,
+		[data]() {
+			float sum = 0.0f;
+			for (size_t i = 0; i < kContactCount; i++) {
+				Contact contact;
+				if (data->heightField.CheckCollision(data->boxes[i], contact)) {
+					sum += contact.depth;
+				}
+			}
+			DoNotOptimize(sum);
+		});
+}
+
+} // namespace
+
+void AddRaycastBenchmarks(Benchmark& benchmark) {
+	benchmark.AddSection("Raycast");
+
+	// projectディレクトリで実行したときにモデルを読み込む(無ければ飛ばす)
+	std::vector<std::shared_ptr<MeshData>> meshes;
+	for (const char* name : { "stage", "terrain", "teapot" }) {
+		std::shared_ptr<MeshData> mesh = CreateMeshData(std::string("Resources/Model/obj/") + name + ".obj", 1000);
+		if (!mesh) {
+			continue;
+		}
+		AddMeshRaycast(benchmark, name, mesh);
+		meshes.push_back(mesh);
+	}
+	if (!meshes.empty()) {
+		// 100体のインスタンスに4096本のレイをまとめて飛ばす(ThreadPoolで並列に処理する)
+		std::shared_ptr<SceneData> scene = CreateSceneData(meshes, 100, 4096);
+		benchmark.Add("SceneBVH build (100 instances)", 100,
+			[scene]() {
+				SceneBVH bvh;
+				for (size_t i = 0; i < scene->worlds.size(); i++) {
+					bvh.AddInstance(&scene->meshes[scene->meshIndices[i]]->bvh, scene->worlds[i]);
+				}
+				bvh.Build();
+				DoNotOptimize(bvh.GetInstanceCount());
+			});
+		benchmark.Add("SceneBVH Raycast batch (100 instances, 4096 rays)", scene->rays.size(),
+			[scene]() {
+				DoNotOptimize(scene->scene.Raycast(scene->rays.data(), scene->rays.size(), scene->hits.data()));
+			},
+			[scene]() { return CountSceneMismatches(*scene, 0.0f, 256); });
+		benchmark.Add("SceneBVH SphereCast batch (100 instances, 4096 rays)", scene->rays.size(),
+			[scene]() {
+				DoNotOptimize(scene->scene.SphereCast(scene->rays.data(), scene->rays.size(), 1.5f, scene->hits.data()));
+			},
+			[scene]() { return CountSceneMismatches(*scene, 1.5f, 256); });
+	}
+
+	benchmark.AddSection("HeightField");
+
+	// 等間隔な格子のterrain.objから作った高さの格子と、同じモデルの三角形のBVHを比べる
+	for (const std::shared_ptr<MeshData>& mesh : meshes) {
+		HeightField heightField;
+		if (heightField.BuildFromMesh(mesh->positions.data(), mesh->positions.size())) {
+			AddHeightField(benchmark, mesh);
+		}
+	}
+}
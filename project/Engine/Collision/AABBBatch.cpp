@@ -0,0 +1,175 @@
+#include "AABBBatch.h"
+#include "kMathSimd.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+namespace {
+
+// 64個分(マスク1個分)のビットを求める関数
+using MaskKernel = uint64_t (*)(const AABB& aabb, const AABBSoA& aabbs, size_t begin, size_t count);
+
+// 分岐しないスカラー版
+uint64_t CollisionMaskScalar(const AABB& aabb, const AABBSoA& aabbs, size_t begin, size_t count) {
+	uint64_t mask = 0;
+	for (size_t i = 0; i < count; i++) {
+		const size_t index = begin + i;
+		const bool hit =
+			(aabb.min.x <= aabbs.maxX[index]) & (aabb.max.x >= aabbs.minX[index]) &
+			(aabb.min.y <= aabbs.maxY[index]) & (aabb.max.y >= aabbs.minY[index]) &
+			(aabb.min.z <= aabbs.maxZ[index]) & (aabb.max.z >= aabbs.minZ[index]);
+		mask |= static_cast<uint64_t>(hit) << i;
+	}
+	return mask;
+}
+
+#if KMATH_SIMD_X86
+
+// SSE4.1版(4個ずつ)
+KMATH_TARGET_SSE41 uint64_t CollisionMaskSSE41(const AABB& aabb, const AABBSoA& aabbs, size_t begin, size_t count) {
+	const __m128 minX = _mm_set1_ps(aabb.min.x);
+	const __m128 minY = _mm_set1_ps(aabb.min.y);
+	const __m128 minZ = _mm_set1_ps(aabb.min.z);
+	const __m128 maxX = _mm_set1_ps(aabb.max.x);
+	const __m128 maxY = _mm_set1_ps(aabb.max.y);
+	const __m128 maxZ = _mm_set1_ps(aabb.max.z);
+
+	uint64_t mask = 0;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const size_t index = begin + i;
+		__m128 hit = _mm_and_ps(_mm_cmple_ps(minX, _mm_loadu_ps(&aabbs.maxX[index])), _mm_cmpge_ps(maxX, _mm_loadu_ps(&aabbs.minX[index])));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(minY, _mm_loadu_ps(&aabbs.maxY[index])), _mm_cmpge_ps(maxY, _mm_loadu_ps(&aabbs.minY[index]))));
+		hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmple_ps(minZ, _mm_loadu_ps(&aabbs.maxZ[index])), _mm_cmpge_ps(maxZ, _mm_loadu_ps(&aabbs.minZ[index]))));
+		mask |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << i;
+	}
+	if (i < count) {
+		mask |= CollisionMaskScalar(aabb, aabbs, begin + i, count - i) << i;
+	}
+	return mask;
+}
+
+// AVX2版(8個ずつ)
+KMATH_TARGET_AVX2 uint64_t CollisionMaskAVX2(const AABB& aabb, const AABBSoA& aabbs, size_t begin, size_t count) {
+	const __m256 minX = _mm256_set1_ps(aabb.min.x);
+	const __m256 minY = _mm256_set1_ps(aabb.min.y);
+	const __m256 minZ = _mm256_set1_ps(aabb.min.z);
+	const __m256 maxX = _mm256_set1_ps(aabb.max.x);
+	const __m256 maxY = _mm256_set1_ps(aabb.max.y);
+	const __m256 maxZ = _mm256_set1_ps(aabb.max.z);
+
+	uint64_t mask = 0;
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const size_t index = begin + i;
+		__m256 hit = _mm256_and_ps(_mm256_cmp_ps(minX, _mm256_loadu_ps(&aabbs.maxX[index]), _CMP_LE_OQ), _mm256_cmp_ps(maxX, _mm256_loadu_ps(&aabbs.minX[index]), _CMP_GE_OQ));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(minY, _mm256_loadu_ps(&aabbs.maxY[index]), _CMP_LE_OQ), _mm256_cmp_ps(maxY, _mm256_loadu_ps(&aabbs.minY[index]), _CMP_GE_OQ)));
+		hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(minZ, _mm256_loadu_ps(&aabbs.maxZ[index]), _CMP_LE_OQ), _mm256_cmp_ps(maxZ, _mm256_loadu_ps(&aabbs.minZ[index]), _CMP_GE_OQ)));
+		mask |= static_cast<uint64_t>(_mm256_movemask_ps(hit)) << i;
+	}
+	if (i < count) {
+		mask |= CollisionMaskScalar(aabb, aabbs, begin + i, count - i) << i;
+	}
+	return mask;
+}
+
+#endif
+
+// 現在のSIMDレベルに対応したカーネル
+MaskKernel GetMaskKernel() {
+#if KMATH_SIMD_X86
+	switch (GetSimdLevel()) {
+	case SimdLevel::AVX2:
+		return CollisionMaskAVX2;
+	case SimdLevel::SSE41:
+		return CollisionMaskSSE41;
+	default:
+		break;
+	}
+#endif
+	return CollisionMaskScalar;
+}
+
+} // namespace
+
+void AABBSoA::Resize(size_t size) {
+	const size_t oldSize = Size();
+	minX.resize(size);
+	minY.resize(size);
+	minZ.resize(size);
+	maxX.resize(size);
+	maxY.resize(size);
+	maxZ.resize(size);
+	for (size_t i = oldSize; i < size; i++) {
+		SetEmpty(i);
+	}
+}
+
+void AABBSoA::PushBack(const AABB& aabb) {
+	minX.push_back(aabb.min.x);
+	minY.push_back(aabb.min.y);
+	minZ.push_back(aabb.min.z);
+	maxX.push_back(aabb.max.x);
+	maxY.push_back(aabb.max.y);
+	maxZ.push_back(aabb.max.z);
+}
+
+void AABBSoA::Set(size_t index, const AABB& aabb) {
+	minX[index] = aabb.min.x;
+	minY[index] = aabb.min.y;
+	minZ[index] = aabb.min.z;
+	maxX[index] = aabb.max.x;
+	maxY[index] = aabb.max.y;
+	maxZ[index] = aabb.max.z;
+}
+
+void AABBSoA::SetEmpty(size_t index) {
+	// minが+∞、maxが-∞ならどのAABBとも重ならない
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+	Set(index, AABB{ { kInfinity, kInfinity, kInfinity }, { -kInfinity, -kInfinity, -kInfinity } });
+}
+
+AABB AABBSoA::Get(size_t index) const {
+	return AABB{ { minX[index], minY[index], minZ[index] }, { maxX[index], maxY[index], maxZ[index] } };
+}
+
+size_t CollisionAABBMask(const AABB& aabb, const AABBSoA& aabbs, uint64_t* outMask) {
+	const MaskKernel kernel = GetMaskKernel();
+	const size_t count = aabbs.Size();
+	size_t hitCount = 0;
+	for (size_t begin = 0; begin < count; begin += 64) {
+		const uint64_t mask = kernel(aabb, aabbs, begin, std::min<size_t>(64, count - begin));
+		outMask[begin / 64] = mask;
+		hitCount += static_cast<size_t>(std::popcount(mask));
+	}
+	return hitCount;
+}
+
+size_t CollisionAABBMask(const AABB& aabb, const AABBSoA& aabbs, std::vector<uint64_t>& outMask) {
+	outMask.resize((aabbs.Size() + 63) / 64);
+	return CollisionAABBMask(aabb, aabbs, outMask.data());
+}
+
+size_t CollisionAABBIndices(const AABB& aabb, const AABBSoA& aabbs, uint32_t* outIndices) {
+	assert(aabbs.Size() <= std::numeric_limits<uint32_t>::max());
+	const MaskKernel kernel = GetMaskKernel();
+	const size_t count = aabbs.Size();
+	size_t hitCount = 0;
+	for (size_t begin = 0; begin < count; begin += 64) {
+		// 立っているビットを下から順に取り出して番号にする
+		uint64_t mask = kernel(aabb, aabbs, begin, std::min<size_t>(64, count - begin));
+		while (mask != 0) {
+			outIndices[hitCount++] = static_cast<uint32_t>(begin) + static_cast<uint32_t>(std::countr_zero(mask));
+			mask &= mask - 1;
+		}
+	}
+	return hitCount;
+}
+
+size_t CollisionAABBIndices(const AABB& aabb, const AABBSoA& aabbs, std::vector<uint32_t>& outIndices) {
+	outIndices.resize(aabbs.Size());
+	const size_t hitCount = CollisionAABBIndices(aabb, aabbs, outIndices.data());
+	outIndices.resize(hitCount);
+	return hitCount;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "AABB.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// SoAレイアウトのAABB配列(成分ごとに連続した配列を持つ)
+struct AABBSoA {
+	std::vector<float> minX;
+	std::vector<float> minY;
+	std::vector<float> minZ;
+	std::vector<float> maxX;
+	std::vector<float> maxY;
+	std::vector<float> maxZ;
+
+	// 要素数
+	size_t Size() const { return minX.size(); }
+	// 要素数を変更(増えた分は空のAABBにする)
+	void Resize(size_t size);
+	// 全て消す
+	void Clear() { Resize(0); }
+	// 追加
+	void PushBack(const AABB& aabb);
+	// Setter
+	void Set(size_t index, const AABB& aabb);
+	// どれとも重ならない空のAABBにする(消した要素の穴埋めに使う)
+	void SetEmpty(size_t index);
+	// Getter
+	AABB Get(size_t index) const;
+};
+
+// 以下の関数は現在のSIMDレベル(GetSimdLevel)で4個/8個ずつまとめて判定する
+// 判定の結果はCollisionAABBと同じ(接しているだけでも重なりとみなす)
+
+// aabbと重なっている要素のビットを立てる(outMaskは(要素数 + 63) / 64個以上。戻り値は重なっている数)
+size_t CollisionAABBMask(const AABB& aabb, const AABBSoA& aabbs, uint64_t* outMask);
+
+// aabbと重なっている要素のビットを立てる(outMaskは上書きする)
+size_t CollisionAABBMask(const AABB& aabb, const AABBSoA& aabbs, std::vector<uint64_t>& outMask);
+
+// aabbと重なっている要素の番号を小さい順に書く(outIndicesは要素数以上。戻り値は書いた数)
+size_t CollisionAABBIndices(const AABB& aabb, const AABBSoA& aabbs, uint32_t* outIndices);
+
+// aabbと重なっている要素の番号を小さい順に書く(outIndicesは上書きする)
+size_t CollisionAABBIndices(const AABB& aabb, const AABBSoA& aabbs, std::vector<uint32_t>& outIndices);
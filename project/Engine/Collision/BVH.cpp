@@ -0,0 +1,218 @@
+#include "BVH.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// SAHで分割位置を探すときのビンの数
+constexpr int kBinCount = 16;
+// 葉に入れる最大の要素数
+constexpr uint32_t kMaxLeafSize = 4;
+// これより深くなったら要素数で半分に分ける(たどるときのスタックがあふれないようにする)
+constexpr uint32_t kMaxSahDepth = 40;
+// レイの向きの成分がこれより小さければ0とみなす
+constexpr float kMinDirection = 1.0e-30f;
+
+AABB EmptyAABB() {
+	const float inf = std::numeric_limits<float>::infinity();
+	return AABB{ { inf, inf, inf }, { -inf, -inf, -inf } };
+}
+
+void Grow(AABB& aabb, const AABB& other) {
+	aabb.min.x = std::min(aabb.min.x, other.min.x);
+	aabb.min.y = std::min(aabb.min.y, other.min.y);
+	aabb.min.z = std::min(aabb.min.z, other.min.z);
+	aabb.max.x = std::max(aabb.max.x, other.max.x);
+	aabb.max.y = std::max(aabb.max.y, other.max.y);
+	aabb.max.z = std::max(aabb.max.z, other.max.z);
+}
+
+void Grow(AABB& aabb, const Vector3& point) {
+	Grow(aabb, AABB{ point, point });
+}
+
+// 表面積の半分(比べるだけなので2倍しない)
+float HalfArea(const AABB& aabb) {
+	const Vector3 d = aabb.max - aabb.min;
+	if (d.x < 0.0f) {
+		return 0.0f;
+	}
+	return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+float GetAxis(const Vector3& v, int axis) {
+	return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+float Centroid(const AABB& aabb, int axis) {
+	return (GetAxis(aabb.min, axis) + GetAxis(aabb.max, axis)) * 0.5f;
+}
+
+class Builder {
+public:
+	Builder(const AABB* bounds, std::vector<BVHNode>& nodes, std::vector<uint32_t>& order)
+		: bounds(bounds), nodes(nodes), order(order) {}
+
+	// order[begin, end)の要素でnodeIndexのノードを作る
+	void Build(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t depth) {
+		AABB nodeBounds = EmptyAABB();
+		AABB centroidBounds = EmptyAABB();
+		for (uint32_t i = begin; i < end; i++) {
+			const AABB& b = bounds[order[i]];
+			Grow(nodeBounds, b);
+			Grow(centroidBounds, (b.min + b.max) * 0.5f);
+		}
+		nodes[nodeIndex].bounds = nodeBounds;
+
+		const uint32_t count = end - begin;
+		if (count <= kMaxLeafSize) {
+			MakeLeaf(nodeIndex, begin, count);
+			return;
+		}
+
+		// 重心が一番広がっている軸で分ける
+		const Vector3 extent = centroidBounds.max - centroidBounds.min;
+		int axis = 0;
+		if (extent.y > GetAxis(extent, axis)) {
+			axis = 1;
+		}
+		if (extent.z > GetAxis(extent, axis)) {
+			axis = 2;
+		}
+		const float axisMin = GetAxis(centroidBounds.min, axis);
+		const float axisExtent = GetAxis(extent, axis);
+
+		uint32_t middle = begin;
+		if (axisExtent > 0.0f && depth < kMaxSahDepth) {
+			middle = PartitionSah(begin, end, axis, axisMin, axisExtent, nodeBounds);
+		}
+		if (middle == begin || middle == end) {
+			// 重心が全て同じ場合やSAHで分けない方が良い場合でも、葉が大きくなりすぎないように半分に分ける
+			middle = begin + count / 2;
+			std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [this, axis](uint32_t a, uint32_t b) {
+				return Centroid(bounds[a], axis) < Centroid(bounds[b], axis);
+			});
+		}
+
+		// 左の子は親の直後に置き、右の子は左の部分木を作り終えてから置く
+		const uint32_t left = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+		Build(left, begin, middle, depth + 1);
+		const uint32_t right = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+		Build(right, middle, end, depth + 1);
+		nodes[nodeIndex].start = right;
+		nodes[nodeIndex].count = 0;
+	}
+
+private:
+	void MakeLeaf(uint32_t nodeIndex, uint32_t begin, uint32_t count) {
+		nodes[nodeIndex].start = begin;
+		nodes[nodeIndex].count = count;
+	}
+
+	// ビンに分けてSAHのコストが一番小さい位置で分ける。分けない方が良ければbeginを返す
+	uint32_t PartitionSah(uint32_t begin, uint32_t end, int axis, float axisMin, float axisExtent, const AABB& nodeBounds) {
+		uint32_t binCounts[kBinCount] = {};
+		AABB binBounds[kBinCount];
+		for (AABB& b : binBounds) {
+			b = EmptyAABB();
+		}
+		const float scale = kBinCount / axisExtent;
+		auto binOf = [&](uint32_t element) {
+			const int bin = static_cast<int>((Centroid(bounds[element], axis) - axisMin) * scale);
+			return std::clamp(bin, 0, kBinCount - 1);
+		};
+		for (uint32_t i = begin; i < end; i++) {
+			const int bin = binOf(order[i]);
+			binCounts[bin]++;
+			Grow(binBounds[bin], bounds[order[i]]);
+		}
+
+		// 右から累積した面積と数
+		float rightAreas[kBinCount];
+		uint32_t rightCounts[kBinCount];
+		AABB accumulated = EmptyAABB();
+		uint32_t accumulatedCount = 0;
+		for (int i = kBinCount - 1; i > 0; i--) {
+			Grow(accumulated, binBounds[i]);
+			accumulatedCount += binCounts[i];
+			rightAreas[i] = HalfArea(accumulated);
+			rightCounts[i] = accumulatedCount;
+		}
+
+		// 左からたどってコストを比べる(split番目のビンから右に入れる)
+		float bestCost = std::numeric_limits<float>::max();
+		int bestSplit = -1;
+		accumulated = EmptyAABB();
+		accumulatedCount = 0;
+		for (int split = 1; split < kBinCount; split++) {
+			Grow(accumulated, binBounds[split - 1]);
+			accumulatedCount += binCounts[split - 1];
+			if (accumulatedCount == 0 || rightCounts[split] == 0) {
+				continue;
+			}
+			const float cost = HalfArea(accumulated) * accumulatedCount + rightAreas[split] * rightCounts[split];
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestSplit = split;
+			}
+		}
+
+		// 葉にした方が安く、葉に入る数なら分けない
+		const uint32_t count = end - begin;
+		const float leafCost = HalfArea(nodeBounds) * count;
+		if (bestSplit < 0 || (bestCost >= leafCost && count <= kMaxLeafSize * 2)) {
+			return begin;
+		}
+		auto middle = std::partition(order.begin() + begin, order.begin() + end, [&](uint32_t element) {
+			return binOf(element) < bestSplit;
+		});
+		return static_cast<uint32_t>(middle - order.begin());
+	}
+
+private:
+	const AABB* bounds;
+	std::vector<BVHNode>& nodes;
+	std::vector<uint32_t>& order;
+};
+
+} // namespace
+
+void BuildBVH(const AABB* bounds, size_t count, std::vector<BVHNode>& nodes, std::vector<uint32_t>& order) {
+	nodes.clear();
+	order.resize(count);
+	for (size_t i = 0; i < count; i++) {
+		order[i] = static_cast<uint32_t>(i);
+	}
+	if (count == 0) {
+		return;
+	}
+	nodes.reserve(count * 2);
+	nodes.emplace_back();
+	Builder builder(bounds, nodes, order);
+	builder.Build(0, 0, static_cast<uint32_t>(count), 0);
+}
+
+RayBoxQuery MakeRayBoxQuery(const Vector3& origin, const Vector3& direction, float inflate) {
+	// 0の成分は逆数が無限大になり、スラブの面上から出たレイで0 * 無限大 = NaNになるので、十分大きな有限の値にする
+	auto inverse = [](float value) {
+		return std::fabs(value) > kMinDirection ? 1.0f / value : std::copysign(1.0f / kMinDirection, value);
+	};
+	return RayBoxQuery{ origin, { inverse(direction.x), inverse(direction.y), inverse(direction.z) }, inflate };
+}
+
+bool IntersectRayBox(const RayBoxQuery& query, const AABB& bounds, float maxDistance, float& distance) {
+	// スラブ法
+	const float x0 = (bounds.min.x - query.inflate - query.origin.x) * query.inverseDirection.x;
+	const float x1 = (bounds.max.x + query.inflate - query.origin.x) * query.inverseDirection.x;
+	const float y0 = (bounds.min.y - query.inflate - query.origin.y) * query.inverseDirection.y;
+	const float y1 = (bounds.max.y + query.inflate - query.origin.y) * query.inverseDirection.y;
+	const float z0 = (bounds.min.z - query.inflate - query.origin.z) * query.inverseDirection.z;
+	const float z1 = (bounds.max.z + query.inflate - query.origin.z) * query.inverseDirection.z;
+	const float enter = std::max({ std::min(x0, x1), std::min(y0, y1), std::min(z0, z1), 0.0f });
+	const float exit = std::min({ std::max(x0, x1), std::max(y0, y1), std::max(z0, z1), maxDistance });
+	distance = enter;
+	return enter <= exit;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "AABB.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 配列で持つBVHのノード
+// 左の子は必ず自分の次の番号に置くので、右の子の番号だけを持つ
+struct BVHNode {
+	AABB bounds;
+	// 葉ならorderの開始位置、内部ノードなら右の子の番号
+	uint32_t start;
+	// 葉に入っている要素数(0なら内部ノード)
+	uint32_t count;
+
+	bool IsLeaf() const { return count != 0; }
+};
+
+// 要素のAABBからSAH(表面積ヒューリスティック)でBVHを作る
+// orderには葉から参照する要素の番号が入る(葉のstartからcount個)
+void BuildBVH(const AABB* bounds, size_t count, std::vector<BVHNode>& nodes, std::vector<uint32_t>& order);
+
+// レイとAABBの判定に使う値(逆数は先に求めておく)
+struct RayBoxQuery {
+	Vector3 origin;
+	Vector3 inverseDirection;
+	// AABBをこれだけ広げて判定する(スフィアキャスト用)
+	float inflate;
+};
+
+// レイの逆数などを求める
+RayBoxQuery MakeRayBoxQuery(const Vector3& origin, const Vector3& direction, float inflate = 0.0f);
+
+// レイがAABBに[0, maxDistance]の範囲で当たるか。当たれば入った位置をdistanceに書く
+bool IntersectRayBox(const RayBoxQuery& query, const AABB& bounds, float maxDistance, float& distance);
+
+// BVHのノードをレイに沿って近い順にたどる
+// visitLeaf(start, count, maxDistance)は葉ごとに呼ばれ、当たればmaxDistanceを縮める
+template<typename VisitLeaf>
+void TraverseBVH(const std::vector<BVHNode>& nodes, const RayBoxQuery& query, float& maxDistance, VisitLeaf&& visitLeaf) {
+	if (nodes.empty()) {
+		return;
+	}
+	float distance;
+	if (!IntersectRayBox(query, nodes[0].bounds, maxDistance, distance)) {
+		return;
+	}
+	uint32_t stack[64];
+	float stackDistances[64];
+	uint32_t stackSize = 0;
+	stack[stackSize] = 0;
+	stackDistances[stackSize++] = distance;
+	while (stackSize > 0) {
+		stackSize--;
+		// 積んだ後に近い当たりが見つかっていれば調べない
+		if (stackDistances[stackSize] > maxDistance) {
+			continue;
+		}
+		const BVHNode& node = nodes[stack[stackSize]];
+		if (node.IsLeaf()) {
+			visitLeaf(node.start, node.count, maxDistance);
+			continue;
+		}
+		const uint32_t left = static_cast<uint32_t>(&node - nodes.data()) + 1;
+		const uint32_t right = node.start;
+		float leftDistance;
+		float rightDistance;
+		const bool hitLeft = IntersectRayBox(query, nodes[left].bounds, maxDistance, leftDistance);
+		const bool hitRight = IntersectRayBox(query, nodes[right].bounds, maxDistance, rightDistance);
+		// 近い方を後に積んで先に調べる
+		if (hitLeft && hitRight) {
+			const bool leftFirst = leftDistance <= rightDistance;
+			stack[stackSize] = leftFirst ? right : left;
+			stackDistances[stackSize++] = leftFirst ? rightDistance : leftDistance;
+			stack[stackSize] = leftFirst ? left : right;
+			stackDistances[stackSize++] = leftFirst ? leftDistance : rightDistance;
+		} else if (hitLeft) {
+			stack[stackSize] = left;
+			stackDistances[stackSize++] = leftDistance;
+		} else if (hitRight) {
+			stack[stackSize] = right;
+			stackDistances[stackSize++] = rightDistance;
+		}
+	}
+}
+
+// BVHのノードのうちaabbと重なる葉をたどる
+// visitLeaf(start, count)は葉ごとに呼ばれる
+template<typename VisitLeaf>
+void TraverseBVH(const std::vector<BVHNode>& nodes, const AABB& aabb, VisitLeaf&& visitLeaf) {
+	if (nodes.empty()) {
+		return;
+	}
+	uint32_t stack[64];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0) {
+		const uint32_t index = stack[--stackSize];
+		const BVHNode& node = nodes[index];
+		if (node.bounds.min.x > aabb.max.x || node.bounds.max.x < aabb.min.x ||
+			node.bounds.min.y > aabb.max.y || node.bounds.max.y < aabb.min.y ||
+			node.bounds.min.z > aabb.max.z || node.bounds.max.z < aabb.min.z) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			visitLeaf(node.start, node.count);
+			continue;
+		}
+		stack[stackSize++] = node.start;
+		stack[stackSize++] = index + 1;
+	}
+}
@@ -0,0 +1,315 @@
+#include "BoundingVolume.h"
+#include "kMath.h"
+#include "kMathSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Jacobi法の最大反復回数(3x3なので数回で収束する)
+constexpr int kJacobiIterations = 16;
+
+// 列ベクトル(ローカルの軸axisがワールドでどの向きになるか)
+Vector3 GetColumn(const Matrix3x4& m, int axis) {
+	return Vector3{ m.m[0][axis], m.m[1][axis], m.m[2][axis] };
+}
+
+// 回転・スケールだけを掛ける
+Vector3 TransformDirection(const Vector3& v, const Matrix3x4& m) {
+	return Vector3{
+		m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z,
+		m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z,
+		m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z
+	};
+}
+
+Vector3 Abs(const Vector3& v) {
+	return Vector3{ std::fabs(v.x), std::fabs(v.y), std::fabs(v.z) };
+}
+
+// 対称行列の固有ベクトルを求める(Jacobi法)。vectors[i]がi番目の固有ベクトル
+void ComputeEigenVectors(float (&matrix)[3][3], Vector3 (&vectors)[3]) {
+	float v[3][3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	for (int iteration = 0; iteration < kJacobiIterations; iteration++) {
+		// 一番大きい非対角成分を消す
+		int p = 0;
+		int q = 1;
+		float largest = std::fabs(matrix[0][1]);
+		if (std::fabs(matrix[0][2]) > largest) {
+			largest = std::fabs(matrix[0][2]);
+			p = 0;
+			q = 2;
+		}
+		if (std::fabs(matrix[1][2]) > largest) {
+			largest = std::fabs(matrix[1][2]);
+			p = 1;
+			q = 2;
+		}
+		if (largest < 1.0e-9f) {
+			break;
+		}
+
+		const float theta = (matrix[q][q] - matrix[p][p]) / (2.0f * matrix[p][q]);
+		const float t = (theta >= 0.0f ? 1.0f : -1.0f) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0f));
+		const float c = 1.0f / std::sqrt(t * t + 1.0f);
+		const float s = t * c;
+
+		// matrix = J^T * matrix * J
+		for (int k = 0; k < 3; k++) {
+			const float kp = matrix[k][p];
+			const float kq = matrix[k][q];
+			matrix[k][p] = c * kp - s * kq;
+			matrix[k][q] = s * kp + c * kq;
+		}
+		for (int k = 0; k < 3; k++) {
+			const float pk = matrix[p][k];
+			const float qk = matrix[q][k];
+			matrix[p][k] = c * pk - s * qk;
+			matrix[q][k] = s * pk + c * qk;
+		}
+		// v = v * J
+		for (int k = 0; k < 3; k++) {
+			const float kp = v[k][p];
+			const float kq = v[k][q];
+			v[k][p] = c * kp - s * kq;
+			v[k][q] = s * kp + c * kq;
+		}
+	}
+	for (int i = 0; i < 3; i++) {
+		vectors[i] = Vector3{ v[0][i], v[1][i], v[2][i] };
+	}
+}
+
+// axesの向きで点群を囲むOBB
+OBB FitOBB(const Vector3* points, size_t count, const Vector3 (&axes)[3]) {
+	float minimum[3];
+	float maximum[3];
+	for (int i = 0; i < 3; i++) {
+		minimum[i] = std::numeric_limits<float>::max();
+		maximum[i] = std::numeric_limits<float>::lowest();
+	}
+	for (size_t n = 0; n < count; n++) {
+		for (int i = 0; i < 3; i++) {
+			const float d = Dot(points[n], axes[i]);
+			minimum[i] = std::min(minimum[i], d);
+			maximum[i] = std::max(maximum[i], d);
+		}
+	}
+	OBB obb;
+	obb.center = { 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 3; i++) {
+		obb.orientation[i] = axes[i];
+		obb.center += axes[i] * ((minimum[i] + maximum[i]) * 0.5f);
+	}
+	obb.size = { (maximum[0] - minimum[0]) * 0.5f, (maximum[1] - minimum[1]) * 0.5f, (maximum[2] - minimum[2]) * 0.5f };
+	return obb;
+}
+
+AABB TransformAABBScalar(const OBB& obb, const Matrix3x4& world) {
+	const Vector3 center = MatrixTransform(obb.center, world);
+	const Vector3 extent =
+		Abs(TransformDirection(obb.orientation[0] * obb.size.x, world)) +
+		Abs(TransformDirection(obb.orientation[1] * obb.size.y, world)) +
+		Abs(TransformDirection(obb.orientation[2] * obb.size.z, world));
+	return AABB{ center - extent, center + extent };
+}
+
+#if KMATH_SIMD_X86
+
+// SSE4.1版。行列を転置して列を1本ずつレジスタに載せ、軸ごとに掛けて足す
+KMATH_TARGET_SSE41 AABB TransformAABBSSE41(const OBB& obb, const Matrix3x4& world) {
+	__m128 column0 = _mm_loadu_ps(world.m[0]);
+	__m128 column1 = _mm_loadu_ps(world.m[1]);
+	__m128 column2 = _mm_loadu_ps(world.m[2]);
+	__m128 column3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+
+	auto transform = [&](const Vector3& v) {
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(v.x)), _mm_mul_ps(column1, _mm_set1_ps(v.y))), _mm_mul_ps(column2, _mm_set1_ps(v.z)));
+	};
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 center = _mm_add_ps(transform(obb.center), column3);
+	const __m128 axis0 = _mm_andnot_ps(signMask, _mm_mul_ps(transform(obb.orientation[0]), _mm_set1_ps(obb.size.x)));
+	const __m128 axis1 = _mm_andnot_ps(signMask, _mm_mul_ps(transform(obb.orientation[1]), _mm_set1_ps(obb.size.y)));
+	const __m128 axis2 = _mm_andnot_ps(signMask, _mm_mul_ps(transform(obb.orientation[2]), _mm_set1_ps(obb.size.z)));
+	const __m128 extent = _mm_add_ps(_mm_add_ps(axis0, axis1), axis2);
+
+	alignas(16) float minimum[4];
+	alignas(16) float maximum[4];
+	_mm_store_ps(minimum, _mm_sub_ps(center, extent));
+	_mm_store_ps(maximum, _mm_add_ps(center, extent));
+	return AABB{ { minimum[0], minimum[1], minimum[2] }, { maximum[0], maximum[1], maximum[2] } };
+}
+
+#endif
+
+} // namespace
+
+AABB ComputeAABB(const Vector3* points, size_t count) {
+	if (count == 0) {
+		return AABB{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+	}
+	AABB result = { points[0], points[0] };
+	for (size_t i = 1; i < count; i++) {
+		result.min.x = std::min(result.min.x, points[i].x);
+		result.min.y = std::min(result.min.y, points[i].y);
+		result.min.z = std::min(result.min.z, points[i].z);
+		result.max.x = std::max(result.max.x, points[i].x);
+		result.max.y = std::max(result.max.y, points[i].y);
+		result.max.z = std::max(result.max.z, points[i].z);
+	}
+	return result;
+}
+
+Sphere ComputeBoundingSphere(const Vector3* points, size_t count) {
+	if (count == 0) {
+		return Sphere{ { 0.0f, 0.0f, 0.0f }, 0.0f };
+	}
+
+	// 各軸で一番離れている2点のうち、最も遠い組を直径にする
+	size_t minIndex[3] = { 0, 0, 0 };
+	size_t maxIndex[3] = { 0, 0, 0 };
+	for (size_t i = 1; i < count; i++) {
+		const Vector3& p = points[i];
+		if (p.x < points[minIndex[0]].x) { minIndex[0] = i; }
+		if (p.x > points[maxIndex[0]].x) { maxIndex[0] = i; }
+		if (p.y < points[minIndex[1]].y) { minIndex[1] = i; }
+		if (p.y > points[maxIndex[1]].y) { maxIndex[1] = i; }
+		if (p.z < points[minIndex[2]].z) { minIndex[2] = i; }
+		if (p.z > points[maxIndex[2]].z) { maxIndex[2] = i; }
+	}
+	int axis = 0;
+	float longest = -1.0f;
+	for (int i = 0; i < 3; i++) {
+		const Vector3 d = points[maxIndex[i]] - points[minIndex[i]];
+		const float lengthSq = Dot(d, d);
+		if (lengthSq > longest) {
+			longest = lengthSq;
+			axis = i;
+		}
+	}
+	Sphere sphere;
+	sphere.center = (points[minIndex[axis]] + points[maxIndex[axis]]) * 0.5f;
+	sphere.radius = std::sqrt(longest) * 0.5f;
+
+	// 外にある点を含むように広げる
+	for (size_t i = 0; i < count; i++) {
+		const Vector3 d = points[i] - sphere.center;
+		const float distanceSq = Dot(d, d);
+		if (distanceSq > sphere.radius * sphere.radius) {
+			const float distance = std::sqrt(distanceSq);
+			const float radius = (sphere.radius + distance) * 0.5f;
+			sphere.center += d * ((radius - sphere.radius) / distance);
+			sphere.radius = radius;
+		}
+	}
+	return sphere;
+}
+
+OBB ComputeOBB(const Vector3* points, size_t count) {
+	const Vector3 identity[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	if (count == 0) {
+		return OBB{ { 0.0f, 0.0f, 0.0f }, { identity[0], identity[1], identity[2] }, { 0.0f, 0.0f, 0.0f } };
+	}
+
+	// 共分散行列
+	Vector3 mean = { 0.0f, 0.0f, 0.0f };
+	for (size_t i = 0; i < count; i++) {
+		mean += points[i];
+	}
+	mean = mean * (1.0f / static_cast<float>(count));
+	float covariance[3][3] = {};
+	for (size_t i = 0; i < count; i++) {
+		const Vector3 d = points[i] - mean;
+		covariance[0][0] += d.x * d.x;
+		covariance[0][1] += d.x * d.y;
+		covariance[0][2] += d.x * d.z;
+		covariance[1][1] += d.y * d.y;
+		covariance[1][2] += d.y * d.z;
+		covariance[2][2] += d.z * d.z;
+	}
+	covariance[1][0] = covariance[0][1];
+	covariance[2][0] = covariance[0][2];
+	covariance[2][1] = covariance[1][2];
+
+	// 固有ベクトルを軸にする(右手系になるように3本目は外積で求める)
+	Vector3 axes[3];
+	ComputeEigenVectors(covariance, axes);
+	axes[0] = Normalize(axes[0]);
+	axes[1] = Normalize(axes[1] - axes[0] * Dot(axes[1], axes[0]));
+	axes[2] = Cross(axes[0], axes[1]);
+	const OBB pca = FitOBB(points, count, axes);
+
+	// 箱型のモデルなどはAABBの方が小さくなる
+	const OBB aligned = FitOBB(points, count, identity);
+	const float pcaVolume = pca.size.x * pca.size.y * pca.size.z;
+	const float alignedVolume = aligned.size.x * aligned.size.y * aligned.size.z;
+	return pcaVolume < alignedVolume ? pca : aligned;
+}
+
+BoundingVolume ComputeBoundingVolume(const Vector3* points, size_t count) {
+	BoundingVolume result;
+	result.aabb = ComputeAABB(points, count);
+	result.sphere = ComputeBoundingSphere(points, count);
+	result.obb = ComputeOBB(points, count);
+	return result;
+}
+
+AABB TransformAABB(const OBB& obb, const Matrix3x4& world) {
+#if KMATH_SIMD_X86
+	if (GetSimdLevel() >= SimdLevel::SSE41) {
+		return TransformAABBSSE41(obb, world);
+	}
+#endif
+	return TransformAABBScalar(obb, world);
+}
+
+AABB TransformAABB(const AABB& aabb, const Matrix3x4& world) {
+	OBB obb;
+	obb.center = (aabb.min + aabb.max) * 0.5f;
+	obb.orientation[0] = { 1.0f, 0.0f, 0.0f };
+	obb.orientation[1] = { 0.0f, 1.0f, 0.0f };
+	obb.orientation[2] = { 0.0f, 0.0f, 1.0f };
+	obb.size = (aabb.max - aabb.min) * 0.5f;
+	return TransformAABB(obb, world);
+}
+
+Sphere TransformSphere(const Sphere& sphere, const Matrix3x4& world) {
+	float scaleSq = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		const Vector3 column = GetColumn(world, i);
+		scaleSq = std::max(scaleSq, Dot(column, column));
+	}
+	return Sphere{ MatrixTransform(sphere.center, world), sphere.radius * std::sqrt(scaleSq) };
+}
+
+OBB TransformOBB(const OBB& obb, const Matrix3x4& world) {
+	// 変換後の各辺(半分の長さ)
+	const Vector3 edges[3] = {
+		TransformDirection(obb.orientation[0] * obb.size.x, world),
+		TransformDirection(obb.orientation[1] * obb.size.y, world),
+		TransformDirection(obb.orientation[2] * obb.size.z, world)
+	};
+
+	// 直交するように軸を作り直す(せん断が無ければ辺の向きと一致する)
+	OBB result;
+	result.center = MatrixTransform(obb.center, world);
+	const float lengthSq0 = Dot(edges[0], edges[0]);
+	result.orientation[0] = lengthSq0 > 0.0f ? edges[0] * (1.0f / std::sqrt(lengthSq0)) : Vector3{ 1.0f, 0.0f, 0.0f };
+	Vector3 second = edges[1] - result.orientation[0] * Dot(edges[1], result.orientation[0]);
+	if (Dot(second, second) <= 1.0e-12f) {
+		// 潰れている場合は適当な直交する向き
+		second = Cross(result.orientation[0], std::fabs(result.orientation[0].x) < 0.9f ? Vector3{ 1.0f, 0.0f, 0.0f } : Vector3{ 0.0f, 1.0f, 0.0f });
+	}
+	result.orientation[1] = Normalize(second);
+	result.orientation[2] = Cross(result.orientation[0], result.orientation[1]);
+
+	// 各軸に辺を投影した長さの合計が半分の大きさ
+	float size[3];
+	for (int i = 0; i < 3; i++) {
+		size[i] = std::fabs(Dot(edges[0], result.orientation[i])) + std::fabs(Dot(edges[1], result.orientation[i])) + std::fabs(Dot(edges[2], result.orientation[i]));
+	}
+	result.size = { size[0], size[1], size[2] };
+	return result;
+}
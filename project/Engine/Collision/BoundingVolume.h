@@ -0,0 +1,40 @@
+#pragma once
+#include "AABB.h"
+#include "Sphere.h"
+#include "OBB.h"
+#include "Matrix3x4.h"
+#include "Vector3.h"
+#include <cstddef>
+
+// モデルのローカル座標での境界ボリューム(読み込み時に1回だけ求める)
+struct BoundingVolume {
+	AABB aabb;
+	Sphere sphere;
+	OBB obb;
+};
+
+// 点群を囲むAABB
+AABB ComputeAABB(const Vector3* points, size_t count);
+
+// 点群を囲む球(Ritterの方法。最小の球より5~20%ほど大きくなる)
+Sphere ComputeBoundingSphere(const Vector3* points, size_t count);
+
+// 点群を囲むOBB(主成分分析で向きを決める。AABBの方が小さければAABBと同じ向きにする)
+OBB ComputeOBB(const Vector3* points, size_t count);
+
+// AABB・球・OBBをまとめて求める
+BoundingVolume ComputeBoundingVolume(const Vector3* points, size_t count);
+
+// ローカル座標のOBBをワールド行列で変換して、8つの角を囲むAABBを求める
+// 角を1つずつ変換せず、各軸の寄与の絶対値を足して求める(結果は同じ)
+AABB TransformAABB(const OBB& obb, const Matrix3x4& world);
+
+// ローカル座標のAABBをワールド行列で変換して、8つの角を囲むAABBを求める
+AABB TransformAABB(const AABB& aabb, const Matrix3x4& world);
+
+// ローカル座標の球をワールド行列で変換する(半径は一番大きいスケールで拡大する)
+Sphere TransformSphere(const Sphere& sphere, const Matrix3x4& world);
+
+// ローカル座標のOBBをワールド行列で変換する
+// 軸と違う向きにスケールが掛かるとせん断が出るので、その場合は元の形を含む少し大きめのOBBになる
+OBB TransformOBB(const OBB& obb, const Matrix3x4& world);
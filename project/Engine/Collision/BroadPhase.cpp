@@ -0,0 +1,65 @@
+#include "BroadPhase.h"
+#include "DynamicAABBTree.h"
+#include "SweepAndPrune.h"
+#include "SpatialHashGrid.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// 並べる区間の大きさ(これより少なければそのまま並べる)
+constexpr size_t kSortChunkSize = 16384;
+
+} // namespace
+
+std::unique_ptr<BroadPhase> CreateBroadPhase(BroadPhaseType type) {
+	switch (type) {
+	case BroadPhaseType::DynamicAABBTree:
+		return std::make_unique<DynamicAABBTree>();
+	case BroadPhaseType::SweepAndPrune:
+		return std::make_unique<SweepAndPrune>();
+	case BroadPhaseType::SpatialHashGrid:
+		return std::make_unique<SpatialHashGrid>();
+	}
+	assert(false);
+	return nullptr;
+}
+
+void SortProxyPairs(std::vector<ProxyPair>& pairs) {
+	const size_t count = pairs.size();
+	if (count <= kSortChunkSize) {
+		std::sort(pairs.begin(), pairs.end());
+		return;
+	}
+
+	// 区間ごとに並べる
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	const size_t chunkCount = (count + kSortChunkSize - 1) / kSortChunkSize;
+	threadPool->ParallelFor(chunkCount, 1, [&pairs, count](size_t begin, size_t end) {
+		for (size_t chunk = begin; chunk < end; chunk++) {
+			const size_t first = chunk * kSortChunkSize;
+			std::sort(pairs.begin() + first, pairs.begin() + std::min(first + kSortChunkSize, count));
+		}
+	});
+
+	// 隣り合う区間を2つずつマージしていく
+	std::vector<ProxyPair> buffer(count);
+	std::vector<ProxyPair>* source = &pairs;
+	std::vector<ProxyPair>* destination = &buffer;
+	for (size_t width = kSortChunkSize; width < count; width *= 2) {
+		const size_t mergeCount = (count + width * 2 - 1) / (width * 2);
+		threadPool->ParallelFor(mergeCount, 1, [source, destination, width, count](size_t begin, size_t end) {
+			for (size_t merge = begin; merge < end; merge++) {
+				const size_t first = merge * width * 2;
+				const size_t middle = std::min(first + width, count);
+				const size_t last = std::min(first + width * 2, count);
+				std::merge(source->begin() + first, source->begin() + middle, source->begin() + middle, source->begin() + last, destination->begin() + first);
+			}
+		});
+		std::swap(source, destination);
+	}
+	if (source != &pairs) {
+		pairs.swap(buffer);
+	}
+}
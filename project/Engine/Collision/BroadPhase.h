@@ -0,0 +1,70 @@
+#pragma once
+#include "AABB.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ブロードフェーズに登録したAABB(プロキシ)を指すハンドル
+using ProxyHandle = int32_t;
+
+// 無効なハンドル
+constexpr ProxyHandle kNullProxy = -1;
+
+// AABBが重なっているプロキシのペア(a < b)
+struct ProxyPair {
+	ProxyHandle a;
+	ProxyHandle b;
+};
+
+// ペアの並び順(a, bの順で比較する)
+inline bool operator<(const ProxyPair& lhs, const ProxyPair& rhs) {
+	return lhs.a != rhs.a ? lhs.a < rhs.a : lhs.b < rhs.b;
+}
+
+inline bool operator==(const ProxyPair& lhs, const ProxyPair& rhs) {
+	return lhs.a == rhs.a && lhs.b == rhs.b;
+}
+
+// ブロードフェーズ(衝突する可能性のあるペアを絞り込む)の共通インターフェース
+class BroadPhase {
+public:
+	virtual ~BroadPhase() = default;
+
+	// AABBを登録する。userDataはペアから元のオブジェクトを引くのに使う
+	virtual ProxyHandle CreateProxy(const AABB& aabb, void* userData) = 0;
+
+	// 登録を解除する
+	virtual void DestroyProxy(ProxyHandle proxy) = 0;
+
+	// AABBを更新する
+	virtual void MoveProxy(ProxyHandle proxy, const AABB& aabb) = 0;
+
+	// AABBが重なっているペアを全て求める(pairsは上書きする。並び順は実装による)
+	virtual void ComputePairs(std::vector<ProxyPair>& pairs) = 0;
+
+	// aabbと重なっているプロキシを求める(resultは上書きする)
+	virtual void Query(const AABB& aabb, std::vector<ProxyHandle>& result) const = 0;
+
+	// Getter(userData)
+	virtual void* GetUserData(ProxyHandle proxy) const = 0;
+
+	// Getter(登録したAABB)
+	virtual const AABB& GetAABB(ProxyHandle proxy) const = 0;
+
+	// 登録されているプロキシの数
+	virtual size_t GetProxyCount() const = 0;
+};
+
+// ブロードフェーズの種類
+enum class BroadPhaseType {
+	DynamicAABBTree, // 動的AABB木。大きく動くオブジェクトや追加・削除が多い場合
+	SweepAndPrune,   // Sweep and Prune。少しずつ動くオブジェクトが多い場合
+	SpatialHashGrid, // 一様グリッド。同じくらいの大きさの小さなオブジェクトが大量にある場合
+};
+
+// 種類を指定してブロードフェーズを作る
+std::unique_ptr<BroadPhase> CreateBroadPhase(BroadPhaseType type);
+
+// ペアをハンドル順に並べる(区間ごとに並列に並べてからマージする。結果はスレッド数によらずstd::sortと同じ)
+void SortProxyPairs(std::vector<ProxyPair>& pairs);
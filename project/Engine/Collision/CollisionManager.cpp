@@ -1,55 +1,341 @@
-//#include "CollisionManager.h"
-//#include "kMath.h"
-//
-////CollisionManager* CollisionManager::instance = nullptr;
-//
-////CollisionManager* CollisionManager::GetInstance() {
-////	if (instance == nullptr)
-////	{
-////		instance = new CollisionManager;
-////	}
-////	return instance;
-////}
-//
-//void CollisionManager::Initialize() {
-//
-//}
-//
-//void CollisionManager::Update() {
-//	
-//}
-//
-////void CollisionManager::Finalize() {
-////	delete instance;
-////	instance = nullptr;
-////}
-//
-//const bool& CollisionManager::CheckCollision(const AABB& a, const AABB& b) {
-//	if ((a.min.x <= b.max.x && a.max.x >= b.min.x) && 
-//		(a.min.y <= b.max.y && a.max.y >= b.min.y) && 
-//		(a.min.z <= b.max.z && a.max.z >= b.min.z)) {
-//		return true;
-//	}
-//	return false;
-//}
-//
-//const bool& CollisionManager::CheckCollision(const AABB& target1, const Sphere& target2) {
-//	// 最近接点を求める
-//	Vector3 closestPoint{
-//		std::clamp(target2.center.x, target1.min.x, target1.max.x),
-//		std::clamp(target2.center.y, target1.min.y, target1.max.y),
-//		std::clamp(target2.center.z, target1.min.z, target1.max.z)
-//	};
-//	// 最近接点と球の中心との距離を求める
-//	float distance = Length(closestPoint - target2.center);
-//	// 距離が半径よりも小さければ衝突
-//	if (distance <= target2.radius)
-//	{
-//		return true;
-//	}
-//	return false;
-//}
-//
-////const bool& CollisionManager::CheckCollision(const AABB& target1, const OBB& target2) {
-////
-////}
\ No newline at end of file
+#include "CollisionManager.h"
+#include "Object3d.h"
+#include "Model.h"
+#include "ThreadPool.h"
+#include <cassert>
+
+namespace {
+
+// 速いオブジェクトをまとめて処理するときの1回分の数
+constexpr size_t kFastMoversPerBatch = 16;
+
+Vector3 Center(const AABB& aabb) {
+	return (aabb.min + aabb.max) * 0.5f;
+}
+
+// 形状が変わっていないか(同じ行列から求めたものは同じ値になるので、そのまま比べる)
+bool IsSameOBB(const OBB& a, const OBB& b) {
+	auto isSame = [](const Vector3& lhs, const Vector3& rhs) { return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z; };
+	return isSame(a.center, b.center) && isSame(a.size, b.size) &&
+		isSame(a.orientation[0], b.orientation[0]) && isSame(a.orientation[1], b.orientation[1]) && isSame(a.orientation[2], b.orientation[2]);
+}
+
+// 2つのAABBを囲むAABB
+AABB Merge(const AABB& a, const AABB& b) {
+	return AABB{
+		{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+		{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+	};
+}
+
+} // namespace
+
+CollisionManager* CollisionManager::instance = nullptr;
+
+CollisionManager* CollisionManager::GetInstance() {
+	if (instance == nullptr) {
+		instance = new CollisionManager;
+	}
+	return instance;
+}
+
+void CollisionManager::Finalize() {
+	delete instance;
+	instance = nullptr;
+}
+
+void CollisionManager::Initialize(BroadPhaseType type) {
+	broadPhaseType = type;
+	broadPhase = CreateBroadPhase(type);
+	entries.clear();
+	entryIndices.clear();
+	proxyEntries.clear();
+	proxyPairs.clear();
+	collisionPairs.clear();
+	sceneBVH.Clear();
+	fastMovers.clear();
+	sweepResults.clear();
+	sweepHits.clear();
+	contactCache.Clear();
+	enterEvents.clear();
+	stayEvents.clear();
+	exitEvents.clear();
+}
+
+void CollisionManager::SetBroadPhaseType(BroadPhaseType type) {
+	assert(broadPhase);
+	if (type == broadPhaseType) {
+		return;
+	}
+	broadPhaseType = type;
+	broadPhase = CreateBroadPhase(type);
+	// ハンドルは作り直しになるので、接触の状態は新しいハンドルに付け替えて引き継ぐ
+	std::vector<ProxyHandle> newHandles(proxyEntries.size(), kNullProxy);
+	proxyEntries.clear();
+	for (size_t i = 0; i < entries.size(); i++) {
+		Entry& entry = entries[i];
+		const ProxyHandle proxy = broadPhase->CreateProxy(entry.object->GetAABB(), entry.object);
+		newHandles[entry.proxy] = proxy;
+		entry.proxy = proxy;
+		SetProxyEntry(proxy, i);
+	}
+	contactCache.Remap(newHandles);
+}
+
+void CollisionManager::Update() {
+	assert(broadPhase);
+
+	// Object3d::Updateで求めたAABBを反映する(速いオブジェクトは前のフレームの位置から今の位置までを囲む)
+	fastMovers.clear();
+	for (size_t i = 0; i < entries.size(); i++) {
+		Entry& entry = entries[i];
+		const OBB& obb = entry.object->GetOBB();
+		entry.isMoved = entry.isFastMover || !IsSameOBB(entry.obb, obb);
+		entry.obb = obb;
+		const Model* model = entry.object->GetModel();
+		entry.hull = model && model->GetConvexHull().IsValid() ? &model->GetConvexHull() : nullptr;
+		if (entry.hull) {
+			entry.world = MakeMatrix3x4(entry.object->GetWorldMatrix());
+		}
+		if (entry.isFastMover) {
+			fastMovers.push_back(i);
+			broadPhase->MoveProxy(entry.proxy, Merge(entry.previousAABB, entry.object->GetAABB()));
+		} else {
+			broadPhase->MoveProxy(entry.proxy, entry.object->GetAABB());
+		}
+	}
+
+	broadPhase->ComputePairs(proxyPairs);
+	// バックエンドによって順番が変わらないように並べる
+	SortProxyPairs(proxyPairs);
+
+	collisionPairs.clear();
+	collisionPairs.reserve(proxyPairs.size());
+	for (const ProxyPair& pair : proxyPairs) {
+		Object3d* a = static_cast<Object3d*>(broadPhase->GetUserData(pair.a));
+		Object3d* b = static_cast<Object3d*>(broadPhase->GetUserData(pair.b));
+		if (!fastMovers.empty()) {
+			// 速いオブジェクトを含むペアは移動を囲むAABBで見つけたので、途中で本当に重なったかを調べる
+			const Entry& entryA = entries[proxyEntries[pair.a]];
+			const Entry& entryB = entries[proxyEntries[pair.b]];
+			Contact contact;
+			if ((entryA.isFastMover || entryB.isFastMover) && !CheckSweptPair(entryA, entryB, contact)) {
+				continue;
+			}
+		}
+		collisionPairs.push_back({ a, b });
+	}
+
+	// 動いたオブジェクトを含むペアだけナローフェーズをやり直して、接触の状態の変化を求める
+	contactCache.Update(proxyPairs.data(), proxyPairs.size(),
+		[this](ProxyHandle proxy) { return entries[proxyEntries[proxy]].isMoved; },
+		[this](ProxyHandle a, ProxyHandle b, Contact& contact) { return CollidePair(a, b, contact); });
+	ConvertEvents(contactCache.GetEnterEvents(), enterEvents);
+	ConvertEvents(contactCache.GetStayEvents(), stayEvents);
+	ConvertEvents(contactCache.GetExitEvents(), exitEvents);
+
+	BuildSceneBVH();
+
+	// 速いオブジェクトの移動をシーンの三角形に対して調べる(オブジェクトごとに独立しているので並列に処理する)
+	sweepResults.resize(fastMovers.size());
+	ThreadPool::GetInstance()->ParallelFor(fastMovers.size(), kFastMoversPerBatch, [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			SweepFastMover(entries[fastMovers[i]], sweepResults[i]);
+		}
+	});
+	sweepHits.clear();
+	for (const SweepHit& result : sweepResults) {
+		if (result.object) {
+			sweepHits.push_back(result);
+		}
+	}
+
+	// 次のフレームの移動の始まりとして覚えておく
+	for (Entry& entry : entries) {
+		entry.previousAABB = entry.object->GetAABB();
+		entry.previousCenter = entry.object->GetBoundingSphere().center;
+	}
+}
+
+void CollisionManager::AddObject(Object3d* object, bool isFastMover) {
+	assert(broadPhase);
+	assert(object);
+	assert(!HasObject(object));
+
+	const ProxyHandle proxy = broadPhase->CreateProxy(object->GetAABB(), object);
+	entryIndices[object] = entries.size();
+	SetProxyEntry(proxy, entries.size());
+	entries.push_back({ object, proxy, isFastMover, true, object->GetOBB(), object->GetAABB(), object->GetBoundingSphere().center, SceneBVH::kNoInstance, nullptr, MakeMatrix3x4(object->GetWorldMatrix()) });
+}
+
+void CollisionManager::SetFastMover(Object3d* object, bool isFastMover) {
+	auto it = entryIndices.find(object);
+	assert(it != entryIndices.end());
+	entries[it->second].isFastMover = isFastMover;
+}
+
+void CollisionManager::RemoveObject(Object3d* object) {
+	auto it = entryIndices.find(object);
+	if (it == entryIndices.end()) {
+		return;
+	}
+
+	const size_t index = it->second;
+	contactCache.Remove(entries[index].proxy);
+	broadPhase->DestroyProxy(entries[index].proxy);
+	// SceneBVHは次のUpdateで作り直すので、それまでクエリで当たらないように外すだけにする
+	if (entries[index].instance != SceneBVH::kNoInstance) {
+		sceneBVH.RemoveInstance(entries[index].instance);
+	}
+
+	// 末尾と入れ替えて消す
+	entries[index] = entries.back();
+	entryIndices[entries[index].object] = index;
+	proxyEntries[entries[index].proxy] = index;
+	entries.pop_back();
+	entryIndices.erase(object);
+
+	// 消したオブジェクトを含むペアを残さない
+	std::erase_if(collisionPairs, [object](const CollisionPair& pair) { return pair.a == object || pair.b == object; });
+	std::erase_if(sweepHits, [object](const SweepHit& hit) { return hit.object == object || hit.other == object; });
+	auto containsObject = [object](const CollisionEvent& event) { return event.a == object || event.b == object; };
+	std::erase_if(enterEvents, containsObject);
+	std::erase_if(stayEvents, containsObject);
+	std::erase_if(exitEvents, containsObject);
+}
+
+void CollisionManager::Query(const AABB& aabb, std::vector<Object3d*>& result) const {
+	assert(broadPhase);
+	result.clear();
+	broadPhase->Query(aabb, queryResult);
+	for (ProxyHandle proxy : queryResult) {
+		result.push_back(static_cast<Object3d*>(broadPhase->GetUserData(proxy)));
+	}
+}
+
+bool CollisionManager::Raycast(const Ray& ray, RaycastResult& result) const {
+	SceneHit sceneHit;
+	if (!sceneBVH.Raycast(ray, sceneHit)) {
+		return false;
+	}
+	result.object = static_cast<Object3d*>(sceneBVH.GetUserData(sceneHit.instance));
+	result.hit = sceneHit.hit;
+	return true;
+}
+
+bool CollisionManager::SphereCast(const Ray& ray, float radius, RaycastResult& result) const {
+	SceneHit sceneHit;
+	if (!sceneBVH.SphereCast(ray, radius, sceneHit)) {
+		return false;
+	}
+	result.object = static_cast<Object3d*>(sceneBVH.GetUserData(sceneHit.instance));
+	result.hit = sceneHit.hit;
+	return true;
+}
+
+void CollisionManager::BuildSceneBVH() {
+	sceneBVH.Clear();
+	for (Entry& entry : entries) {
+		entry.instance = SceneBVH::kNoInstance;
+		const Model* model = entry.object->GetModel();
+		if (!model || model->GetTriangleBVH().GetTriangleCount() == 0) {
+			continue;
+		}
+		const Matrix3x4 world = MakeMatrix3x4(entry.object->GetWorldMatrix());
+		// スケールが0のオブジェクトは逆行列が無いので入れない
+		const float determinant =
+			world.m[0][0] * (world.m[1][1] * world.m[2][2] - world.m[1][2] * world.m[2][1]) -
+			world.m[0][1] * (world.m[1][0] * world.m[2][2] - world.m[1][2] * world.m[2][0]) +
+			world.m[0][2] * (world.m[1][0] * world.m[2][1] - world.m[1][1] * world.m[2][0]);
+		if (determinant == 0.0f) {
+			continue;
+		}
+		entry.instance = sceneBVH.AddInstance(&model->GetTriangleBVH(), world, entry.object);
+	}
+	sceneBVH.Build();
+}
+
+bool CollisionManager::CheckSweptPair(const Entry& a, const Entry& b, Contact& contact) {
+	// bから見たaの移動で判定する(回転による大きさの変化は前のフレームのAABBのまま扱う)
+	const Vector3 displacementA = Center(a.object->GetAABB()) - Center(a.previousAABB);
+	const Vector3 displacementB = Center(b.object->GetAABB()) - Center(b.previousAABB);
+	const Vector3 displacement = displacementA - displacementB;
+	float toi;
+	Vector3 normal;
+	if (!SweepAABB(a.previousAABB, displacement, b.previousAABB, toi, normal)) {
+		return false;
+	}
+	// 当たったときのaの中心に最も近いbの点を接触点にする
+	const Vector3 center = Center(a.previousAABB) + displacement * toi;
+	contact.normal = -normal;
+	contact.depth = 0.0f;
+	contact.point = {
+		std::clamp(center.x, b.previousAABB.min.x, b.previousAABB.max.x),
+		std::clamp(center.y, b.previousAABB.min.y, b.previousAABB.max.y),
+		std::clamp(center.z, b.previousAABB.min.z, b.previousAABB.max.z)
+	};
+	return true;
+}
+
+bool CollisionManager::CollidePair(ProxyHandle a, ProxyHandle b, Contact& contact) const {
+	const Entry& entryA = entries[proxyEntries[a]];
+	const Entry& entryB = entries[proxyEntries[b]];
+	if (CollideShapes(entryA, entryB, contact)) {
+		return true;
+	}
+	// 今は離れていても、移動の途中で重なっていれば接触したことにする
+	return (entryA.isFastMover || entryB.isFastMover) && CheckSweptPair(entryA, entryB, contact);
+}
+
+bool CollisionManager::CollideShapes(const Entry& a, const Entry& b, Contact& contact) {
+	if (a.hull && b.hull) {
+		return CheckCollision(ConvexHullCollider{ a.hull, a.world }, ConvexHullCollider{ b.hull, b.world }, contact);
+	}
+	if (a.hull) {
+		return CheckCollision(ConvexHullCollider{ a.hull, a.world }, b.obb, contact);
+	}
+	if (b.hull) {
+		return CheckCollision(a.obb, ConvexHullCollider{ b.hull, b.world }, contact);
+	}
+	return CheckCollision(a.obb, b.obb, contact);
+}
+
+void CollisionManager::ConvertEvents(const std::vector<ContactEvent>& events, std::vector<CollisionEvent>& result) const {
+	result.clear();
+	result.reserve(events.size());
+	for (const ContactEvent& event : events) {
+		result.push_back({
+			static_cast<Object3d*>(broadPhase->GetUserData(event.pair.a)),
+			static_cast<Object3d*>(broadPhase->GetUserData(event.pair.b)),
+			event.contact
+		});
+	}
+}
+
+void CollisionManager::SetProxyEntry(ProxyHandle proxy, size_t index) {
+	if (static_cast<size_t>(proxy) >= proxyEntries.size()) {
+		proxyEntries.resize(proxy + 1);
+	}
+	proxyEntries[proxy] = index;
+}
+
+void CollisionManager::SweepFastMover(const Entry& entry, SweepHit& result) const {
+	result.object = nullptr;
+	const Sphere& sphere = entry.object->GetBoundingSphere();
+	const Vector3 displacement = sphere.center - entry.previousCenter;
+	const float length = Length(displacement);
+	if (length <= 0.0f) {
+		return;
+	}
+	// 自分のモデルには当てない
+	const Ray ray = { entry.previousCenter, displacement * (1.0f / length), length };
+	SceneHit hit;
+	if (!sceneBVH.SphereCast(ray, sphere.radius, hit, entry.instance)) {
+		return;
+	}
+	result.object = entry.object;
+	result.other = static_cast<Object3d*>(sceneBVH.GetUserData(hit.instance));
+	result.toi = hit.hit.distance / length;
+	result.position = ray.origin + ray.direction * hit.hit.distance;
+	result.normal = hit.hit.normal;
+}
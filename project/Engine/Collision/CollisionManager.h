@@ -4,7 +4,17 @@
 #include "Plane.h"
 #include "Sphere.h"
 #include "OBB.h"
+#include "BroadPhase.h"
+#include "NarrowPhase.h"
+#include "ConvexCollision.h"
+#include "ContinuousCollision.h"
+#include "ContactCache.h"
+#include "SceneBVH.h"
+#include "Ray.h"
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 
 //enum class CollisionType {
@@ -14,58 +24,189 @@
 //	Plat,
 //};
 
+class Object3d;
 
-//class CollisionManager {
-////private:
-////	// シングルトンパターンの適用
-////	static CollisionManager* instance;
-////
-////	// コンストラクタ、デストラクタの隠蔽
-////	CollisionManager() = default;
-////	~CollisionManager() = default;
-////	// コピーコンストラクタ、コピー代入演算子の封印
-////	CollisionManager(CollisionManager&) = delete;
-////	CollisionManager& operator=(CollisionManager&) = delete;
-//
-//public:
-//
-//	//static CollisionManager* GetInstance();
-//
-//	void Initialize();
-//
-//	void Update();
-//
-//	//void Finalize();
-//
-//	// 当たり判定の追加
-//	const bool& CheckCollision(const AABB& a, const AABB& b);
-//	const bool& CheckCollision(const AABB& a, const Sphere& b);
-//	//const bool& CheckCollision(const AABB& a, const OBB& b);
-//};
-//
-const bool& CollisionAABB(const AABB& a, const AABB& b) {
-	if ((a.min.x <= b.max.x && a.max.x >= b.min.x) &&
-		(a.min.y <= b.max.y && a.max.y >= b.min.y) &&
-		(a.min.z <= b.max.z && a.max.z >= b.min.z)) {
-		return true;
-	}
-	return false;
-}
-
-//const bool& CollisionAABBSphere(const AABB& target1, const Sphere& target2) {
-//	// 最近接点を求める
-//	Vector3 closestPoint{
-//		std::clamp(target2.center.x, target1.min.x, target1.max.x),
-//		std::clamp(target2.center.y, target1.min.y, target1.max.y),
-//		std::clamp(target2.center.z, target1.min.z, target1.max.z)
-//	};
-//	// 最近接点と球の中心との距離を求める
-//	float distance = Length(closestPoint - target2.center);
-//	// 距離が半径よりも小さければ衝突
-//	if (distance <= target2.radius)
-//	{
-//		return true;
-//	}
-//	return false;
-//}
+// 衝突しているオブジェクトのペア
+struct CollisionPair {
+	Object3d* a;
+	Object3d* b;
+};
+
+// レイ・スフィアキャストの結果
+struct RaycastResult {
+	Object3d* object;
+	RaycastHit hit;
+};
+
+// 接触の状態が変わったオブジェクトのペア
+struct CollisionEvent {
+	Object3d* a;
+	Object3d* b;
+	// aからbへ向かう法線とめり込み量(OBB同士の判定。Exitでは最後に接触していたときのもの)
+	Contact contact;
+};
+
+// 速いオブジェクトが1フレームの移動の間に最初に当たった結果
+struct SweepHit {
+	// 動いたオブジェクト
+	Object3d* object;
+	// 当たった相手
+	Object3d* other;
+	// 移動の割合(0で前のフレームの位置、1で今の位置)
+	float toi;
+	// 当たったときの境界球の中心
+	Vector3 position;
+	// 当たった面の法線
+	Vector3 normal;
+};
+
+// 登録されたObject3dのAABBをブロードフェーズで管理して、衝突しているペアを求める
+// モデルを持つオブジェクトはSceneBVHにも入れて、三角形に対するレイキャストができるようにする
+// 速いオブジェクト(弾など)は前のフレームからの移動をまとめて調べて、薄い壁のすり抜けを防ぐ
+// AABBが重なったペアはOBB同士で判定して、接触し始めた・し続けている・離れたペアをフレームごとに返す
+class CollisionManager {
+private:
+	// シングルトンパターンの適用
+	static CollisionManager* instance;
+
+	// コンストラクタ、デストラクタの隠蔽
+	CollisionManager() = default;
+	~CollisionManager() = default;
+	// コピーコンストラクタ、コピー代入演算子の封印
+	CollisionManager(CollisionManager&) = delete;
+	CollisionManager& operator=(CollisionManager&) = delete;
+
+public:
+	// インスタンスの取得
+	static CollisionManager* GetInstance();
+
+	// 終了処理
+	void Finalize();
+
+	// 初期化
+	void Initialize(BroadPhaseType type = BroadPhaseType::DynamicAABBTree);
+
+	// 登録されたオブジェクトのAABB(Object3d::Updateで更新したもの)を反映して、衝突ペアを求める
+	void Update();
+
+	// オブジェクトを登録する(オブジェクトを消す前にRemoveObjectを呼ぶこと)
+	// isFastMoverをtrueにすると連続的な当たり判定を行う(コストがかかるので速く動くものだけにする)
+	void AddObject(Object3d* object, bool isFastMover = false);
+
+	// 登録を解除する(すぐにクエリで当たらなくなる。SceneBVHは次のUpdateでまとめて作り直す)
+	void RemoveObject(Object3d* object);
+
+	// 登録されているか
+	bool HasObject(Object3d* object) const { return entryIndices.contains(object); }
+
+	// Setter(連続的な当たり判定を行うか)
+	void SetFastMover(Object3d* object, bool isFastMover);
+
+	// aabbと重なっているオブジェクトを求める(resultは上書きする)
+	void Query(const AABB& aabb, std::vector<Object3d*>& result) const;
+
+	// 登録されたオブジェクトのモデルにレイを飛ばして、一番近い当たりを求める(直前のUpdateの位置で調べる)
+	bool Raycast(const Ray& ray, RaycastResult& result) const;
+
+	// 登録されたオブジェクトのモデルに球を飛ばして、最初に当たる位置を求める
+	bool SphereCast(const Ray& ray, float radius, RaycastResult& result) const;
+
+	// Getter(SceneBVH。まとめてレイを飛ばす場合や重なりを調べる場合に使う。ユーザーデータはObject3d*)
+	const SceneBVH& GetSceneBVH() const { return sceneBVH; }
+
+	// Getter(直前のUpdateで求めた衝突ペア。ハンドル順に並べてあるので毎フレーム同じ順になる)
+	// 速いオブジェクトを含むペアは、移動の途中で重なったものも入る
+	const std::vector<CollisionPair>& GetCollisionPairs() const { return collisionPairs; }
+
+	// Getter(直前のUpdateで速いオブジェクトがモデルの三角形に最初に当たった結果。1つのオブジェクトにつき1つまで)
+	const std::vector<SweepHit>& GetSweepHits() const { return sweepHits; }
+
+	// Getter(直前のUpdateで接触し始めたペア)
+	const std::vector<CollisionEvent>& GetEnterEvents() const { return enterEvents; }
+	// Getter(直前のUpdateで接触し続けているペア)
+	const std::vector<CollisionEvent>& GetStayEvents() const { return stayEvents; }
+	// Getter(直前のUpdateで離れたペア。消したオブジェクトのペアは入らない)
+	const std::vector<CollisionEvent>& GetExitEvents() const { return exitEvents; }
+
+	// Getter(直前のUpdateでOBB同士の判定を行ったペアの数。動いていないペアは前のフレームの結果を使う)
+	size_t GetNarrowPhaseCount() const { return contactCache.GetNarrowPhaseCount(); }
+
+	// Getter(BroadPhase)
+	BroadPhase* GetBroadPhase() const { return broadPhase.get(); }
+
+	// Getter(BroadPhaseの種類)
+	BroadPhaseType GetBroadPhaseType() const { return broadPhaseType; }
+
+	// Setter(BroadPhaseの種類。登録済みのオブジェクトは新しいBroadPhaseに移す)
+	void SetBroadPhaseType(BroadPhaseType type);
+
+private:
+	// 登録されたオブジェクトのワールド行列でSceneBVHを作り直す
+	void BuildSceneBVH();
+
+	struct Entry;
+
+	// 速いオブジェクトを含むペアが移動の途中で重なったか(contactには当たったときの向きを書く)
+	static bool CheckSweptPair(const Entry& a, const Entry& b, Contact& contact);
+
+	// ナローフェーズ(モデルに凸包があれば凸包、無ければOBBで調べる。速いオブジェクトを含むペアは移動の途中も調べる)
+	bool CollidePair(ProxyHandle a, ProxyHandle b, Contact& contact) const;
+
+	// 今の形状同士の当たり判定
+	static bool CollideShapes(const Entry& a, const Entry& b, Contact& contact);
+
+	// ContactCacheのイベントをオブジェクトのペアに直す
+	void ConvertEvents(const std::vector<ContactEvent>& events, std::vector<CollisionEvent>& result) const;
+
+	// プロキシのハンドルからentriesの番号を引けるようにする
+	void SetProxyEntry(ProxyHandle proxy, size_t index);
+
+	// 速いオブジェクトの前のフレームからの移動で、境界球をシーンに飛ばす
+	void SweepFastMover(const Entry& entry, SweepHit& result) const;
+
+private:
+	// 登録されたオブジェクト
+	struct Entry {
+		Object3d* object;
+		ProxyHandle proxy;
+		bool isFastMover;
+		// 前のフレームから形状が変わったか
+		bool isMoved;
+		// 前のUpdateでのOBB(動いたかを調べる)
+		OBB obb;
+		// 前のフレームのAABBと境界球の中心
+		AABB previousAABB;
+		Vector3 previousCenter;
+		// SceneBVHのインスタンスの番号(モデルが無ければkNoInstance)
+		uint32_t instance;
+		// モデルの凸包(無ければnullptr)とワールド行列
+		const ConvexHull* hull;
+		Matrix3x4 world;
+	};
+
+	std::unique_ptr<BroadPhase> broadPhase;
+	BroadPhaseType broadPhaseType = BroadPhaseType::DynamicAABBTree;
+
+	std::vector<Entry> entries;
+	// オブジェクトからentriesの番号を引く
+	std::unordered_map<Object3d*, size_t> entryIndices;
+	// プロキシのハンドルからentriesの番号を引く
+	std::vector<size_t> proxyEntries;
+
+	std::vector<ProxyPair> proxyPairs;
+	std::vector<CollisionPair> collisionPairs;
+	mutable std::vector<ProxyHandle> queryResult;
+
+	SceneBVH sceneBVH;
+
+	// 速いオブジェクトのentriesの番号
+	std::vector<size_t> fastMovers;
+	// fastMoversごとの結果(当たらなければobjectがnullptr)
+	std::vector<SweepHit> sweepResults;
+	std::vector<SweepHit> sweepHits;
 
+	ContactCache contactCache;
+	std::vector<CollisionEvent> enterEvents;
+	std::vector<CollisionEvent> stayEvents;
+	std::vector<CollisionEvent> exitEvents;
+};
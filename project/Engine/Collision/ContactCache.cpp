@@ -0,0 +1,38 @@
+#include "ContactCache.h"
+#include "kMath.h"
+
+void ContactCache::Remove(ProxyHandle proxy) {
+	auto contains = [proxy](const ProxyPair& pair) { return pair.a == proxy || pair.b == proxy; };
+	std::erase_if(contacts, [&](const CachedContact& contact) { return contains(contact.pair); });
+	std::erase_if(enterEvents, [&](const ContactEvent& event) { return contains(event.pair); });
+	std::erase_if(stayEvents, [&](const ContactEvent& event) { return contains(event.pair); });
+	std::erase_if(exitEvents, [&](const ContactEvent& event) { return contains(event.pair); });
+}
+
+void ContactCache::Remap(const std::vector<ProxyHandle>& newHandles) {
+	for (CachedContact& contact : contacts) {
+		contact.pair.a = newHandles[contact.pair.a];
+		contact.pair.b = newHandles[contact.pair.b];
+		// a < bを保つ(入れ替えたら法線も逆にする)
+		if (contact.pair.b < contact.pair.a) {
+			std::swap(contact.pair.a, contact.pair.b);
+			contact.contact.normal = -contact.contact.normal;
+		}
+	}
+	std::sort(contacts.begin(), contacts.end(), [](const CachedContact& lhs, const CachedContact& rhs) { return lhs.pair < rhs.pair; });
+	// 古いハンドルのイベントは残さない
+	enterEvents.clear();
+	stayEvents.clear();
+	exitEvents.clear();
+}
+
+void ContactCache::Clear() {
+	contacts.clear();
+	nextContacts.clear();
+	wasTouching.clear();
+	dirtyContacts.clear();
+	enterEvents.clear();
+	stayEvents.clear();
+	exitEvents.clear();
+	narrowPhaseCount = 0;
+}
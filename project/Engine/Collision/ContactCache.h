@@ -0,0 +1,137 @@
+#pragma once
+#include "BroadPhase.h"
+#include "NarrowPhase.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// 接触の状態が変わったペア
+struct ContactEvent {
+	ProxyPair pair;
+	// 接触情報(Exitでは最後に接触していたときのもの)
+	Contact contact;
+};
+
+// フレームをまたいでペアの接触状態を覚えておき、Enter/Stay/Exitのイベントを作る
+// ブロードフェーズのペアはハンドル順に並べて渡すので、キャッシュも同じ順の配列にして前のフレームと突き合わせる
+// どちらのプロキシも動いていないペアはナローフェーズをやり直さずに前のフレームの結果を使う
+// ナローフェーズはペアごとに独立しているので並列に行い、イベントはペアの順に作る(スレッド数によらず同じ順番になる)
+class ContactCache {
+public:
+	// 1フレーム分のペアで更新する(pairsはハンドル順に並べてあること)
+	// isMoved(ProxyHandle)は前のフレームから形状が変わったか、collide(ProxyHandle a, ProxyHandle b, Contact&)はナローフェーズ
+	// collideは並列に呼ばれるので、共有する状態を書き換えないこと
+	template<typename IsMoved, typename Collide>
+	void Update(const ProxyPair* pairs, size_t count, IsMoved&& isMoved, Collide&& collide) {
+		assert(std::is_sorted(pairs, pairs + count));
+		enterEvents.clear();
+		stayEvents.clear();
+		exitEvents.clear();
+		nextContacts.clear();
+		wasTouching.clear();
+		dirtyContacts.clear();
+
+		// 前のフレームと突き合わせて、ナローフェーズをやり直すペアを集める
+		size_t cached = 0;
+		for (size_t i = 0; i < count; i++) {
+			const ProxyPair& pair = pairs[i];
+			// 今のフレームで無くなったペア
+			while (cached < contacts.size() && contacts[cached].pair < pair) {
+				Exit(contacts[cached++]);
+			}
+
+			CachedContact current = { pair, {}, false };
+			bool isCached = false;
+			if (cached < contacts.size() && contacts[cached].pair == pair) {
+				current = contacts[cached++];
+				isCached = true;
+			}
+			wasTouching.push_back(current.isTouching);
+			if (!isCached || isMoved(pair.a) || isMoved(pair.b)) {
+				dirtyContacts.push_back(nextContacts.size());
+			}
+			// 離れていてもブロードフェーズのペアであるうちは、次のフレームで動かなければ判定を省けるように残す
+			nextContacts.push_back(current);
+		}
+		while (cached < contacts.size()) {
+			Exit(contacts[cached++]);
+		}
+		narrowPhaseCount = dirtyContacts.size();
+
+		// ナローフェーズ
+		ThreadPool::GetInstance()->ParallelFor(dirtyContacts.size(), kContactsPerBatch, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				CachedContact& current = nextContacts[dirtyContacts[i]];
+				current.isTouching = collide(current.pair.a, current.pair.b, current.contact);
+			}
+		});
+
+		// ペアの順にイベントを作る
+		for (size_t i = 0; i < nextContacts.size(); i++) {
+			const CachedContact& current = nextContacts[i];
+			if (current.isTouching) {
+				(wasTouching[i] ? stayEvents : enterEvents).push_back({ current.pair, current.contact });
+			} else if (wasTouching[i]) {
+				exitEvents.push_back({ current.pair, current.contact });
+			}
+		}
+		// 無くなったペアと離れたペアが混ざらないようにペアの順にそろえる
+		std::sort(exitEvents.begin(), exitEvents.end(), [](const ContactEvent& lhs, const ContactEvent& rhs) { return lhs.pair < rhs.pair; });
+		contacts.swap(nextContacts);
+	}
+
+	// プロキシを含むペアを消す(プロキシを消す前に呼ぶ。ハンドルが使い回されても前の状態を引き継がないようにする)
+	void Remove(ProxyHandle proxy);
+
+	// プロキシのハンドルを付け替える(ブロードフェーズを作り直したとき。newHandles[古いハンドル] = 新しいハンドル)
+	void Remap(const std::vector<ProxyHandle>& newHandles);
+
+	// 全て消す
+	void Clear();
+
+	// Getter(直前のUpdateで接触し始めたペア)
+	const std::vector<ContactEvent>& GetEnterEvents() const { return enterEvents; }
+	// Getter(直前のUpdateで接触し続けているペア)
+	const std::vector<ContactEvent>& GetStayEvents() const { return stayEvents; }
+	// Getter(直前のUpdateで離れたペア)
+	const std::vector<ContactEvent>& GetExitEvents() const { return exitEvents; }
+
+	// Getter(直前のUpdateでナローフェーズを行ったペアの数)
+	size_t GetNarrowPhaseCount() const { return narrowPhaseCount; }
+
+	// Getter(覚えているペアの数)
+	size_t GetPairCount() const { return contacts.size(); }
+
+private:
+	// 1回の並列処理でまとめてナローフェーズを行うペアの数
+	static constexpr size_t kContactsPerBatch = 256;
+
+	struct CachedContact {
+		ProxyPair pair;
+		Contact contact;
+		bool isTouching;
+	};
+
+	// ブロードフェーズのペアから外れたペア
+	void Exit(const CachedContact& contact) {
+		if (contact.isTouching) {
+			exitEvents.push_back({ contact.pair, contact.contact });
+		}
+	}
+
+private:
+	// ハンドル順に並べたペア
+	std::vector<CachedContact> contacts;
+	std::vector<CachedContact> nextContacts;
+	// nextContactsごとの前のフレームの状態と、ナローフェーズをやり直すnextContactsの番号
+	std::vector<bool> wasTouching;
+	std::vector<size_t> dirtyContacts;
+
+	std::vector<ContactEvent> enterEvents;
+	std::vector<ContactEvent> stayEvents;
+	std::vector<ContactEvent> exitEvents;
+
+	size_t narrowPhaseCount = 0;
+};
@@ -0,0 +1,162 @@
+#include "ContinuousCollision.h"
+#include "NarrowPhase.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 保守的前進法の最大の繰り返し回数
+constexpr int kMaxAdvanceIterations = 32;
+// 距離がこの割合(半径 + 移動量に対する)より近くなったら当たったとみなす
+constexpr float kAdvanceToleranceRate = 1.0e-4f;
+// 移動量の成分がこれより小さければ0とみなす
+constexpr float kMinDisplacement = 1.0e-12f;
+
+float GetAxis(const Vector3& v, int axis) {
+	return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+Vector3 UnitAxis(int axis) {
+	return axis == 0 ? Vector3{ 1.0f, 0.0f, 0.0f } : axis == 1 ? Vector3{ 0.0f, 1.0f, 0.0f } : Vector3{ 0.0f, 0.0f, 1.0f };
+}
+
+// 始めから重なっている場合の法線(動く向きと逆にする)
+Vector3 BackwardNormal(const Vector3& displacement) {
+	const float lengthSq = Dot(displacement, displacement);
+	return lengthSq > 0.0f ? displacement * (-1.0f / std::sqrt(lengthSq)) : Vector3{ 0.0f, 1.0f, 0.0f };
+}
+
+// 原点を中心とする大きさhalfの箱と動く球の保守的前進法
+// 凸な形状までの距離は移動の割合に対して下に凸なので、接線の根まで進めても当たる時刻を越えない(ニュートン法で速く収束する)
+bool AdvanceLocalBoxSphere(const Vector3& half, const Vector3& center, float radius, const Vector3& displacement, float& toi, Vector3& normal) {
+	const float tolerance = kAdvanceToleranceRate * (radius + Length(displacement));
+	float t = 0.0f;
+	for (int i = 0; i < kMaxAdvanceIterations; i++) {
+		const Vector3 position = center + displacement * t;
+		const Vector3 closest{
+			std::clamp(position.x, -half.x, half.x),
+			std::clamp(position.y, -half.y, half.y),
+			std::clamp(position.z, -half.z, half.z)
+		};
+		const Vector3 offset = position - closest;
+		const float distance = Length(offset);
+		if (distance <= radius + tolerance) {
+			toi = t;
+			normal = distance > 0.0f ? offset * (1.0f / distance) : BackwardNormal(displacement);
+			return true;
+		}
+		// 距離が縮む速さ。離れていく向きならこれ以上近づかない
+		const Vector3 direction = offset * (1.0f / distance);
+		const float approach = -Dot(displacement, direction);
+		if (approach <= 0.0f) {
+			return false;
+		}
+		t += (distance - radius) / approach;
+		if (t > 1.0f) {
+			return false;
+		}
+		normal = direction;
+	}
+	// 収束しなかった場合も、ここまでは当たっていないことが分かっているので止まる位置として返す
+	toi = t;
+	return true;
+}
+
+} // namespace
+
+bool SweepAABB(const AABB& a, const Vector3& displacement, const AABB& b, float& toi, Vector3& normal) {
+	if (CollisionAABB(a, b)) {
+		Contact contact;
+		CheckCollision(a, b, contact);
+		toi = 0.0f;
+		normal = -contact.normal;
+		return true;
+	}
+
+	// bをaの大きさだけ広げて、aの中心から出したレイとして判定する
+	const Vector3 half = (a.max - a.min) * 0.5f;
+	const Vector3 center = (a.min + a.max) * 0.5f;
+	float enter = 0.0f;
+	float exit = 1.0f;
+	int enterAxis = -1;
+	for (int axis = 0; axis < 3; axis++) {
+		const float origin = GetAxis(center, axis);
+		const float lower = GetAxis(b.min, axis) - GetAxis(half, axis);
+		const float upper = GetAxis(b.max, axis) + GetAxis(half, axis);
+		const float d = GetAxis(displacement, axis);
+		if (std::fabs(d) < kMinDisplacement) {
+			if (origin < lower || origin > upper) {
+				return false;
+			}
+			continue;
+		}
+		float t0 = (lower - origin) / d;
+		float t1 = (upper - origin) / d;
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		if (t0 > enter) {
+			enter = t0;
+			enterAxis = axis;
+		}
+		exit = std::min(exit, t1);
+		if (enter > exit) {
+			return false;
+		}
+	}
+	if (enterAxis < 0) {
+		return false;
+	}
+	toi = enter;
+	normal = UnitAxis(enterAxis) * (GetAxis(displacement, enterAxis) > 0.0f ? -1.0f : 1.0f);
+	return true;
+}
+
+bool SweepSphere(const Sphere& a, const Vector3& displacement, const Sphere& b, float& toi, Vector3& normal) {
+	// |m + d * t| = rを解く
+	const Vector3 m = a.center - b.center;
+	const float radius = a.radius + b.radius;
+	const float c = Dot(m, m) - radius * radius;
+	if (c <= 0.0f) {
+		toi = 0.0f;
+		const float lengthSq = Dot(m, m);
+		normal = lengthSq > 0.0f ? m * (1.0f / std::sqrt(lengthSq)) : BackwardNormal(displacement);
+		return true;
+	}
+	const float dd = Dot(displacement, displacement);
+	const float md = Dot(m, displacement);
+	if (dd <= 0.0f || md >= 0.0f) {
+		return false;
+	}
+	const float discriminant = md * md - dd * c;
+	if (discriminant < 0.0f) {
+		return false;
+	}
+	const float t = (-md - std::sqrt(discriminant)) / dd;
+	if (t > 1.0f) {
+		return false;
+	}
+	toi = t;
+	normal = Normalize(m + displacement * t);
+	return true;
+}
+
+bool SweepSphere(const Sphere& a, const Vector3& displacement, const AABB& b, float& toi, Vector3& normal) {
+	const Vector3 center = (b.min + b.max) * 0.5f;
+	const Vector3 half = (b.max - b.min) * 0.5f;
+	return AdvanceLocalBoxSphere(half, a.center - center, a.radius, displacement, toi, normal);
+}
+
+bool SweepSphere(const Sphere& a, const Vector3& displacement, const OBB& b, float& toi, Vector3& normal) {
+	// OBBのローカル座標で判定してから法線を戻す
+	const Vector3 d = a.center - b.center;
+	const Vector3 localCenter{ Dot(d, b.orientation[0]), Dot(d, b.orientation[1]), Dot(d, b.orientation[2]) };
+	const Vector3 localDisplacement{ Dot(displacement, b.orientation[0]), Dot(displacement, b.orientation[1]), Dot(displacement, b.orientation[2]) };
+	Vector3 localNormal;
+	if (!AdvanceLocalBoxSphere(b.size, localCenter, a.radius, localDisplacement, toi, localNormal)) {
+		return false;
+	}
+	normal = b.orientation[0] * localNormal.x + b.orientation[1] * localNormal.y + b.orientation[2] * localNormal.z;
+	return true;
+}
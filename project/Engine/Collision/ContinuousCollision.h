@@ -0,0 +1,22 @@
+#pragma once
+#include "AABB.h"
+#include "Sphere.h"
+#include "OBB.h"
+#include "Vector3.h"
+
+// 連続的な当たり判定(1フレームの移動量displacementの間に最初に当たる時刻を求める)
+// toiは移動の割合(0で移動前、1で移動後)。始めから重なっていれば0
+// normalは当たった面の法線(相手から動く側へ向かう向き)
+// 相手も動いている場合はdisplacementに相対的な移動量(自分の移動量 - 相手の移動量)を渡す
+
+// 動くAABBと止まっているAABB
+bool SweepAABB(const AABB& a, const Vector3& displacement, const AABB& b, float& toi, Vector3& normal);
+
+// 動く球と止まっている球
+bool SweepSphere(const Sphere& a, const Vector3& displacement, const Sphere& b, float& toi, Vector3& normal);
+
+// 動く球と止まっているAABB(保守的前進法)
+bool SweepSphere(const Sphere& a, const Vector3& displacement, const AABB& b, float& toi, Vector3& normal);
+
+// 動く球と止まっているOBB(保守的前進法)
+bool SweepSphere(const Sphere& a, const Vector3& displacement, const OBB& b, float& toi, Vector3& normal);
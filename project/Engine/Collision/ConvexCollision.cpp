@@ -0,0 +1,588 @@
+#include "ConvexCollision.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+#include <utility>
+
+namespace {
+
+// GJKの最大の繰り返し回数
+constexpr int kMaxGJKIterations = 64;
+// GJKで距離の2乗がこれ以上(距離の2乗と、形状の大きさの2乗に対する割合)縮まなければ収束したとみなす
+// floatの誤差で新しい点が単体と同じ平面に乗ったまま行き来しないよう、大きさに対する分も入れておく
+constexpr float kGJKTolerance = 1.0e-5f;
+constexpr float kGJKScaleTolerance = 1.0e-6f;
+// 距離の2乗がこれより(形状の大きさの2乗に対する割合)小さければ重なっているとみなす
+constexpr float kOverlapTolerance = 1.0e-10f;
+// EPAの最大の繰り返し回数と、多面体の頂点・面・穴の縁の辺の数(1回に面は2枚ずつ増える。判定ごとに確保しないよう固定の配列に置く)
+constexpr int kMaxEPAIterations = 64;
+constexpr size_t kMaxEPAVertices = 4 + kMaxEPAIterations;
+constexpr size_t kMaxEPAFaces = 4 + 2 * kMaxEPAIterations;
+constexpr size_t kMaxEPAEdges = kMaxEPAFaces;
+// EPAで面がこれ以上(形状の大きさに対する割合)広がらなければ収束したとみなす
+constexpr float kEPATolerance = 1.0e-4f;
+
+// ミンコフスキー差(A - B)の点と、それを作ったA, Bの点
+struct SupportPoint {
+	Vector3 w;
+	Vector3 a;
+	Vector3 b;
+};
+
+// 凸包のサポート写像(向きをローカル座標に戻して一番遠い頂点を求め、ワールド座標に移す)
+struct HullSupport {
+	const ConvexHull* hull;
+	const Matrix3x4* world;
+
+	Vector3 operator()(const Vector3& direction) const {
+		const float (&m)[3][4] = world->m;
+		const Vector3 local{
+			m[0][0] * direction.x + m[1][0] * direction.y + m[2][0] * direction.z,
+			m[0][1] * direction.x + m[1][1] * direction.y + m[2][1] * direction.z,
+			m[0][2] * direction.x + m[1][2] * direction.y + m[2][2] * direction.z
+		};
+		return MatrixTransform(hull->GetSupport(local), *world);
+	}
+
+	// 内側の点(最初の探索の向きに使う)
+	Vector3 GetCenter() const {
+		const AABB& bounds = hull->GetBounds();
+		return MatrixTransform((bounds.min + bounds.max) * 0.5f, *world);
+	}
+};
+
+// 点(球の中心)のサポート写像
+struct PointSupport {
+	Vector3 point;
+
+	Vector3 operator()(const Vector3&) const { return point; }
+	Vector3 GetCenter() const { return point; }
+};
+
+// 箱(AABB, OBB)のサポート写像
+struct BoxSupport {
+	Vector3 center;
+	Vector3 axes[3];
+	Vector3 half;
+
+	Vector3 operator()(const Vector3& direction) const {
+		return center +
+			axes[0] * (Dot(direction, axes[0]) >= 0.0f ? half.x : -half.x) +
+			axes[1] * (Dot(direction, axes[1]) >= 0.0f ? half.y : -half.y) +
+			axes[2] * (Dot(direction, axes[2]) >= 0.0f ? half.z : -half.z);
+	}
+	Vector3 GetCenter() const { return center; }
+};
+
+HullSupport MakeSupport(const ConvexHullCollider& collider) {
+	assert(collider.hull && collider.hull->IsValid());
+	return HullSupport{ collider.hull, &collider.world };
+}
+
+BoxSupport MakeSupport(const AABB& aabb) {
+	return BoxSupport{ (aabb.min + aabb.max) * 0.5f, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, (aabb.max - aabb.min) * 0.5f };
+}
+
+BoxSupport MakeSupport(const OBB& obb) {
+	return BoxSupport{ obb.center, { obb.orientation[0], obb.orientation[1], obb.orientation[2] }, obb.size };
+}
+
+// 2つの形状のミンコフスキー差のサポート写像
+template<typename SupportA, typename SupportB>
+SupportPoint Support(const SupportA& supportA, const SupportB& supportB, const Vector3& direction) {
+	const Vector3 a = supportA(direction);
+	const Vector3 b = supportB(-direction);
+	return SupportPoint{ a - b, a, b };
+}
+
+// GJKの単体(1〜4点)
+struct Simplex {
+	SupportPoint points[4];
+	float weights[4];
+	int count = 0;
+
+	// 残す点を選び直す
+	void Keep(std::initializer_list<int> indices, std::initializer_list<float> newWeights) {
+		SupportPoint kept[4];
+		int i = 0;
+		for (int index : indices) {
+			kept[i++] = points[index];
+		}
+		i = 0;
+		for (float weight : newWeights) {
+			weights[i++] = weight;
+		}
+		count = static_cast<int>(indices.size());
+		std::copy(kept, kept + count, points);
+	}
+
+	// 重みから形状ごとの点を求める
+	void GetClosestPoints(Vector3& pointA, Vector3& pointB) const {
+		pointA = { 0.0f, 0.0f, 0.0f };
+		pointB = { 0.0f, 0.0f, 0.0f };
+		for (int i = 0; i < count; i++) {
+			pointA += points[i].a * weights[i];
+			pointB += points[i].b * weights[i];
+		}
+	}
+};
+
+// 三角形abc上の原点に最も近い点を求め、その点を含む部分(頂点・辺・面)だけを単体に残す
+Vector3 SolveTriangle(Simplex& simplex, int ia, int ib, int ic) {
+	const Vector3 a = simplex.points[ia].w;
+	const Vector3 b = simplex.points[ib].w;
+	const Vector3 c = simplex.points[ic].w;
+	const Vector3 ab = b - a;
+	const Vector3 ac = c - a;
+	const float d1 = -Dot(ab, a);
+	const float d2 = -Dot(ac, a);
+	if (d1 <= 0.0f && d2 <= 0.0f) {
+		simplex.Keep({ ia }, { 1.0f });
+		return a;
+	}
+	const float d3 = -Dot(ab, b);
+	const float d4 = -Dot(ac, b);
+	if (d3 >= 0.0f && d4 <= d3) {
+		simplex.Keep({ ib }, { 1.0f });
+		return b;
+	}
+	const float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+		const float t = d1 / (d1 - d3);
+		simplex.Keep({ ia, ib }, { 1.0f - t, t });
+		return a + ab * t;
+	}
+	const float d5 = -Dot(ab, c);
+	const float d6 = -Dot(ac, c);
+	if (d6 >= 0.0f && d5 <= d6) {
+		simplex.Keep({ ic }, { 1.0f });
+		return c;
+	}
+	const float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+		const float t = d2 / (d2 - d6);
+		simplex.Keep({ ia, ic }, { 1.0f - t, t });
+		return a + ac * t;
+	}
+	const float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+		const float t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		simplex.Keep({ ib, ic }, { 1.0f - t, t });
+		return b + (c - b) * t;
+	}
+	const float sum = va + vb + vc;
+	if (sum <= 0.0f) {
+		// 潰れた三角形は一番近い辺にする
+		simplex.Keep({ ia, ib }, { 1.0f, 0.0f });
+		return a;
+	}
+	const float v = vb / sum;
+	const float w = vc / sum;
+	simplex.Keep({ ia, ib, ic }, { 1.0f - v - w, v, w });
+	return a + ab * v + ac * w;
+}
+
+// 単体上の原点に最も近い点を求める。四面体の中に原点があればfalse
+bool SolveSimplex(Simplex& simplex, Vector3& closest) {
+	switch (simplex.count) {
+	case 1:
+		simplex.weights[0] = 1.0f;
+		closest = simplex.points[0].w;
+		return true;
+	case 2: {
+		const Vector3 a = simplex.points[0].w;
+		const Vector3 ab = simplex.points[1].w - a;
+		const float lengthSq = Dot(ab, ab);
+		const float t = lengthSq > 0.0f ? std::clamp(-Dot(a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+		if (t <= 0.0f) {
+			simplex.Keep({ 0 }, { 1.0f });
+		} else if (t >= 1.0f) {
+			simplex.Keep({ 1 }, { 1.0f });
+		} else {
+			simplex.Keep({ 0, 1 }, { 1.0f - t, t });
+		}
+		closest = a + ab * t;
+		return true;
+	}
+	case 3:
+		closest = SolveTriangle(simplex, 0, 1, 2);
+		return true;
+	default: {
+		// 原点が外側にある面の中で一番近いもの
+		static const int kFaces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+		bool isOutside = false;
+		float bestDistanceSq = 0.0f;
+		Simplex best;
+		for (const int (&face)[4] : kFaces) {
+			const Vector3 a = simplex.points[face[0]].w;
+			const Vector3 normal = Cross(simplex.points[face[1]].w - a, simplex.points[face[2]].w - a);
+			const float originSide = -Dot(normal, a);
+			const float otherSide = Dot(normal, simplex.points[face[3]].w - a);
+			if (originSide * otherSide > 0.0f) {
+				continue;
+			}
+			Simplex candidate = simplex;
+			const Vector3 point = SolveTriangle(candidate, face[0], face[1], face[2]);
+			const float distanceSq = Dot(point, point);
+			if (!isOutside || distanceSq < bestDistanceSq) {
+				isOutside = true;
+				bestDistanceSq = distanceSq;
+				best = candidate;
+				closest = point;
+			}
+		}
+		if (!isOutside) {
+			return false;
+		}
+		simplex = best;
+		return true;
+	}
+	}
+}
+
+// GJK。離れていればtrueを返し、simplexに最も近い点を作った単体、closestに原点に最も近い点(A - B)を書く
+// separation > 0なら、距離がそれより大きいと分かった時点で打ち切る(closestは途中のもの)
+template<typename SupportA, typename SupportB>
+bool RunGJK(const SupportA& supportA, const SupportB& supportB, float separation, Simplex& simplex, Vector3& closest, float& scaleSq) {
+	closest = supportA.GetCenter() - supportB.GetCenter();
+	if (Dot(closest, closest) == 0.0f) {
+		closest = { 1.0f, 0.0f, 0.0f };
+	}
+	simplex.count = 0;
+	scaleSq = 0.0f;
+	for (int iteration = 0; iteration < kMaxGJKIterations; iteration++) {
+		const SupportPoint point = Support(supportA, supportB, -closest);
+		scaleSq = std::max(scaleSq, Dot(point.w, point.w));
+		const float distanceSq = Dot(closest, closest);
+		const float progress = Dot(closest, point.w);
+		if (simplex.count > 0) {
+			// 分離軸が見つかった
+			if (separation > 0.0f && progress > separation * std::sqrt(distanceSq)) {
+				return true;
+			}
+			// これ以上近づかない(新しい点が原点の向こう側にあれば、重なっているかもしれないので続ける)
+			if (progress > 0.0f && distanceSq - progress <= kGJKTolerance * distanceSq + kGJKScaleTolerance * scaleSq) {
+				return true;
+			}
+			bool isDuplicate = false;
+			for (int i = 0; i < simplex.count; i++) {
+				isDuplicate |= simplex.points[i].w.x == point.w.x && simplex.points[i].w.y == point.w.y && simplex.points[i].w.z == point.w.z;
+			}
+			if (isDuplicate) {
+				return progress > 0.0f;
+			}
+		}
+		const Simplex previous = simplex;
+		const Vector3 previousClosest = closest;
+		simplex.points[simplex.count++] = point;
+		if (!SolveSimplex(simplex, closest)) {
+			return false;
+		}
+		// 誤差で近づかなくなったら1つ前の単体で終わる(同じ単体を行き来しないように)
+		if (previous.count > 0 && Dot(closest, closest) >= distanceSq) {
+			simplex = previous;
+			closest = previousClosest;
+			return progress > 0.0f;
+		}
+		if (Dot(closest, closest) <= kOverlapTolerance * scaleSq) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// EPAの面(外向きの法線と原点からの距離)
+struct PolytopeFace {
+	uint32_t vertices[3];
+	Vector3 normal;
+	float distance;
+};
+
+// 面を作る(a, b, cの順に反時計回りに見える側が表)。潰れていればfalse
+bool MakePolytopeFace(const SupportPoint* points, uint32_t a, uint32_t b, uint32_t c, PolytopeFace& face) {
+	const Vector3 normal = Cross(points[b].w - points[a].w, points[c].w - points[a].w);
+	const float length = Length(normal);
+	if (length <= 0.0f) {
+		return false;
+	}
+	face.vertices[0] = a;
+	face.vertices[1] = b;
+	face.vertices[2] = c;
+	face.normal = normal * (1.0f / length);
+	face.distance = Dot(face.normal, points[a].w);
+	return true;
+}
+
+// GJKで重なっていると分かった単体を四面体まで広げる。広げられなければfalse
+template<typename SupportA, typename SupportB>
+bool ExpandToTetrahedron(const SupportA& supportA, const SupportB& supportB, Simplex& simplex, float toleranceSq) {
+	static const Vector3 kAxes[6] = { { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } };
+	if (simplex.count == 1) {
+		for (const Vector3& axis : kAxes) {
+			const SupportPoint point = Support(supportA, supportB, axis);
+			const Vector3 offset = point.w - simplex.points[0].w;
+			if (Dot(offset, offset) > toleranceSq) {
+				simplex.points[simplex.count++] = point;
+				break;
+			}
+		}
+	}
+	if (simplex.count == 2) {
+		const Vector3 line = simplex.points[1].w - simplex.points[0].w;
+		const Vector3 axis = std::fabs(line.x) < std::fabs(line.y) ? (std::fabs(line.x) < std::fabs(line.z) ? kAxes[0] : kAxes[4]) : (std::fabs(line.y) < std::fabs(line.z) ? kAxes[2] : kAxes[4]);
+		const Vector3 perpendicular0 = Cross(line, axis);
+		const Vector3 perpendicular1 = Cross(line, perpendicular0);
+		for (const Vector3& direction : { perpendicular0, -perpendicular0, perpendicular1, -perpendicular1 }) {
+			const SupportPoint point = Support(supportA, supportB, direction);
+			const Vector3 offset = Cross(point.w - simplex.points[0].w, line);
+			if (Dot(offset, offset) > toleranceSq * Dot(line, line)) {
+				simplex.points[simplex.count++] = point;
+				break;
+			}
+		}
+	}
+	if (simplex.count == 3) {
+		const Vector3 normal = Normalize(Cross(simplex.points[1].w - simplex.points[0].w, simplex.points[2].w - simplex.points[0].w));
+		for (const Vector3& direction : { normal, -normal }) {
+			const SupportPoint point = Support(supportA, supportB, direction);
+			const float height = Dot(point.w - simplex.points[0].w, normal);
+			if (height * height > toleranceSq) {
+				simplex.points[simplex.count++] = point;
+				break;
+			}
+		}
+	}
+	return simplex.count == 4;
+}
+
+// EPA。原点を含む単体から、原点に一番近いミンコフスキー差の面を求める
+template<typename SupportA, typename SupportB>
+bool RunEPA(const SupportA& supportA, const SupportB& supportB, Simplex simplex, float scaleSq, Vector3& normal, float& depth, Vector3& pointA, Vector3& pointB) {
+	const float tolerance = kEPATolerance * std::sqrt(scaleSq);
+	if (!ExpandToTetrahedron(supportA, supportB, simplex, tolerance * tolerance)) {
+		return false;
+	}
+
+	SupportPoint points[kMaxEPAVertices];
+	PolytopeFace faces[kMaxEPAFaces];
+	std::pair<uint32_t, uint32_t> edges[kMaxEPAEdges];
+	std::copy(simplex.points, simplex.points + 4, points);
+	size_t pointCount = 4;
+	size_t faceCount = 0;
+	const Vector3 centroid = (points[0].w + points[1].w + points[2].w + points[3].w) * 0.25f;
+	static const uint32_t kFaces[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+	for (const uint32_t (&indices)[3] : kFaces) {
+		PolytopeFace& face = faces[faceCount++];
+		if (!MakePolytopeFace(points, indices[0], indices[1], indices[2], face)) {
+			return false;
+		}
+		// 外向きにする
+		if (Dot(face.normal, points[indices[0]].w - centroid) < 0.0f) {
+			MakePolytopeFace(points, indices[0], indices[2], indices[1], face);
+		}
+	}
+
+	auto findClosestFace = [&faces, &faceCount]() {
+		size_t closest = 0;
+		for (size_t i = 1; i < faceCount; i++) {
+			if (faces[i].distance < faces[closest].distance) {
+				closest = i;
+			}
+		}
+		return closest;
+	};
+	for (int iteration = 0; iteration < kMaxEPAIterations; iteration++) {
+		const PolytopeFace face = faces[findClosestFace()];
+		const SupportPoint point = Support(supportA, supportB, face.normal);
+		// これ以上広がらなければ、この面が一番近い
+		if (Dot(point.w, face.normal) - face.distance <= tolerance) {
+			break;
+		}
+
+		// 新しい点から見える面を消し、残った穴の縁の辺を集める(2枚の面で共有される辺は穴の内側)
+		size_t edgeCount = 0;
+		bool isOverflow = false;
+		for (size_t i = 0; i < faceCount;) {
+			if (Dot(faces[i].normal, point.w - points[faces[i].vertices[0]].w) <= 0.0f) {
+				i++;
+				continue;
+			}
+			for (int k = 0; k < 3; k++) {
+				const uint32_t a = faces[i].vertices[k];
+				const uint32_t b = faces[i].vertices[(k + 1) % 3];
+				auto reverse = std::find(edges, edges + edgeCount, std::make_pair(b, a));
+				if (reverse != edges + edgeCount) {
+					*reverse = edges[--edgeCount];
+				} else if (edgeCount < kMaxEPAEdges) {
+					edges[edgeCount++] = { a, b };
+				} else {
+					isOverflow = true;
+				}
+			}
+			faces[i] = faces[--faceCount];
+		}
+		if (isOverflow || faceCount + edgeCount > kMaxEPAFaces) {
+			return false;
+		}
+
+		// 穴の縁の辺と新しい点で面を作る
+		const uint32_t newIndex = static_cast<uint32_t>(pointCount);
+		points[pointCount++] = point;
+		for (size_t i = 0; i < edgeCount; i++) {
+			if (MakePolytopeFace(points, edges[i].first, edges[i].second, newIndex, faces[faceCount])) {
+				faceCount++;
+			}
+		}
+		if (faceCount == 0) {
+			return false;
+		}
+	}
+
+	// 原点を面に投影した点の重みから、形状ごとの点を求める
+	const PolytopeFace& face = faces[findClosestFace()];
+	const SupportPoint& p0 = points[face.vertices[0]];
+	const SupportPoint& p1 = points[face.vertices[1]];
+	const SupportPoint& p2 = points[face.vertices[2]];
+	const Vector3 projected = face.normal * face.distance;
+	const Vector3 v0 = p1.w - p0.w;
+	const Vector3 v1 = p2.w - p0.w;
+	const Vector3 v2 = projected - p0.w;
+	const float d00 = Dot(v0, v0);
+	const float d01 = Dot(v0, v1);
+	const float d11 = Dot(v1, v1);
+	const float d20 = Dot(v2, v0);
+	const float d21 = Dot(v2, v1);
+	const float denominator = d00 * d11 - d01 * d01;
+	float u = 1.0f / 3.0f, v = 1.0f / 3.0f;
+	if (denominator > 0.0f) {
+		u = (d11 * d20 - d01 * d21) / denominator;
+		v = (d00 * d21 - d01 * d20) / denominator;
+	}
+	const float w0 = 1.0f - u - v;
+	pointA = p0.a * w0 + p1.a * u + p2.a * v;
+	pointB = p0.b * w0 + p1.b * u + p2.b * v;
+	normal = face.normal;
+	depth = std::max(face.distance, 0.0f);
+	return true;
+}
+
+// 凸形状同士の当たり判定(marginBはbを広げる量。球の半径)
+template<typename SupportA, typename SupportB>
+bool CollideConvex(const SupportA& supportA, const SupportB& supportB, float marginB, Contact& contact) {
+	Simplex simplex;
+	Vector3 closest;
+	float scaleSq;
+	if (RunGJK(supportA, supportB, 0.0f, simplex, closest, scaleSq)) {
+		// 離れていても、広げた分より近ければ当たっている
+		const float distance = Length(closest);
+		if (distance >= marginB || distance <= 0.0f) {
+			return false;
+		}
+		Vector3 pointA, pointB;
+		simplex.GetClosestPoints(pointA, pointB);
+		contact.normal = closest * (-1.0f / distance);
+		contact.depth = marginB - distance;
+		contact.point = (pointA + pointB - contact.normal * marginB) * 0.5f;
+		return true;
+	}
+
+	Vector3 normal, pointA, pointB;
+	float depth;
+	if (!RunEPA(supportA, supportB, simplex, scaleSq, normal, depth, pointA, pointB)) {
+		// 面が作れないほど薄く重なっている場合は中心を結ぶ向きで押し出す
+		const Vector3 offset = supportB.GetCenter() - supportA.GetCenter();
+		const float length = Length(offset);
+		contact.normal = length > 0.0f ? offset * (1.0f / length) : Vector3{ 0.0f, 1.0f, 0.0f };
+		contact.depth = marginB;
+		contact.point = (supportA.GetCenter() + supportB.GetCenter()) * 0.5f;
+		return true;
+	}
+	contact.normal = normal;
+	contact.depth = depth + marginB;
+	contact.point = (pointA + pointB - normal * marginB) * 0.5f;
+	return true;
+}
+
+// 凸形状同士が重なっているか(離れていると分かった時点で終わる)
+template<typename SupportA, typename SupportB>
+bool OverlapConvex(const SupportA& supportA, const SupportB& supportB, float marginB) {
+	Simplex simplex;
+	Vector3 closest;
+	float scaleSq;
+	// 打ち切る距離は0より大きくしておく(0だと早く打ち切らない)
+	const float separation = std::max(marginB, 1.0e-30f);
+	if (!RunGJK(supportA, supportB, separation, simplex, closest, scaleSq)) {
+		return true;
+	}
+	return Dot(closest, closest) < marginB * marginB;
+}
+
+// 凸形状同士の最短距離
+template<typename SupportA, typename SupportB>
+float DistanceConvex(const SupportA& supportA, const SupportB& supportB, float marginB, Vector3& closestA, Vector3& closestB) {
+	Simplex simplex;
+	Vector3 closest;
+	float scaleSq;
+	if (!RunGJK(supportA, supportB, 0.0f, simplex, closest, scaleSq)) {
+		return 0.0f;
+	}
+	const float distance = Length(closest);
+	if (distance <= marginB) {
+		return 0.0f;
+	}
+	simplex.GetClosestPoints(closestA, closestB);
+	closestB += closest * (marginB / distance);
+	return distance - marginB;
+}
+
+} // namespace
+
+bool CheckCollision(const ConvexHullCollider& a, const ConvexHullCollider& b) {
+	return OverlapConvex(MakeSupport(a), MakeSupport(b), 0.0f);
+}
+
+bool CheckCollision(const ConvexHullCollider& a, const Sphere& b) {
+	return OverlapConvex(MakeSupport(a), PointSupport{ b.center }, b.radius);
+}
+
+bool CheckCollision(const ConvexHullCollider& a, const AABB& b) {
+	return OverlapConvex(MakeSupport(a), MakeSupport(b), 0.0f);
+}
+
+bool CheckCollision(const ConvexHullCollider& a, const OBB& b) {
+	return OverlapConvex(MakeSupport(a), MakeSupport(b), 0.0f);
+}
+
+bool CheckCollision(const ConvexHullCollider& a, const ConvexHullCollider& b, Contact& contact) {
+	return CollideConvex(MakeSupport(a), MakeSupport(b), 0.0f, contact);
+}
+
+bool CheckCollision(const ConvexHullCollider& a, const Sphere& b, Contact& contact) {
+	return CollideConvex(MakeSupport(a), PointSupport{ b.center }, b.radius, contact);
+}
+
+bool CheckCollision(const ConvexHullCollider& a, const AABB& b, Contact& contact) {
+	return CollideConvex(MakeSupport(a), MakeSupport(b), 0.0f, contact);
+}
+
+bool CheckCollision(const ConvexHullCollider& a, const OBB& b, Contact& contact) {
+	return CollideConvex(MakeSupport(a), MakeSupport(b), 0.0f, contact);
+}
+
+float ComputeDistance(const ConvexHullCollider& a, const ConvexHullCollider& b, Vector3& closestA, Vector3& closestB) {
+	return DistanceConvex(MakeSupport(a), MakeSupport(b), 0.0f, closestA, closestB);
+}
+
+float ComputeDistance(const ConvexHullCollider& a, const Sphere& b, Vector3& closestA, Vector3& closestB) {
+	return DistanceConvex(MakeSupport(a), PointSupport{ b.center }, b.radius, closestA, closestB);
+}
+
+float ComputeDistance(const ConvexHullCollider& a, const AABB& b, Vector3& closestA, Vector3& closestB) {
+	return DistanceConvex(MakeSupport(a), MakeSupport(b), 0.0f, closestA, closestB);
+}
+
+float ComputeDistance(const ConvexHullCollider& a, const OBB& b, Vector3& closestA, Vector3& closestB) {
+	return DistanceConvex(MakeSupport(a), MakeSupport(b), 0.0f, closestA, closestB);
+}
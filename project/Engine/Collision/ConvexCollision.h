@@ -0,0 +1,37 @@
+#pragma once
+#include "ConvexHull.h"
+#include "NarrowPhase.h"
+#include "AABB.h"
+#include "Sphere.h"
+#include "OBB.h"
+#include "Vector3.h"
+
+// 凸包とほかの形状の当たり判定
+// GJKで最短距離を求めて離れているかを調べ、重なっていればEPAでめり込みの向きと量を求める
+// 球は中心の点として判定してから半径の分だけ広げる(丸みのある形状をそのまま扱える)
+
+// 当たり判定(衝突しているかだけを求める。離れていると分かった時点で終わる)
+bool CheckCollision(const ConvexHullCollider& a, const ConvexHullCollider& b);
+bool CheckCollision(const ConvexHullCollider& a, const Sphere& b);
+bool CheckCollision(const ConvexHullCollider& a, const AABB& b);
+bool CheckCollision(const ConvexHullCollider& a, const OBB& b);
+
+// 当たり判定(衝突していればcontactに衝突情報を書く)
+bool CheckCollision(const ConvexHullCollider& a, const ConvexHullCollider& b, Contact& contact);
+bool CheckCollision(const ConvexHullCollider& a, const Sphere& b, Contact& contact);
+bool CheckCollision(const ConvexHullCollider& a, const AABB& b, Contact& contact);
+bool CheckCollision(const ConvexHullCollider& a, const OBB& b, Contact& contact);
+
+// 順番を入れ替えたもの(法線の向きも入れ替わる)
+inline bool CheckCollision(const Sphere& a, const ConvexHullCollider& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const AABB& a, const ConvexHullCollider& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const OBB& a, const ConvexHullCollider& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const Sphere& a, const ConvexHullCollider& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+inline bool CheckCollision(const AABB& a, const ConvexHullCollider& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+inline bool CheckCollision(const OBB& a, const ConvexHullCollider& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+
+// 最短距離(GJK)。closestA, closestBにそれぞれの形状の上で最も近い点を書く。重なっていれば0を返す(点は書かない)
+float ComputeDistance(const ConvexHullCollider& a, const ConvexHullCollider& b, Vector3& closestA, Vector3& closestB);
+float ComputeDistance(const ConvexHullCollider& a, const Sphere& b, Vector3& closestA, Vector3& closestB);
+float ComputeDistance(const ConvexHullCollider& a, const AABB& b, Vector3& closestA, Vector3& closestB);
+float ComputeDistance(const ConvexHullCollider& a, const OBB& b, Vector3& closestA, Vector3& closestB);
@@ -0,0 +1,428 @@
+#include "ConvexHull.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// 面上とみなす距離(頂点群の大きさに対する割合)
+constexpr float kHullToleranceRate = 1.0e-5f;
+
+// QuickHullの作業用の三角形
+struct HullFace {
+	uint32_t vertices[3];
+	// 辺i(vertices[i] -> vertices[(i + 1) % 3])を挟んで隣り合う面
+	int32_t neighbors[3];
+	Vector3 normal;
+	float distance;
+	// この面より外側にある頂点
+	std::vector<uint32_t> outside;
+	bool isRemoved;
+	// 見える面を探すときの印
+	uint32_t visitMark;
+};
+
+// QuickHull(面を外側の一番遠い点まで広げていく)
+class QuickHullBuilder {
+public:
+	QuickHullBuilder(const Vector3* points, size_t count, float tolerance)
+		: points(points), count(count), tolerance(tolerance) {}
+
+	// 凸包を作る。立体にならなければfalse
+	bool Build() {
+		if (!CreateInitialTetrahedron()) {
+			return false;
+		}
+		// 面はfacesの後ろに足していくので、前から順に外側の点が無くなるまで広げる
+		for (size_t i = 0; i < faces.size(); i++) {
+			if (!faces[i].isRemoved && !faces[i].outside.empty()) {
+				AddPoint(static_cast<int32_t>(i));
+			}
+		}
+		return true;
+	}
+
+	// 残った面の三角形と、使われている頂点(元の頂点の番号)を求める
+	void Extract(std::vector<uint32_t>& usedPoints, std::vector<uint32_t>& triangles) const {
+		std::vector<int32_t> remap(count, -1);
+		usedPoints.clear();
+		triangles.clear();
+		for (const HullFace& face : faces) {
+			if (face.isRemoved) {
+				continue;
+			}
+			for (uint32_t vertex : face.vertices) {
+				if (remap[vertex] < 0) {
+					remap[vertex] = static_cast<int32_t>(usedPoints.size());
+					usedPoints.push_back(vertex);
+				}
+				triangles.push_back(static_cast<uint32_t>(remap[vertex]));
+			}
+		}
+	}
+
+private:
+	// 面からの距離(外側が正)
+	float Distance(const HullFace& face, uint32_t point) const {
+		return Dot(face.normal, points[point]) - face.distance;
+	}
+
+	// 面を足す(法線は頂点の並びから求める)
+	int32_t AddFace(uint32_t a, uint32_t b, uint32_t c) {
+		HullFace face{};
+		face.vertices[0] = a;
+		face.vertices[1] = b;
+		face.vertices[2] = c;
+		face.neighbors[0] = face.neighbors[1] = face.neighbors[2] = -1;
+		const Vector3 normal = Cross(points[b] - points[a], points[c] - points[a]);
+		const float length = Length(normal);
+		// 潰れた面は法線を0にして、どの点からも見えないものとして扱う
+		face.normal = length > 0.0f ? normal * (1.0f / length) : Vector3{ 0.0f, 0.0f, 0.0f };
+		face.distance = Dot(face.normal, (points[a] + points[b] + points[c]) * (1.0f / 3.0f));
+		faces.push_back(std::move(face));
+		return static_cast<int32_t>(faces.size() - 1);
+	}
+
+	// 面faceの中で辺(a -> b)の番号
+	static int FindEdge(const HullFace& face, uint32_t a, uint32_t b) {
+		for (int i = 0; i < 3; i++) {
+			if (face.vertices[i] == a && face.vertices[(i + 1) % 3] == b) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	// 一番離れた4点で最初の四面体を作り、残りの点を面の外側に振り分ける
+	bool CreateInitialTetrahedron() {
+		if (count < 4) {
+			return false;
+		}
+		// 各軸の両端の点の中で一番離れた2点
+		uint32_t extremes[6] = {};
+		for (uint32_t i = 1; i < count; i++) {
+			for (int axis = 0; axis < 3; axis++) {
+				auto get = [axis](const Vector3& v) { return axis == 0 ? v.x : axis == 1 ? v.y : v.z; };
+				if (get(points[i]) < get(points[extremes[axis * 2]])) {
+					extremes[axis * 2] = i;
+				}
+				if (get(points[i]) > get(points[extremes[axis * 2 + 1]])) {
+					extremes[axis * 2 + 1] = i;
+				}
+			}
+		}
+		uint32_t v0 = 0, v1 = 0;
+		float bestDistance = -1.0f;
+		for (int i = 0; i < 6; i++) {
+			for (int j = i + 1; j < 6; j++) {
+				const float distance = Dot(points[extremes[i]] - points[extremes[j]], points[extremes[i]] - points[extremes[j]]);
+				if (distance > bestDistance) {
+					bestDistance = distance;
+					v0 = extremes[i];
+					v1 = extremes[j];
+				}
+			}
+		}
+		if (std::sqrt(bestDistance) <= tolerance) {
+			return false;
+		}
+
+		// 直線から一番離れた点
+		const Vector3 line = Normalize(points[v1] - points[v0]);
+		uint32_t v2 = 0;
+		bestDistance = -1.0f;
+		for (uint32_t i = 0; i < count; i++) {
+			const Vector3 offset = points[i] - points[v0];
+			const Vector3 perpendicular = offset - line * Dot(offset, line);
+			const float distance = Dot(perpendicular, perpendicular);
+			if (distance > bestDistance) {
+				bestDistance = distance;
+				v2 = i;
+			}
+		}
+		if (std::sqrt(bestDistance) <= tolerance) {
+			return false;
+		}
+
+		// 平面から一番離れた点
+		const Vector3 normal = Normalize(Cross(points[v1] - points[v0], points[v2] - points[v0]));
+		uint32_t v3 = 0;
+		bestDistance = -1.0f;
+		for (uint32_t i = 0; i < count; i++) {
+			const float distance = std::fabs(Dot(points[i] - points[v0], normal));
+			if (distance > bestDistance) {
+				bestDistance = distance;
+				v3 = i;
+			}
+		}
+		if (bestDistance <= tolerance) {
+			return false;
+		}
+
+		// v3が(v0, v1, v2)の裏側に来るように並べる
+		if (Dot(points[v3] - points[v0], normal) > 0.0f) {
+			std::swap(v1, v2);
+		}
+		AddFace(v0, v1, v2);
+		AddFace(v0, v3, v1);
+		AddFace(v1, v3, v2);
+		AddFace(v2, v3, v0);
+		// 隣り合う面をつなぐ
+		for (int32_t i = 0; i < 4; i++) {
+			for (int edge = 0; edge < 3; edge++) {
+				const uint32_t a = faces[i].vertices[edge];
+				const uint32_t b = faces[i].vertices[(edge + 1) % 3];
+				for (int32_t j = 0; j < 4; j++) {
+					if (j != i && FindEdge(faces[j], b, a) >= 0) {
+						faces[i].neighbors[edge] = j;
+					}
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < count; i++) {
+			if (i == v0 || i == v1 || i == v2 || i == v3) {
+				continue;
+			}
+			for (int32_t face = 0; face < 4; face++) {
+				if (Distance(faces[face], i) > tolerance) {
+					faces[face].outside.push_back(i);
+					break;
+				}
+			}
+		}
+		return true;
+	}
+
+	// 面faceの外側で一番遠い点を凸包に加える
+	void AddPoint(int32_t face) {
+		// 一番遠い点
+		uint32_t eye = faces[face].outside.front();
+		float eyeDistance = Distance(faces[face], eye);
+		for (uint32_t point : faces[face].outside) {
+			const float distance = Distance(faces[face], point);
+			if (distance > eyeDistance) {
+				eyeDistance = distance;
+				eye = point;
+			}
+		}
+
+		// 点から見える面をたどり、見える面と見えない面の境目の辺を反時計回りの順に集める
+		visitMark++;
+		visibleFaces.clear();
+		horizon.clear();
+		frames.clear();
+		faces[face].visitMark = visitMark;
+		visibleFaces.push_back(face);
+		frames.push_back({ face, 0, 3 });
+		while (!frames.empty()) {
+			Frame& top = frames.back();
+			if (top.remaining == 0) {
+				frames.pop_back();
+				continue;
+			}
+			const int edge = top.edge;
+			top.edge = (edge + 1) % 3;
+			top.remaining--;
+			const int32_t current = top.face;
+			const int32_t neighbor = faces[current].neighbors[edge];
+			if (faces[neighbor].visitMark == visitMark) {
+				continue;
+			}
+			if (Distance(faces[neighbor], eye) > tolerance) {
+				faces[neighbor].visitMark = visitMark;
+				visibleFaces.push_back(neighbor);
+				// 入ってきた辺の次の辺から調べる
+				const int back = FindEdge(faces[neighbor], faces[current].vertices[(edge + 1) % 3], faces[current].vertices[edge]);
+				assert(back >= 0);
+				frames.push_back({ neighbor, (back + 1) % 3, 2 });
+			} else {
+				horizon.push_back({ current, edge });
+			}
+		}
+
+		// 境目の辺と点で新しい面を作る
+		const size_t firstNewFace = faces.size();
+		for (size_t i = 0; i < horizon.size(); i++) {
+			const HullFace& oldFace = faces[horizon[i].face];
+			const uint32_t a = oldFace.vertices[horizon[i].edge];
+			const uint32_t b = oldFace.vertices[(horizon[i].edge + 1) % 3];
+			const int32_t outer = oldFace.neighbors[horizon[i].edge];
+			const int32_t created = AddFace(a, b, eye);
+			faces[created].neighbors[0] = outer;
+			const int outerEdge = FindEdge(faces[outer], b, a);
+			assert(outerEdge >= 0);
+			faces[outer].neighbors[outerEdge] = created;
+		}
+		const size_t newFaceCount = faces.size() - firstNewFace;
+		for (size_t i = 0; i < newFaceCount; i++) {
+			HullFace& created = faces[firstNewFace + i];
+			const int32_t next = static_cast<int32_t>(firstNewFace + (i + 1) % newFaceCount);
+			const int32_t previous = static_cast<int32_t>(firstNewFace + (i + newFaceCount - 1) % newFaceCount);
+			assert(faces[next].vertices[0] == created.vertices[1]);
+			created.neighbors[1] = next;
+			created.neighbors[2] = previous;
+		}
+
+		// 消える面の外側の点を新しい面に振り分ける(どの面の外側でもなければ内側なので捨てる)
+		for (int32_t visible : visibleFaces) {
+			HullFace& removed = faces[visible];
+			removed.isRemoved = true;
+			for (uint32_t point : removed.outside) {
+				if (point == eye) {
+					continue;
+				}
+				for (size_t i = firstNewFace; i < faces.size(); i++) {
+					if (Distance(faces[i], point) > tolerance) {
+						faces[i].outside.push_back(point);
+						break;
+					}
+				}
+			}
+			removed.outside.clear();
+			removed.outside.shrink_to_fit();
+		}
+	}
+
+private:
+	struct HorizonEdge {
+		int32_t face;
+		int edge;
+	};
+
+	// 見える面をたどるときのスタックの要素(次に調べる辺と残りの辺の数)
+	struct Frame {
+		int32_t face;
+		int edge;
+		int remaining;
+	};
+
+	const Vector3* points;
+	size_t count;
+	float tolerance;
+
+	std::vector<HullFace> faces;
+	uint32_t visitMark = 0;
+	std::vector<int32_t> visibleFaces;
+	std::vector<HorizonEdge> horizon;
+	std::vector<Frame> frames;
+};
+
+} // namespace
+
+bool ConvexHull::Build(const Vector3* points, size_t count, uint32_t maxVertexCount) {
+	assert(points || count == 0);
+	assert(maxVertexCount >= 4);
+	Clear();
+	if (count < 4) {
+		return false;
+	}
+
+	AABB pointBounds{ points[0], points[0] };
+	for (size_t i = 1; i < count; i++) {
+		pointBounds.min = { std::min(pointBounds.min.x, points[i].x), std::min(pointBounds.min.y, points[i].y), std::min(pointBounds.min.z, points[i].z) };
+		pointBounds.max = { std::max(pointBounds.max.x, points[i].x), std::max(pointBounds.max.y, points[i].y), std::max(pointBounds.max.z, points[i].z) };
+	}
+	const float hullTolerance = Length(pointBounds.max - pointBounds.min) * kHullToleranceRate;
+
+	std::vector<uint32_t> usedPoints;
+	std::vector<uint32_t> triangles;
+	{
+		QuickHullBuilder builder(points, count, hullTolerance);
+		if (!builder.Build()) {
+			return false;
+		}
+		builder.Extract(usedPoints, triangles);
+	}
+	std::vector<Vector3> hullPoints(usedPoints.size());
+	for (size_t i = 0; i < usedPoints.size(); i++) {
+		hullPoints[i] = points[usedPoints[i]];
+	}
+
+	// 頂点が多すぎれば、球面上に均等に並べた向きで一番遠い頂点だけを残して作り直す
+	if (hullPoints.size() > maxVertexCount) {
+		std::vector<Vector3> reduced;
+		std::vector<uint8_t> isSelected(hullPoints.size(), 0);
+		const float goldenAngle = 3.14159265f * (3.0f - std::sqrt(5.0f));
+		for (uint32_t i = 0; i < maxVertexCount; i++) {
+			const float y = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / static_cast<float>(maxVertexCount);
+			const float radius = std::sqrt(std::max(1.0f - y * y, 0.0f));
+			const float angle = goldenAngle * static_cast<float>(i);
+			const Vector3 direction{ std::cos(angle) * radius, y, std::sin(angle) * radius };
+			size_t best = 0;
+			for (size_t j = 1; j < hullPoints.size(); j++) {
+				if (Dot(hullPoints[j], direction) > Dot(hullPoints[best], direction)) {
+					best = j;
+				}
+			}
+			if (!isSelected[best]) {
+				isSelected[best] = 1;
+				reduced.push_back(hullPoints[best]);
+			}
+		}
+		QuickHullBuilder builder(reduced.data(), reduced.size(), hullTolerance);
+		if (!builder.Build()) {
+			return false;
+		}
+		builder.Extract(usedPoints, triangles);
+		hullPoints.resize(usedPoints.size());
+		for (size_t i = 0; i < usedPoints.size(); i++) {
+			hullPoints[i] = reduced[usedPoints[i]];
+		}
+	}
+
+	vertices = std::move(hullPoints);
+	indices = std::move(triangles);
+	planes.reserve(indices.size() / 3);
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const Vector3& a = vertices[indices[i]];
+		const Vector3& b = vertices[indices[i + 1]];
+		const Vector3& c = vertices[indices[i + 2]];
+		const Vector3 normal = Cross(b - a, c - a);
+		const float length = Length(normal);
+		const Vector3 unit = length > 0.0f ? normal * (1.0f / length) : Vector3{ 0.0f, 0.0f, 0.0f };
+		planes.push_back({ unit, Dot(unit, a) });
+	}
+	bounds = { vertices[0], vertices[0] };
+	for (const Vector3& vertex : vertices) {
+		bounds.min = { std::min(bounds.min.x, vertex.x), std::min(bounds.min.y, vertex.y), std::min(bounds.min.z, vertex.z) };
+		bounds.max = { std::max(bounds.max.x, vertex.x), std::max(bounds.max.y, vertex.y), std::max(bounds.max.z, vertex.z) };
+	}
+	tolerance = hullTolerance;
+	return true;
+}
+
+Vector3 ConvexHull::GetSupport(const Vector3& direction) const {
+	assert(IsValid());
+	size_t best = 0;
+	float bestDot = Dot(vertices[0], direction);
+	for (size_t i = 1; i < vertices.size(); i++) {
+		const float dot = Dot(vertices[i], direction);
+		if (dot > bestDot) {
+			bestDot = dot;
+			best = i;
+		}
+	}
+	return vertices[best];
+}
+
+bool ConvexHull::Contains(const Vector3& point) const {
+	if (!IsValid()) {
+		return false;
+	}
+	for (const Plane& plane : planes) {
+		if (Dot(plane.normal, point) - plane.distance > tolerance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void ConvexHull::Clear() {
+	vertices.clear();
+	indices.clear();
+	planes.clear();
+	bounds = {};
+	tolerance = 0.0f;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "AABB.h"
+#include "Plane.h"
+#include "Matrix3x4.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 凸包(QuickHullで頂点群から作る)
+// モデルの読み込み時に1回だけ作り、ローカル座標のまま使う。当たり判定はGJK/EPA(ConvexCollision.h)で行う
+class ConvexHull {
+public:
+	// 頂点数の上限の既定値(GJKのサポート写像は頂点を全て調べるので、多すぎると遅くなる)
+	static constexpr uint32_t kDefaultMaxVertexCount = 64;
+
+	/// <summary>
+	/// 頂点群から作る
+	/// 凸包の頂点がmaxVertexCountより多ければ、いろいろな向きで一番遠い頂点だけを残して作り直す(少し内側に縮む)
+	/// </summary>
+	/// <param name="points">頂点(重複していてもよい)</param>
+	/// <param name="count">頂点の数</param>
+	/// <param name="maxVertexCount">頂点数の上限(4以上)</param>
+	/// <returns>全ての頂点が同じ平面上にあるなど、立体にならなければfalse</returns>
+	bool Build(const Vector3* points, size_t count, uint32_t maxVertexCount = kDefaultMaxVertexCount);
+
+	// 向きdirectionに一番遠い頂点(サポート写像)
+	Vector3 GetSupport(const Vector3& direction) const;
+
+	// 点が内側(面上を含む)にあるか
+	bool Contains(const Vector3& point) const;
+
+	// Getter(頂点)
+	const std::vector<Vector3>& GetVertices() const { return vertices; }
+	// Getter(三角形の頂点番号。表から見て反時計回り)
+	const std::vector<uint32_t>& GetIndices() const { return indices; }
+	// Getter(三角形ごとの外向きの平面)
+	const std::vector<Plane>& GetPlanes() const { return planes; }
+	// Getter(頂点を囲むAABB)
+	const AABB& GetBounds() const { return bounds; }
+
+	// 作られているか
+	bool IsValid() const { return !vertices.empty(); }
+
+	// 全て消す
+	void Clear();
+
+private:
+	std::vector<Vector3> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<Plane> planes;
+	AABB bounds{};
+	// 面上とみなす距離(大きさに合わせて決める)
+	float tolerance = 0.0f;
+};
+
+// ワールド座標に置いた凸包(worldはモデルのワールド行列。拡縮・回転していてもよい)
+struct ConvexHullCollider {
+	const ConvexHull* hull;
+	Matrix3x4 world;
+};
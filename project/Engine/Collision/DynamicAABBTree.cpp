@@ -0,0 +1,417 @@
+#include "DynamicAABBTree.h"
+#include "NarrowPhase.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// ペアを求めるときに分ける部分木の組の数の目安(スレッド数によらず同じにする)
+constexpr size_t kMinPairTasks = 256;
+
+// 2つのAABBを囲むAABB
+AABB Union(const AABB& a, const AABB& b) {
+	return AABB{
+		{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+		{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+	};
+}
+
+// 表面積(の半分)。挿入先を選ぶコストに使う
+float SurfaceArea(const AABB& aabb) {
+	const Vector3 d = aabb.max - aabb.min;
+	return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+// outerがinnerを含んでいるか
+bool Contains(const AABB& outer, const AABB& inner) {
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+	       inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+} // namespace
+
+DynamicAABBTree::DynamicAABBTree() {
+	nodes.reserve(16);
+	stack.reserve(64);
+	pairStack.reserve(64);
+}
+
+ProxyHandle DynamicAABBTree::CreateProxy(const AABB& aabb, void* userData) {
+	const int32_t proxy = AllocateNode();
+	Node& node = nodes[proxy];
+	node.aabb = aabb;
+	node.fatAABB = Fatten(aabb);
+	node.userData = userData;
+	node.height = 0;
+	InsertLeaf(proxy);
+	proxyCount++;
+	return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(ProxyHandle proxy) {
+	assert(0 <= proxy && proxy < static_cast<int32_t>(nodes.size()));
+	assert(nodes[proxy].height == 0);
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	proxyCount--;
+}
+
+void DynamicAABBTree::MoveProxy(ProxyHandle proxy, const AABB& aabb) {
+	assert(0 <= proxy && proxy < static_cast<int32_t>(nodes.size()));
+	assert(nodes[proxy].height == 0);
+	Node& node = nodes[proxy];
+	const Vector3 displacement = ((aabb.min + aabb.max) - (node.aabb.min + node.aabb.max)) * 0.5f;
+	node.aabb = aabb;
+	// fat AABBに収まっていれば木はそのまま
+	if (Contains(node.fatAABB, aabb)) {
+		return;
+	}
+
+	RemoveLeaf(proxy);
+
+	// 次のフレームも同じ方向に動くとみなして、移動方向に広げておく
+	AABB fatAABB = Fatten(aabb);
+	const Vector3 d = displacement * displacementMultiplier;
+	if (d.x < 0.0f) { fatAABB.min.x += d.x; } else { fatAABB.max.x += d.x; }
+	if (d.y < 0.0f) { fatAABB.min.y += d.y; } else { fatAABB.max.y += d.y; }
+	if (d.z < 0.0f) { fatAABB.min.z += d.z; } else { fatAABB.max.z += d.z; }
+	nodes[proxy].fatAABB = fatAABB;
+
+	InsertLeaf(proxy);
+}
+
+void DynamicAABBTree::ComputePairs(std::vector<ProxyPair>& pairs) {
+	pairs.clear();
+	if (root == kNullProxy) {
+		return;
+	}
+
+	// 部分木の中のペア(自分自身)と、2つの部分木の間のペアを調べる
+	// 自分自身は(n, n)、部分木の間は(n1, n2)として表し、根から1段ずつ分けて十分な数の組にする
+	tasks.clear();
+	tasks.push_back({ root, root });
+	while (tasks.size() < kMinPairTasks) {
+		pairStack.clear();
+		bool isSplit = false;
+		for (const ProxyPair& task : tasks) {
+			isSplit |= SplitPair(task, pairStack);
+		}
+		tasks.swap(pairStack);
+		if (!isSplit) {
+			break;
+		}
+	}
+
+	taskStacks.resize(tasks.size());
+	taskPairs.resize(tasks.size());
+	auto collect = [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			taskPairs[i].clear();
+			CollectPairs(tasks[i], taskStacks[i], taskPairs[i]);
+		}
+	};
+	if (isParallel) {
+		ThreadPool::GetInstance()->ParallelFor(tasks.size(), 1, collect);
+	} else {
+		collect(0, tasks.size());
+	}
+
+	size_t pairCount = 0;
+	for (const std::vector<ProxyPair>& taskPair : taskPairs) {
+		pairCount += taskPair.size();
+	}
+	pairs.reserve(pairCount);
+	for (size_t i = 0; i < tasks.size(); i++) {
+		pairs.insert(pairs.end(), taskPairs[i].begin(), taskPairs[i].end());
+	}
+}
+
+bool DynamicAABBTree::SplitPair(const ProxyPair& pair, std::vector<ProxyPair>& next) const {
+	const Node& a = nodes[pair.a];
+	const Node& b = nodes[pair.b];
+
+	if (pair.a == pair.b) {
+		if (!a.IsLeaf()) {
+			next.push_back({ a.child1, a.child1 });
+			next.push_back({ a.child2, a.child2 });
+			next.push_back({ a.child1, a.child2 });
+			return true;
+		}
+		return false;
+	}
+
+	if (!CollisionAABB(a.fatAABB, b.fatAABB)) {
+		return false;
+	}
+
+	if (a.IsLeaf() && b.IsLeaf()) {
+		// 葉同士はそのまま残す
+		next.push_back(pair);
+		return false;
+	}
+
+	// 大きい方(葉でない方)を分割する
+	if (b.IsLeaf() || (!a.IsLeaf() && SurfaceArea(a.fatAABB) >= SurfaceArea(b.fatAABB))) {
+		next.push_back({ a.child1, pair.b });
+		next.push_back({ a.child2, pair.b });
+	} else {
+		next.push_back({ pair.a, b.child1 });
+		next.push_back({ pair.a, b.child2 });
+	}
+	return true;
+}
+
+void DynamicAABBTree::CollectPairs(const ProxyPair& task, std::vector<ProxyPair>& taskStack, std::vector<ProxyPair>& pairs) const {
+	taskStack.clear();
+	taskStack.push_back(task);
+	while (!taskStack.empty()) {
+		const ProxyPair top = taskStack.back();
+		taskStack.pop_back();
+		const Node& a = nodes[top.a];
+		const Node& b = nodes[top.b];
+
+		if (top.a != top.b && a.IsLeaf() && b.IsLeaf()) {
+			// 葉同士は登録されたAABBで判定する
+			if (CollisionAABB(a.fatAABB, b.fatAABB) && CollisionAABB(a.aabb, b.aabb)) {
+				pairs.push_back(top.a < top.b ? ProxyPair{ top.a, top.b } : ProxyPair{ top.b, top.a });
+			}
+			continue;
+		}
+		SplitPair(top, taskStack);
+	}
+}
+
+void DynamicAABBTree::Query(const AABB& aabb, std::vector<ProxyHandle>& result) const {
+	result.clear();
+	if (root == kNullProxy) {
+		return;
+	}
+
+	// constで呼べるようにスタックはその場で用意する
+	std::vector<int32_t> queryStack;
+	queryStack.reserve(64);
+	queryStack.push_back(root);
+	while (!queryStack.empty()) {
+		const int32_t index = queryStack.back();
+		queryStack.pop_back();
+		const Node& node = nodes[index];
+		if (!CollisionAABB(node.fatAABB, aabb)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			if (CollisionAABB(node.aabb, aabb)) {
+				result.push_back(index);
+			}
+		} else {
+			queryStack.push_back(node.child1);
+			queryStack.push_back(node.child2);
+		}
+	}
+}
+
+void* DynamicAABBTree::GetUserData(ProxyHandle proxy) const {
+	assert(0 <= proxy && proxy < static_cast<int32_t>(nodes.size()));
+	return nodes[proxy].userData;
+}
+
+const AABB& DynamicAABBTree::GetAABB(ProxyHandle proxy) const {
+	assert(0 <= proxy && proxy < static_cast<int32_t>(nodes.size()));
+	return nodes[proxy].aabb;
+}
+
+const AABB& DynamicAABBTree::GetFatAABB(ProxyHandle proxy) const {
+	assert(0 <= proxy && proxy < static_cast<int32_t>(nodes.size()));
+	return nodes[proxy].fatAABB;
+}
+
+int32_t DynamicAABBTree::GetHeight() const {
+	if (root == kNullProxy) {
+		return 0;
+	}
+	return nodes[root].height;
+}
+
+int32_t DynamicAABBTree::AllocateNode() {
+	if (freeList == kNullProxy) {
+		nodes.emplace_back();
+		return static_cast<int32_t>(nodes.size() - 1);
+	}
+	const int32_t node = freeList;
+	freeList = nodes[node].parent;
+	nodes[node] = Node{};
+	return node;
+}
+
+void DynamicAABBTree::FreeNode(int32_t node) {
+	nodes[node] = Node{};
+	nodes[node].parent = freeList;
+	freeList = node;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+	if (root == kNullProxy) {
+		root = leaf;
+		nodes[root].parent = kNullProxy;
+		return;
+	}
+
+	// 表面積の増え方が最も少ない兄弟を探す
+	const AABB leafAABB = nodes[leaf].fatAABB;
+	int32_t index = root;
+	while (!nodes[index].IsLeaf()) {
+		const Node& node = nodes[index];
+		const float area = SurfaceArea(node.fatAABB);
+		const float combinedArea = SurfaceArea(Union(node.fatAABB, leafAABB));
+
+		// ここで新しい親を作る場合のコスト
+		const float cost = 2.0f * combinedArea;
+		// さらに下に降りる場合に祖先が大きくなる分のコスト
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		// 子に降りる場合のコスト
+		float childCost[2];
+		const int32_t children[2] = { node.child1, node.child2 };
+		for (int i = 0; i < 2; i++) {
+			const Node& child = nodes[children[i]];
+			const float unionArea = SurfaceArea(Union(child.fatAABB, leafAABB));
+			childCost[i] = child.IsLeaf() ? unionArea + inheritanceCost : unionArea - SurfaceArea(child.fatAABB) + inheritanceCost;
+		}
+
+		if (cost < childCost[0] && cost < childCost[1]) {
+			break;
+		}
+		index = childCost[0] < childCost[1] ? children[0] : children[1];
+	}
+	const int32_t sibling = index;
+
+	// 兄弟と葉をまとめる親を作る
+	const int32_t oldParent = nodes[sibling].parent;
+	const int32_t newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].fatAABB = Union(leafAABB, nodes[sibling].fatAABB);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent == kNullProxy) {
+		root = newParent;
+	} else if (nodes[oldParent].child1 == sibling) {
+		nodes[oldParent].child1 = newParent;
+	} else {
+		nodes[oldParent].child2 = newParent;
+	}
+
+	Refit(nodes[leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+	if (leaf == root) {
+		root = kNullProxy;
+		return;
+	}
+
+	// 親を消して兄弟を祖父につなげる
+	const int32_t parent = nodes[leaf].parent;
+	const int32_t grandParent = nodes[parent].parent;
+	const int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent == kNullProxy) {
+		root = sibling;
+		nodes[sibling].parent = kNullProxy;
+		FreeNode(parent);
+		return;
+	}
+
+	if (nodes[grandParent].child1 == parent) {
+		nodes[grandParent].child1 = sibling;
+	} else {
+		nodes[grandParent].child2 = sibling;
+	}
+	nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	Refit(grandParent);
+}
+
+void DynamicAABBTree::Refit(int32_t node) {
+	int32_t index = node;
+	while (index != kNullProxy) {
+		index = Balance(index);
+
+		Node& n = nodes[index];
+		const Node& child1 = nodes[n.child1];
+		const Node& child2 = nodes[n.child2];
+		n.height = 1 + std::max(child1.height, child2.height);
+		n.fatAABB = Union(child1.fatAABB, child2.fatAABB);
+
+		index = n.parent;
+	}
+}
+
+int32_t DynamicAABBTree::Balance(int32_t iA) {
+	// Aの子B, Cの高さの差が2以上なら、高い方を持ち上げる
+	Node& A = nodes[iA];
+	if (A.IsLeaf() || A.height < 2) {
+		return iA;
+	}
+
+	const int32_t iB = A.child1;
+	const int32_t iC = A.child2;
+	const int32_t balance = nodes[iC].height - nodes[iB].height;
+
+	// 高い方の子をFとして、Fを持ち上げてAをFの子にする
+	auto rotate = [&](int32_t iF, int32_t iOther, bool fIsChild2) {
+		Node& F = nodes[iF];
+		const int32_t iG = F.child1;
+		const int32_t iH = F.child2;
+
+		F.child1 = iA;
+		F.parent = A.parent;
+		A.parent = iF;
+
+		if (F.parent == kNullProxy) {
+			root = iF;
+		} else if (nodes[F.parent].child1 == iA) {
+			nodes[F.parent].child1 = iF;
+		} else {
+			nodes[F.parent].child2 = iF;
+		}
+
+		// Fの子のうち高い方をFに残し、低い方をAに渡す
+		int32_t keep = iG;
+		int32_t give = iH;
+		if (nodes[iG].height < nodes[iH].height) {
+			keep = iH;
+			give = iG;
+		}
+		F.child2 = keep;
+		if (fIsChild2) {
+			A.child2 = give;
+		} else {
+			A.child1 = give;
+		}
+		nodes[give].parent = iA;
+
+		A.fatAABB = Union(nodes[iOther].fatAABB, nodes[give].fatAABB);
+		F.fatAABB = Union(A.fatAABB, nodes[keep].fatAABB);
+		A.height = 1 + std::max(nodes[iOther].height, nodes[give].height);
+		F.height = 1 + std::max(A.height, nodes[keep].height);
+		return iF;
+	};
+
+	if (balance > 1) {
+		return rotate(iC, iB, true);
+	}
+	if (balance < -1) {
+		return rotate(iB, iC, false);
+	}
+	return iA;
+}
+
+AABB DynamicAABBTree::Fatten(const AABB& aabb) const {
+	const Vector3 r{ margin, margin, margin };
+	return AABB{ aabb.min - r, aabb.max + r };
+}
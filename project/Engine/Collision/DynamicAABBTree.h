@@ -0,0 +1,108 @@
+#pragma once
+#include "BroadPhase.h"
+#include "AABB.h"
+#include <cstdint>
+#include <vector>
+
+// 動的AABB木によるブロードフェーズ
+// 葉は少し広げたAABB(fat AABB)を持ち、AABBがその中に収まっている間は木を組み替えない
+// ハンドルはノードの番号なので、登録を解除するまで変わらない
+class DynamicAABBTree : public BroadPhase {
+public:
+	DynamicAABBTree();
+
+	ProxyHandle CreateProxy(const AABB& aabb, void* userData) override;
+
+	void DestroyProxy(ProxyHandle proxy) override;
+
+	// AABBがfat AABBからはみ出したら葉を入れ直す
+	void MoveProxy(ProxyHandle proxy, const AABB& aabb) override;
+
+	// 木同士を同時にたどって重なっているペアを求める
+	// 根から数段だけ分けた部分木の組ごとに並列にたどり、組の順に結果をつなぐ(スレッド数によらず同じ順番になる)
+	void ComputePairs(std::vector<ProxyPair>& pairs) override;
+
+	void Query(const AABB& aabb, std::vector<ProxyHandle>& result) const override;
+
+	void* GetUserData(ProxyHandle proxy) const override;
+
+	const AABB& GetAABB(ProxyHandle proxy) const override;
+
+	size_t GetProxyCount() const override { return proxyCount; }
+
+	// Getter(fat AABB)
+	const AABB& GetFatAABB(ProxyHandle proxy) const;
+
+	// Getter(木の高さ)
+	int32_t GetHeight() const;
+
+	// Setter(fat AABBの余白)
+	void SetMargin(float margin) { this->margin = margin; }
+
+	// Setter(移動方向にfat AABBを広げる倍率)
+	void SetDisplacementMultiplier(float multiplier) { displacementMultiplier = multiplier; }
+
+	// Setter(ペアを並列に求めるか)
+	void SetParallel(bool isParallel) { this->isParallel = isParallel; }
+
+private:
+	struct Node {
+		// 葉はfat AABB、内部ノードは子を囲むAABB
+		AABB fatAABB;
+		// 登録されたAABB(葉のみ)
+		AABB aabb;
+		void* userData = nullptr;
+		// 親(空きノードの場合は次の空きノード)
+		int32_t parent = kNullProxy;
+		int32_t child1 = kNullProxy;
+		int32_t child2 = kNullProxy;
+		// 葉は0、空きノードは-1
+		int32_t height = -1;
+
+		bool IsLeaf() const { return child1 == kNullProxy; }
+	};
+
+	// ノードを確保する
+	int32_t AllocateNode();
+	// ノードを解放する
+	void FreeNode(int32_t node);
+
+	// 葉を木に入れる
+	void InsertLeaf(int32_t leaf);
+	// 葉を木から外す
+	void RemoveLeaf(int32_t leaf);
+
+	// nodeの高さが偏っていれば回転して、新しい部分木の根を返す
+	int32_t Balance(int32_t node);
+
+	// leafから根に向かってAABBと高さを更新する
+	void Refit(int32_t node);
+
+	// aabbを余白の分だけ広げる
+	AABB Fatten(const AABB& aabb) const;
+
+	// 部分木の組(自分自身は(n, n))を1段だけ分けてnextに積む。分けられなければfalse
+	bool SplitPair(const ProxyPair& pair, std::vector<ProxyPair>& next) const;
+
+	// 部分木の組の中で重なっているペアを求める
+	void CollectPairs(const ProxyPair& task, std::vector<ProxyPair>& taskStack, std::vector<ProxyPair>& pairs) const;
+
+private:
+	std::vector<Node> nodes;
+	int32_t root = kNullProxy;
+	int32_t freeList = kNullProxy;
+	size_t proxyCount = 0;
+
+	float margin = 0.1f;
+	float displacementMultiplier = 2.0f;
+	bool isParallel = true;
+
+	// 走査用のスタック(確保を毎回しないように使い回す)
+	std::vector<int32_t> stack;
+	std::vector<ProxyPair> pairStack;
+
+	// 並列にたどる部分木の組と、組ごとの結果
+	std::vector<ProxyPair> tasks;
+	std::vector<std::vector<ProxyPair>> taskStacks;
+	std::vector<std::vector<ProxyPair>> taskPairs;
+};
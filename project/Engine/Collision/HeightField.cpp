@@ -0,0 +1,491 @@
+#include "HeightField.h"
+#include "BVH.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// メッシュの頂点を同じ格子点とみなす距離(格子全体の大きさに対する割合)
+constexpr float kGridToleranceRate = 1.0e-5f;
+// 格子点からこれ以上(間隔に対する割合)ずれた頂点があれば格子ではないとみなす
+constexpr float kGridSnapRate = 1.0e-2f;
+// レイキャストでマスを飛ばすときの高さの余裕(高さの範囲と間隔に対する割合)
+constexpr float kRaycastToleranceRate = 1.0e-5f;
+
+// 値を並べて、ほぼ同じ値をまとめた数を格子点の数とする。等間隔でなければfalse
+bool FindGridAxis(std::vector<float>& values, float tolerance, float& origin, float& cellSize, uint32_t& count) {
+	std::sort(values.begin(), values.end());
+	std::vector<float> lines;
+	for (float value : values) {
+		if (lines.empty() || value - lines.back() > tolerance) {
+			lines.push_back(value);
+		}
+	}
+	if (lines.size() < 2) {
+		return false;
+	}
+	origin = lines.front();
+	cellSize = (values.back() - values.front()) / static_cast<float>(lines.size() - 1);
+	count = static_cast<uint32_t>(lines.size());
+	for (size_t i = 0; i < lines.size(); i++) {
+		if (std::fabs(lines[i] - (origin + cellSize * static_cast<float>(i))) > cellSize * kGridSnapRate) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// 格子点の番号に丸める。格子点から離れていればfalse
+bool SnapToGrid(float value, float origin, float cellSize, uint32_t count, uint32_t& index) {
+	const float position = (value - origin) / cellSize;
+	const float rounded = std::round(position);
+	if (std::fabs(position - rounded) > kGridSnapRate || rounded < 0.0f || rounded >= static_cast<float>(count)) {
+		return false;
+	}
+	index = static_cast<uint32_t>(rounded);
+	return true;
+}
+
+// 三角形をXZ平面の範囲で切り取った多角形の頂点のうち、一番高いもの(面の上の点なので高さは平面のまま)
+bool FindHighestClippedPoint(const Triangle& triangle, float minX, float minZ, float maxX, float maxZ, Vector3& highest) {
+	// 三角形を4本の辺で切ると最大で7角形になる
+	Vector3 buffers[2][8];
+	size_t counts[2] = { 3, 0 };
+	std::copy(std::begin(triangle.vertices), std::end(triangle.vertices), buffers[0]);
+	int current = 0;
+	for (int plane = 0; plane < 4; plane++) {
+		// 範囲の内側ほど大きくなる距離
+		auto distance = [plane, minX, minZ, maxX, maxZ](const Vector3& p) {
+			switch (plane) {
+			case 0: return p.x - minX;
+			case 1: return maxX - p.x;
+			case 2: return p.z - minZ;
+			default: return maxZ - p.z;
+			}
+		};
+		const Vector3* input = buffers[current];
+		Vector3* output = buffers[1 - current];
+		const size_t inputCount = counts[current];
+		size_t outputCount = 0;
+		for (size_t i = 0; i < inputCount; i++) {
+			const Vector3& p0 = input[i];
+			const Vector3& p1 = input[(i + 1) % inputCount];
+			const float d0 = distance(p0);
+			const float d1 = distance(p1);
+			if (d0 >= 0.0f) {
+				output[outputCount++] = p0;
+			}
+			if ((d0 >= 0.0f) != (d1 >= 0.0f)) {
+				output[outputCount++] = p0 + (p1 - p0) * (d0 / (d0 - d1));
+			}
+		}
+		counts[1 - current] = outputCount;
+		current = 1 - current;
+		if (outputCount == 0) {
+			return false;
+		}
+	}
+	highest = buffers[current][0];
+	for (size_t i = 1; i < counts[current]; i++) {
+		if (buffers[current][i].y > highest.y) {
+			highest = buffers[current][i];
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+void HeightField::Initialize(const float* heights, uint32_t countX, uint32_t countZ, const Vector3& origin, float cellSizeX, float cellSizeZ) {
+	assert(heights);
+	assert(countX >= 2 && countZ >= 2);
+	assert(cellSizeX > 0.0f && cellSizeZ > 0.0f);
+	this->heights.assign(heights, heights + static_cast<size_t>(countX) * countZ);
+	diagonals.assign(static_cast<size_t>(countX - 1) * (countZ - 1), 0);
+	this->countX = countX;
+	this->countZ = countZ;
+	originX = origin.x;
+	originZ = origin.z;
+	this->cellSizeX = cellSizeX;
+	this->cellSizeZ = cellSizeZ;
+	inverseCellSizeX = 1.0f / cellSizeX;
+	inverseCellSizeZ = 1.0f / cellSizeZ;
+	UpdateBounds();
+}
+
+bool HeightField::BuildFromMesh(const Vector3* positions, size_t vertexCount) {
+	assert(positions || vertexCount == 0);
+	assert(vertexCount % 3 == 0);
+	heights.clear();
+	diagonals.clear();
+	if (vertexCount == 0) {
+		return false;
+	}
+
+	// X, Zの値から格子の間隔と数を求める
+	std::vector<float> xs(vertexCount);
+	std::vector<float> zs(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++) {
+		xs[i] = positions[i].x;
+		zs[i] = positions[i].z;
+	}
+	const float extent = std::max(*std::max_element(xs.begin(), xs.end()) - *std::min_element(xs.begin(), xs.end()),
+		*std::max_element(zs.begin(), zs.end()) - *std::min_element(zs.begin(), zs.end()));
+	const float tolerance = extent * kGridToleranceRate;
+	float gridOriginX, gridOriginZ, gridCellSizeX, gridCellSizeZ;
+	uint32_t gridCountX, gridCountZ;
+	if (!FindGridAxis(xs, tolerance, gridOriginX, gridCellSizeX, gridCountX) ||
+		!FindGridAxis(zs, tolerance, gridOriginZ, gridCellSizeZ, gridCountZ)) {
+		return false;
+	}
+
+	// 頂点を格子点に置く(同じ格子点に違う高さがあれば格子ではない)
+	const uint32_t cellCountX = gridCountX - 1;
+	std::vector<float> gridHeights(static_cast<size_t>(gridCountX) * gridCountZ, 0.0f);
+	std::vector<uint8_t> isFilled(gridHeights.size(), 0);
+	std::vector<uint8_t> gridDiagonals(static_cast<size_t>(cellCountX) * (gridCountZ - 1), 0);
+	std::vector<uint8_t> triangleCounts(gridDiagonals.size(), 0);
+	for (size_t i = 0; i < vertexCount; i += 3) {
+		uint32_t xIndices[3], zIndices[3];
+		for (size_t k = 0; k < 3; k++) {
+			const Vector3& p = positions[i + k];
+			if (!SnapToGrid(p.x, gridOriginX, gridCellSizeX, gridCountX, xIndices[k]) ||
+				!SnapToGrid(p.z, gridOriginZ, gridCellSizeZ, gridCountZ, zIndices[k])) {
+				return false;
+			}
+			const size_t index = static_cast<size_t>(zIndices[k]) * gridCountX + xIndices[k];
+			if (isFilled[index] && std::fabs(gridHeights[index] - p.y) > tolerance) {
+				return false;
+			}
+			gridHeights[index] = p.y;
+			isFilled[index] = 1;
+		}
+
+		// 三角形は1マスの半分になっていること
+		const uint32_t cellX = std::min({ xIndices[0], xIndices[1], xIndices[2] });
+		const uint32_t cellZ = std::min({ zIndices[0], zIndices[1], zIndices[2] });
+		if (std::max({ xIndices[0], xIndices[1], xIndices[2] }) != cellX + 1 ||
+			std::max({ zIndices[0], zIndices[1], zIndices[2] }) != cellZ + 1) {
+			return false;
+		}
+		// XもZも違う2頂点が対角線
+		uint8_t diagonal = 0;
+		for (size_t k = 0; k < 3; k++) {
+			const size_t next = (k + 1) % 3;
+			if (xIndices[k] != xIndices[next] && zIndices[k] != zIndices[next]) {
+				diagonal = (xIndices[k] < xIndices[next]) == (zIndices[k] < zIndices[next]) ? 0 : 1;
+			}
+		}
+		const size_t cell = static_cast<size_t>(cellZ) * cellCountX + cellX;
+		if (triangleCounts[cell] > 0 && gridDiagonals[cell] != diagonal) {
+			return false;
+		}
+		gridDiagonals[cell] = diagonal;
+		triangleCounts[cell]++;
+	}
+	// 全てのマスがちょうど2つの三角形で埋まっていること
+	if (std::any_of(triangleCounts.begin(), triangleCounts.end(), [](uint8_t count) { return count != 2; })) {
+		return false;
+	}
+
+	Initialize(gridHeights.data(), gridCountX, gridCountZ, { gridOriginX, 0.0f, gridOriginZ }, gridCellSizeX, gridCellSizeZ);
+	diagonals = std::move(gridDiagonals);
+	return true;
+}
+
+void HeightField::BuildFromImage(const uint8_t* pixels, uint32_t width, uint32_t height, size_t rowPitch, size_t bytesPerPixel, const Vector3& origin, const Vector3& size) {
+	assert(pixels);
+	assert(width >= 2 && height >= 2);
+	std::vector<float> imageHeights(static_cast<size_t>(width) * height);
+	const float scale = size.y / 255.0f;
+	for (uint32_t z = 0; z < height; z++) {
+		const uint8_t* row = pixels + rowPitch * z;
+		for (uint32_t x = 0; x < width; x++) {
+			imageHeights[static_cast<size_t>(z) * width + x] = origin.y + static_cast<float>(row[bytesPerPixel * x]) * scale;
+		}
+	}
+	Initialize(imageHeights.data(), width, height, origin, size.x / static_cast<float>(width - 1), size.z / static_cast<float>(height - 1));
+}
+
+bool HeightField::GetHeight(float x, float z, float& height) const {
+	uint32_t cellX, cellZ;
+	float u, v;
+	if (!FindCell(x, z, cellX, cellZ, u, v)) {
+		return false;
+	}
+	float slopeX, slopeZ;
+	height = SampleCell(cellX, cellZ, u, v, slopeX, slopeZ);
+	return true;
+}
+
+bool HeightField::GetHeight(float x, float z, float& height, Vector3& normal) const {
+	uint32_t cellX, cellZ;
+	float u, v;
+	if (!FindCell(x, z, cellX, cellZ, u, v)) {
+		return false;
+	}
+	float slopeX, slopeZ;
+	height = SampleCell(cellX, cellZ, u, v, slopeX, slopeZ);
+	normal = Normalize(Vector3{ -slopeX, 1.0f, -slopeZ });
+	return true;
+}
+
+bool HeightField::Raycast(const Ray& ray, RaycastHit& hit) const {
+	if (!IsValid()) {
+		return false;
+	}
+
+	// 格子全体を囲むAABBに入ってから出るまでの範囲を求める
+	const RayBoxQuery query = MakeRayBoxQuery(ray.origin, ray.direction);
+	float enter;
+	if (!IntersectRayBox(query, bounds, ray.maxDistance, enter)) {
+		return false;
+	}
+	const float exit = std::min({
+		std::max((bounds.min.x - ray.origin.x) * query.inverseDirection.x, (bounds.max.x - ray.origin.x) * query.inverseDirection.x),
+		std::max((bounds.min.y - ray.origin.y) * query.inverseDirection.y, (bounds.max.y - ray.origin.y) * query.inverseDirection.y),
+		std::max((bounds.min.z - ray.origin.z) * query.inverseDirection.z, (bounds.max.z - ray.origin.z) * query.inverseDirection.z),
+		ray.maxDistance });
+
+	// 入った位置のマスから、レイが横切るマスを近い順にたどる
+	const Vector3 start = ray.origin + ray.direction * enter;
+	const uint32_t cellCountX = countX - 1;
+	const uint32_t cellCountZ = countZ - 1;
+	int32_t cellX = static_cast<int32_t>(std::clamp((start.x - originX) * inverseCellSizeX, 0.0f, static_cast<float>(cellCountX - 1)));
+	int32_t cellZ = static_cast<int32_t>(std::clamp((start.z - originZ) * inverseCellSizeZ, 0.0f, static_cast<float>(cellCountZ - 1)));
+	const int32_t stepX = ray.direction.x > 0.0f ? 1 : -1;
+	const int32_t stepZ = ray.direction.z > 0.0f ? 1 : -1;
+	const float infinity = std::numeric_limits<float>::infinity();
+	const float deltaX = ray.direction.x != 0.0f ? cellSizeX / std::fabs(ray.direction.x) : infinity;
+	const float deltaZ = ray.direction.z != 0.0f ? cellSizeZ / std::fabs(ray.direction.z) : infinity;
+	float nextX = ray.direction.x != 0.0f ? (originX + cellSizeX * static_cast<float>(cellX + (stepX > 0 ? 1 : 0)) - ray.origin.x) / ray.direction.x : infinity;
+	float nextZ = ray.direction.z != 0.0f ? (originZ + cellSizeZ * static_cast<float>(cellZ + (stepZ > 0 ? 1 : 0)) - ray.origin.z) / ray.direction.z : infinity;
+
+	const float tolerance = kRaycastToleranceRate * (bounds.max.y - bounds.min.y + cellSizeX + cellSizeZ);
+	float t = enter;
+	while (true) {
+		// マスの中を通る間の高さの範囲がマスの高さの範囲と重ならなければ飛ばす
+		const float cellExit = std::min({ nextX, nextZ, exit });
+		const float y0 = ray.origin.y + ray.direction.y * t;
+		const float y1 = ray.origin.y + ray.direction.y * cellExit;
+		const float h00 = GetVertexHeight(cellX, cellZ);
+		const float h10 = GetVertexHeight(cellX + 1, cellZ);
+		const float h01 = GetVertexHeight(cellX, cellZ + 1);
+		const float h11 = GetVertexHeight(cellX + 1, cellZ + 1);
+		if (std::min(y0, y1) <= std::max({ h00, h10, h01, h11 }) + tolerance && std::max(y0, y1) >= std::min({ h00, h10, h01, h11 }) - tolerance) {
+			Triangle triangles[2];
+			GetCellTriangles(cellX, cellZ, triangles);
+			Ray limited = ray;
+			int hitTriangle = -1;
+			for (int i = 0; i < 2; i++) {
+				float distance;
+				if (RaycastTriangle(limited, triangles[i], distance)) {
+					limited.maxDistance = distance;
+					hitTriangle = i;
+				}
+			}
+			// マスは近い順にたどるので、最初に当たったマスの中で一番近いものが答え
+			if (hitTriangle >= 0) {
+				hit.distance = limited.maxDistance;
+				hit.point = ray.origin + ray.direction * limited.maxDistance;
+				const Vector3 normal = ComputeTriangleNormal(triangles[hitTriangle]);
+				hit.normal = Dot(normal, ray.direction) <= 0.0f ? normal : -normal;
+				hit.triangle = (static_cast<uint32_t>(cellZ) * cellCountX + static_cast<uint32_t>(cellX)) * 2 + static_cast<uint32_t>(hitTriangle);
+				return true;
+			}
+		}
+
+		if (cellExit >= exit) {
+			return false;
+		}
+		if (nextX < nextZ) {
+			cellX += stepX;
+			if (cellX < 0 || cellX >= static_cast<int32_t>(cellCountX)) {
+				return false;
+			}
+			t = nextX;
+			nextX += deltaX;
+		} else {
+			cellZ += stepZ;
+			if (cellZ < 0 || cellZ >= static_cast<int32_t>(cellCountZ)) {
+				return false;
+			}
+			t = nextZ;
+			nextZ += deltaZ;
+		}
+	}
+}
+
+bool HeightField::CheckCollision(const Sphere& sphere, Contact& contact) const {
+	if (!IsValid() || sphere.center.y - sphere.radius > bounds.max.y) {
+		return false;
+	}
+
+	// 中心が面より下にあれば面の法線の向きに押し出す
+	uint32_t cellX, cellZ;
+	float u, v;
+	if (FindCell(sphere.center.x, sphere.center.z, cellX, cellZ, u, v)) {
+		float slopeX, slopeZ;
+		const float height = SampleCell(cellX, cellZ, u, v, slopeX, slopeZ);
+		if (sphere.center.y < height) {
+			contact.normal = Normalize(Vector3{ -slopeX, 1.0f, -slopeZ });
+			contact.depth = (height - sphere.center.y) * contact.normal.y + sphere.radius;
+			contact.point = { sphere.center.x, height, sphere.center.z };
+			return true;
+		}
+	}
+
+	// 球と重なるマスの三角形の中で一番深く当たっているもの
+	uint32_t beginX, beginZ, endX, endZ;
+	if (!FindCellRange(sphere.center.x - sphere.radius, sphere.center.z - sphere.radius, sphere.center.x + sphere.radius, sphere.center.z + sphere.radius, beginX, beginZ, endX, endZ)) {
+		return false;
+	}
+	const float lowest = sphere.center.y - sphere.radius;
+	float bestDistanceSq = sphere.radius * sphere.radius;
+	bool isHit = false;
+	for (uint32_t z = beginZ; z <= endZ; z++) {
+		for (uint32_t x = beginX; x <= endX; x++) {
+			if (std::max({ GetVertexHeight(x, z), GetVertexHeight(x + 1, z), GetVertexHeight(x, z + 1), GetVertexHeight(x + 1, z + 1) }) < lowest) {
+				continue;
+			}
+			Triangle triangles[2];
+			GetCellTriangles(x, z, triangles);
+			for (const Triangle& triangle : triangles) {
+				const Vector3 closest = ClosestPointOnTriangle(sphere.center, triangle);
+				const Vector3 offset = sphere.center - closest;
+				const float distanceSq = Dot(offset, offset);
+				if (distanceSq < bestDistanceSq || (!isHit && distanceSq <= bestDistanceSq)) {
+					bestDistanceSq = distanceSq;
+					const float distance = std::sqrt(distanceSq);
+					contact.normal = distance > 0.0f ? offset * (1.0f / distance) : ComputeTriangleNormal(triangle);
+					contact.depth = sphere.radius - distance;
+					contact.point = closest;
+					isHit = true;
+				}
+			}
+		}
+	}
+	return isHit;
+}
+
+bool HeightField::CheckCollision(const AABB& aabb, Contact& contact) const {
+	if (!IsValid() || aabb.min.y > bounds.max.y) {
+		return false;
+	}
+	uint32_t beginX, beginZ, endX, endZ;
+	if (!FindCellRange(aabb.min.x, aabb.min.z, aabb.max.x, aabb.max.z, beginX, beginZ, endX, endZ)) {
+		return false;
+	}
+
+	// AABBの真下の範囲で切り取った三角形の頂点のうち一番高い点(面は平らな三角形なので頂点だけ調べればよい)
+	Vector3 highest{ 0.0f, aabb.min.y, 0.0f };
+	bool isHit = false;
+	for (uint32_t z = beginZ; z <= endZ; z++) {
+		for (uint32_t x = beginX; x <= endX; x++) {
+			const float cellMax = std::max({ GetVertexHeight(x, z), GetVertexHeight(x + 1, z), GetVertexHeight(x, z + 1), GetVertexHeight(x + 1, z + 1) });
+			if (cellMax < highest.y) {
+				continue;
+			}
+			Triangle triangles[2];
+			GetCellTriangles(x, z, triangles);
+			for (const Triangle& triangle : triangles) {
+				Vector3 point;
+				if (FindHighestClippedPoint(triangle, aabb.min.x, aabb.min.z, aabb.max.x, aabb.max.z, point) && point.y >= highest.y) {
+					highest = point;
+					isHit = true;
+				}
+			}
+		}
+	}
+	if (!isHit) {
+		return false;
+	}
+	contact.normal = { 0.0f, 1.0f, 0.0f };
+	contact.depth = highest.y - aabb.min.y;
+	contact.point = highest;
+	return true;
+}
+
+void HeightField::GetCellTriangles(uint32_t cellX, uint32_t cellZ, Triangle (&triangles)[2]) const {
+	const float x0 = originX + cellSizeX * static_cast<float>(cellX);
+	const float z0 = originZ + cellSizeZ * static_cast<float>(cellZ);
+	const Vector3 p00{ x0, GetVertexHeight(cellX, cellZ), z0 };
+	const Vector3 p10{ x0 + cellSizeX, GetVertexHeight(cellX + 1, cellZ), z0 };
+	const Vector3 p01{ x0, GetVertexHeight(cellX, cellZ + 1), z0 + cellSizeZ };
+	const Vector3 p11{ x0 + cellSizeX, GetVertexHeight(cellX + 1, cellZ + 1), z0 + cellSizeZ };
+	if (diagonals[static_cast<size_t>(cellZ) * (countX - 1) + cellX] == 0) {
+		triangles[0] = { { p00, p10, p11 } };
+		triangles[1] = { { p00, p11, p01 } };
+	} else {
+		triangles[0] = { { p00, p10, p01 } };
+		triangles[1] = { { p10, p11, p01 } };
+	}
+}
+
+float HeightField::SampleCell(uint32_t cellX, uint32_t cellZ, float u, float v, float& slopeX, float& slopeZ) const {
+	const float h00 = GetVertexHeight(cellX, cellZ);
+	const float h10 = GetVertexHeight(cellX + 1, cellZ);
+	const float h01 = GetVertexHeight(cellX, cellZ + 1);
+	const float h11 = GetVertexHeight(cellX + 1, cellZ + 1);
+	// 対角線で分けた三角形の平面で補間する
+	float slopeU, slopeV, height;
+	if (diagonals[static_cast<size_t>(cellZ) * (countX - 1) + cellX] == 0) {
+		if (u >= v) {
+			slopeU = h10 - h00;
+			slopeV = h11 - h10;
+		} else {
+			slopeU = h11 - h01;
+			slopeV = h01 - h00;
+		}
+		height = h00 + slopeU * u + slopeV * v;
+	} else {
+		if (u + v <= 1.0f) {
+			slopeU = h10 - h00;
+			slopeV = h01 - h00;
+			height = h00 + slopeU * u + slopeV * v;
+		} else {
+			slopeU = h11 - h01;
+			slopeV = h11 - h10;
+			height = h11 + slopeU * (u - 1.0f) + slopeV * (v - 1.0f);
+		}
+	}
+	slopeX = slopeU * inverseCellSizeX;
+	slopeZ = slopeV * inverseCellSizeZ;
+	return height;
+}
+
+bool HeightField::FindCell(float x, float z, uint32_t& cellX, uint32_t& cellZ, float& u, float& v) const {
+	const float gridX = (x - originX) * inverseCellSizeX;
+	const float gridZ = (z - originZ) * inverseCellSizeZ;
+	// NaNもここで弾く
+	if (!(gridX >= 0.0f && gridX <= static_cast<float>(countX - 1) && gridZ >= 0.0f && gridZ <= static_cast<float>(countZ - 1))) {
+		return false;
+	}
+	cellX = std::min(static_cast<uint32_t>(gridX), countX - 2);
+	cellZ = std::min(static_cast<uint32_t>(gridZ), countZ - 2);
+	u = gridX - static_cast<float>(cellX);
+	v = gridZ - static_cast<float>(cellZ);
+	return true;
+}
+
+bool HeightField::FindCellRange(float minX, float minZ, float maxX, float maxZ, uint32_t& beginX, uint32_t& beginZ, uint32_t& endX, uint32_t& endZ) const {
+	if (maxX < bounds.min.x || minX > bounds.max.x || maxZ < bounds.min.z || minZ > bounds.max.z) {
+		return false;
+	}
+	const float lastX = static_cast<float>(countX - 2);
+	const float lastZ = static_cast<float>(countZ - 2);
+	beginX = static_cast<uint32_t>(std::clamp((minX - originX) * inverseCellSizeX, 0.0f, lastX));
+	beginZ = static_cast<uint32_t>(std::clamp((minZ - originZ) * inverseCellSizeZ, 0.0f, lastZ));
+	endX = static_cast<uint32_t>(std::clamp((maxX - originX) * inverseCellSizeX, 0.0f, lastX));
+	endZ = static_cast<uint32_t>(std::clamp((maxZ - originZ) * inverseCellSizeZ, 0.0f, lastZ));
+	return true;
+}
+
+void HeightField::UpdateBounds() {
+	const auto [minHeight, maxHeight] = std::minmax_element(heights.begin(), heights.end());
+	bounds.min = { originX, *minHeight, originZ };
+	bounds.max = { originX + cellSizeX * static_cast<float>(countX - 1), *maxHeight, originZ + cellSizeZ * static_cast<float>(countZ - 1) };
+}
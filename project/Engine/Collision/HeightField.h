@@ -0,0 +1,109 @@
+#pragma once
+#include "AABB.h"
+#include "Sphere.h"
+#include "Ray.h"
+#include "NarrowPhase.h"
+#include "TriangleBVH.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 地形用の高さの格子(XZ平面の等間隔な格子点ごとに高さを持つ)
+// 格子の1マスを対角線で2つの三角形に分けた面として扱い、面より下は中身が詰まっているものとする
+// 高さは格子のマスを直接引くので、三角形をたどらずに定数時間で求まる
+class HeightField {
+public:
+	/// <summary>
+	/// 高さの配列から作る
+	/// </summary>
+	/// <param name="heights">countX * countZ個の高さ(heights[z * countX + x])</param>
+	/// <param name="countX">X方向の格子点の数(2以上)</param>
+	/// <param name="countZ">Z方向の格子点の数(2以上)</param>
+	/// <param name="origin">格子点(0, 0)のX, Z座標(yは使わない)</param>
+	/// <param name="cellSizeX">X方向の間隔</param>
+	/// <param name="cellSizeZ">Z方向の間隔</param>
+	void Initialize(const float* heights, uint32_t countX, uint32_t countZ, const Vector3& origin, float cellSizeX, float cellSizeZ);
+
+	/// <summary>
+	/// 等間隔な格子の三角形メッシュから作る(terrain.objのようなもの。Model::GetVerticesをGetIndicesの順に並べたもの)
+	/// マスの分け方(対角線の向き)もメッシュに合わせる
+	/// </summary>
+	/// <param name="positions">頂点(3つずつで1つの三角形)</param>
+	/// <param name="vertexCount">頂点の数</param>
+	/// <returns>格子になっていない(抜けや重なりがある)場合はfalse</returns>
+	bool BuildFromMesh(const Vector3* positions, size_t vertexCount);
+
+	/// <summary>
+	/// ハイトマップ画像から作る(各画素の先頭の1バイトを高さとして使う。画像の行がZ方向、列がX方向)
+	/// DirectX::ScratchImageなどで8bitの形式に変換してから画素を渡す
+	/// </summary>
+	/// <param name="pixels">画素の先頭</param>
+	/// <param name="width">画像の幅(2以上)</param>
+	/// <param name="height">画像の高さ(2以上)</param>
+	/// <param name="rowPitch">1行のバイト数</param>
+	/// <param name="bytesPerPixel">1画素のバイト数</param>
+	/// <param name="origin">画素(0, 0)の位置(高さ0の位置)</param>
+	/// <param name="size">画像全体の大きさ(yは画素の値が255のときの高さ)</param>
+	void BuildFromImage(const uint8_t* pixels, uint32_t width, uint32_t height, size_t rowPitch, size_t bytesPerPixel, const Vector3& origin, const Vector3& size);
+
+	// 位置(x, z)の高さ。格子の外ならfalse
+	bool GetHeight(float x, float z, float& height) const;
+
+	// 位置(x, z)の高さと面の法線。格子の外ならfalse
+	bool GetHeight(float x, float z, float& height, Vector3& normal) const;
+
+	// 面とのレイキャスト(レイが通るマスだけを順にたどる)。hit.triangleはマスの番号 * 2 + マスの中の三角形の番号
+	bool Raycast(const Ray& ray, RaycastHit& hit) const;
+
+	// 面と球の判定(contact.normalは面から球へ向かう向き。中心が面より下にあれば面の法線の向きに押し出す)
+	bool CheckCollision(const Sphere& sphere, Contact& contact) const;
+
+	// 面とAABBの判定(AABBの真下で一番高い面の点まで真上に押し出す。contact.normalは常に上向き)
+	bool CheckCollision(const AABB& aabb, Contact& contact) const;
+
+	// Getter(格子点の数)
+	uint32_t GetCountX() const { return countX; }
+	uint32_t GetCountZ() const { return countZ; }
+
+	// Getter(格子全体を囲むAABB)
+	const AABB& GetBounds() const { return bounds; }
+
+	// 作られているか
+	bool IsValid() const { return !heights.empty(); }
+
+private:
+	// マスの2つの三角形を求める(0はZが小さい側の辺を含む三角形)
+	void GetCellTriangles(uint32_t cellX, uint32_t cellZ, Triangle (&triangles)[2]) const;
+
+	// マスの中の位置(u, v: 0〜1)の高さとX, Z方向の傾き
+	float SampleCell(uint32_t cellX, uint32_t cellZ, float u, float v, float& slopeX, float& slopeZ) const;
+
+	// 位置(x, z)のあるマスと、マスの中の位置を求める。格子の外ならfalse
+	bool FindCell(float x, float z, uint32_t& cellX, uint32_t& cellZ, float& u, float& v) const;
+
+	// 範囲[min, max]と重なるマスの範囲を求める。重ならなければfalse
+	bool FindCellRange(float minX, float minZ, float maxX, float maxZ, uint32_t& beginX, uint32_t& beginZ, uint32_t& endX, uint32_t& endZ) const;
+
+	// 格子点の高さ
+	float GetVertexHeight(uint32_t x, uint32_t z) const { return heights[z * countX + x]; }
+
+	// 高さの範囲を求め直す
+	void UpdateBounds();
+
+private:
+	std::vector<float> heights;
+	// マスの対角線の向き(0: (x0, z0)-(x1, z1)、1: (x1, z0)-(x0, z1))
+	std::vector<uint8_t> diagonals;
+
+	uint32_t countX = 0;
+	uint32_t countZ = 0;
+	float originX = 0.0f;
+	float originZ = 0.0f;
+	float cellSizeX = 1.0f;
+	float cellSizeZ = 1.0f;
+	float inverseCellSizeX = 1.0f;
+	float inverseCellSizeZ = 1.0f;
+
+	AABB bounds{};
+};
@@ -0,0 +1,411 @@
+#include "NarrowPhase.h"
+#include "kMath.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// まとめて判定するときに1回の並列処理で扱うペアの数
+constexpr size_t kPairsPerBatch = 1024;
+
+// 分離軸として使わないほど短い外積(平行な辺の組)
+constexpr float kParallelEpsilon = 1.0e-6f;
+// 辺同士の軸は面の軸よりこれだけ浅くないと選ばない(法線がばたつかないようにする)
+constexpr float kEdgeAxisBias = 1.05f;
+
+// 成分の取り出し
+float GetAxis(const Vector3& v, int axis) {
+	return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+}
+
+// 軸の単位ベクトル
+Vector3 UnitAxis(int axis) {
+	return axis == 0 ? Vector3{ 1.0f, 0.0f, 0.0f } : axis == 1 ? Vector3{ 0.0f, 1.0f, 0.0f } : Vector3{ 0.0f, 0.0f, 1.0f };
+}
+
+// 点に最も近いAABB上の点
+Vector3 ClosestPoint(const AABB& aabb, const Vector3& point) {
+	return Vector3{
+		std::clamp(point.x, aabb.min.x, aabb.max.x),
+		std::clamp(point.y, aabb.min.y, aabb.max.y),
+		std::clamp(point.z, aabb.min.z, aabb.max.z)
+	};
+}
+
+// OBBを軸に投影したときの半径
+float ProjectRadius(const OBB& obb, const Vector3& axis) {
+	return obb.size.x * std::fabs(Dot(obb.orientation[0], axis)) +
+	       obb.size.y * std::fabs(Dot(obb.orientation[1], axis)) +
+	       obb.size.z * std::fabs(Dot(obb.orientation[2], axis));
+}
+
+// direction方向に最も遠いOBBの頂点
+Vector3 SupportPoint(const OBB& obb, const Vector3& direction) {
+	Vector3 result = obb.center;
+	for (int i = 0; i < 3; i++) {
+		const float sign = Dot(obb.orientation[i], direction) >= 0.0f ? 1.0f : -1.0f;
+		result += obb.orientation[i] * (GetAxis(obb.size, i) * sign);
+	}
+	return result;
+}
+
+// 球とローカル座標のAABB(中心が原点で半分の大きさがhalf)の判定
+bool CollideLocalBoxSphere(const Vector3& half, const Vector3& center, float radius, Vector3& normal, float& depth, Vector3& point) {
+	const Vector3 closest{
+		std::clamp(center.x, -half.x, half.x),
+		std::clamp(center.y, -half.y, half.y),
+		std::clamp(center.z, -half.z, half.z)
+	};
+	const Vector3 d = center - closest;
+	const float distanceSq = Dot(d, d);
+	if (distanceSq > radius * radius) {
+		return false;
+	}
+
+	if (distanceSq > 0.0f) {
+		// 中心が箱の外: 最近接点から中心への向き
+		const float distance = std::sqrt(distanceSq);
+		normal = d * (1.0f / distance);
+		depth = radius - distance;
+		point = closest;
+		return true;
+	}
+
+	// 中心が箱の中: 一番近い面から押し出す
+	int axis = 0;
+	float faceDistance = half.x - std::fabs(center.x);
+	for (int i = 1; i < 3; i++) {
+		const float distance = GetAxis(half, i) - std::fabs(GetAxis(center, i));
+		if (distance < faceDistance) {
+			faceDistance = distance;
+			axis = i;
+		}
+	}
+	const float sign = GetAxis(center, axis) >= 0.0f ? 1.0f : -1.0f;
+	normal = UnitAxis(axis) * sign;
+	depth = radius + faceDistance;
+	point = center + normal * faceDistance;
+	return true;
+}
+
+// 中心と投影半径から平面との判定をする(球・AABB・OBB共通)
+bool CollidePlane(const Vector3& center, float radius, const Plane& plane, Contact* contact) {
+	const float signedDistance = Dot(plane.normal, center) - plane.distance;
+	if (std::fabs(signedDistance) > radius) {
+		return false;
+	}
+	if (contact) {
+		// 形状のある側から平面へ向かう向き
+		const float side = signedDistance >= 0.0f ? 1.0f : -1.0f;
+		contact->normal = plane.normal * -side;
+		contact->depth = radius - std::fabs(signedDistance);
+		contact->point = center - plane.normal * signedDistance;
+	}
+	return true;
+}
+
+// OBB同士の分離軸判定
+// bの軸をaの座標系で表した回転行列を先に求めて、15本の軸を内積の組み合わせだけで調べる
+bool CollideOBB(const OBB& a, const OBB& b, Contact* contact) {
+	float rotation[3][3];
+	float absRotation[3][3];
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			rotation[i][j] = Dot(a.orientation[i], b.orientation[j]);
+			// 平行な辺の組で外積が0になっても誤判定しないように少し足す
+			absRotation[i][j] = std::fabs(rotation[i][j]) + kParallelEpsilon;
+		}
+	}
+	const Vector3 offset = b.center - a.center;
+	const float t[3] = { Dot(offset, a.orientation[0]), Dot(offset, a.orientation[1]), Dot(offset, a.orientation[2]) };
+	const float ea[3] = { a.size.x, a.size.y, a.size.z };
+	const float eb[3] = { b.size.x, b.size.y, b.size.z };
+
+	// めり込みが一番浅い軸(種類: 0ならaの面、1ならbの面、2なら辺同士)
+	float bestDepth = 0.0f;
+	int bestType = -1;
+	int bestI = 0;
+	int bestJ = 0;
+	float bestSign = 1.0f;
+	// 調べた軸のめり込み量を比べる(lengthは軸の長さ。辺同士の軸は正規化していない)
+	auto record = [&](float distance, float overlap, float length, int type, int i, int j) {
+		if (!contact) {
+			return;
+		}
+		const float depth = overlap / length;
+		const float biased = type == 2 ? depth * kEdgeAxisBias : depth;
+		if (bestType < 0 || biased < bestDepth) {
+			bestDepth = depth;
+			bestType = type;
+			bestI = i;
+			bestJ = j;
+			bestSign = distance >= 0.0f ? 1.0f : -1.0f;
+		}
+	};
+
+	// aの面の軸
+	for (int i = 0; i < 3; i++) {
+		const float rb = eb[0] * absRotation[i][0] + eb[1] * absRotation[i][1] + eb[2] * absRotation[i][2];
+		const float overlap = ea[i] + rb - std::fabs(t[i]);
+		if (overlap < 0.0f) {
+			return false;
+		}
+		record(t[i], overlap, 1.0f, 0, i, 0);
+	}
+	// bの面の軸
+	for (int j = 0; j < 3; j++) {
+		const float ra = ea[0] * absRotation[0][j] + ea[1] * absRotation[1][j] + ea[2] * absRotation[2][j];
+		const float distance = t[0] * rotation[0][j] + t[1] * rotation[1][j] + t[2] * rotation[2][j];
+		const float overlap = ra + eb[j] - std::fabs(distance);
+		if (overlap < 0.0f) {
+			return false;
+		}
+		record(distance, overlap, 1.0f, 1, 0, j);
+	}
+	// 辺同士の軸(aの軸i × bの軸j)
+	for (int i = 0; i < 3; i++) {
+		const int i1 = (i + 1) % 3;
+		const int i2 = (i + 2) % 3;
+		for (int j = 0; j < 3; j++) {
+			const int j1 = (j + 1) % 3;
+			const int j2 = (j + 2) % 3;
+			const float ra = ea[i1] * absRotation[i2][j] + ea[i2] * absRotation[i1][j];
+			const float rb = eb[j1] * absRotation[i][j2] + eb[j2] * absRotation[i][j1];
+			const float distance = t[i2] * rotation[i1][j] - t[i1] * rotation[i2][j];
+			const float overlap = ra + rb - std::fabs(distance);
+			if (overlap < 0.0f) {
+				return false;
+			}
+			// 平行な組は面の軸で調べ済みなので、めり込みの向きには使わない
+			const float lengthSq = 1.0f - rotation[i][j] * rotation[i][j];
+			if (lengthSq > kParallelEpsilon) {
+				record(distance, overlap, std::sqrt(lengthSq), 2, i, j);
+			}
+		}
+	}
+
+	if (contact) {
+		Vector3 axis;
+		if (bestType == 0) {
+			axis = a.orientation[bestI];
+		} else if (bestType == 1) {
+			axis = b.orientation[bestJ];
+		} else {
+			axis = Normalize(Cross(a.orientation[bestI], b.orientation[bestJ]));
+		}
+		axis = axis * bestSign;
+		contact->normal = axis;
+		contact->depth = bestDepth;
+		// bのaに一番めり込んでいる頂点から、めり込み量の半分だけ戻した位置
+		contact->point = SupportPoint(b, -axis) + axis * (bestDepth * 0.5f);
+	}
+	return true;
+}
+
+} // namespace
+
+OBB MakeOBB(const AABB& aabb) {
+	OBB obb;
+	obb.center = (aabb.min + aabb.max) * 0.5f;
+	obb.orientation[0] = { 1.0f, 0.0f, 0.0f };
+	obb.orientation[1] = { 0.0f, 1.0f, 0.0f };
+	obb.orientation[2] = { 0.0f, 0.0f, 1.0f };
+	obb.size = (aabb.max - aabb.min) * 0.5f;
+	return obb;
+}
+
+AABB MakeAABB(const OBB& obb) {
+	const Vector3 extent{
+		ProjectRadius(obb, { 1.0f, 0.0f, 0.0f }),
+		ProjectRadius(obb, { 0.0f, 1.0f, 0.0f }),
+		ProjectRadius(obb, { 0.0f, 0.0f, 1.0f })
+	};
+	return AABB{ obb.center - extent, obb.center + extent };
+}
+
+bool CheckCollision(const AABB& a, const AABB& b) {
+	return CollisionAABB(a, b);
+}
+
+bool CheckCollision(const AABB& a, const Sphere& b) {
+	const Vector3 d = ClosestPoint(a, b.center) - b.center;
+	return Dot(d, d) <= b.radius * b.radius;
+}
+
+bool CheckCollision(const AABB& a, const OBB& b) {
+	return CollideOBB(MakeOBB(a), b, nullptr);
+}
+
+bool CheckCollision(const AABB& a, const Plane& b) {
+	const Vector3 center = (a.min + a.max) * 0.5f;
+	const Vector3 half = (a.max - a.min) * 0.5f;
+	const float radius = half.x * std::fabs(b.normal.x) + half.y * std::fabs(b.normal.y) + half.z * std::fabs(b.normal.z);
+	return CollidePlane(center, radius, b, nullptr);
+}
+
+bool CheckCollision(const Sphere& a, const Sphere& b) {
+	const Vector3 d = b.center - a.center;
+	const float radius = a.radius + b.radius;
+	return Dot(d, d) <= radius * radius;
+}
+
+bool CheckCollision(const Sphere& a, const OBB& b) {
+	// OBBのローカル座標で判定する
+	const Vector3 d = a.center - b.center;
+	const Vector3 local{ Dot(d, b.orientation[0]), Dot(d, b.orientation[1]), Dot(d, b.orientation[2]) };
+	const Vector3 closest{
+		std::clamp(local.x, -b.size.x, b.size.x),
+		std::clamp(local.y, -b.size.y, b.size.y),
+		std::clamp(local.z, -b.size.z, b.size.z)
+	};
+	const Vector3 diff = local - closest;
+	return Dot(diff, diff) <= a.radius * a.radius;
+}
+
+bool CheckCollision(const Sphere& a, const Plane& b) {
+	return CollidePlane(a.center, a.radius, b, nullptr);
+}
+
+bool CheckCollision(const OBB& a, const OBB& b) {
+	return CollideOBB(a, b, nullptr);
+}
+
+bool CheckCollision(const OBB& a, const Plane& b) {
+	return CollidePlane(a.center, ProjectRadius(a, b.normal), b, nullptr);
+}
+
+bool CheckCollision(const AABB& a, const AABB& b, Contact& contact) {
+	if (!CollisionAABB(a, b)) {
+		return false;
+	}
+	// 押し出す距離が一番短い軸と向きを選ぶ(片方がもう片方に収まっている場合も考える)
+	int axis = 0;
+	float sign = 1.0f;
+	float depth = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		const float positive = GetAxis(a.max, i) - GetAxis(b.min, i);
+		const float negative = GetAxis(b.max, i) - GetAxis(a.min, i);
+		const float distance = std::min(positive, negative);
+		if (i == 0 || distance < depth) {
+			depth = distance;
+			axis = i;
+			sign = positive <= negative ? 1.0f : -1.0f;
+		}
+	}
+	contact.normal = UnitAxis(axis) * sign;
+	contact.depth = depth;
+	// 重なっている範囲の中心
+	const Vector3 overlapMin{ std::max(a.min.x, b.min.x), std::max(a.min.y, b.min.y), std::max(a.min.z, b.min.z) };
+	const Vector3 overlapMax{ std::min(a.max.x, b.max.x), std::min(a.max.y, b.max.y), std::min(a.max.z, b.max.z) };
+	contact.point = (overlapMin + overlapMax) * 0.5f;
+	return true;
+}
+
+bool CheckCollision(const AABB& a, const Sphere& b, Contact& contact) {
+	const Vector3 center = (a.min + a.max) * 0.5f;
+	const Vector3 half = (a.max - a.min) * 0.5f;
+	Vector3 normal;
+	float depth;
+	Vector3 point;
+	if (!CollideLocalBoxSphere(half, b.center - center, b.radius, normal, depth, point)) {
+		return false;
+	}
+	contact.normal = normal;
+	contact.depth = depth;
+	contact.point = point + center;
+	return true;
+}
+
+bool CheckCollision(const AABB& a, const OBB& b, Contact& contact) {
+	return CollideOBB(MakeOBB(a), b, &contact);
+}
+
+bool CheckCollision(const AABB& a, const Plane& b, Contact& contact) {
+	const Vector3 center = (a.min + a.max) * 0.5f;
+	const Vector3 half = (a.max - a.min) * 0.5f;
+	const float radius = half.x * std::fabs(b.normal.x) + half.y * std::fabs(b.normal.y) + half.z * std::fabs(b.normal.z);
+	return CollidePlane(center, radius, b, &contact);
+}
+
+bool CheckCollision(const Sphere& a, const Sphere& b, Contact& contact) {
+	const Vector3 d = b.center - a.center;
+	const float radius = a.radius + b.radius;
+	const float distanceSq = Dot(d, d);
+	if (distanceSq > radius * radius) {
+		return false;
+	}
+	const float distance = std::sqrt(distanceSq);
+	// 中心が重なっている場合は上に押し出す
+	contact.normal = distance > 0.0f ? d * (1.0f / distance) : Vector3{ 0.0f, 1.0f, 0.0f };
+	contact.depth = radius - distance;
+	contact.point = a.center + contact.normal * (a.radius - contact.depth * 0.5f);
+	return true;
+}
+
+bool CheckCollision(const Sphere& a, const OBB& b, Contact& contact) {
+	// OBBのローカル座標で判定してから戻す(法線はOBBから球への向きなので反転する)
+	const Vector3 d = a.center - b.center;
+	const Vector3 local{ Dot(d, b.orientation[0]), Dot(d, b.orientation[1]), Dot(d, b.orientation[2]) };
+	Vector3 normal;
+	float depth;
+	Vector3 point;
+	if (!CollideLocalBoxSphere(b.size, local, a.radius, normal, depth, point)) {
+		return false;
+	}
+	const Vector3 worldNormal = b.orientation[0] * normal.x + b.orientation[1] * normal.y + b.orientation[2] * normal.z;
+	contact.normal = -worldNormal;
+	contact.depth = depth;
+	contact.point = b.center + b.orientation[0] * point.x + b.orientation[1] * point.y + b.orientation[2] * point.z;
+	return true;
+}
+
+bool CheckCollision(const Sphere& a, const Plane& b, Contact& contact) {
+	return CollidePlane(a.center, a.radius, b, &contact);
+}
+
+bool CheckCollision(const OBB& a, const OBB& b, Contact& contact) {
+	return CollideOBB(a, b, &contact);
+}
+
+bool CheckCollision(const OBB& a, const Plane& b, Contact& contact) {
+	return CollidePlane(a.center, ProjectRadius(a, b.normal), b, &contact);
+}
+
+bool CheckCollision(const Collider& a, const Collider& b) {
+	return std::visit([](const auto& shapeA, const auto& shapeB) { return CheckCollision(shapeA, shapeB); }, a, b);
+}
+
+bool CheckCollision(const Collider& a, const Collider& b, Contact& contact) {
+	return std::visit([&contact](const auto& shapeA, const auto& shapeB) { return CheckCollision(shapeA, shapeB, contact); }, a, b);
+}
+
+size_t CheckCollisions(const Collider* colliders, const ProxyPair* pairs, size_t pairCount, std::vector<ContactPair>& outContacts) {
+	outContacts.clear();
+	auto check = [colliders, pairs](size_t begin, size_t end, std::vector<ContactPair>& contacts) {
+		for (size_t i = begin; i < end; i++) {
+			const ProxyPair& pair = pairs[i];
+			Contact contact;
+			if (CheckCollision(colliders[pair.a], colliders[pair.b], contact)) {
+				contacts.push_back({ pair.a, pair.b, contact });
+			}
+		}
+	};
+	const size_t batchCount = (pairCount + kPairsPerBatch - 1) / kPairsPerBatch;
+	if (batchCount <= 1) {
+		check(0, pairCount, outContacts);
+		return outContacts.size();
+	}
+
+	// バッチごとに結果を分けて判定し、バッチの順につなぐ(スレッド数によらず同じ順番になる)
+	std::vector<std::vector<ContactPair>> batchContacts(batchCount);
+	ThreadPool::GetInstance()->ParallelFor(batchCount, 1, [&](size_t begin, size_t end) {
+		for (size_t batch = begin; batch < end; batch++) {
+			check(batch * kPairsPerBatch, std::min((batch + 1) * kPairsPerBatch, pairCount), batchContacts[batch]);
+		}
+	});
+	for (const std::vector<ContactPair>& contacts : batchContacts) {
+		outContacts.insert(outContacts.end(), contacts.begin(), contacts.end());
+	}
+	return outContacts.size();
+}
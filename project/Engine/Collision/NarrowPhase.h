@@ -0,0 +1,119 @@
+#pragma once
+#include "AABB.h"
+#include "Sphere.h"
+#include "OBB.h"
+#include "Plane.h"
+#include "BroadPhase.h"
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+// 形状の約束
+// OBB: orientationは正規直交な軸、sizeは各軸方向の半分の長さ
+// Plane: dot(normal, p) = distanceを満たす点pの集合(normalは正規化されていること)。両面とも当たる
+
+// 衝突情報
+struct Contact {
+	// aからbへ向かう向き(bをnormal * depthだけ動かすと離れる)
+	Vector3 normal;
+	// めり込み量
+	float depth;
+	// 接触点(めり込んでいる部分の中心付近)
+	Vector3 point;
+};
+
+// AABBとAABBの当たり判定
+inline bool CollisionAABB(const AABB& a, const AABB& b) {
+	if ((a.min.x <= b.max.x && a.max.x >= b.min.x) &&
+		(a.min.y <= b.max.y && a.max.y >= b.min.y) &&
+		(a.min.z <= b.max.z && a.max.z >= b.min.z)) {
+		return true;
+	}
+	return false;
+}
+
+// 当たり判定(衝突しているかだけを求める)
+bool CheckCollision(const AABB& a, const AABB& b);
+bool CheckCollision(const AABB& a, const Sphere& b);
+bool CheckCollision(const AABB& a, const OBB& b);
+bool CheckCollision(const AABB& a, const Plane& b);
+bool CheckCollision(const Sphere& a, const Sphere& b);
+bool CheckCollision(const Sphere& a, const OBB& b);
+bool CheckCollision(const Sphere& a, const Plane& b);
+bool CheckCollision(const OBB& a, const OBB& b);
+bool CheckCollision(const OBB& a, const Plane& b);
+
+// 当たり判定(衝突していればcontactに衝突情報を書く)
+bool CheckCollision(const AABB& a, const AABB& b, Contact& contact);
+bool CheckCollision(const AABB& a, const Sphere& b, Contact& contact);
+bool CheckCollision(const AABB& a, const OBB& b, Contact& contact);
+bool CheckCollision(const AABB& a, const Plane& b, Contact& contact);
+bool CheckCollision(const Sphere& a, const Sphere& b, Contact& contact);
+bool CheckCollision(const Sphere& a, const OBB& b, Contact& contact);
+bool CheckCollision(const Sphere& a, const Plane& b, Contact& contact);
+bool CheckCollision(const OBB& a, const OBB& b, Contact& contact);
+bool CheckCollision(const OBB& a, const Plane& b, Contact& contact);
+
+// 順番を入れ替えたもの(法線の向きも入れ替わる)
+inline bool CheckCollision(const Sphere& a, const AABB& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const OBB& a, const AABB& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const OBB& a, const Sphere& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const Plane& a, const AABB& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const Plane& a, const Sphere& b) { return CheckCollision(b, a); }
+inline bool CheckCollision(const Plane& a, const OBB& b) { return CheckCollision(b, a); }
+
+template<typename A, typename B>
+inline bool CheckCollisionSwapped(const A& a, const B& b, Contact& contact) {
+	if (!CheckCollision(b, a, contact)) {
+		return false;
+	}
+	contact.normal = -contact.normal;
+	return true;
+}
+inline bool CheckCollision(const Sphere& a, const AABB& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+inline bool CheckCollision(const OBB& a, const AABB& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+inline bool CheckCollision(const OBB& a, const Sphere& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+inline bool CheckCollision(const Plane& a, const AABB& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+inline bool CheckCollision(const Plane& a, const Sphere& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+inline bool CheckCollision(const Plane& a, const OBB& b, Contact& contact) { return CheckCollisionSwapped(a, b, contact); }
+
+// 平面同士は動かない無限の形状なので判定しない(常にfalse)
+inline bool CheckCollision(const Plane&, const Plane&) { return false; }
+inline bool CheckCollision(const Plane&, const Plane&, Contact&) { return false; }
+
+// AABBをOBBとして扱う
+OBB MakeOBB(const AABB& aabb);
+
+// OBBを囲むAABB
+AABB MakeAABB(const OBB& obb);
+
+// 種類の違う形状をまとめて扱うためのコライダー
+using Collider = std::variant<AABB, Sphere, OBB, Plane>;
+
+// コライダー同士の当たり判定
+bool CheckCollision(const Collider& a, const Collider& b);
+bool CheckCollision(const Collider& a, const Collider& b, Contact& contact);
+
+// 衝突したペアと衝突情報
+struct ContactPair {
+	ProxyHandle a;
+	ProxyHandle b;
+	Contact contact;
+};
+
+// ブロードフェーズで求めたペアをまとめて判定する(colliders[pair.a]とcolliders[pair.b]を比べる)
+// 衝突したものだけoutContactsにペアの順で書き、その数を返す(outContactsは上書きする。ペアが多ければ並列に判定する)
+size_t CheckCollisions(const Collider* colliders, const ProxyPair* pairs, size_t pairCount, std::vector<ContactPair>& outContacts);
+
+// 1つの形状と配列をまとめて判定して、衝突した要素の番号を書く(outIndicesは上書きする)
+template<typename A, typename B>
+size_t CheckCollisions(const A& shape, const B* shapes, size_t count, std::vector<uint32_t>& outIndices) {
+	outIndices.clear();
+	for (size_t i = 0; i < count; i++) {
+		if (CheckCollision(shape, shapes[i])) {
+			outIndices.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	return outIndices.size();
+}
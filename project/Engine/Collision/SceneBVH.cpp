@@ -0,0 +1,192 @@
+#include "SceneBVH.h"
+#include "BoundingVolume.h"
+#include "ThreadPool.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// まとめて処理するときの1回分のレイの数
+constexpr size_t kRaysPerBatch = 64;
+
+} // namespace
+
+void SceneBVH::Clear() {
+	instances.clear();
+	nodes.clear();
+	order.clear();
+}
+
+uint32_t SceneBVH::AddInstance(const TriangleBVH* mesh, const Matrix3x4& world, void* userData) {
+	Instance instance;
+	instance.mesh = mesh;
+	instance.world = world;
+	instance.inverse = Inverse(world);
+	instance.bounds = TransformAABB(mesh->GetBounds(), world);
+	// 3x3部分のフロベニウスノルムは一番大きい伸び率以上になる
+	float sum = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			sum += instance.inverse.m[i][j] * instance.inverse.m[i][j];
+		}
+	}
+	instance.inverseScale = std::sqrt(sum);
+	instance.userData = userData;
+	instances.push_back(instance);
+	return static_cast<uint32_t>(instances.size() - 1);
+}
+
+void SceneBVH::RemoveInstance(uint32_t instance) {
+	instances[instance].mesh = nullptr;
+	instances[instance].userData = nullptr;
+}
+
+void SceneBVH::Build() {
+	std::vector<AABB> bounds(instances.size());
+	for (size_t i = 0; i < instances.size(); i++) {
+		bounds[i] = instances[i].bounds;
+	}
+	BuildBVH(bounds.data(), bounds.size(), nodes, order);
+}
+
+bool SceneBVH::Raycast(const Ray& ray, SceneHit& result, uint32_t ignoreInstance) const {
+	result.instance = kNoInstance;
+	float maxDistance = ray.maxDistance;
+	Triangle hitTriangle;
+	const RayBoxQuery query = MakeRayBoxQuery(ray.origin, ray.direction);
+	TraverseBVH(nodes, query, maxDistance, [&](uint32_t start, uint32_t count, float& distance) {
+		for (uint32_t i = start; i < start + count; i++) {
+			const Instance& instance = instances[order[i]];
+			if (order[i] == ignoreInstance || !instance.mesh) {
+				continue;
+			}
+			// ローカル座標に直しても距離(directionに対する割合)は変わらない
+			const Vector3 localOrigin = MatrixTransform(ray.origin, instance.inverse);
+			const Vector3 localDirection = TransformNormal(ray.direction, instance.inverse);
+			instance.mesh->TraverseRay(localOrigin, localDirection, 0.0f, distance,
+				[&](const Triangle& triangle, uint32_t index, float& maxT) {
+					const Ray local = { localOrigin, localDirection, maxT };
+					float t;
+					if (RaycastTriangle(local, triangle, t)) {
+						maxT = t;
+						result.instance = order[i];
+						result.hit.triangle = index;
+						hitTriangle = triangle;
+					}
+				});
+		}
+	});
+	if (result.instance == kNoInstance) {
+		return false;
+	}
+	// 法線はワールド座標の三角形から求める(スケールで向きが変わるため)
+	const Vector3 normal = ComputeTriangleNormal(TransformTriangle(hitTriangle, instances[result.instance].world));
+	result.hit.distance = maxDistance;
+	result.hit.point = ray.origin + ray.direction * maxDistance;
+	result.hit.normal = Dot(normal, ray.direction) <= 0.0f ? normal : -normal;
+	return true;
+}
+
+bool SceneBVH::SphereCast(const Ray& ray, float radius, SceneHit& result, uint32_t ignoreInstance) const {
+	result.instance = kNoInstance;
+	float maxDistance = ray.maxDistance;
+	Triangle hitTriangle;
+	const RayBoxQuery query = MakeRayBoxQuery(ray.origin, ray.direction, radius);
+	TraverseBVH(nodes, query, maxDistance, [&](uint32_t start, uint32_t count, float& distance) {
+		for (uint32_t i = start; i < start + count; i++) {
+			const Instance& instance = instances[order[i]];
+			if (order[i] == ignoreInstance || !instance.mesh) {
+				continue;
+			}
+			// ローカル座標では球が楕円体になるので、ノードは広めに調べて三角形はワールド座標で判定する
+			const Vector3 localOrigin = MatrixTransform(ray.origin, instance.inverse);
+			const Vector3 localDirection = TransformNormal(ray.direction, instance.inverse);
+			instance.mesh->TraverseRay(localOrigin, localDirection, radius * instance.inverseScale, distance,
+				[&](const Triangle& triangle, uint32_t index, float& maxT) {
+					const Triangle world = TransformTriangle(triangle, instance.world);
+					Ray limited = ray;
+					limited.maxDistance = maxT;
+					float t;
+					if (SphereCastTriangle(limited, radius, world, t)) {
+						maxT = t;
+						result.instance = order[i];
+						result.hit.triangle = index;
+						hitTriangle = world;
+					}
+				});
+		}
+	});
+	if (result.instance == kNoInstance) {
+		return false;
+	}
+	const Vector3 center = ray.origin + ray.direction * maxDistance;
+	result.hit.distance = maxDistance;
+	result.hit.point = ClosestPointOnTriangle(center, hitTriangle);
+	const Vector3 offset = center - result.hit.point;
+	const float lengthSq = Dot(offset, offset);
+	result.hit.normal = lengthSq > 0.0f ? offset * (1.0f / std::sqrt(lengthSq)) : ComputeTriangleNormal(hitTriangle);
+	return true;
+}
+
+void SceneBVH::Overlap(const Sphere& sphere, std::vector<SceneOverlap>& result) const {
+	result.clear();
+	const Vector3 extent = { sphere.radius, sphere.radius, sphere.radius };
+	const AABB aabb = { sphere.center - extent, sphere.center + extent };
+	TraverseBVH(nodes, aabb, [&](uint32_t start, uint32_t count) {
+		for (uint32_t i = start; i < start + count; i++) {
+			const Instance& instance = instances[order[i]];
+			if (!instance.mesh) {
+				continue;
+			}
+			instance.mesh->TraverseAABB(TransformAABB(aabb, instance.inverse), [&](const Triangle& triangle, uint32_t index) {
+				if (OverlapTriangle(sphere, TransformTriangle(triangle, instance.world))) {
+					result.push_back({ order[i], index });
+				}
+			});
+		}
+	});
+}
+
+void SceneBVH::Overlap(const AABB& aabb, std::vector<SceneOverlap>& result) const {
+	result.clear();
+	TraverseBVH(nodes, aabb, [&](uint32_t start, uint32_t count) {
+		for (uint32_t i = start; i < start + count; i++) {
+			const Instance& instance = instances[order[i]];
+			if (!instance.mesh) {
+				continue;
+			}
+			instance.mesh->TraverseAABB(TransformAABB(aabb, instance.inverse), [&](const Triangle& triangle, uint32_t index) {
+				if (OverlapTriangle(aabb, TransformTriangle(triangle, instance.world))) {
+					result.push_back({ order[i], index });
+				}
+			});
+		}
+	});
+}
+
+size_t SceneBVH::Raycast(const Ray* rays, size_t count, SceneHit* results) const {
+	ThreadPool::GetInstance()->ParallelFor(count, kRaysPerBatch, [this, rays, results](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			Raycast(rays[i], results[i]);
+		}
+	});
+	return std::count_if(results, results + count, [](const SceneHit& result) { return result.instance != kNoInstance; });
+}
+
+size_t SceneBVH::SphereCast(const Ray* rays, size_t count, float radius, SceneHit* results) const {
+	ThreadPool::GetInstance()->ParallelFor(count, kRaysPerBatch, [this, rays, radius, results](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			SphereCast(rays[i], radius, results[i]);
+		}
+	});
+	return std::count_if(results, results + count, [](const SceneHit& result) { return result.instance != kNoInstance; });
+}
+
+Triangle SceneBVH::TransformTriangle(const Triangle& triangle, const Matrix3x4& world) {
+	return Triangle{ {
+		MatrixTransform(triangle.vertices[0], world),
+		MatrixTransform(triangle.vertices[1], world),
+		MatrixTransform(triangle.vertices[2], world)
+	} };
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "BVH.h"
+#include "TriangleBVH.h"
+#include "AABB.h"
+#include "Sphere.h"
+#include "Ray.h"
+#include "Matrix3x4.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// シーンへのレイ・スフィアキャストの結果
+struct SceneHit {
+	// 当たったインスタンスの番号(当たらなければkNoInstance)
+	uint32_t instance;
+	// ワールド座標での結果(三角形の番号はモデルのもの)
+	RaycastHit hit;
+};
+
+// シーンとの重なりの結果
+struct SceneOverlap {
+	uint32_t instance;
+	uint32_t triangle;
+};
+
+// 配置されたモデル(インスタンス)に対するBVH(トップレベル)
+// インスタンスはワールド行列とモデルのTriangleBVHを持ち、毎フレームClearからBuildまでをやり直す
+// クエリはconstなので、Buildの後なら複数のスレッドから同時に呼んでよい
+class SceneBVH {
+public:
+	// 当たらなかった場合のインスタンスの番号
+	static constexpr uint32_t kNoInstance = 0xFFFFFFFFu;
+
+	// インスタンスを全て消す
+	void Clear();
+
+	// インスタンスを追加して番号を返す(meshはBuildからクエリが終わるまで残しておくこと)
+	uint32_t AddInstance(const TriangleBVH* mesh, const Matrix3x4& world, void* userData = nullptr);
+
+	// インスタンスを外す(BVHは作り直さず、クエリで当たらないようにするだけ。番号は次のClearまで詰めない)
+	void RemoveInstance(uint32_t instance);
+
+	// 追加したインスタンスでBVHを作る
+	void Build();
+
+	// 一番近い当たりを求める(距離はワールド座標。レイの向きは正規化しておく)
+	// ignoreInstanceのインスタンスは調べない(自分自身から飛ばす場合など)
+	bool Raycast(const Ray& ray, SceneHit& result, uint32_t ignoreInstance = kNoInstance) const;
+
+	// 半径radiusの球をレイに沿って動かして最初に当たる位置を求める
+	bool SphereCast(const Ray& ray, float radius, SceneHit& result, uint32_t ignoreInstance = kNoInstance) const;
+
+	// 球と重なっている三角形を求める(resultは上書きする)
+	void Overlap(const Sphere& sphere, std::vector<SceneOverlap>& result) const;
+
+	// AABBと重なっている三角形を求める(resultは上書きする)
+	void Overlap(const AABB& aabb, std::vector<SceneOverlap>& result) const;
+
+	// まとめてレイを飛ばす(ThreadPoolがあれば並列に処理する)。当たった数を返す
+	size_t Raycast(const Ray* rays, size_t count, SceneHit* results) const;
+
+	// まとめてスフィアキャストする(ThreadPoolがあれば並列に処理する)。当たった数を返す
+	size_t SphereCast(const Ray* rays, size_t count, float radius, SceneHit* results) const;
+
+	// Getter(インスタンスに渡したユーザーデータ)
+	void* GetUserData(uint32_t instance) const { return instances[instance].userData; }
+
+	// Getter(インスタンスの数)
+	size_t GetInstanceCount() const { return instances.size(); }
+
+private:
+	struct Instance {
+		// RemoveInstanceで外したインスタンスはnullptr
+		const TriangleBVH* mesh;
+		Matrix3x4 world;
+		Matrix3x4 inverse;
+		// ワールド座標のAABB
+		AABB bounds;
+		// ワールドの長さをローカルに直したときに一番伸びる倍率(スフィアキャストでノードを広げる量)
+		float inverseScale;
+		void* userData;
+	};
+
+	// ワールド座標の三角形
+	static Triangle TransformTriangle(const Triangle& triangle, const Matrix3x4& world);
+
+private:
+	std::vector<Instance> instances;
+	std::vector<BVHNode> nodes;
+	std::vector<uint32_t> order;
+};
@@ -0,0 +1,283 @@
+#include "SpatialHashGrid.h"
+#include "NarrowPhase.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// これより多くのセルにまたがるプロキシはグリッドに入れない
+constexpr int64_t kMaxCellsPerProxy = 64;
+// 並列に処理するときの1回分のバケット数
+constexpr uint32_t kBucketsPerBatch = 4096;
+// セルの番号の範囲(ハッシュの計算であふれないようにする)
+constexpr float kCellLimit = 1048576.0f;
+
+// 2つのAABBの重なりの最小の角
+Vector3 OverlapMin(const AABB& a, const AABB& b) {
+	return Vector3{ std::max(a.min.x, b.min.x), std::max(a.min.y, b.min.y), std::max(a.min.z, b.min.z) };
+}
+
+} // namespace
+
+ProxyHandle SpatialHashGrid::CreateProxy(const AABB& aabb, void* userData) {
+	ProxyHandle proxy = freeList;
+	if (proxy == kNullProxy) {
+		proxies.emplace_back();
+		bounds.PushBack(aabb);
+		proxy = static_cast<ProxyHandle>(proxies.size() - 1);
+	} else {
+		freeList = proxies[proxy].next;
+	}
+	Proxy& p = proxies[proxy];
+	p = Proxy{};
+	p.aabb = aabb;
+	p.userData = userData;
+	bounds.Set(proxy, aabb);
+	p.isUsed = true;
+	proxyCount++;
+	isDirty = true;
+	return proxy;
+}
+
+void SpatialHashGrid::DestroyProxy(ProxyHandle proxy) {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	assert(proxies[proxy].isUsed);
+	proxies[proxy].isUsed = false;
+	proxies[proxy].userData = nullptr;
+	bounds.SetEmpty(proxy);
+	proxies[proxy].next = freeList;
+	freeList = proxy;
+	proxyCount--;
+	isDirty = true;
+}
+
+void SpatialHashGrid::MoveProxy(ProxyHandle proxy, const AABB& aabb) {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	assert(proxies[proxy].isUsed);
+	proxies[proxy].aabb = aabb;
+	bounds.Set(proxy, aabb);
+	isDirty = true;
+}
+
+void SpatialHashGrid::ComputePairs(std::vector<ProxyPair>& pairs) {
+	Rebuild();
+	pairs.clear();
+
+	// バケットを一定数ずつに分けて、分けた単位で結果を持つ(スレッド数によらず同じ順番になる)
+	const uint32_t bucketCount = bucketMask + 1;
+	const size_t batchCount = (bucketCount + kBucketsPerBatch - 1) / kBucketsPerBatch;
+	batchPairs.resize(batchCount);
+	auto collect = [this, bucketCount](size_t begin, size_t end) {
+		for (size_t batch = begin; batch < end; batch++) {
+			const uint32_t beginBucket = static_cast<uint32_t>(batch) * kBucketsPerBatch;
+			const uint32_t endBucket = std::min(beginBucket + kBucketsPerBatch, bucketCount);
+			batchPairs[batch].clear();
+			CollectPairs(beginBucket, endBucket, batchPairs[batch]);
+		}
+	};
+	if (isParallel) {
+		ThreadPool::GetInstance()->ParallelFor(batchCount, 1, collect);
+	} else {
+		collect(0, batchCount);
+	}
+
+	size_t pairCount = 0;
+	for (const std::vector<ProxyPair>& batch : batchPairs) {
+		pairCount += batch.size();
+	}
+	pairs.reserve(pairCount);
+	for (const std::vector<ProxyPair>& batch : batchPairs) {
+		pairs.insert(pairs.end(), batch.begin(), batch.end());
+	}
+
+	// 大きなプロキシは全てとまとめて比べる(大きいもの同士は番号の小さい方から見たときだけ数える)
+	for (ProxyHandle large : largeProxies) {
+		CollisionAABBIndices(proxies[large].aabb, bounds, hitIndices);
+		for (uint32_t index : hitIndices) {
+			const ProxyHandle other = static_cast<ProxyHandle>(index);
+			if (other == large) {
+				continue;
+			}
+			if (other < large && std::binary_search(largeProxies.begin(), largeProxies.end(), other)) {
+				continue;
+			}
+			pairs.push_back(large < other ? ProxyPair{ large, other } : ProxyPair{ other, large });
+		}
+	}
+}
+
+void SpatialHashGrid::Query(const AABB& aabb, std::vector<ProxyHandle>& result) const {
+	result.clear();
+
+	const CellRange range = ComputeCellRange(aabb);
+	const int64_t cellCount = int64_t(range.maxX - range.minX + 1) * (range.maxY - range.minY + 1) * (range.maxZ - range.minZ + 1);
+	if (isDirty || cellCount > static_cast<int64_t>(entries.size())) {
+		// グリッドが古い場合と、調べるセルがプロキシより多い場合は全てとまとめて比べる
+		std::vector<uint32_t> indices;
+		CollisionAABBIndices(aabb, bounds, indices);
+		result.assign(indices.begin(), indices.end());
+		return;
+	}
+
+	for (int32_t z = range.minZ; z <= range.maxZ; z++) {
+		for (int32_t y = range.minY; y <= range.maxY; y++) {
+			for (int32_t x = range.minX; x <= range.maxX; x++) {
+				const uint32_t bucket = HashCell(x, y, z);
+				for (uint32_t i = bucketStarts[bucket]; i < bucketStarts[bucket + 1]; i++) {
+					const CellEntry& entry = entries[i];
+					if (entry.x != x || entry.y != y || entry.z != z) {
+						continue;
+					}
+					const AABB& proxyAABB = proxies[entry.proxy].aabb;
+					if (!CollisionAABB(proxyAABB, aabb)) {
+						continue;
+					}
+					// 重なりの角が入っているセルでだけ数える(複数のセルで重なっても1回にする)
+					const Vector3 corner = OverlapMin(proxyAABB, aabb);
+					if (ToCell(corner.x) == x && ToCell(corner.y) == y && ToCell(corner.z) == z) {
+						result.push_back(entry.proxy);
+					}
+				}
+			}
+		}
+	}
+	for (ProxyHandle large : largeProxies) {
+		if (CollisionAABB(proxies[large].aabb, aabb)) {
+			result.push_back(large);
+		}
+	}
+}
+
+void* SpatialHashGrid::GetUserData(ProxyHandle proxy) const {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	return proxies[proxy].userData;
+}
+
+const AABB& SpatialHashGrid::GetAABB(ProxyHandle proxy) const {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	return proxies[proxy].aabb;
+}
+
+void SpatialHashGrid::Rebuild() {
+	// セルの大きさを決める(指定がなければAABBの一番長い辺の平均)
+	currentCellSize = cellSize;
+	if (currentCellSize <= 0.0f) {
+		double total = 0.0;
+		for (const Proxy& proxy : proxies) {
+			if (proxy.isUsed) {
+				const Vector3 size = proxy.aabb.max - proxy.aabb.min;
+				total += std::max({ size.x, size.y, size.z });
+			}
+		}
+		currentCellSize = proxyCount > 0 ? static_cast<float>(total / static_cast<double>(proxyCount)) : 1.0f;
+		currentCellSize = std::max(currentCellSize, 1.0e-3f);
+	}
+	inverseCellSize = 1.0f / currentCellSize;
+
+	// 各プロキシが掛かるセルを求めて、要素数を数える
+	cellRanges.resize(proxies.size());
+	largeProxies.clear();
+	size_t entryCount = 0;
+	for (size_t i = 0; i < proxies.size(); i++) {
+		if (!proxies[i].isUsed) {
+			continue;
+		}
+		const CellRange& range = cellRanges[i] = ComputeCellRange(proxies[i].aabb);
+		const int64_t cellCount = int64_t(range.maxX - range.minX + 1) * (range.maxY - range.minY + 1) * (range.maxZ - range.minZ + 1);
+		if (cellCount > kMaxCellsPerProxy) {
+			largeProxies.push_back(static_cast<ProxyHandle>(i));
+		} else {
+			entryCount += static_cast<size_t>(cellCount);
+		}
+	}
+
+	// バケット数は要素数の2倍以上の2のべき乗にする
+	uint32_t bucketCount = 1;
+	while (bucketCount < entryCount * 2) {
+		bucketCount <<= 1;
+	}
+	bucketMask = bucketCount - 1;
+
+	// 計数ソート: バケットごとの数を数えて、累積和で開始位置を求めてから詰める
+	bucketStarts.assign(static_cast<size_t>(bucketCount) + 1, 0);
+	auto forEachCell = [this](auto&& function) {
+		size_t largeIndex = 0;
+		for (size_t i = 0; i < proxies.size(); i++) {
+			if (!proxies[i].isUsed) {
+				continue;
+			}
+			if (largeIndex < largeProxies.size() && largeProxies[largeIndex] == static_cast<ProxyHandle>(i)) {
+				largeIndex++;
+				continue;
+			}
+			const CellRange& range = cellRanges[i];
+			for (int32_t z = range.minZ; z <= range.maxZ; z++) {
+				for (int32_t y = range.minY; y <= range.maxY; y++) {
+					for (int32_t x = range.minX; x <= range.maxX; x++) {
+						function(static_cast<ProxyHandle>(i), x, y, z);
+					}
+				}
+			}
+		}
+	};
+	forEachCell([this](ProxyHandle, int32_t x, int32_t y, int32_t z) {
+		bucketStarts[HashCell(x, y, z) + 1]++;
+	});
+	for (uint32_t i = 0; i < bucketCount; i++) {
+		bucketStarts[i + 1] += bucketStarts[i];
+	}
+	entries.resize(entryCount);
+	std::vector<uint32_t> cursors(bucketStarts.begin(), bucketStarts.end() - 1);
+	forEachCell([this, &cursors](ProxyHandle proxy, int32_t x, int32_t y, int32_t z) {
+		entries[cursors[HashCell(x, y, z)]++] = CellEntry{ proxy, x, y, z };
+	});
+
+	isDirty = false;
+}
+
+SpatialHashGrid::CellRange SpatialHashGrid::ComputeCellRange(const AABB& aabb) const {
+	return CellRange{
+		ToCell(aabb.min.x), ToCell(aabb.min.y), ToCell(aabb.min.z),
+		ToCell(aabb.max.x), ToCell(aabb.max.y), ToCell(aabb.max.z)
+	};
+}
+
+int32_t SpatialHashGrid::ToCell(float value) const {
+	const float cell = std::floor(value * inverseCellSize);
+	return static_cast<int32_t>(std::clamp(cell, -kCellLimit, kCellLimit));
+}
+
+uint32_t SpatialHashGrid::HashCell(int32_t x, int32_t y, int32_t z) const {
+	const uint32_t hash = (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u) ^ (static_cast<uint32_t>(z) * 83492791u);
+	return hash & bucketMask;
+}
+
+void SpatialHashGrid::CollectPairs(uint32_t beginBucket, uint32_t endBucket, std::vector<ProxyPair>& pairs) const {
+	for (uint32_t bucket = beginBucket; bucket < endBucket; bucket++) {
+		const uint32_t begin = bucketStarts[bucket];
+		const uint32_t end = bucketStarts[bucket + 1];
+		for (uint32_t i = begin; i < end; i++) {
+			const CellEntry& a = entries[i];
+			const AABB& aabbA = proxies[a.proxy].aabb;
+			for (uint32_t j = i + 1; j < end; j++) {
+				const CellEntry& b = entries[j];
+				// ハッシュが衝突した別のセル
+				if (a.x != b.x || a.y != b.y || a.z != b.z) {
+					continue;
+				}
+				const AABB& aabbB = proxies[b.proxy].aabb;
+				if (!CollisionAABB(aabbA, aabbB)) {
+					continue;
+				}
+				// 重なりの角が入っているセルでだけ数える(複数のセルで重なっても1回にする)
+				const Vector3 corner = OverlapMin(aabbA, aabbB);
+				if (ToCell(corner.x) != a.x || ToCell(corner.y) != a.y || ToCell(corner.z) != a.z) {
+					continue;
+				}
+				pairs.push_back(a.proxy < b.proxy ? ProxyPair{ a.proxy, b.proxy } : ProxyPair{ b.proxy, a.proxy });
+			}
+		}
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "BroadPhase.h"
+#include "AABB.h"
+#include "AABBBatch.h"
+#include <cstdint>
+#include <vector>
+
+// 一様グリッド(空間ハッシュ)によるブロードフェーズ
+// 同じくらいの大きさの小さなオブジェクトが大量にある場面(弾幕など)向け
+// 登録・移動はAABBを書き換えるだけで、ComputePairsのたびにグリッドを計数ソートで作り直す
+class SpatialHashGrid : public BroadPhase {
+public:
+	ProxyHandle CreateProxy(const AABB& aabb, void* userData) override;
+
+	void DestroyProxy(ProxyHandle proxy) override;
+
+	void MoveProxy(ProxyHandle proxy, const AABB& aabb) override;
+
+	// グリッドを作り直してから、セルごとにペアを求める(ThreadPoolがあれば並列に処理する)
+	void ComputePairs(std::vector<ProxyPair>& pairs) override;
+
+	// グリッドが最新ならaabbの範囲のセルだけを調べる(そうでなければ全てと比べる)
+	void Query(const AABB& aabb, std::vector<ProxyHandle>& result) const override;
+
+	void* GetUserData(ProxyHandle proxy) const override;
+
+	const AABB& GetAABB(ProxyHandle proxy) const override;
+
+	size_t GetProxyCount() const override { return proxyCount; }
+
+	// Setter(セルの大きさ。0ならAABBの大きさの平均から決める)
+	void SetCellSize(float cellSize) { this->cellSize = cellSize; }
+
+	// Getter(直前に作ったグリッドのセルの大きさ)
+	float GetCellSize() const { return currentCellSize; }
+
+	// Setter(ペアを並列に求めるか)
+	void SetParallel(bool isParallel) { this->isParallel = isParallel; }
+
+private:
+	struct Proxy {
+		AABB aabb;
+		void* userData = nullptr;
+		// 使われていない場合は次の空き番号
+		ProxyHandle next = kNullProxy;
+		bool isUsed = false;
+	};
+
+	// セルに入っているプロキシ(ハッシュが衝突しても区別できるようにセルの座標も持つ)
+	struct CellEntry {
+		ProxyHandle proxy;
+		int32_t x;
+		int32_t y;
+		int32_t z;
+	};
+
+	// セルの範囲
+	struct CellRange {
+		int32_t minX, minY, minZ;
+		int32_t maxX, maxY, maxZ;
+	};
+
+	// グリッドを作り直す
+	void Rebuild();
+
+	// AABBが掛かっているセルの範囲
+	CellRange ComputeCellRange(const AABB& aabb) const;
+	// 座標からセルの番号
+	int32_t ToCell(float value) const;
+	// セルの座標からバケットの番号
+	uint32_t HashCell(int32_t x, int32_t y, int32_t z) const;
+
+	// バケット[begin, end)の中のペアを求める
+	void CollectPairs(uint32_t beginBucket, uint32_t endBucket, std::vector<ProxyPair>& pairs) const;
+
+private:
+	std::vector<Proxy> proxies;
+	// プロキシのAABB(まとめて判定する用。使われていない番号は空のAABB)
+	AABBSoA bounds;
+	ProxyHandle freeList = kNullProxy;
+	size_t proxyCount = 0;
+
+	float cellSize = 0.0f;
+	float currentCellSize = 1.0f;
+	float inverseCellSize = 1.0f;
+	bool isParallel = true;
+
+	// 登録・移動があってグリッドが古くなっている
+	bool isDirty = true;
+
+	// バケットごとの開始位置(計数ソートの結果。bucketStarts[i]からbucketStarts[i + 1]まで)
+	std::vector<uint32_t> bucketStarts;
+	std::vector<CellEntry> entries;
+	uint32_t bucketMask = 0;
+
+	// セルにまたがりすぎるプロキシ(グリッドに入れず全てと比べる)
+	std::vector<ProxyHandle> largeProxies;
+
+	// 作り直しで使う作業領域
+	std::vector<CellRange> cellRanges;
+	std::vector<std::vector<ProxyPair>> batchPairs;
+	std::vector<uint32_t> hitIndices;
+};
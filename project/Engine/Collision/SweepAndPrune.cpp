@@ -0,0 +1,289 @@
+#include "SweepAndPrune.h"
+#include "NarrowPhase.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// AABBの軸ごとの値
+float GetMin(const AABB& aabb, int axis) {
+	return axis == 0 ? aabb.min.x : axis == 1 ? aabb.min.y : aabb.min.z;
+}
+
+float GetMax(const AABB& aabb, int axis) {
+	return axis == 0 ? aabb.max.x : axis == 1 ? aabb.max.y : aabb.max.z;
+}
+
+} // namespace
+
+SweepAndPrune::SweepAndPrune() {
+	for (std::vector<EndPoint>& axisEndPoints : endPoints) {
+		axisEndPoints.reserve(32);
+	}
+}
+
+ProxyHandle SweepAndPrune::CreateProxy(const AABB& aabb, void* userData) {
+	assert(aabb.min.x <= aabb.max.x && aabb.min.y <= aabb.max.y && aabb.min.z <= aabb.max.z);
+
+	ProxyHandle proxy = freeList;
+	if (proxy == kNullProxy) {
+		proxies.emplace_back();
+		bounds.PushBack(aabb);
+		proxy = static_cast<ProxyHandle>(proxies.size() - 1);
+		for (std::vector<uint32_t>& indices : endPointIndices) {
+			indices.resize(proxies.size() * 2);
+		}
+	} else {
+		freeList = proxies[proxy].next;
+	}
+	Proxy& p = proxies[proxy];
+	p = Proxy{};
+	p.aabb = aabb;
+	p.userData = userData;
+	bounds.Set(proxy, aabb);
+	p.isUsed = true;
+	proxyCount++;
+
+	pendingProxies.push_back(proxy);
+	return proxy;
+}
+
+void SweepAndPrune::DestroyProxy(ProxyHandle proxy) {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	assert(proxies[proxy].isUsed);
+	FlushPendingProxies();
+
+	// このプロキシを含むペアを消す
+	std::erase_if(pairs, [proxy](uint64_t key) {
+		return static_cast<ProxyHandle>(key >> 32) == proxy || static_cast<ProxyHandle>(key & 0xffffffffu) == proxy;
+	});
+
+	// 端点を詰めて、ずれた端点の位置を記録し直す
+	for (int axis = 0; axis < 3; axis++) {
+		std::vector<EndPoint>& axisEndPoints = endPoints[axis];
+		std::erase_if(axisEndPoints, [proxy](const EndPoint& endPoint) { return endPoint.GetProxy() == proxy; });
+		for (uint32_t i = GetMinIndex(axis, proxy); i < axisEndPoints.size(); i++) {
+			SetEndPointIndex(axis, i);
+		}
+	}
+
+	proxies[proxy].isUsed = false;
+	proxies[proxy].userData = nullptr;
+	bounds.SetEmpty(proxy);
+	proxies[proxy].next = freeList;
+	freeList = proxy;
+	proxyCount--;
+}
+
+void SweepAndPrune::MoveProxy(ProxyHandle proxy, const AABB& aabb) {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	assert(proxies[proxy].isUsed);
+	assert(aabb.min.x <= aabb.max.x && aabb.min.y <= aabb.max.y && aabb.min.z <= aabb.max.z);
+
+	FlushPendingProxies();
+
+	Proxy& p = proxies[proxy];
+	for (int axis = 0; axis < 3; axis++) {
+		const float newMin = GetMin(aabb, axis);
+		const float newMax = GetMax(aabb, axis);
+		// minがmaxを追い越さないように、動く方向の先にある端点から動かす
+		if (newMin < GetMin(p.aabb, axis)) {
+			UpdateEndPoint(axis, GetMinIndex(axis, proxy), newMin);
+			UpdateEndPoint(axis, GetMaxIndex(axis, proxy), newMax);
+		} else {
+			UpdateEndPoint(axis, GetMaxIndex(axis, proxy), newMax);
+			UpdateEndPoint(axis, GetMinIndex(axis, proxy), newMin);
+		}
+	}
+	p.aabb = aabb;
+	bounds.Set(proxy, aabb);
+}
+
+void SweepAndPrune::ComputePairs(std::vector<ProxyPair>& result) {
+	FlushPendingProxies();
+	result.clear();
+	result.reserve(pairs.size());
+	for (uint64_t key : pairs) {
+		result.push_back({ static_cast<ProxyHandle>(key >> 32), static_cast<ProxyHandle>(key & 0xffffffffu) });
+	}
+}
+
+void SweepAndPrune::Query(const AABB& aabb, std::vector<ProxyHandle>& result) const {
+	std::vector<uint32_t> indices;
+	CollisionAABBIndices(aabb, bounds, indices);
+	result.assign(indices.begin(), indices.end());
+}
+
+void* SweepAndPrune::GetUserData(ProxyHandle proxy) const {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	return proxies[proxy].userData;
+}
+
+const AABB& SweepAndPrune::GetAABB(ProxyHandle proxy) const {
+	assert(0 <= proxy && proxy < static_cast<ProxyHandle>(proxies.size()));
+	return proxies[proxy].aabb;
+}
+
+void SweepAndPrune::FlushPendingProxies() {
+	if (pendingProxies.empty()) {
+		return;
+	}
+
+	// 1つずつ入れると登録数に比例した時間がかかるので、多い場合はまとめて並べ直す
+	constexpr size_t kRebuildThreshold = 64;
+	if (pendingProxies.size() >= kRebuildThreshold && pendingProxies.size() * 4 >= proxyCount) {
+		Rebuild();
+	} else {
+		for (ProxyHandle proxy : pendingProxies) {
+			InsertEndPoints(proxy);
+		}
+	}
+	pendingProxies.clear();
+}
+
+void SweepAndPrune::InsertEndPoints(ProxyHandle proxy) {
+	// 末尾に無限遠の端点として追加してから、正しい位置まで下ろす
+	// 先の軸では他の軸が末尾にあるのでペアは作られず、最後の軸で全ての軸が揃ってからペアが作られる
+	constexpr float kInfinity = std::numeric_limits<float>::infinity();
+	const AABB& aabb = proxies[proxy].aabb;
+	for (int axis = 0; axis < 3; axis++) {
+		std::vector<EndPoint>& axisEndPoints = endPoints[axis];
+		const uint32_t minIndex = static_cast<uint32_t>(axisEndPoints.size());
+		axisEndPoints.push_back({ kInfinity, static_cast<uint32_t>(proxy) << 1 });
+		axisEndPoints.push_back({ kInfinity, (static_cast<uint32_t>(proxy) << 1) | 1 });
+		SetEndPointIndex(axis, minIndex);
+		SetEndPointIndex(axis, minIndex + 1);
+	}
+	for (int axis = 0; axis < 3; axis++) {
+		UpdateEndPoint(axis, GetMinIndex(axis, proxy), GetMin(aabb, axis));
+		UpdateEndPoint(axis, GetMaxIndex(axis, proxy), GetMax(aabb, axis));
+	}
+}
+
+void SweepAndPrune::Rebuild() {
+	for (int axis = 0; axis < 3; axis++) {
+		std::vector<EndPoint>& axisEndPoints = endPoints[axis];
+		axisEndPoints.clear();
+		for (size_t i = 0; i < proxies.size(); i++) {
+			if (!proxies[i].isUsed) {
+				continue;
+			}
+			const uint32_t data = static_cast<uint32_t>(i) << 1;
+			axisEndPoints.push_back({ GetMin(proxies[i].aabb, axis), data });
+			axisEndPoints.push_back({ GetMax(proxies[i].aabb, axis), data | 1 });
+		}
+		std::sort(axisEndPoints.begin(), axisEndPoints.end(), Less);
+		for (uint32_t i = 0; i < axisEndPoints.size(); i++) {
+			SetEndPointIndex(axis, i);
+		}
+	}
+
+	// x軸を掃引して、区間が重なっているものだけ他の軸を調べる
+	pairs.clear();
+	std::vector<ProxyHandle> active;
+	for (const EndPoint& endPoint : endPoints[0]) {
+		const ProxyHandle proxy = endPoint.GetProxy();
+		if (endPoint.IsMax()) {
+			auto it = std::find(active.begin(), active.end(), proxy);
+			*it = active.back();
+			active.pop_back();
+			continue;
+		}
+		for (ProxyHandle other : active) {
+			if (OverlapOtherAxes(0, proxy, other)) {
+				AddPair(proxy, other);
+			}
+		}
+		active.push_back(proxy);
+	}
+}
+
+void SweepAndPrune::UpdateEndPoint(int axis, uint32_t index, float value) {
+	EndPoint& endPoint = endPoints[axis][index];
+	const float oldValue = endPoint.value;
+	endPoint.value = value;
+	if (value < oldValue) {
+		SortDown(axis, index);
+	} else if (value > oldValue) {
+		SortUp(axis, index);
+	}
+}
+
+void SweepAndPrune::SortDown(int axis, uint32_t index) {
+	std::vector<EndPoint>& axisEndPoints = endPoints[axis];
+	const EndPoint endPoint = axisEndPoints[index];
+	const ProxyHandle proxy = endPoint.GetProxy();
+
+	while (index > 0 && Less(endPoint, axisEndPoints[index - 1])) {
+		const EndPoint& prev = axisEndPoints[index - 1];
+		const ProxyHandle other = prev.GetProxy();
+		if (!endPoint.IsMax() && prev.IsMax()) {
+			// minが他のmaxより前に来た: この軸で重なり始める
+			if (OverlapOtherAxes(axis, proxy, other)) {
+				AddPair(proxy, other);
+			}
+		} else if (endPoint.IsMax() && !prev.IsMax()) {
+			// maxが他のminより前に来た: この軸で離れる
+			RemovePair(proxy, other);
+		}
+		axisEndPoints[index] = prev;
+		SetEndPointIndex(axis, index);
+		index--;
+	}
+	axisEndPoints[index] = endPoint;
+	SetEndPointIndex(axis, index);
+}
+
+void SweepAndPrune::SortUp(int axis, uint32_t index) {
+	std::vector<EndPoint>& axisEndPoints = endPoints[axis];
+	const EndPoint endPoint = axisEndPoints[index];
+	const ProxyHandle proxy = endPoint.GetProxy();
+	const uint32_t last = static_cast<uint32_t>(axisEndPoints.size() - 1);
+
+	while (index < last && Less(axisEndPoints[index + 1], endPoint)) {
+		const EndPoint& next = axisEndPoints[index + 1];
+		const ProxyHandle other = next.GetProxy();
+		if (endPoint.IsMax() && !next.IsMax()) {
+			// maxが他のminより後ろに来た: この軸で重なり始める
+			if (OverlapOtherAxes(axis, proxy, other)) {
+				AddPair(proxy, other);
+			}
+		} else if (!endPoint.IsMax() && next.IsMax()) {
+			// minが他のmaxより後ろに来た: この軸で離れる
+			RemovePair(proxy, other);
+		}
+		axisEndPoints[index] = next;
+		SetEndPointIndex(axis, index);
+		index++;
+	}
+	axisEndPoints[index] = endPoint;
+	SetEndPointIndex(axis, index);
+}
+
+bool SweepAndPrune::OverlapOtherAxes(int axis, ProxyHandle a, ProxyHandle b) const {
+	// 端点の並び順で比べる(値で比べるとソート中の端点と食い違うことがある)
+	for (int i = 1; i < 3; i++) {
+		const int other = (axis + i) % 3;
+		if (GetMaxIndex(other, a) < GetMinIndex(other, b) || GetMaxIndex(other, b) < GetMinIndex(other, a)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SweepAndPrune::AddPair(ProxyHandle a, ProxyHandle b) {
+	pairs.insert(MakeKey(a, b));
+}
+
+void SweepAndPrune::RemovePair(ProxyHandle a, ProxyHandle b) {
+	pairs.erase(MakeKey(a, b));
+}
+
+uint64_t SweepAndPrune::MakeKey(ProxyHandle a, ProxyHandle b) {
+	if (b < a) {
+		std::swap(a, b);
+	}
+	return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "BroadPhase.h"
+#include "AABB.h"
+#include "AABBBatch.h"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// Sweep and Pruneによるブロードフェーズ
+// 各軸のAABBの端点(min/max)をソート済みのまま持ち続け、移動したら挿入ソートで並べ直す
+// 少しずつ動くオブジェクトが多い場合は並べ替えがほとんど起きないので速い
+// 端点が入れ替わったときだけペアを追加・削除するので、ペアは常に最新の状態になっている
+class SweepAndPrune : public BroadPhase {
+public:
+	SweepAndPrune();
+
+	// 追加したプロキシは次に更新・ペアの計算をするときにまとめて並べる
+	ProxyHandle CreateProxy(const AABB& aabb, void* userData) override;
+
+	// 端点を配列から消すので、登録数に比例した時間がかかる
+	void DestroyProxy(ProxyHandle proxy) override;
+
+	void MoveProxy(ProxyHandle proxy, const AABB& aabb) override;
+
+	// 管理しているペアをそのまま返す
+	void ComputePairs(std::vector<ProxyPair>& pairs) override;
+
+	// 全てのプロキシとまとめて比べる
+	void Query(const AABB& aabb, std::vector<ProxyHandle>& result) const override;
+
+	void* GetUserData(ProxyHandle proxy) const override;
+
+	const AABB& GetAABB(ProxyHandle proxy) const override;
+
+	size_t GetProxyCount() const override { return proxyCount; }
+
+private:
+	// 端点
+	struct EndPoint {
+		float value;
+		// プロキシの番号 * 2 + (maxなら1)
+		uint32_t data;
+
+		ProxyHandle GetProxy() const { return static_cast<ProxyHandle>(data >> 1); }
+		bool IsMax() const { return (data & 1) != 0; }
+	};
+
+	struct Proxy {
+		AABB aabb;
+		void* userData = nullptr;
+		// 使われていない場合は次の空き番号
+		ProxyHandle next = kNullProxy;
+		bool isUsed = false;
+	};
+
+	// lhsがrhsより前に並ぶか(同じ値ならminを先にして、接しているだけでも重なりとみなす)
+	static bool Less(const EndPoint& lhs, const EndPoint& rhs) {
+		return lhs.value < rhs.value || (lhs.value == rhs.value && !lhs.IsMax() && rhs.IsMax());
+	}
+
+	// 追加待ちのプロキシを端点の配列に入れる
+	void FlushPendingProxies();
+	// 1つずつ末尾から挿入ソートで入れる
+	void InsertEndPoints(ProxyHandle proxy);
+	// 全ての端点を並べ直して、ペアも作り直す
+	void Rebuild();
+
+	// 端点の値を変えて、正しい位置まで動かす
+	void UpdateEndPoint(int axis, uint32_t index, float value);
+	// 端点を前に動かす
+	void SortDown(int axis, uint32_t index);
+	// 端点を後ろに動かす
+	void SortUp(int axis, uint32_t index);
+
+	// 端点の位置を記録する
+	void SetEndPointIndex(int axis, uint32_t index) { endPointIndices[axis][endPoints[axis][index].data] = index; }
+	// 端点の位置
+	uint32_t GetMinIndex(int axis, ProxyHandle proxy) const { return endPointIndices[axis][static_cast<uint32_t>(proxy) << 1]; }
+	uint32_t GetMaxIndex(int axis, ProxyHandle proxy) const { return endPointIndices[axis][(static_cast<uint32_t>(proxy) << 1) | 1]; }
+
+	// 2つのプロキシがaxis以外の軸で重なっているか
+	bool OverlapOtherAxes(int axis, ProxyHandle a, ProxyHandle b) const;
+
+	// ペアの追加と削除
+	void AddPair(ProxyHandle a, ProxyHandle b);
+	void RemovePair(ProxyHandle a, ProxyHandle b);
+
+	// ペアのキー
+	static uint64_t MakeKey(ProxyHandle a, ProxyHandle b);
+
+private:
+	std::vector<EndPoint> endPoints[3];
+	// 各軸の端点の位置(EndPoint::dataで引く)
+	// 並べ替えのたびに書き換えるので、キャッシュに載りやすいようにProxyとは別に持つ
+	std::vector<uint32_t> endPointIndices[3];
+	std::vector<Proxy> proxies;
+	// プロキシのAABB(まとめて判定する用。使われていない番号は空のAABB)
+	AABBSoA bounds;
+	ProxyHandle freeList = kNullProxy;
+	size_t proxyCount = 0;
+
+	// 追加待ちのプロキシ
+	std::vector<ProxyHandle> pendingProxies;
+
+	// 重なっているペア
+	std::unordered_set<uint64_t> pairs;
+};
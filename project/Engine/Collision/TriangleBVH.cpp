@@ -0,0 +1,340 @@
+#include "TriangleBVH.h"
+#include "kMath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 平行とみなす行列式の大きさ
+constexpr float kParallelEpsilon = 1.0e-12f;
+
+// 線分(円柱の部分)と動く球の判定。始点から最初に接する距離
+bool SphereCastEdge(const Ray& ray, float radius, const Vector3& p0, const Vector3& p1, float& distance) {
+	const Vector3 edge = p1 - p0;
+	const Vector3 m = ray.origin - p0;
+	const float ee = Dot(edge, edge);
+	const float ed = Dot(edge, ray.direction);
+	const float em = Dot(edge, m);
+	const float a = ee * Dot(ray.direction, ray.direction) - ed * ed;
+	// 辺と平行に動く場合は端の球と面で判定する
+	if (std::fabs(a) < kParallelEpsilon) {
+		return false;
+	}
+	const float b = ee * Dot(m, ray.direction) - em * ed;
+	const float c = ee * (Dot(m, m) - radius * radius) - em * em;
+	const float discriminant = b * b - a * c;
+	if (discriminant < 0.0f) {
+		return false;
+	}
+	const float t = (-b - std::sqrt(discriminant)) / a;
+	if (t < 0.0f || t > ray.maxDistance) {
+		return false;
+	}
+	// 円柱のうち線分の範囲に当たったか
+	const float s = em + t * ed;
+	if (s < 0.0f || s > ee) {
+		return false;
+	}
+	distance = t;
+	return true;
+}
+
+// 点(頂点の球)と動く球の判定
+bool SphereCastPoint(const Ray& ray, float radius, const Vector3& point, float& distance) {
+	const Vector3 m = ray.origin - point;
+	const float a = Dot(ray.direction, ray.direction);
+	const float b = Dot(m, ray.direction);
+	const float c = Dot(m, m) - radius * radius;
+	if (b > 0.0f || a <= 0.0f) {
+		return false;
+	}
+	const float discriminant = b * b - a * c;
+	if (discriminant < 0.0f) {
+		return false;
+	}
+	const float t = (-b - std::sqrt(discriminant)) / a;
+	if (t < 0.0f || t > ray.maxDistance) {
+		return false;
+	}
+	distance = t;
+	return true;
+}
+
+// 3点の重心座標で三角形の中に入っているか(同じ平面上の点)
+bool IsInsideTriangle(const Vector3& point, const Triangle& triangle, const Vector3& normal) {
+	for (int i = 0; i < 3; i++) {
+		const Vector3& a = triangle.vertices[i];
+		const Vector3& b = triangle.vertices[(i + 1) % 3];
+		if (Dot(Cross(b - a, point - a), normal) < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// 分離軸axisに三角形とAABB(中心が原点、半分の大きさがhalf)を投影して離れているか
+bool IsSeparated(const Vector3& axis, const Vector3 (&v)[3], const Vector3& half) {
+	const float p0 = Dot(v[0], axis);
+	const float p1 = Dot(v[1], axis);
+	const float p2 = Dot(v[2], axis);
+	const float r = half.x * std::fabs(axis.x) + half.y * std::fabs(axis.y) + half.z * std::fabs(axis.z);
+	return std::max({ p0, p1, p2 }) < -r || std::min({ p0, p1, p2 }) > r;
+}
+
+} // namespace
+
+bool RaycastTriangle(const Ray& ray, const Triangle& triangle, float& distance) {
+	// Moller-Trumbore法
+	const Vector3 edge1 = triangle.vertices[1] - triangle.vertices[0];
+	const Vector3 edge2 = triangle.vertices[2] - triangle.vertices[0];
+	const Vector3 p = Cross(ray.direction, edge2);
+	const float determinant = Dot(edge1, p);
+	if (std::fabs(determinant) < kParallelEpsilon) {
+		return false;
+	}
+	const float inverseDeterminant = 1.0f / determinant;
+	const Vector3 s = ray.origin - triangle.vertices[0];
+	const float u = Dot(s, p) * inverseDeterminant;
+	if (u < 0.0f || u > 1.0f) {
+		return false;
+	}
+	const Vector3 q = Cross(s, edge1);
+	const float v = Dot(ray.direction, q) * inverseDeterminant;
+	if (v < 0.0f || u + v > 1.0f) {
+		return false;
+	}
+	const float t = Dot(edge2, q) * inverseDeterminant;
+	if (t < 0.0f || t > ray.maxDistance) {
+		return false;
+	}
+	distance = t;
+	return true;
+}
+
+bool SphereCastTriangle(const Ray& ray, float radius, const Triangle& triangle, float& distance) {
+	// 始めから重なっている
+	const Vector3 closest = ClosestPointOnTriangle(ray.origin, triangle);
+	const Vector3 offset = ray.origin - closest;
+	if (Dot(offset, offset) <= radius * radius) {
+		distance = 0.0f;
+		return true;
+	}
+
+	bool isHit = false;
+	float best = ray.maxDistance;
+
+	// 面: 球が平面にradiusまで近づいた位置で、接点が三角形の中にあるか
+	const Vector3 normal = ComputeTriangleNormal(triangle);
+	const float side = Dot(normal, ray.origin - triangle.vertices[0]);
+	const Vector3 faceNormal = side >= 0.0f ? normal : -normal;
+	const float approach = Dot(faceNormal, ray.direction);
+	if (approach < 0.0f) {
+		const float t = (std::fabs(side) - radius) / -approach;
+		if (t >= 0.0f && t <= best) {
+			const Vector3 contact = ray.origin + ray.direction * t - faceNormal * radius;
+			if (IsInsideTriangle(contact, triangle, normal)) {
+				best = t;
+				isHit = true;
+			}
+		}
+	}
+
+	// 辺と頂点(面に当たった場合は、それより近いものだけが意味を持つ)
+	Ray limited = ray;
+	for (int i = 0; i < 3; i++) {
+		limited.maxDistance = best;
+		float t;
+		if (SphereCastEdge(limited, radius, triangle.vertices[i], triangle.vertices[(i + 1) % 3], t)) {
+			best = t;
+			isHit = true;
+		}
+		limited.maxDistance = best;
+		if (SphereCastPoint(limited, radius, triangle.vertices[i], t)) {
+			best = t;
+			isHit = true;
+		}
+	}
+	if (isHit) {
+		distance = best;
+	}
+	return isHit;
+}
+
+Vector3 ClosestPointOnTriangle(const Vector3& point, const Triangle& triangle) {
+	// 点がどの領域(頂点・辺・面)にあるかで場合分けする
+	const Vector3& a = triangle.vertices[0];
+	const Vector3& b = triangle.vertices[1];
+	const Vector3& c = triangle.vertices[2];
+	const Vector3 ab = b - a;
+	const Vector3 ac = c - a;
+	const Vector3 ap = point - a;
+	const float d1 = Dot(ab, ap);
+	const float d2 = Dot(ac, ap);
+	if (d1 <= 0.0f && d2 <= 0.0f) {
+		return a;
+	}
+	const Vector3 bp = point - b;
+	const float d3 = Dot(ab, bp);
+	const float d4 = Dot(ac, bp);
+	if (d3 >= 0.0f && d4 <= d3) {
+		return b;
+	}
+	const float vc = d1 * d4 - d3 * d2;
+	if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+		return a + ab * (d1 / (d1 - d3));
+	}
+	const Vector3 cp = point - c;
+	const float d5 = Dot(ab, cp);
+	const float d6 = Dot(ac, cp);
+	if (d6 >= 0.0f && d5 <= d6) {
+		return c;
+	}
+	const float vb = d5 * d2 - d1 * d6;
+	if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+		return a + ac * (d2 / (d2 - d6));
+	}
+	const float va = d3 * d6 - d5 * d4;
+	if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+	}
+	const float denominator = 1.0f / (va + vb + vc);
+	return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+bool OverlapTriangle(const Sphere& sphere, const Triangle& triangle) {
+	const Vector3 d = ClosestPointOnTriangle(sphere.center, triangle) - sphere.center;
+	return Dot(d, d) <= sphere.radius * sphere.radius;
+}
+
+bool OverlapTriangle(const AABB& aabb, const Triangle& triangle) {
+	// AABBの中心を原点にする
+	const Vector3 center = (aabb.min + aabb.max) * 0.5f;
+	const Vector3 half = (aabb.max - aabb.min) * 0.5f;
+	const Vector3 v[3] = { triangle.vertices[0] - center, triangle.vertices[1] - center, triangle.vertices[2] - center };
+	const Vector3 edges[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+
+	// AABBの面の軸(三角形のAABBと比べるのと同じ)
+	if (IsSeparated({ 1.0f, 0.0f, 0.0f }, v, half) || IsSeparated({ 0.0f, 1.0f, 0.0f }, v, half) || IsSeparated({ 0.0f, 0.0f, 1.0f }, v, half)) {
+		return false;
+	}
+	// 三角形の面の軸
+	if (IsSeparated(Cross(edges[0], edges[1]), v, half)) {
+		return false;
+	}
+	// 辺同士の軸
+	const Vector3 axes[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	for (const Vector3& axis : axes) {
+		for (const Vector3& edge : edges) {
+			if (IsSeparated(Cross(axis, edge), v, half)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+AABB ComputeTriangleAABB(const Triangle& triangle) {
+	const Vector3& a = triangle.vertices[0];
+	const Vector3& b = triangle.vertices[1];
+	const Vector3& c = triangle.vertices[2];
+	return AABB{
+		{ std::min({ a.x, b.x, c.x }), std::min({ a.y, b.y, c.y }), std::min({ a.z, b.z, c.z }) },
+		{ std::max({ a.x, b.x, c.x }), std::max({ a.y, b.y, c.y }), std::max({ a.z, b.z, c.z }) }
+	};
+}
+
+Vector3 ComputeTriangleNormal(const Triangle& triangle) {
+	const Vector3 normal = Cross(triangle.vertices[1] - triangle.vertices[0], triangle.vertices[2] - triangle.vertices[0]);
+	const float lengthSq = Dot(normal, normal);
+	if (lengthSq <= 0.0f) {
+		return Vector3{ 0.0f, 1.0f, 0.0f };
+	}
+	return normal * (1.0f / std::sqrt(lengthSq));
+}
+
+void TriangleBVH::Build(const Vector3* positions, size_t vertexCount) {
+	const size_t triangleCount = vertexCount / 3;
+	std::vector<Triangle> source(triangleCount);
+	std::vector<AABB> triangleBounds(triangleCount);
+	for (size_t i = 0; i < triangleCount; i++) {
+		source[i] = Triangle{ { positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2] } };
+		triangleBounds[i] = ComputeTriangleAABB(source[i]);
+	}
+
+	BuildBVH(triangleBounds.data(), triangleCount, nodes, triangleIndices);
+
+	// 葉から順番に読めるように並べ直す
+	triangles.resize(triangleCount);
+	for (size_t i = 0; i < triangleCount; i++) {
+		triangles[i] = source[triangleIndices[i]];
+	}
+	bounds = nodes.empty() ? AABB{} : nodes[0].bounds;
+}
+
+bool TriangleBVH::Raycast(const Ray& ray, RaycastHit& hit) const {
+	float maxDistance = ray.maxDistance;
+	const Triangle* hitTriangle = nullptr;
+	TraverseRay(ray.origin, ray.direction, 0.0f, maxDistance, [&](const Triangle& triangle, uint32_t index, float& distance) {
+		Ray limited = ray;
+		limited.maxDistance = distance;
+		float t;
+		if (RaycastTriangle(limited, triangle, t)) {
+			distance = t;
+			hitTriangle = &triangle;
+			hit.triangle = index;
+		}
+	});
+	if (!hitTriangle) {
+		return false;
+	}
+	hit.distance = maxDistance;
+	hit.point = ray.origin + ray.direction * maxDistance;
+	const Vector3 normal = ComputeTriangleNormal(*hitTriangle);
+	hit.normal = Dot(normal, ray.direction) <= 0.0f ? normal : -normal;
+	return true;
+}
+
+bool TriangleBVH::SphereCast(const Ray& ray, float radius, RaycastHit& hit) const {
+	float maxDistance = ray.maxDistance;
+	const Triangle* hitTriangle = nullptr;
+	TraverseRay(ray.origin, ray.direction, radius, maxDistance, [&](const Triangle& triangle, uint32_t index, float& distance) {
+		Ray limited = ray;
+		limited.maxDistance = distance;
+		float t;
+		if (SphereCastTriangle(limited, radius, triangle, t)) {
+			distance = t;
+			hitTriangle = &triangle;
+			hit.triangle = index;
+		}
+	});
+	if (!hitTriangle) {
+		return false;
+	}
+	// 当たった位置の球の中心から一番近い三角形上の点が接点
+	const Vector3 center = ray.origin + ray.direction * maxDistance;
+	hit.distance = maxDistance;
+	hit.point = ClosestPointOnTriangle(center, *hitTriangle);
+	const Vector3 offset = center - hit.point;
+	const float lengthSq = Dot(offset, offset);
+	hit.normal = lengthSq > 0.0f ? offset * (1.0f / std::sqrt(lengthSq)) : ComputeTriangleNormal(*hitTriangle);
+	return true;
+}
+
+void TriangleBVH::Overlap(const Sphere& sphere, std::vector<uint32_t>& result) const {
+	result.clear();
+	const Vector3 extent = { sphere.radius, sphere.radius, sphere.radius };
+	TraverseAABB(AABB{ sphere.center - extent, sphere.center + extent }, [&](const Triangle& triangle, uint32_t index) {
+		if (OverlapTriangle(sphere, triangle)) {
+			result.push_back(index);
+		}
+	});
+}
+
+void TriangleBVH::Overlap(const AABB& aabb, std::vector<uint32_t>& result) const {
+	result.clear();
+	TraverseAABB(aabb, [&](const Triangle& triangle, uint32_t index) {
+		if (OverlapTriangle(aabb, triangle)) {
+			result.push_back(index);
+		}
+	});
+}
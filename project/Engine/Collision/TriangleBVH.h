@@ -0,0 +1,107 @@
+#pragma once
+#include "BVH.h"
+#include "AABB.h"
+#include "Sphere.h"
+#include "Ray.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 三角形
+struct Triangle {
+	Vector3 vertices[3];
+};
+
+// レイ・スフィアキャストの結果
+struct RaycastHit {
+	// レイの始点からの距離(Ray::directionの長さを1とした値)
+	float distance;
+	// 当たった位置(スフィアキャストでは球と三角形が接する位置)
+	Vector3 point;
+	// 当たった面の法線(レイの向きと逆向き)
+	Vector3 normal;
+	// 三角形の番号(頂点配列の先頭から3つずつ数えた番号)
+	uint32_t triangle;
+};
+
+// 三角形とレイの判定(両面)。当たれば始点からの距離をdistanceに書く
+bool RaycastTriangle(const Ray& ray, const Triangle& triangle, float& distance);
+
+// 三角形と動く球の判定(両面)。最初に接する距離をdistanceに書く。始めから重なっていれば0
+bool SphereCastTriangle(const Ray& ray, float radius, const Triangle& triangle, float& distance);
+
+// 三角形上の点pに最も近い点
+Vector3 ClosestPointOnTriangle(const Vector3& point, const Triangle& triangle);
+
+// 三角形と球が重なっているか
+bool OverlapTriangle(const Sphere& sphere, const Triangle& triangle);
+
+// 三角形とAABBが重なっているか(分離軸判定)
+bool OverlapTriangle(const AABB& aabb, const Triangle& triangle);
+
+// 三角形を囲むAABB
+AABB ComputeTriangleAABB(const Triangle& triangle);
+
+// 三角形の法線(正規化済み。面積が0なら上向き)
+Vector3 ComputeTriangleNormal(const Triangle& triangle);
+
+// モデルの三角形に対するBVH(ボトムレベル)
+// モデルの読み込み時に1回だけ作り、ローカル座標のまま使う
+class TriangleBVH {
+public:
+	// 頂点配列から作る(頂点を3つずつで1つの三角形とみなす。Model::GetVerticesをGetIndicesの順に並べたもの)
+	void Build(const Vector3* positions, size_t vertexCount);
+
+	// 一番近い三角形との当たりを求める
+	bool Raycast(const Ray& ray, RaycastHit& hit) const;
+
+	// 半径radiusの球をレイに沿って動かして、最初に当たる三角形を求める
+	bool SphereCast(const Ray& ray, float radius, RaycastHit& hit) const;
+
+	// 球と重なっている三角形を求める(resultは上書きする)
+	void Overlap(const Sphere& sphere, std::vector<uint32_t>& result) const;
+
+	// AABBと重なっている三角形を求める(resultは上書きする)
+	void Overlap(const AABB& aabb, std::vector<uint32_t>& result) const;
+
+	// BVHの葉に当たった三角形をレイに沿って近い順にたどる(inflateだけ広げたノードに当たったものを調べる)
+	// visit(const Triangle&, uint32_t triangleIndex, float& maxDistance)は当たればmaxDistanceを縮める
+	template<typename Visit>
+	void TraverseRay(const Vector3& origin, const Vector3& direction, float inflate, float& maxDistance, Visit&& visit) const {
+		const RayBoxQuery query = MakeRayBoxQuery(origin, direction, inflate);
+		TraverseBVH(nodes, query, maxDistance, [this, &visit](uint32_t start, uint32_t count, float& distance) {
+			for (uint32_t i = start; i < start + count; i++) {
+				visit(triangles[i], triangleIndices[i], distance);
+			}
+		});
+	}
+
+	// aabbと重なるBVHの葉の三角形をたどる
+	// visit(const Triangle&, uint32_t triangleIndex)
+	template<typename Visit>
+	void TraverseAABB(const AABB& aabb, Visit&& visit) const {
+		TraverseBVH(nodes, aabb, [this, &visit](uint32_t start, uint32_t count) {
+			for (uint32_t i = start; i < start + count; i++) {
+				visit(triangles[i], triangleIndices[i]);
+			}
+		});
+	}
+
+	// Getter(三角形の数)
+	size_t GetTriangleCount() const { return triangles.size(); }
+
+	// Getter(全体を囲むAABB)
+	const AABB& GetBounds() const { return bounds; }
+
+	// Getter(ノード数)
+	size_t GetNodeCount() const { return nodes.size(); }
+
+private:
+	std::vector<BVHNode> nodes;
+	// 葉の順番に並べ直した三角形
+	std::vector<Triangle> triangles;
+	// 並べ直した三角形の元の番号
+	std::vector<uint32_t> triangleIndices;
+	AABB bounds = {};
+};
@@ -0,0 +1,121 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace {
+
+// ワーカースレッドならtrue
+thread_local bool isWorkerThread = false;
+
+} // namespace
+
+ThreadPool* ThreadPool::instance = nullptr;
+
+ThreadPool* ThreadPool::GetInstance() {
+	if (instance == nullptr) {
+		instance = new ThreadPool;
+	}
+	return instance;
+}
+
+void ThreadPool::Finalize() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	condition.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+
+	delete instance;
+	instance = nullptr;
+}
+
+void ThreadPool::Initialize(size_t threadCount) {
+	assert(workers.empty());
+	if (threadCount == 0) {
+		const size_t hardwareCount = std::thread::hardware_concurrency();
+		threadCount = hardwareCount > 1 ? hardwareCount - 1 : 0;
+	}
+	isStopping = false;
+	for (size_t i = 0; i < threadCount; i++) {
+		workers.emplace_back([this]() { WorkerMain(); });
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t batchSize, const RangeFunction& function) {
+	if (count == 0) {
+		return;
+	}
+	batchSize = std::max<size_t>(batchSize, 1);
+	const size_t batchCount = (count + batchSize - 1) / batchSize;
+	// 分ける必要がない場合と、ワーカースレッドから呼ばれた場合(待つとデッドロックする)はその場で処理する
+	if (workers.empty() || batchCount == 1 || isWorkerThread) {
+		function(0, count);
+		return;
+	}
+
+	std::atomic<size_t> nextBatch = 0;
+	auto run = [&]() {
+		for (;;) {
+			const size_t batch = nextBatch.fetch_add(1);
+			if (batch >= batchCount) {
+				break;
+			}
+			const size_t begin = batch * batchSize;
+			function(begin, std::min(begin + batchSize, count));
+		}
+	};
+
+	// 終わったタスクの数を数えて、全て終わるまで待つ
+	const size_t taskCount = std::min(batchCount, workers.size() + 1) - 1;
+	size_t remaining = taskCount;
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+	for (size_t i = 0; i < taskCount; i++) {
+		Enqueue([&]() {
+			run();
+			std::lock_guard<std::mutex> lock(doneMutex);
+			if (--remaining == 0) {
+				doneCondition.notify_one();
+			}
+		});
+	}
+	run();
+
+	std::unique_lock<std::mutex> lock(doneMutex);
+	doneCondition.wait(lock, [&]() { return remaining == 0; });
+}
+
+bool ThreadPool::IsWorkerThread() {
+	return isWorkerThread;
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push(std::move(task));
+	}
+	condition.notify_one();
+}
+
+void ThreadPool::WorkerMain() {
+	isWorkerThread = true;
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+			// 止める場合も積まれている処理は全て実行する
+			if (tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ワーカースレッドを使い回して処理を並列に実行する
+// Initializeを呼ぶまでは全て呼び出し元のスレッドで実行する
+class ThreadPool {
+private:
+	// シングルトンパターンを適用
+	static ThreadPool* instance;
+
+	// コンストラクタ、デストラクタの隠蔽
+	ThreadPool() = default;
+	~ThreadPool() = default;
+	// コピーコンストラクタ、コピー代入演算子の封印
+	ThreadPool(ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&) = delete;
+
+public:
+	// 範囲[begin, end)を処理する関数
+	using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	// インスタンスの取得
+	static ThreadPool* GetInstance();
+
+	// 終了処理(実行中の処理を待ってからスレッドを止める)
+	void Finalize();
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="threadCount">ワーカースレッドの数(0なら論理コア数 - 1)</param>
+	void Initialize(size_t threadCount = 0);
+
+	/// <summary>
+	/// [0, count)をbatchSize個ずつに分けて並列に処理する。全て終わるまで戻らない
+	/// 呼び出し元のスレッドも処理に参加する。ワーカースレッドの中から呼んだ場合はその場で順番に処理する
+	/// </summary>
+	/// <param name="count">要素数</param>
+	/// <param name="batchSize">1回に処理する要素数</param>
+	/// <param name="function">処理</param>
+	void ParallelFor(size_t count, size_t batchSize, const RangeFunction& function);
+
+	/// <summary>
+	/// 処理を1つワーカースレッドに積み、結果を受け取るfutureを返す(終わるのは待たない)
+	/// ワーカースレッドが無い場合はその場で実行してから返す
+	/// </summary>
+	/// <param name="function">処理</param>
+	template<typename Function>
+	std::future<std::invoke_result_t<Function>> Submit(Function function) {
+		using Result = std::invoke_result_t<Function>;
+		// std::functionはコピーできるものしか持てないので、shared_ptrで包む
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+		std::future<Result> future = task->get_future();
+		if (workers.empty()) {
+			(*task)();
+		} else {
+			Enqueue([task]() { (*task)(); });
+		}
+		return future;
+	}
+
+	// ワーカースレッドの数
+	size_t GetThreadCount() const { return workers.size(); }
+
+	// 今のスレッドがワーカースレッドか
+	static bool IsWorkerThread();
+
+private:
+	// 処理を積む
+	void Enqueue(std::function<void()> task);
+
+	// ワーカースレッドの処理
+	void WorkerMain();
+
+private:
+	std::vector<std::thread> workers;
+
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool isStopping = false;
+};
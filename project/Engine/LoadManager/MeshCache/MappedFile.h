@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 読み取り専用でメモリに割り当てたファイル(OSがページ単位で読み込むので、ファイル全体を読む必要がない)
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile() { Close(); }
+	// コピーの封印(割り当てを2回解放しないように)
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// 開く。開けなければfalse
+	bool Open(const std::string& filePath);
+
+	// 閉じる(GetDataのポインタは使えなくなる)
+	void Close();
+
+	// Getter(ファイルの先頭)
+	const uint8_t* GetData() const { return data; }
+	// Getter(ファイルのバイト数)
+	size_t GetSize() const { return size; }
+
+	// 開いているか
+	bool IsOpen() const { return data != nullptr; }
+
+private:
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	// OSのハンドル(WindowsではファイルとFileMapping、それ以外ではファイル記述子)
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+	int descriptor = -1;
+};
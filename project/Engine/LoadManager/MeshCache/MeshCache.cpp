@@ -0,0 +1,212 @@
+#include "MeshCache.h"
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+
+// ファイルの先頭(割り当てたメモリをそのまま参照する)
+struct MeshCache::Header {
+	uint32_t magic;
+	uint32_t version;
+	// 元のファイルの大きさと更新時刻
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	uint32_t vertexStride;
+	uint32_t vertexCount;
+	uint32_t indexSize;
+	uint32_t indexCount;
+	uint32_t materialCount;
+	uint32_t reserved;
+	// 各ブロックのファイルの先頭からの位置
+	uint64_t vertexOffset;
+	uint64_t indexOffset;
+	uint64_t materialOffset;
+	uint64_t fileSize;
+	BoundingVolume bounds;
+};
+namespace {
+
+// ファイルの識別子("KMSH")と形式の版(形式を変えたら上げて、古いキャッシュを作り直させる)
+constexpr uint32_t kMagic = 0x48534D4B;
+constexpr uint32_t kVersion = 3;
+// ブロックの先頭をそろえるバイト数
+constexpr uint64_t kBlockAlignment = 16;
+
+// マテリアル(テクスチャのパスの位置と長さ)
+struct MeshCacheMaterial {
+	uint64_t textureOffset;
+	uint64_t textureLength;
+};
+
+uint64_t AlignUp(uint64_t value) {
+	return (value + kBlockAlignment - 1) & ~(kBlockAlignment - 1);
+}
+
+// 元のファイルの大きさと更新時刻。無ければfalse
+bool GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time) {
+	std::error_code error;
+	const std::filesystem::path path(sourcePath);
+	size = std::filesystem::file_size(path, error);
+	if (error) {
+		return false;
+	}
+	time = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+	return !error;
+}
+
+} // namespace
+
+std::string MeshCache::GetCachePath(const std::string& sourcePath) {
+	return sourcePath + ".mesh";
+}
+
+bool MeshCache::Write(const std::string& sourcePath, const MeshCacheSource& source) {
+	static_assert(std::is_trivially_copyable_v<Header>);
+	assert(source.vertices || source.vertexCount == 0);
+	assert(source.indexSize == 0 || source.indexSize == 2 || source.indexSize == 4);
+
+	Header header{};
+	header.magic = kMagic;
+	header.version = kVersion;
+	if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceTime)) {
+		return false;
+	}
+	header.vertexStride = source.vertexStride;
+	header.vertexCount = source.vertexCount;
+	header.indexSize = source.indexSize;
+	header.indexCount = source.indexCount;
+	header.materialCount = static_cast<uint32_t>(source.textureFilePaths.size());
+	header.bounds = source.bounds;
+
+	const uint64_t vertexBytes = static_cast<uint64_t>(source.vertexStride) * source.vertexCount;
+	const uint64_t indexBytes = static_cast<uint64_t>(source.indexSize) * source.indexCount;
+	header.vertexOffset = AlignUp(sizeof(Header));
+	header.indexOffset = AlignUp(header.vertexOffset + vertexBytes);
+	header.materialOffset = AlignUp(header.indexOffset + indexBytes);
+	std::vector<MeshCacheMaterial> materials(header.materialCount);
+	uint64_t textureOffset = header.materialOffset + sizeof(MeshCacheMaterial) * materials.size();
+	for (size_t i = 0; i < materials.size(); i++) {
+		materials[i] = { textureOffset, source.textureFilePaths[i].size() };
+		textureOffset += source.textureFilePaths[i].size();
+	}
+	header.fileSize = textureOffset;
+
+	// 一時ファイルに書いてから置き換える
+	const std::string cachePath = GetCachePath(sourcePath);
+	const std::string temporaryPath = cachePath + ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+		static const char kPadding[kBlockAlignment] = {};
+		auto writeBlock = [&file](uint64_t offset, const void* data, uint64_t bytes) {
+			const uint64_t position = static_cast<uint64_t>(file.tellp());
+			file.write(kPadding, static_cast<std::streamsize>(offset - position));
+			file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+		};
+		writeBlock(0, &header, sizeof(Header));
+		writeBlock(header.vertexOffset, source.vertices, vertexBytes);
+		writeBlock(header.indexOffset, source.indices, indexBytes);
+		writeBlock(header.materialOffset, materials.data(), sizeof(MeshCacheMaterial) * materials.size());
+		for (const std::string& texturePath : source.textureFilePaths) {
+			file.write(texturePath.data(), static_cast<std::streamsize>(texturePath.size()));
+		}
+		if (!file) {
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	if (error) {
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+bool MeshCache::Open(const std::string& sourcePath, uint32_t vertexStride) {
+	Close();
+	if (!file.Open(GetCachePath(sourcePath))) {
+		return false;
+	}
+	// 中身を確かめる(途中で切れたファイルや、違う版のファイルは使わない)
+	const Header* candidate = reinterpret_cast<const Header*>(file.GetData());
+	const uint64_t size = file.GetSize();
+	bool isValid = size >= sizeof(Header) &&
+		candidate->magic == kMagic &&
+		candidate->version == kVersion &&
+		candidate->fileSize == size &&
+		candidate->vertexStride == vertexStride &&
+		(candidate->indexSize == 0 || candidate->indexSize == 2 || candidate->indexSize == 4) &&
+		candidate->vertexOffset + static_cast<uint64_t>(candidate->vertexStride) * candidate->vertexCount <= size &&
+		candidate->indexOffset + static_cast<uint64_t>(candidate->indexSize) * candidate->indexCount <= size &&
+		candidate->materialOffset + sizeof(MeshCacheMaterial) * candidate->materialCount <= size;
+	if (isValid) {
+		const MeshCacheMaterial* materials = reinterpret_cast<const MeshCacheMaterial*>(file.GetData() + candidate->materialOffset);
+		for (uint32_t i = 0; i < candidate->materialCount; i++) {
+			isValid &= materials[i].textureOffset + materials[i].textureLength <= size;
+		}
+	}
+	// 元のファイルがあれば、キャッシュを作ったときから変わっていないか調べる
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	if (isValid && GetSourceStamp(sourcePath, sourceSize, sourceTime)) {
+		isValid = candidate->sourceSize == sourceSize && candidate->sourceTime == sourceTime;
+	}
+	if (!isValid) {
+		file.Close();
+		return false;
+	}
+	header = candidate;
+	return true;
+}
+
+void MeshCache::Close() {
+	header = nullptr;
+	file.Close();
+}
+
+const void* MeshCache::GetVertices() const {
+	assert(header);
+	return file.GetData() + header->vertexOffset;
+}
+
+uint32_t MeshCache::GetVertexCount() const {
+	assert(header);
+	return header->vertexCount;
+}
+
+const void* MeshCache::GetIndices() const {
+	assert(header);
+	return header->indexCount > 0 ? file.GetData() + header->indexOffset : nullptr;
+}
+
+uint32_t MeshCache::GetIndexSize() const {
+	assert(header);
+	return header->indexSize;
+}
+
+uint32_t MeshCache::GetIndexCount() const {
+	assert(header);
+	return header->indexCount;
+}
+
+const BoundingVolume& MeshCache::GetBounds() const {
+	assert(header);
+	return header->bounds;
+}
+
+uint32_t MeshCache::GetMaterialCount() const {
+	assert(header);
+	return header->materialCount;
+}
+
+std::string_view MeshCache::GetTextureFilePath(uint32_t materialIndex) const {
+	assert(header);
+	assert(materialIndex < header->materialCount);
+	const MeshCacheMaterial& material = reinterpret_cast<const MeshCacheMaterial*>(file.GetData() + header->materialOffset)[materialIndex];
+	return std::string_view(reinterpret_cast<const char*>(file.GetData() + material.textureOffset), static_cast<size_t>(material.textureLength));
+}
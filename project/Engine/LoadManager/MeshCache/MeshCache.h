@@ -0,0 +1,80 @@
+#pragma once
+#include "MappedFile.h"
+#include "BoundingVolume.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 書き出すメッシュ(頂点・インデックスはGPUに送る形のまま渡す)
+struct MeshCacheSource {
+	const void* vertices = nullptr;
+	uint32_t vertexStride = 0;
+	uint32_t vertexCount = 0;
+	// インデックス(無ければindexSizeとindexCountを0にする)
+	const void* indices = nullptr;
+	uint32_t indexSize = 0;
+	uint32_t indexCount = 0;
+	// ローカル座標の境界ボリューム
+	BoundingVolume bounds{};
+	// マテリアルごとのテクスチャのパス
+	std::vector<std::string> textureFilePaths;
+};
+
+// 読み込み済みのメッシュを変換後の形のまま保存したバイナリファイル
+// 起動時にassimpで読み込み直さず、ファイルをメモリに割り当てて頂点をそのままアップロード用のバッファにコピーする
+// 元のファイルの大きさと更新時刻を記録しておき、元のファイルが変わっていれば使わない(作り直す)
+//
+// ファイルの中身(各ブロックの先頭は16バイト境界にそろえる)
+//   MeshCacheHeader
+//   頂点(vertexStride * vertexCountバイト)
+//   インデックス(indexSize * indexCountバイト)
+//   マテリアル(MeshCacheMaterial * materialCount、続けてテクスチャのパスの文字列)
+class MeshCache {
+public:
+	// 元のファイルに対するキャッシュのパス(同じディレクトリに拡張子.meshを足して置く)
+	static std::string GetCachePath(const std::string& sourcePath);
+
+	/// <summary>
+	/// 書き出す(途中で失敗しても壊れたファイルが残らないように、一時ファイルに書いてから置き換える)
+	/// </summary>
+	/// <param name="sourcePath">元のファイルのパス</param>
+	/// <param name="source">書き出すメッシュ</param>
+	/// <returns>書き出せなければfalse</returns>
+	static bool Write(const std::string& sourcePath, const MeshCacheSource& source);
+
+	/// <summary>
+	/// 開く
+	/// キャッシュが無い、壊れている、元のファイルが更新された、頂点の大きさが違う場合はfalse
+	/// 元のファイルが無い場合はキャッシュだけで使えるようにする(変換済みのファイルだけを配る場合)
+	/// </summary>
+	/// <param name="sourcePath">元のファイルのパス</param>
+	/// <param name="vertexStride">頂点1個のバイト数</param>
+	bool Open(const std::string& sourcePath, uint32_t vertexStride);
+
+	// 閉じる(Getterで受け取ったポインタは使えなくなる)
+	void Close();
+
+	// 開いているか
+	bool IsOpen() const { return header != nullptr; }
+
+	// Getter(頂点。ファイルを割り当てたメモリを指す)
+	const void* GetVertices() const;
+	uint32_t GetVertexCount() const;
+	// Getter(インデックス。無ければnullptr)
+	const void* GetIndices() const;
+	uint32_t GetIndexSize() const;
+	uint32_t GetIndexCount() const;
+	// Getter(境界ボリューム)
+	const BoundingVolume& GetBounds() const;
+	// Getter(マテリアル)
+	uint32_t GetMaterialCount() const;
+	std::string_view GetTextureFilePath(uint32_t materialIndex) const;
+
+private:
+	struct Header;
+
+	MappedFile file;
+	const Header* header = nullptr;
+};
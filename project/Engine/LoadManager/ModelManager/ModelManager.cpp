@@ -2,6 +2,9 @@
 #include "Model.h"
 #include "ModelBase.h"
 #include "DirectXBase.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <exception>
 
 ModelManager* ModelManager::instance = nullptr;
 
@@ -13,6 +16,10 @@ ModelManager* ModelManager::GetInstance() {
 }
 
 void ModelManager::Finalize() {
+	// ワーカースレッドが書き込んでいる途中のモデルを消さないように、読み込みだけは待つ
+	for (auto& [filePath, loading] : loadingModels) {
+		loading.loaded.wait();
+	}
 	delete instance;
 	instance = nullptr;
 }
@@ -27,6 +34,14 @@ void ModelManager::LoadModel(const std::string& directoryPath, const std::string
 		// 読み込み済なら早期return
 		return;
 	}
+	// 非同期で読み込み中なら、終わるのを待ってResourceを作る
+	if (loadingModels.contains(filePath)) {
+		const std::shared_future<Model*> future = loadingModels.at(filePath).future;
+		FinishLoading(loadingModels.find(filePath));
+		// 読み込みに失敗していれば、同期で読んだときと同じようにここで例外を投げる
+		future.get();
+		return;
+	}
 
 	// モデルの生成と読み込み、初期化
 	std::unique_ptr<Model> model = std::make_unique<Model>();
@@ -36,6 +51,68 @@ void ModelManager::LoadModel(const std::string& directoryPath, const std::string
 	models.insert(std::make_pair(filePath, std::move(model)));
 }
 
+std::shared_future<Model*> ModelManager::LoadModelAsync(const std::string& directoryPath, const std::string& filePath, const bool& enableLighting) {
+	// 読み込み済なら、モデルの入ったfutureをすぐに返す
+	if (models.contains(filePath)) {
+		std::promise<Model*> promise;
+		promise.set_value(models.at(filePath).get());
+		return promise.get_future().share();
+	}
+	// 読み込み中なら同じfutureを返す
+	if (loadingModels.contains(filePath)) {
+		return loadingModels.at(filePath).future;
+	}
+
+	LoadingModel& loading = loadingModels[filePath];
+	loading.model = std::make_unique<Model>();
+	loading.enableLighting = enableLighting;
+	loading.future = loading.promise.get_future().share();
+	// 頂点の形式は頼んだ時点の設定を使う(ワーカースレッドからModelBaseに触らない)
+	Model* model = loading.model.get();
+	const VertexFormat vertexFormat = ModelBase::GetInstance()->GetVertexFormat();
+	loading.loaded = ThreadPool::GetInstance()->Submit([model, directoryPath, filePath, vertexFormat]() {
+		model->Load(directoryPath, filePath, vertexFormat);
+	});
+	return loading.future;
+}
+
+void ModelManager::Update() {
+	// 読み終わったものだけResourceを作る(読み込み中のものは待たない)
+	for (auto it = loadingModels.begin(); it != loadingModels.end();) {
+		auto next = std::next(it);
+		if (it->second.loaded.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+			FinishLoading(it);
+		}
+		it = next;
+	}
+}
+
+void ModelManager::WaitAll() {
+	while (!loadingModels.empty()) {
+		FinishLoading(loadingModels.begin());
+	}
+}
+
+void ModelManager::FinishLoading(std::map<std::string, LoadingModel>::iterator it) {
+	LoadingModel& loading = it->second;
+	// ワーカースレッドでの読み込みを待つ
+	// 読み込みに失敗したら、futureを待っている側に例外を渡して読み込み中から外す(getしたfutureは二度と使えない)
+	try {
+		loading.loaded.get();
+	} catch (...) {
+		loading.promise.set_exception(std::current_exception());
+		loadingModels.erase(it);
+		return;
+	}
+	// Resourceの作成とアップロードはこのスレッドで行う
+	loading.model->CreateResources(loading.enableLighting);
+
+	Model* model = loading.model.get();
+	models.insert(std::make_pair(it->first, std::move(loading.model)));
+	loading.promise.set_value(model);
+	loadingModels.erase(it);
+}
+
 Model* ModelManager::FindModel(const std::string& filePath) {
 	// 読み込み済モデルを検索
 	if (models.contains(filePath)) {
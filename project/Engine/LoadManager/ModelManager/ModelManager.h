@@ -1,3 +1,4 @@
+#include <future>
 #include <map>
 #include <string>
 #include <memory>
@@ -39,16 +40,54 @@ public:
 	/// enableLightingは何も入力しなければfalse
 	void LoadModel(const std::string& directoryPath, const std::string& filePath, const bool& enableLighting = false);
 
+	/// <summary>
+	/// モデルファイルの非同期読み込み
+	/// 読み込みと頂点の最適化はワーカースレッドで行い、Resourceの作成はUpdateで行う
+	/// </summary>
+	/// <param name="directoryPath"> : ディレクトリ(元ファイル)のパス</param>
+	/// <param name="filePath"> : モデルファイルのパス</param>
+	/// <param name="enableLighting"> : ライティングを適用するかどうか</param>
+	/// <returns>Resourceまで作り終えるとモデルが入るfuture(Updateで値が入るので、同じスレッドでgetして待たないこと。読み込みに失敗したときは例外が入る)</returns>
+	std::shared_future<Model*> LoadModelAsync(const std::string& directoryPath, const std::string& filePath, const bool& enableLighting = false);
+
+	// ワーカースレッドで読み終わったモデルのResourceを作る(毎フレーム呼ぶ)
+	void Update();
+
+	// 読み込み中のモデルを全て読み終えるまで待ち、Resourceを作る(ロード画面の最後など)
+	void WaitAll();
+
+	// 読み込みが終わって使えるか
+	bool IsLoaded(const std::string& filePath) const { return models.contains(filePath); }
+	// 読み込み中のモデルの数
+	size_t GetLoadingCount() const { return loadingModels.size(); }
+
 	/// <summary>
 	/// モデルの検索
 	/// </summary>
 	/// <param name="filePath">モデルファイルのパス</param>
-	/// <returns>モデル</returns>
+	/// <returns>モデル(読み込み中ならnullptr)</returns>
 	Model* FindModel(const std::string& filePath);
 
+private:
+	// 読み込み中のモデル
+	struct LoadingModel {
+		std::unique_ptr<Model> model;
+		bool enableLighting = false;
+		// ワーカースレッドでの読み込み
+		std::future<void> loaded;
+		// Resourceまで作り終えたらモデルを入れる
+		std::promise<Model*> promise;
+		std::shared_future<Model*> future;
+	};
+
+	// ワーカースレッドでの読み込みを待ってResourceを作り、読み込み済みのモデルに移す(失敗したらpromiseに例外を入れて捨てる)
+	void FinishLoading(std::map<std::string, LoadingModel>::iterator it);
+
 private:
 	// モデレータ
 	std::map<std::string, std::unique_ptr<Model>> models;
+	// 読み込み中のモデル
+	std::map<std::string, LoadingModel> loadingModels;
 
 	ModelBase* modelBase = nullptr;
 };
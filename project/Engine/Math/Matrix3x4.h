@@ -0,0 +1,8 @@
+#pragma once
+
+// 4x4のアフィン行列を転置して、定数の4列目(0,0,0,1)を省いたもの
+// m[i] = (Matrix4x4のi列目) なので、HLSLのrow_major float3x4にそのまま送れる
+struct Matrix3x4
+{
+	float m[3][4];
+};
\ No newline at end of file
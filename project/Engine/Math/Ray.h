@@ -0,0 +1,11 @@
+#pragma once
+#include "Vector3.h"
+
+// レイ(originからdirection方向にmaxDistanceまでの線分)
+// 当たった位置の距離はdirectionの長さを1とした値になるので、距離が欲しい場合はdirectionを正規化しておく
+struct Ray final
+{
+	Vector3 origin;
+	Vector3 direction;
+	float maxDistance;
+};
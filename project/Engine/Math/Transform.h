@@ -1,5 +1,6 @@
 #include "Vector3.h"
 #include "Vector4.h"
+#include "Quaternion.h"
 
 #pragma once
 struct Transform {
@@ -8,4 +9,11 @@ struct Transform {
 	Vector3 translate;
 };
 
+// 回転をQuaternionで持つTransform
+struct QuaternionTransform {
+	Vector3 scale;
+	Quaternion rotate;
+	Vector3 translate;
+};
+
 //class Transform {};
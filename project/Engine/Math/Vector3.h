@@ -1,8 +1,101 @@
 #pragma once
+#include <type_traits>
 
 struct Vector3
 {
 	float x;
 	float y;
 	float z;
-};
\ No newline at end of file
+};
+
+// GPUに送る構造体(VertexDataなど)に使うのでレイアウトを変えない
+static_assert(sizeof(Vector3) == sizeof(float) * 3 && std::is_trivially_copyable_v<Vector3> && std::is_standard_layout_v<Vector3>);
+
+// 演算子はインライン展開できるようにヘッダーに定義する
+
+constexpr Vector3& operator+=(Vector3& v1, const Vector3& v2) {
+	v1.x += v2.x;
+	v1.y += v2.y;
+	v1.z += v2.z;
+	return v1;
+}
+
+constexpr Vector3& operator-=(Vector3& v1, const Vector3& v2) {
+	v1.x -= v2.x;
+	v1.y -= v2.y;
+	v1.z -= v2.z;
+	return v1;
+}
+
+constexpr Vector3& operator*=(Vector3& v1, const Vector3& v2) {
+	v1.x *= v2.x;
+	v1.y *= v2.y;
+	v1.z *= v2.z;
+	return v1;
+}
+
+constexpr Vector3& operator/=(Vector3& v1, const Vector3& v2) {
+	v1.x /= v2.x;
+	v1.y /= v2.y;
+	v1.z /= v2.z;
+	return v1;
+}
+
+constexpr Vector3& operator*=(Vector3& v, const float f) {
+	v.x *= f;
+	v.y *= f;
+	v.z *= f;
+	return v;
+}
+
+constexpr Vector3& operator/=(Vector3& v, const float f) {
+	v.x /= f;
+	v.y /= f;
+	v.z /= f;
+	return v;
+}
+
+constexpr Vector3 operator+(const Vector3& v1, const Vector3& v2) {
+	return Vector3{ v1.x + v2.x, v1.y + v2.y, v1.z + v2.z };
+}
+
+constexpr Vector3 operator-(const Vector3& v1, const Vector3& v2) {
+	return Vector3{ v1.x - v2.x, v1.y - v2.y, v1.z - v2.z };
+}
+
+constexpr Vector3 operator*(const Vector3& v1, const Vector3& v2) {
+	return Vector3{ v1.x * v2.x, v1.y * v2.y, v1.z * v2.z };
+}
+
+constexpr Vector3 operator/(const Vector3& v1, const Vector3& v2) {
+	return Vector3{ v1.x / v2.x, v1.y / v2.y, v1.z / v2.z };
+}
+
+constexpr Vector3 operator+(const Vector3& v, const float f) {
+	return Vector3{ v.x + f, v.y + f, v.z + f };
+}
+
+constexpr Vector3 operator-(const Vector3& v, const float f) {
+	return Vector3{ v.x - f, v.y - f, v.z - f };
+}
+
+constexpr Vector3 operator*(const Vector3& v, const float f) {
+	return Vector3{ v.x * f, v.y * f, v.z * f };
+}
+
+constexpr Vector3 operator*(const float f, const Vector3& v) {
+	return Vector3{ v.x * f, v.y * f, v.z * f };
+}
+
+constexpr Vector3 operator/(const Vector3& v, const float f) {
+	return Vector3{ v.x / f, v.y / f, v.z / f };
+}
+
+constexpr Vector3 operator-(const Vector3& v) {
+	return Vector3{ -v.x, -v.y, -v.z };
+}
+
+// 内積
+constexpr float Dot(const Vector3& v1, const Vector3& v2) {
+	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
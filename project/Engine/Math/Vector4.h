@@ -1,4 +1,5 @@
 #pragma once
+#include <type_traits>
 
 struct Vector4
 {
@@ -6,4 +7,94 @@ struct Vector4
 	float y;
 	float z;
 	float w;
-};
\ No newline at end of file
+};
+
+// GPUに送る構造体(VertexDataなど)に使うのでレイアウトを変えない
+static_assert(sizeof(Vector4) == sizeof(float) * 4 && std::is_trivially_copyable_v<Vector4> && std::is_standard_layout_v<Vector4>);
+
+// 演算子はインライン展開できるようにヘッダーに定義する
+
+constexpr Vector4& operator+=(Vector4& v1, const Vector4& v2) {
+	v1.x += v2.x;
+	v1.y += v2.y;
+	v1.z += v2.z;
+	v1.w += v2.w;
+	return v1;
+}
+
+constexpr Vector4& operator-=(Vector4& v1, const Vector4& v2) {
+	v1.x -= v2.x;
+	v1.y -= v2.y;
+	v1.z -= v2.z;
+	v1.w -= v2.w;
+	return v1;
+}
+
+constexpr Vector4& operator*=(Vector4& v1, const Vector4& v2) {
+	v1.x *= v2.x;
+	v1.y *= v2.y;
+	v1.z *= v2.z;
+	v1.w *= v2.w;
+	return v1;
+}
+
+constexpr Vector4& operator/=(Vector4& v1, const Vector4& v2) {
+	v1.x /= v2.x;
+	v1.y /= v2.y;
+	v1.z /= v2.z;
+	v1.w /= v2.w;
+	return v1;
+}
+
+constexpr Vector4& operator*=(Vector4& v, const float f) {
+	v.x *= f;
+	v.y *= f;
+	v.z *= f;
+	v.w *= f;
+	return v;
+}
+
+constexpr Vector4& operator/=(Vector4& v, const float f) {
+	v.x /= f;
+	v.y /= f;
+	v.z /= f;
+	v.w /= f;
+	return v;
+}
+
+constexpr Vector4 operator+(const Vector4& v1, const Vector4& v2) {
+	return Vector4{ v1.x + v2.x, v1.y + v2.y, v1.z + v2.z, v1.w + v2.w };
+}
+
+constexpr Vector4 operator-(const Vector4& v1, const Vector4& v2) {
+	return Vector4{ v1.x - v2.x, v1.y - v2.y, v1.z - v2.z, v1.w - v2.w };
+}
+
+constexpr Vector4 operator*(const Vector4& v1, const Vector4& v2) {
+	return Vector4{ v1.x * v2.x, v1.y * v2.y, v1.z * v2.z, v1.w * v2.w };
+}
+
+constexpr Vector4 operator/(const Vector4& v1, const Vector4& v2) {
+	return Vector4{ v1.x / v2.x, v1.y / v2.y, v1.z / v2.z, v1.w / v2.w };
+}
+
+constexpr Vector4 operator*(const Vector4& v, const float f) {
+	return Vector4{ v.x * f, v.y * f, v.z * f, v.w * f };
+}
+
+constexpr Vector4 operator*(const float f, const Vector4& v) {
+	return Vector4{ v.x * f, v.y * f, v.z * f, v.w * f };
+}
+
+constexpr Vector4 operator/(const Vector4& v, const float f) {
+	return Vector4{ v.x / f, v.y / f, v.z / f, v.w / f };
+}
+
+constexpr Vector4 operator-(const Vector4& v) {
+	return Vector4{ -v.x, -v.y, -v.z, -v.w };
+}
+
+// 内積
+constexpr float Dot(const Vector4& v1, const Vector4& v2) {
+	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+}
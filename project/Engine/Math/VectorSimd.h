@@ -0,0 +1,97 @@
+#pragma once
+#include "Vector3.h"
+#include "Vector4.h"
+
+// Vector3/Vector4を128bitレジスタに載せて計算するための型
+// 保存するときはVector3/Vector4に戻す(GPUに送る構造体のレイアウトは変えない)
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VECTOR_SIMD_SSE 1
+#include <xmmintrin.h>
+#else
+#define VECTOR_SIMD_SSE 0
+#endif
+
+struct Float4 {
+#if VECTOR_SIMD_SSE
+	__m128 v;
+#else
+	float v[4];
+#endif
+};
+
+#if VECTOR_SIMD_SSE
+
+inline Float4 LoadFloat4(const Vector4& v) { return Float4{ _mm_loadu_ps(&v.x) }; }
+
+// wは0になる
+inline Float4 LoadFloat4(const Vector3& v) {
+	// 12byteしか読まないように分けて読み込む
+	__m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(&v.x));
+	__m128 z = _mm_load_ss(&v.z);
+	return Float4{ _mm_movelh_ps(xy, z) };
+}
+
+inline Float4 SplatFloat4(float f) { return Float4{ _mm_set1_ps(f) }; }
+
+inline Vector4 StoreVector4(const Float4& f) {
+	Vector4 result;
+	_mm_storeu_ps(&result.x, f.v);
+	return result;
+}
+
+inline Vector3 StoreVector3(const Float4& f) {
+	Vector3 result;
+	_mm_storel_pi(reinterpret_cast<__m64*>(&result.x), f.v);
+	_mm_store_ss(&result.z, _mm_movehl_ps(f.v, f.v));
+	return result;
+}
+
+inline Float4 operator+(const Float4& a, const Float4& b) { return Float4{ _mm_add_ps(a.v, b.v) }; }
+inline Float4 operator-(const Float4& a, const Float4& b) { return Float4{ _mm_sub_ps(a.v, b.v) }; }
+inline Float4 operator*(const Float4& a, const Float4& b) { return Float4{ _mm_mul_ps(a.v, b.v) }; }
+inline Float4 operator/(const Float4& a, const Float4& b) { return Float4{ _mm_div_ps(a.v, b.v) }; }
+inline Float4 operator*(const Float4& a, float f) { return Float4{ _mm_mul_ps(a.v, _mm_set1_ps(f)) }; }
+
+// a * b + c
+inline Float4 MultiplyAdd(const Float4& a, const Float4& b, const Float4& c) { return Float4{ _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; }
+
+inline Float4 Min(const Float4& a, const Float4& b) { return Float4{ _mm_min_ps(a.v, b.v) }; }
+inline Float4 Max(const Float4& a, const Float4& b) { return Float4{ _mm_max_ps(a.v, b.v) }; }
+
+// 4成分の内積
+inline float Dot(const Float4& a, const Float4& b) {
+	__m128 m = _mm_mul_ps(a.v, b.v);
+	__m128 s = _mm_add_ps(m, _mm_movehl_ps(m, m));
+	s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(s);
+}
+
+#else
+
+inline Float4 LoadFloat4(const Vector4& v) { return Float4{ { v.x, v.y, v.z, v.w } }; }
+inline Float4 LoadFloat4(const Vector3& v) { return Float4{ { v.x, v.y, v.z, 0.0f } }; }
+inline Float4 SplatFloat4(float f) { return Float4{ { f, f, f, f } }; }
+inline Vector4 StoreVector4(const Float4& f) { return Vector4{ f.v[0], f.v[1], f.v[2], f.v[3] }; }
+inline Vector3 StoreVector3(const Float4& f) { return Vector3{ f.v[0], f.v[1], f.v[2] }; }
+
+inline Float4 operator+(const Float4& a, const Float4& b) { return Float4{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+inline Float4 operator-(const Float4& a, const Float4& b) { return Float4{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+inline Float4 operator*(const Float4& a, const Float4& b) { return Float4{ { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+inline Float4 operator/(const Float4& a, const Float4& b) { return Float4{ { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+inline Float4 operator*(const Float4& a, float f) { return Float4{ { a.v[0] * f, a.v[1] * f, a.v[2] * f, a.v[3] * f } }; }
+
+// a * b + c
+inline Float4 MultiplyAdd(const Float4& a, const Float4& b, const Float4& c) { return a * b + c; }
+
+inline Float4 Min(const Float4& a, const Float4& b) { return Float4{ { a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3] } }; }
+inline Float4 Max(const Float4& a, const Float4& b) { return Float4{ { a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3] } }; }
+
+// 4成分の内積
+inline float Dot(const Float4& a, const Float4& b) { return a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2] + a.v[3] * b.v[3]; }
+
+#endif
+
+inline Float4& operator+=(Float4& a, const Float4& b) { return a = a + b; }
+inline Float4& operator-=(Float4& a, const Float4& b) { return a = a - b; }
+inline Float4& operator*=(Float4& a, const Float4& b) { return a = a * b; }
@@ -1,104 +1,6 @@
 ﻿#include "kMath.h"
-
-const Vector3 operator*(const Vector3& v, const float f) {
-	Vector3 result;
-	result.x = v.x * f;
-	result.y = v.y * f;
-	result.z = v.z * f;
-	return result;
-}
-
-Vector3& operator+=(Vector3& v1, const Vector3& v2) {
-	v1.x += v2.x;
-	v1.y += v2.y;
-	v1.z += v2.z;
-	return v1;
-}
-
-const Vector3 operator+(const Vector3& v1, const Vector3 v2) {
-	Vector3 result;
-	result.x = v1.x + v2.x;
-	result.y = v1.y + v2.y;
-	result.z = v1.z + v2.z;
-	return result;
-}
-
-Vector3& operator-=(Vector3& v1, const Vector3& v2) {
-	v1.x -= v2.x;
-	v1.y -= v2.y;
-	v1.z -= v2.z;
-	return v1;
-}
-
-const Vector3 operator-(Vector3& v1, const Vector3 v2) {
-	Vector3 result;
-	result.x = v1.x - v2.x;
-	result.y = v1.y - v2.y;
-	result.z = v1.z - v2.z;
-	return result;
-}
-
-Vector3& operator*=(Vector3& v1, const Vector3& v2) {
-	v1.x *= v2.x;
-	v1.y *= v2.y;
-	v1.z *= v2.z;
-	return v1;
-}
-
-const Vector3 operator*(Vector3& v1, const Vector3 v2) {
-	Vector3 result;
-	result.x = v1.x * v2.x;
-	result.y = v1.y * v2.y;
-	result.z = v1.z * v2.z;
-	return result;
-}
-
-Vector3& operator/=(Vector3& v1, const Vector3& v2) {
-	v1.x /= v2.x;
-	v1.y /= v2.y;
-	v1.z /= v2.z;
-	return v1;
-}
-
-const Vector3 operator/(const Vector3& v1, const Vector3 v2) {
-	Vector3 result;
-	result.x = v1.x / v2.x;
-	result.y = v1.y / v2.y;
-	result.z = v1.z / v2.z;
-	return result;
-}
-
-const Vector3 operator+(const Vector3& v1, const float f) {
-	Vector3 result;
-	result.x = v1.x / f;
-	result.y = v1.y / f;
-	result.z = v1.z / f;
-	return result;
-}
-
-const Vector3 operator-(const Vector3& v1, const float f) {
-	Vector3 result;
-	result.x = v1.x / f;
-	result.y = v1.y / f;
-	result.z = v1.z / f;
-	return result;
-}
-
-const Vector3 operator/(const Vector3& v1, const float f) {
-	Vector3 result;
-	result.x = v1.x / f;
-	result.y = v1.y / f;
-	result.z = v1.z / f;
-	return result;
-}
-
-const Vector3 operator-(const Vector3& v1) {
-	Vector3 v;
-	v -= v1;
-	return v;
-}
-
-
+#include "kMathSimd.h"
+#include "kMathTrig.h"
 
 //単位行列の作成
 Matrix4x4 MakeIdentity4x4() {
@@ -168,23 +70,24 @@ Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs) {
 
 // 任意軸回転を表すQuaternionの生成
 Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle) {
+	float sin;
+	float cos;
+	SinCos(angle / 2, sin, cos);
 	Quaternion result;
-	result.w = cos(angle / 2);
-	result.x = axis.x * sin(angle / 2);
-	result.y = axis.y * sin(angle / 2);
-	result.z = axis.z * sin(angle / 2);
+	result.w = cos;
+	result.x = axis.x * sin;
+	result.y = axis.y * sin;
+	result.z = axis.z * sin;
 	return result;
 }
 
 // ベクトルをQuaternionで回転させた結果のベクトルを求める
 Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion) {
-	Vector3 result;
-	Quaternion r{ .x = vector.x, .y = vector.y, .z = vector.z, .w = 0 };
-	Quaternion r1 = Multiply(Multiply(quaternion, r), Conjugate(quaternion));
-	result.x = r1.x;
-	result.y = r1.y;
-	result.z = r1.z;
-	return result;
+	// q * v * q^-1 を展開したもの(単位Quaternionであることが前提)
+	// v' = v + w * t + u × t (u = qのxyz, t = 2 * u × v)
+	Vector3 u = { quaternion.x, quaternion.y, quaternion.z };
+	Vector3 t = Cross(u, vector) * 2.0f;
+	return vector + t * quaternion.w + Cross(u, t);
 }
 
 // Quaternionから回転行列を求める
@@ -210,11 +113,93 @@ Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion) {
 	return result;
 }
 
+// 単位Quaternion(回転無し)
+Quaternion IdentityQuaternion() {
+	return Quaternion{ 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+// Quaternionの内積
+float Dot(const Quaternion& q1, const Quaternion& q2) {
+	return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+// Quaternionの長さ
+float Norm(const Quaternion& quaternion) {
+	return std::sqrt(Dot(quaternion, quaternion));
+}
+
+// Quaternionの正規化
+Quaternion Normalize(const Quaternion& quaternion) {
+	float norm = Norm(quaternion);
+	if (norm == 0.0f) {
+		return IdentityQuaternion();
+	}
+	float inv = 1.0f / norm;
+	return Quaternion{ quaternion.x * inv, quaternion.y * inv, quaternion.z * inv, quaternion.w * inv };
+}
+
+// オイラー角からQuaternionを求める
+Quaternion MakeRotateQuaternion(const Vector3& rotate) {
+	// X→Y→Zの順に回すので qz * qy * qx
+	Vector3 sin;
+	Vector3 cos;
+	SinCos(rotate * 0.5f, sin, cos);
+	const float sx = sin.x, sy = sin.y, sz = sin.z;
+	const float cx = cos.x, cy = cos.y, cz = cos.z;
+
+	Quaternion result;
+	result.x = sx * cy * cz - cx * sy * sz;
+	result.y = cx * sy * cz + sx * cy * sz;
+	result.z = cx * cy * sz - sx * sy * cz;
+	result.w = cx * cy * cz + sx * sy * sz;
+	return result;
+}
+
+// 球面線形補間
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	Quaternion end = q1;
+	float dot = Dot(q0, q1);
+	// 遠回りしないように反転する
+	if (dot < 0.0f) {
+		end = Quaternion{ -q1.x, -q1.y, -q1.z, -q1.w };
+		dot = -dot;
+	}
+	// ほぼ同じ向きの場合はsinθが0に近づくのでNlerpにする
+	if (dot >= 0.9995f) {
+		return Nlerp(q0, end, t);
+	}
+	float theta = std::acos(dot);
+	float invSin = 1.0f / std::sin(theta);
+	float scale0 = std::sin((1.0f - t) * theta) * invSin;
+	float scale1 = std::sin(t * theta) * invSin;
+	return Quaternion{
+		scale0 * q0.x + scale1 * end.x,
+		scale0 * q0.y + scale1 * end.y,
+		scale0 * q0.z + scale1 * end.z,
+		scale0 * q0.w + scale1 * end.w,
+	};
+}
+
+// 線形補間して正規化する
+Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	// 遠回りしないように反転する
+	float sign = Dot(q0, q1) < 0.0f ? -1.0f : 1.0f;
+	float scale0 = 1.0f - t;
+	float scale1 = t * sign;
+	return Normalize(Quaternion{
+		scale0 * q0.x + scale1 * q1.x,
+		scale0 * q0.y + scale1 * q1.y,
+		scale0 * q0.z + scale1 * q1.z,
+		scale0 * q0.w + scale1 * q1.w,
+	});
+}
+
 Matrix4x4 MakeRotateAxisAngle(const Vector3& axis, float angle) {
 
 	// 資料p20を参考に中身を埋める。nはaxisのこと
-	float cos = std::cos(angle);
-	float sin = std::sin(angle);
+	float cos;
+	float sin;
+	SinCos(angle, sin, cos);
 
 	Matrix4x4 rotateMatrix = {};
 	rotateMatrix.m[0][0] = axis.x * axis.x * (1 - cos) + cos;
@@ -277,11 +262,15 @@ Matrix3x3 MakeAffineMatrix3x3(const Vector2& scale, const Vector2& rotate, const
 Matrix4x4 MakeRotateXMatrix(float radian) {
 	Matrix4x4 ans = { 0 };
 
+	float sin;
+	float cos;
+	SinCos(radian, sin, cos);
+
 	ans.m[0][0] = 1;
-	ans.m[1][1] = std::cos(radian);
-	ans.m[1][2] = std::sin(radian);
-	ans.m[2][1] = -std::sin(radian);
-	ans.m[2][2] = std::cos(radian);
+	ans.m[1][1] = cos;
+	ans.m[1][2] = sin;
+	ans.m[2][1] = -sin;
+	ans.m[2][2] = cos;
 	ans.m[3][3] = 1;
 
 	return ans;
@@ -291,11 +280,15 @@ Matrix4x4 MakeRotateXMatrix(float radian) {
 Matrix4x4 MakeRotateYMatrix(float radian) {
 	Matrix4x4 ans = { 0 };
 
-	ans.m[0][0] = std::cos(radian);
-	ans.m[0][2] = -std::sin(radian);
+	float sin;
+	float cos;
+	SinCos(radian, sin, cos);
+
+	ans.m[0][0] = cos;
+	ans.m[0][2] = -sin;
 	ans.m[1][1] = 1;
-	ans.m[2][0] = std::sin(radian);
-	ans.m[2][2] = std::cos(radian);
+	ans.m[2][0] = sin;
+	ans.m[2][2] = cos;
 	ans.m[3][3] = 1;
 
 	return ans;
@@ -305,10 +298,14 @@ Matrix4x4 MakeRotateYMatrix(float radian) {
 Matrix4x4 MakeRotateZMatrix(float radian) {
 	Matrix4x4 ans = { 0 };
 
-	ans.m[0][0] = std::cos(radian);
-	ans.m[0][1] = std::sin(radian);
-	ans.m[1][0] = -std::sin(radian);
-	ans.m[1][1] = std::cos(radian);
+	float sin;
+	float cos;
+	SinCos(radian, sin, cos);
+
+	ans.m[0][0] = cos;
+	ans.m[0][1] = sin;
+	ans.m[1][0] = -sin;
+	ans.m[1][1] = cos;
 	ans.m[2][2] = 1;
 	ans.m[3][3] = 1;
 
@@ -317,6 +314,11 @@ Matrix4x4 MakeRotateZMatrix(float radian) {
 
 //座標変換
 Vector3 MatrixTransform(const Vector3& vector, const Matrix4x4& matrix) {
+	return GetMatrixKernels().transform(vector, matrix);
+}
+
+//座標変換(スカラー版)
+Vector3 MatrixTransformScalar(const Vector3& vector, const Matrix4x4& matrix) {
 	Vector3 ans;
 
 	ans.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
@@ -360,6 +362,11 @@ Matrix4x4 MakeTranslateMatrix(Vector3 translate) {
 
 //  行列の積
 Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	return GetMatrixKernels().multiply(m1, m2);
+}
+
+//  行列の積(スカラー版)
+Matrix4x4 MultiplyScalar(const Matrix4x4& m1, const Matrix4x4& m2) {
 	Matrix4x4 ans;
 	for (int a = 0; a < 4; a++) {
 		for (int b = 0; b < 4; b++) {
@@ -371,28 +378,76 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
 
 //３次元アフィン変換行列
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
-	Matrix4x4 R = { 0 };
-	Matrix4x4 ans = { 0 };
+	Vector3 sin;
+	Vector3 cos;
+	SinCos(rotate, sin, cos);
+	const float sx = sin.x, sy = sin.y, sz = sin.z;
+	const float cx = cos.x, cy = cos.y, cz = cos.z;
 
-	R = Multiply(MakeRotateXMatrix(rotate.x), Multiply(MakeRotateYMatrix(rotate.y), MakeRotateZMatrix(rotate.z)));
+	// Rx * Ry * Rz を展開したものにScaleを掛ける
+	Matrix4x4 ans;
+	ans.m[0][0] = scale.x * (cy * cz);
+	ans.m[0][1] = scale.x * (cy * sz);
+	ans.m[0][2] = scale.x * (-sy);
+	ans.m[0][3] = 0.0f;
+	ans.m[1][0] = scale.y * (sx * sy * cz - cx * sz);
+	ans.m[1][1] = scale.y * (sx * sy * sz + cx * cz);
+	ans.m[1][2] = scale.y * (sx * cy);
+	ans.m[1][3] = 0.0f;
+	ans.m[2][0] = scale.z * (cx * sy * cz + sx * sz);
+	ans.m[2][1] = scale.z * (cx * sy * sz - sx * cz);
+	ans.m[2][2] = scale.z * (cx * cy);
+	ans.m[2][3] = 0.0f;
+	ans.m[3][0] = translate.x;
+	ans.m[3][1] = translate.y;
+	ans.m[3][2] = translate.z;
+	ans.m[3][3] = 1.0f;
 
+	return ans;
+};
 
-	ans.m[0][0] = scale.x * R.m[0][0];
-	ans.m[0][1] = scale.x * R.m[0][1];
-	ans.m[0][2] = scale.x * R.m[0][2];
-	ans.m[1][0] = scale.y * R.m[1][0];
-	ans.m[1][1] = scale.y * R.m[1][1];
-	ans.m[1][2] = scale.y * R.m[1][2];
-	ans.m[2][0] = scale.z * R.m[2][0];
-	ans.m[2][1] = scale.z * R.m[2][1];
-	ans.m[2][2] = scale.z * R.m[2][2];
-	ans.m[3][3] = 1;
+//３次元アフィン変換行列(回転をQuaternionで指定)
+Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate) {
+	// 単位Quaternionであることが前提
+	float x2 = rotate.x + rotate.x;
+	float y2 = rotate.y + rotate.y;
+	float z2 = rotate.z + rotate.z;
+	float xx = rotate.x * x2;
+	float yy = rotate.y * y2;
+	float zz = rotate.z * z2;
+	float xy = rotate.x * y2;
+	float xz = rotate.x * z2;
+	float yz = rotate.y * z2;
+	float wx = rotate.w * x2;
+	float wy = rotate.w * y2;
+	float wz = rotate.w * z2;
+
+	// MakeRotateMatrixと同じ回転行列にScaleを掛ける
+	Matrix4x4 ans;
+	ans.m[0][0] = scale.x * (1.0f - yy - zz);
+	ans.m[0][1] = scale.x * (xy + wz);
+	ans.m[0][2] = scale.x * (xz - wy);
+	ans.m[0][3] = 0.0f;
+	ans.m[1][0] = scale.y * (xy - wz);
+	ans.m[1][1] = scale.y * (1.0f - xx - zz);
+	ans.m[1][2] = scale.y * (yz + wx);
+	ans.m[1][3] = 0.0f;
+	ans.m[2][0] = scale.z * (xz + wy);
+	ans.m[2][1] = scale.z * (yz - wx);
+	ans.m[2][2] = scale.z * (1.0f - xx - yy);
+	ans.m[2][3] = 0.0f;
 	ans.m[3][0] = translate.x;
 	ans.m[3][1] = translate.y;
 	ans.m[3][2] = translate.z;
+	ans.m[3][3] = 1.0f;
 
 	return ans;
-};
+}
+
+//３次元アフィン変換行列(QuaternionTransform版)
+Matrix4x4 MakeAffineMatrix(const QuaternionTransform& transform) {
+	return MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+}
 
 //３次元アフィン変換行列
 Matrix4x4 MakeAffineMatrixInQuaternion(const Vector3& scale, const Matrix4x4& axisAngle, const Vector3& translate) {
@@ -419,6 +474,11 @@ Matrix4x4 MakeAffineMatrixInQuaternion(const Vector3& scale, const Matrix4x4& ax
 
 //逆行列
 Matrix4x4 Inverse(const Matrix4x4& m) {
+	return GetMatrixKernels().inverse(m);
+}
+
+//逆行列(スカラー版)
+Matrix4x4 InverseScalar(const Matrix4x4& m) {
 	Matrix4x4 ans;
 	float inverse;
 	inverse = m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1] + m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2]
@@ -453,6 +513,125 @@ Matrix4x4 Inverse(const Matrix4x4& m) {
 	return ans;
 };
 
+// 行列の種類を判定する
+MatrixClass ClassifyMatrix(const Matrix4x4& m, float epsilon) {
+	// 4列目が(0,0,0,1)でなければ一般の行列
+	if (std::fabs(m.m[0][3]) > epsilon || std::fabs(m.m[1][3]) > epsilon || std::fabs(m.m[2][3]) > epsilon || std::fabs(m.m[3][3] - 1.0f) > epsilon) {
+		return MatrixClass::General;
+	}
+	// 3x3部分の各行が正規直交なら回転と平行移動だけ
+	for (int a = 0; a < 3; a++) {
+		for (int b = a; b < 3; b++) {
+			float dot = m.m[a][0] * m.m[b][0] + m.m[a][1] * m.m[b][1] + m.m[a][2] * m.m[b][2];
+			float expected = (a == b) ? 1.0f : 0.0f;
+			if (std::fabs(dot - expected) > epsilon) {
+				return MatrixClass::Affine;
+			}
+		}
+	}
+	return MatrixClass::Rigid;
+}
+
+// アフィン行列の逆行列
+Matrix4x4 InverseAffine(const Matrix4x4& m) {
+	// 3x3部分の余因子
+	float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+	float c01 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+	float c02 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+	float det = m.m[0][0] * c00 + m.m[0][1] * c01 + m.m[0][2] * c02;
+	assert(det != 0.0f);
+	float invDet = 1.0f / det;
+
+	Matrix4x4 ans;
+	ans.m[0][0] = c00 * invDet;
+	ans.m[0][1] = (m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2]) * invDet;
+	ans.m[0][2] = (m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1]) * invDet;
+	ans.m[0][3] = 0.0f;
+	ans.m[1][0] = c01 * invDet;
+	ans.m[1][1] = (m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0]) * invDet;
+	ans.m[1][2] = (m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2]) * invDet;
+	ans.m[1][3] = 0.0f;
+	ans.m[2][0] = c02 * invDet;
+	ans.m[2][1] = (m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1]) * invDet;
+	ans.m[2][2] = (m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0]) * invDet;
+	ans.m[2][3] = 0.0f;
+	// 平行移動は -t * A^-1
+	ans.m[3][0] = -(m.m[3][0] * ans.m[0][0] + m.m[3][1] * ans.m[1][0] + m.m[3][2] * ans.m[2][0]);
+	ans.m[3][1] = -(m.m[3][0] * ans.m[0][1] + m.m[3][1] * ans.m[1][1] + m.m[3][2] * ans.m[2][1]);
+	ans.m[3][2] = -(m.m[3][0] * ans.m[0][2] + m.m[3][1] * ans.m[1][2] + m.m[3][2] * ans.m[2][2]);
+	ans.m[3][3] = 1.0f;
+	return ans;
+}
+
+// 回転と平行移動だけの行列の逆行列
+Matrix4x4 InverseRigid(const Matrix4x4& m) {
+	// 回転部分は転置するだけ
+	Matrix4x4 ans;
+	for (int a = 0; a < 3; a++) {
+		for (int b = 0; b < 3; b++) {
+			ans.m[a][b] = m.m[b][a];
+		}
+		ans.m[a][3] = 0.0f;
+	}
+	ans.m[3][0] = -(m.m[3][0] * m.m[0][0] + m.m[3][1] * m.m[0][1] + m.m[3][2] * m.m[0][2]);
+	ans.m[3][1] = -(m.m[3][0] * m.m[1][0] + m.m[3][1] * m.m[1][1] + m.m[3][2] * m.m[1][2]);
+	ans.m[3][2] = -(m.m[3][0] * m.m[2][0] + m.m[3][1] * m.m[2][1] + m.m[3][2] * m.m[2][2]);
+	ans.m[3][3] = 1.0f;
+	return ans;
+}
+
+// 種類に合わせた逆行列
+Matrix4x4 Inverse(const Matrix4x4& m, MatrixClass matrixClass) {
+	switch (matrixClass) {
+	case MatrixClass::Rigid:
+		return InverseRigid(m);
+	case MatrixClass::Affine:
+		return InverseAffine(m);
+	default:
+		return Inverse(m);
+	}
+}
+
+// 法線用の行列(3x3部分の逆転置行列)
+Matrix4x4 MakeNormalMatrix(const Matrix4x4& m, MatrixClass matrixClass) {
+	Matrix4x4 ans;
+	// 余因子行列/行列式がそのまま逆行列の転置になる
+	float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+	float c01 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+	float c02 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+	float det = m.m[0][0] * c00 + m.m[0][1] * c01 + m.m[0][2] * c02;
+	if (matrixClass == MatrixClass::Rigid || det == 0.0f) {
+		// 回転だけなら逆転置が元の行列と同じになる(Scaleが0の場合もそのまま使う)
+		ans = m;
+	} else {
+		float invDet = 1.0f / det;
+
+		ans.m[0][0] = c00 * invDet;
+		ans.m[0][1] = c01 * invDet;
+		ans.m[0][2] = c02 * invDet;
+		ans.m[1][0] = (m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2]) * invDet;
+		ans.m[1][1] = (m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0]) * invDet;
+		ans.m[1][2] = (m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1]) * invDet;
+		ans.m[2][0] = (m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1]) * invDet;
+		ans.m[2][1] = (m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2]) * invDet;
+		ans.m[2][2] = (m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0]) * invDet;
+	}
+	// 法線に平行移動は不要
+	ans.m[0][3] = 0.0f;
+	ans.m[1][3] = 0.0f;
+	ans.m[2][3] = 0.0f;
+	ans.m[3][0] = 0.0f;
+	ans.m[3][1] = 0.0f;
+	ans.m[3][2] = 0.0f;
+	ans.m[3][3] = 1.0f;
+	return ans;
+}
+
+// 親のワールド行列を外したローカル行列(world = local * parentWorld)
+Matrix4x4 MakeLocalMatrix(const Matrix4x4& world, const Matrix4x4& parentWorld, MatrixClass parentClass) {
+	return Multiply(world, Inverse(parentWorld, parentClass));
+}
+
 // 正規化
 Vector3 Normalize(const Vector3& v) {
 	float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
@@ -567,4 +746,162 @@ Vector3 TransformNormal(const Vector3& v, const Matrix4x4& m) {
 		v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2],
 	};
 	return result;
+}
+
+// Matrix4x4をMatrix3x4に変換(4列目は捨てる)
+Matrix3x4 MakeMatrix3x4(const Matrix4x4& m) {
+	Matrix3x4 ans;
+	for (int a = 0; a < 3; a++) {
+		for (int b = 0; b < 4; b++) {
+			ans.m[a][b] = m.m[b][a];
+		}
+	}
+	return ans;
+}
+
+// Matrix3x4をMatrix4x4に変換
+Matrix4x4 MakeMatrix4x4(const Matrix3x4& m) {
+	Matrix4x4 ans;
+	for (int a = 0; a < 4; a++) {
+		for (int b = 0; b < 3; b++) {
+			ans.m[a][b] = m.m[b][a];
+		}
+		ans.m[a][3] = 0.0f;
+	}
+	ans.m[3][3] = 1.0f;
+	return ans;
+}
+
+// ３次元アフィン変換行列(Matrix3x4版)
+Matrix3x4 MakeAffineMatrix3x4(const Vector3& scale, const Quaternion& rotate, const Vector3& translate) {
+	// MakeAffineMatrixの転置
+	float x2 = rotate.x + rotate.x;
+	float y2 = rotate.y + rotate.y;
+	float z2 = rotate.z + rotate.z;
+	float xx = rotate.x * x2;
+	float yy = rotate.y * y2;
+	float zz = rotate.z * z2;
+	float xy = rotate.x * y2;
+	float xz = rotate.x * z2;
+	float yz = rotate.y * z2;
+	float wx = rotate.w * x2;
+	float wy = rotate.w * y2;
+	float wz = rotate.w * z2;
+
+	Matrix3x4 ans;
+	ans.m[0][0] = scale.x * (1.0f - yy - zz);
+	ans.m[0][1] = scale.y * (xy - wz);
+	ans.m[0][2] = scale.z * (xz + wy);
+	ans.m[0][3] = translate.x;
+	ans.m[1][0] = scale.x * (xy + wz);
+	ans.m[1][1] = scale.y * (1.0f - xx - zz);
+	ans.m[1][2] = scale.z * (yz - wx);
+	ans.m[1][3] = translate.y;
+	ans.m[2][0] = scale.x * (xz - wy);
+	ans.m[2][1] = scale.y * (yz + wx);
+	ans.m[2][2] = scale.z * (1.0f - xx - yy);
+	ans.m[2][3] = translate.z;
+	return ans;
+}
+
+// 行列の積(Matrix3x4版)。Multiply(Matrix4x4, Matrix4x4)と同じくm1を先に適用する
+Matrix3x4 Multiply(const Matrix3x4& m1, const Matrix3x4& m2) {
+	// 転置して持っているので m2 * m1 を計算する
+	Matrix3x4 ans;
+	for (int a = 0; a < 3; a++) {
+		for (int b = 0; b < 4; b++) {
+			ans.m[a][b] = m2.m[a][0] * m1.m[0][b] + m2.m[a][1] * m1.m[1][b] + m2.m[a][2] * m1.m[2][b];
+		}
+		ans.m[a][3] += m2.m[a][3];
+	}
+	return ans;
+}
+
+// アフィン行列と一般の行列の積(World * ViewProjectionなど)
+Matrix4x4 Multiply(const Matrix3x4& m1, const Matrix4x4& m2) {
+	// m1の4列目は(0,0,0,1)なので3行分の積を省ける
+	Matrix4x4 ans;
+	for (int a = 0; a < 4; a++) {
+		for (int b = 0; b < 4; b++) {
+			ans.m[a][b] = m1.m[0][a] * m2.m[0][b] + m1.m[1][a] * m2.m[1][b] + m1.m[2][a] * m2.m[2][b];
+		}
+	}
+	for (int b = 0; b < 4; b++) {
+		ans.m[3][b] += m2.m[3][b];
+	}
+	return ans;
+}
+
+// 逆行列(Matrix3x4版)
+Matrix3x4 Inverse(const Matrix3x4& m) {
+	// 3x3部分の逆行列
+	float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+	float c10 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+	float c20 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+	float det = m.m[0][0] * c00 + m.m[0][1] * c10 + m.m[0][2] * c20;
+	assert(det != 0.0f);
+	float invDet = 1.0f / det;
+
+	Matrix3x4 ans;
+	ans.m[0][0] = c00 * invDet;
+	ans.m[0][1] = (m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2]) * invDet;
+	ans.m[0][2] = (m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1]) * invDet;
+	ans.m[1][0] = c10 * invDet;
+	ans.m[1][1] = (m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0]) * invDet;
+	ans.m[1][2] = (m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2]) * invDet;
+	ans.m[2][0] = c20 * invDet;
+	ans.m[2][1] = (m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1]) * invDet;
+	ans.m[2][2] = (m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0]) * invDet;
+	// 平行移動は -A^-1 * t
+	for (int a = 0; a < 3; a++) {
+		ans.m[a][3] = -(ans.m[a][0] * m.m[0][3] + ans.m[a][1] * m.m[1][3] + ans.m[a][2] * m.m[2][3]);
+	}
+	return ans;
+}
+
+// 法線用の行列(Matrix3x4版、平行移動は0)
+Matrix3x4 MakeNormalMatrix(const Matrix3x4& m, MatrixClass matrixClass) {
+	Matrix3x4 ans = m;
+	if (matrixClass != MatrixClass::Rigid) {
+		// 転置して持っているので、3x3部分の逆行列を転置したものになる
+		float c00 = m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1];
+		float c10 = m.m[1][2] * m.m[2][0] - m.m[1][0] * m.m[2][2];
+		float c20 = m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0];
+		float det = m.m[0][0] * c00 + m.m[0][1] * c10 + m.m[0][2] * c20;
+		// Scaleが0の場合はそのまま使う
+		if (det != 0.0f) {
+			float invDet = 1.0f / det;
+			ans.m[0][0] = c00 * invDet;
+			ans.m[1][0] = (m.m[0][2] * m.m[2][1] - m.m[0][1] * m.m[2][2]) * invDet;
+			ans.m[2][0] = (m.m[0][1] * m.m[1][2] - m.m[0][2] * m.m[1][1]) * invDet;
+			ans.m[0][1] = c10 * invDet;
+			ans.m[1][1] = (m.m[0][0] * m.m[2][2] - m.m[0][2] * m.m[2][0]) * invDet;
+			ans.m[2][1] = (m.m[0][2] * m.m[1][0] - m.m[0][0] * m.m[1][2]) * invDet;
+			ans.m[0][2] = c20 * invDet;
+			ans.m[1][2] = (m.m[0][1] * m.m[2][0] - m.m[0][0] * m.m[2][1]) * invDet;
+			ans.m[2][2] = (m.m[0][0] * m.m[1][1] - m.m[0][1] * m.m[1][0]) * invDet;
+		}
+	}
+	ans.m[0][3] = 0.0f;
+	ans.m[1][3] = 0.0f;
+	ans.m[2][3] = 0.0f;
+	return ans;
+}
+
+// 座標変換(Matrix3x4版)
+Vector3 MatrixTransform(const Vector3& vector, const Matrix3x4& matrix) {
+	Vector3 result;
+	result.x = matrix.m[0][0] * vector.x + matrix.m[0][1] * vector.y + matrix.m[0][2] * vector.z + matrix.m[0][3];
+	result.y = matrix.m[1][0] * vector.x + matrix.m[1][1] * vector.y + matrix.m[1][2] * vector.z + matrix.m[1][3];
+	result.z = matrix.m[2][0] * vector.x + matrix.m[2][1] * vector.y + matrix.m[2][2] * vector.z + matrix.m[2][3];
+	return result;
+}
+
+// ベクトル変換(Matrix3x4版)
+Vector3 TransformNormal(const Vector3& v, const Matrix3x4& m) {
+	Vector3 result;
+	result.x = m.m[0][0] * v.x + m.m[0][1] * v.y + m.m[0][2] * v.z;
+	result.y = m.m[1][0] * v.x + m.m[1][1] * v.y + m.m[1][2] * v.z;
+	result.z = m.m[2][0] * v.x + m.m[2][1] * v.y + m.m[2][2] * v.z;
+	return result;
 }
\ No newline at end of file
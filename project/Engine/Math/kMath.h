@@ -1,42 +1,18 @@
 ﻿#pragma once
 #include "Matrix3x3.h"
 #include "Matrix4x4.h"
+#include "Matrix3x4.h"
 #include "Vector2.h"
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Quaternion.h"
+#include "Transform.h"
 #include <cmath>
 #include <cassert>
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <numbers>
 
-const Vector3 operator*(const Vector3& v, const float f);
-
-Vector3& operator+=(Vector3& v1, const Vector3& v2);
-
-Vector3& operator-=(Vector3& v1, const Vector3& v2);
-
-Vector3& operator*=(Vector3& v1, const Vector3& v2);
-
-Vector3& operator/=(Vector3& v1, const Vector3& v2);
-
-const Vector3 operator+(const Vector3& v1, const Vector3 v2);
-
-const Vector3 operator-(const Vector3& v1, const Vector3 v2);
-
-const Vector3 operator*(const Vector3& v1, const Vector3 v2);
-
-const Vector3 operator/(const Vector3& v1, const Vector3 v2);
-
-const Vector3 operator+(const Vector3& v1, const float f);
-
-const Vector3 operator-(const Vector3& v1, const float f);
-
-const Vector3 operator/(const Vector3& v1, const float f);
-
-const Vector3 operator-(const Vector3& v1);
-
 //単位行列の作成
 Matrix4x4 MakeIdentity4x4();
 
@@ -73,6 +49,12 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
 //３次元アフィン変換行列
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
 
+//３次元アフィン変換行列(回転をQuaternionで指定、回転行列の積を使わずに直接組み立てる)
+Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
+//３次元アフィン変換行列(QuaternionTransform版)
+Matrix4x4 MakeAffineMatrix(const QuaternionTransform& transform);
+
 //3次元アフィン変換行列Quaternion版
 Matrix4x4 MakeAffineMatrixInQuaternion(const Vector3& scale, const Matrix4x4& axisAngle, const Vector3& translate);
 
@@ -81,6 +63,31 @@ Matrix4x4 MakeRotateAxisAngle(const Vector3& axis, float angle);
 //逆行列
 Matrix4x4 Inverse(const Matrix4x4& m);
 
+// 行列の種類(逆行列の求め方を選ぶのに使う)
+enum class MatrixClass {
+	Rigid,   // 回転と平行移動のみ
+	Affine,  // 4列目が(0,0,0,1)
+	General, // それ以外
+};
+
+// 行列の種類を判定する
+MatrixClass ClassifyMatrix(const Matrix4x4& m, float epsilon = 1.0e-5f);
+
+// アフィン行列の逆行列(3x3部分の逆行列と平行移動から求める)
+Matrix4x4 InverseAffine(const Matrix4x4& m);
+
+// 回転と平行移動だけの行列の逆行列(回転部分を転置する)
+Matrix4x4 InverseRigid(const Matrix4x4& m);
+
+// 種類に合わせた逆行列
+Matrix4x4 Inverse(const Matrix4x4& m, MatrixClass matrixClass);
+
+// 法線用の行列(3x3部分の逆転置行列、平行移動は0)
+Matrix4x4 MakeNormalMatrix(const Matrix4x4& m, MatrixClass matrixClass = MatrixClass::Affine);
+
+// 親のワールド行列を外したローカル行列(world = local * parentWorld)
+Matrix4x4 MakeLocalMatrix(const Matrix4x4& world, const Matrix4x4& parentWorld, MatrixClass parentClass = MatrixClass::Affine);
+
 // 正規化
 Vector3 Normalize(const Vector3& v);
 
@@ -102,6 +109,27 @@ Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion);
 // Quaternionから回転行列を求める
 Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion);
 
+// 単位Quaternion(回転無し)
+Quaternion IdentityQuaternion();
+
+// Quaternionの内積
+float Dot(const Quaternion& q1, const Quaternion& q2);
+
+// Quaternionの長さ
+float Norm(const Quaternion& quaternion);
+
+// Quaternionの正規化
+Quaternion Normalize(const Quaternion& quaternion);
+
+// オイラー角(MakeAffineMatrixと同じX→Y→Zの順)からQuaternionを求める
+Quaternion MakeRotateQuaternion(const Vector3& rotate);
+
+// 球面線形補間
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+// 線形補間して正規化する(Slerpより軽いが角速度は一定にならない)
+Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t);
+
 
 // 1, 透視投影行列
 Matrix4x4 MakePrespectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip);
@@ -130,4 +158,31 @@ float SwapRadian(float degree);
 float Length(const Vector3& v);
 
 // ベクトル変換
-Vector3 TransformNormal(const Vector3& v, const Matrix4x4& m);
\ No newline at end of file
+Vector3 TransformNormal(const Vector3& v, const Matrix4x4& m);
+
+// Matrix4x4をMatrix3x4に変換(4列目は捨てる)
+Matrix3x4 MakeMatrix3x4(const Matrix4x4& m);
+
+// Matrix3x4をMatrix4x4に変換
+Matrix4x4 MakeMatrix4x4(const Matrix3x4& m);
+
+// ３次元アフィン変換行列(Matrix3x4版)
+Matrix3x4 MakeAffineMatrix3x4(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
+// 行列の積(Matrix3x4版)。Multiply(Matrix4x4, Matrix4x4)と同じくm1を先に適用する
+Matrix3x4 Multiply(const Matrix3x4& m1, const Matrix3x4& m2);
+
+// アフィン行列と一般の行列の積(World * ViewProjectionなど)
+Matrix4x4 Multiply(const Matrix3x4& m1, const Matrix4x4& m2);
+
+// 逆行列(Matrix3x4版)
+Matrix3x4 Inverse(const Matrix3x4& m);
+
+// 法線用の行列(Matrix3x4版、平行移動は0)
+Matrix3x4 MakeNormalMatrix(const Matrix3x4& m, MatrixClass matrixClass = MatrixClass::Affine);
+
+// 座標変換(Matrix3x4版)
+Vector3 MatrixTransform(const Vector3& vector, const Matrix3x4& matrix);
+
+// ベクトル変換(Matrix3x4版)
+Vector3 TransformNormal(const Vector3& v, const Matrix3x4& m);
\ No newline at end of file
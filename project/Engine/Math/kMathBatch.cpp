@@ -0,0 +1,417 @@
+#include "kMathBatch.h"
+#include "kMathSimd.h"
+#include <algorithm>
+
+namespace {
+
+// AoSをSoAに並べ替えて処理するときの1回分の要素数
+constexpr size_t kChunkSize = 256;
+
+// オイラー角のsin/cosをまとめて求めるときの1回分の要素数
+constexpr size_t kEulerChunkSize = 64;
+
+// オイラー角のsin/cosをまとめて求めて、1要素ずつfuncに渡す
+// func(index, sin, cos) の sin/cos は x, y, z の順に3つ並んでいる
+template<typename GetRotate, typename Func>
+void ForEachEulerSinCos(size_t count, float angleScale, SinCosPrecision precision, GetRotate getRotate, Func func) {
+	float angles[kEulerChunkSize * 3];
+	float sins[kEulerChunkSize * 3];
+	float coss[kEulerChunkSize * 3];
+	for (size_t begin = 0; begin < count; begin += kEulerChunkSize) {
+		const size_t size = std::min(kEulerChunkSize, count - begin);
+		for (size_t i = 0; i < size; i++) {
+			const Vector3& rotate = getRotate(begin + i);
+			angles[i * 3 + 0] = rotate.x * angleScale;
+			angles[i * 3 + 1] = rotate.y * angleScale;
+			angles[i * 3 + 2] = rotate.z * angleScale;
+		}
+		SinCos(angles, size * 3, sins, coss, precision);
+		for (size_t i = 0; i < size; i++) {
+			func(begin + i, sins + i * 3, coss + i * 3);
+		}
+	}
+}
+
+// Rx * Ry * Rz を展開したものにScaleを掛けて書き込む(MakeAffineMatrixと同じ式)
+void WriteAffineMatrix(const float* sin, const float* cos, const Vector3& scale, const Vector3& translate, Matrix4x4& out) {
+	const float sx = sin[0], sy = sin[1], sz = sin[2];
+	const float cx = cos[0], cy = cos[1], cz = cos[2];
+	out.m[0][0] = scale.x * (cy * cz);
+	out.m[0][1] = scale.x * (cy * sz);
+	out.m[0][2] = scale.x * (-sy);
+	out.m[0][3] = 0.0f;
+	out.m[1][0] = scale.y * (sx * sy * cz - cx * sz);
+	out.m[1][1] = scale.y * (sx * sy * sz + cx * cz);
+	out.m[1][2] = scale.y * (sx * cy);
+	out.m[1][3] = 0.0f;
+	out.m[2][0] = scale.z * (cx * sy * cz + sx * sz);
+	out.m[2][1] = scale.z * (cx * sy * sz - sx * cz);
+	out.m[2][2] = scale.z * (cx * cy);
+	out.m[2][3] = 0.0f;
+	out.m[3][0] = translate.x;
+	out.m[3][1] = translate.y;
+	out.m[3][2] = translate.z;
+	out.m[3][3] = 1.0f;
+}
+
+// WriteAffineMatrixの転置(Matrix3x4版)
+void WriteAffineMatrix(const float* sin, const float* cos, const Vector3& scale, const Vector3& translate, Matrix3x4& out) {
+	const float sx = sin[0], sy = sin[1], sz = sin[2];
+	const float cx = cos[0], cy = cos[1], cz = cos[2];
+	out.m[0][0] = scale.x * (cy * cz);
+	out.m[1][0] = scale.x * (cy * sz);
+	out.m[2][0] = scale.x * (-sy);
+	out.m[0][1] = scale.y * (sx * sy * cz - cx * sz);
+	out.m[1][1] = scale.y * (sx * sy * sz + cx * cz);
+	out.m[2][1] = scale.y * (sx * cy);
+	out.m[0][2] = scale.z * (cx * sy * cz + sx * sz);
+	out.m[1][2] = scale.z * (cx * sy * sz - sx * cz);
+	out.m[2][2] = scale.z * (cx * cy);
+	out.m[0][3] = translate.x;
+	out.m[1][3] = translate.y;
+	out.m[2][3] = translate.z;
+}
+
+// 座標変換(スカラー版)
+void TransformPointsScalar(const float* inX, const float* inY, const float* inZ, size_t begin, size_t count, const Matrix4x4& m, float* outX, float* outY, float* outZ) {
+	for (size_t i = begin; i < count; i++) {
+		const float x = inX[i];
+		const float y = inY[i];
+		const float z = inZ[i];
+		const float w = x * m.m[0][3] + y * m.m[1][3] + z * m.m[2][3] + m.m[3][3];
+		outX[i] = (x * m.m[0][0] + y * m.m[1][0] + z * m.m[2][0] + m.m[3][0]) / w;
+		outY[i] = (x * m.m[0][1] + y * m.m[1][1] + z * m.m[2][1] + m.m[3][1]) / w;
+		outZ[i] = (x * m.m[0][2] + y * m.m[1][2] + z * m.m[2][2] + m.m[3][2]) / w;
+	}
+}
+
+// ベクトル変換(スカラー版)
+void TransformNormalsScalar(const float* inX, const float* inY, const float* inZ, size_t begin, size_t count, const Matrix4x4& m, float* outX, float* outY, float* outZ) {
+	for (size_t i = begin; i < count; i++) {
+		const float x = inX[i];
+		const float y = inY[i];
+		const float z = inZ[i];
+		outX[i] = x * m.m[0][0] + y * m.m[1][0] + z * m.m[2][0];
+		outY[i] = x * m.m[0][1] + y * m.m[1][1] + z * m.m[2][1];
+		outZ[i] = x * m.m[0][2] + y * m.m[1][2] + z * m.m[2][2];
+	}
+}
+
+// 行列の積(スカラー版)
+void MultiplyOneScalar(const Matrix4x4& m1, const Matrix4x4& m2, Matrix4x4& out) {
+	Matrix4x4 ans;
+	for (int a = 0; a < 4; a++) {
+		for (int b = 0; b < 4; b++) {
+			ans.m[a][b] = m1.m[a][0] * m2.m[0][b] + m1.m[a][1] * m2.m[1][b] + m1.m[a][2] * m2.m[2][b] + m1.m[a][3] * m2.m[3][b];
+		}
+	}
+	out = ans;
+}
+
+#if KMATH_SIMD_X86
+
+// 座標変換(SSE4.1、4要素ずつ)
+KMATH_TARGET_SSE41 size_t TransformPointsSSE41(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& m, float* outX, float* outY, float* outZ) {
+	__m128 c[4][4];
+	for (int r = 0; r < 4; r++) {
+		for (int col = 0; col < 4; col++) {
+			c[r][col] = _mm_set1_ps(m.m[r][col]);
+		}
+	}
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 x = _mm_loadu_ps(inX + i);
+		const __m128 y = _mm_loadu_ps(inY + i);
+		const __m128 z = _mm_loadu_ps(inZ + i);
+		__m128 result[4];
+		for (int col = 0; col < 4; col++) {
+			__m128 v = _mm_mul_ps(x, c[0][col]);
+			v = _mm_add_ps(v, _mm_mul_ps(y, c[1][col]));
+			v = _mm_add_ps(v, _mm_mul_ps(z, c[2][col]));
+			result[col] = _mm_add_ps(v, c[3][col]);
+		}
+		_mm_storeu_ps(outX + i, _mm_div_ps(result[0], result[3]));
+		_mm_storeu_ps(outY + i, _mm_div_ps(result[1], result[3]));
+		_mm_storeu_ps(outZ + i, _mm_div_ps(result[2], result[3]));
+	}
+	return i;
+}
+
+// ベクトル変換(SSE4.1、4要素ずつ)
+KMATH_TARGET_SSE41 size_t TransformNormalsSSE41(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& m, float* outX, float* outY, float* outZ) {
+	__m128 c[3][3];
+	for (int r = 0; r < 3; r++) {
+		for (int col = 0; col < 3; col++) {
+			c[r][col] = _mm_set1_ps(m.m[r][col]);
+		}
+	}
+	float* outs[3] = { outX, outY, outZ };
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 x = _mm_loadu_ps(inX + i);
+		const __m128 y = _mm_loadu_ps(inY + i);
+		const __m128 z = _mm_loadu_ps(inZ + i);
+		__m128 result[3];
+		for (int col = 0; col < 3; col++) {
+			__m128 v = _mm_mul_ps(x, c[0][col]);
+			v = _mm_add_ps(v, _mm_mul_ps(y, c[1][col]));
+			result[col] = _mm_add_ps(v, _mm_mul_ps(z, c[2][col]));
+		}
+		for (int col = 0; col < 3; col++) {
+			_mm_storeu_ps(outs[col] + i, result[col]);
+		}
+	}
+	return i;
+}
+
+// 行列の積(SSE4.1)。rhsは事前に読み込んだものを使う
+KMATH_TARGET_SSE41 inline void MultiplyOneSSE41(const Matrix4x4& m1, const __m128 (&rhs)[4], Matrix4x4& out) {
+	__m128 rows[4];
+	for (int a = 0; a < 4; a++) {
+		__m128 row = _mm_mul_ps(_mm_set1_ps(m1.m[a][0]), rhs[0]);
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[a][1]), rhs[1]));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[a][2]), rhs[2]));
+		rows[a] = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[a][3]), rhs[3]));
+	}
+	for (int a = 0; a < 4; a++) {
+		_mm_storeu_ps(out.m[a], rows[a]);
+	}
+}
+
+KMATH_TARGET_SSE41 void MultiplyMatricesSSE41(const Matrix4x4* lhs, const Matrix4x4* rhs, size_t rhsStride, size_t count, Matrix4x4* out) {
+	// rhsが共通の場合は最初の1回だけ読み込む
+	__m128 r[4];
+	for (int k = 0; k < 4; k++) {
+		r[k] = _mm_loadu_ps(rhs[0].m[k]);
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (rhsStride != 0) {
+			for (int k = 0; k < 4; k++) {
+				r[k] = _mm_loadu_ps(rhs[i * rhsStride].m[k]);
+			}
+		}
+		MultiplyOneSSE41(lhs[i], r, out[i]);
+	}
+}
+
+// 座標変換(AVX2、8要素ずつ)
+KMATH_TARGET_AVX2 size_t TransformPointsAVX2(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& m, float* outX, float* outY, float* outZ) {
+	__m256 c[4][4];
+	for (int r = 0; r < 4; r++) {
+		for (int col = 0; col < 4; col++) {
+			c[r][col] = _mm256_set1_ps(m.m[r][col]);
+		}
+	}
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 x = _mm256_loadu_ps(inX + i);
+		const __m256 y = _mm256_loadu_ps(inY + i);
+		const __m256 z = _mm256_loadu_ps(inZ + i);
+		__m256 result[4];
+		for (int col = 0; col < 4; col++) {
+			result[col] = _mm256_fmadd_ps(x, c[0][col], _mm256_fmadd_ps(y, c[1][col], _mm256_fmadd_ps(z, c[2][col], c[3][col])));
+		}
+		_mm256_storeu_ps(outX + i, _mm256_div_ps(result[0], result[3]));
+		_mm256_storeu_ps(outY + i, _mm256_div_ps(result[1], result[3]));
+		_mm256_storeu_ps(outZ + i, _mm256_div_ps(result[2], result[3]));
+	}
+	return i;
+}
+
+// ベクトル変換(AVX2、8要素ずつ)
+KMATH_TARGET_AVX2 size_t TransformNormalsAVX2(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& m, float* outX, float* outY, float* outZ) {
+	__m256 c[3][3];
+	for (int r = 0; r < 3; r++) {
+		for (int col = 0; col < 3; col++) {
+			c[r][col] = _mm256_set1_ps(m.m[r][col]);
+		}
+	}
+	float* outs[3] = { outX, outY, outZ };
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 x = _mm256_loadu_ps(inX + i);
+		const __m256 y = _mm256_loadu_ps(inY + i);
+		const __m256 z = _mm256_loadu_ps(inZ + i);
+		__m256 result[3];
+		for (int col = 0; col < 3; col++) {
+			result[col] = _mm256_fmadd_ps(x, c[0][col], _mm256_fmadd_ps(y, c[1][col], _mm256_mul_ps(z, c[2][col])));
+		}
+		for (int col = 0; col < 3; col++) {
+			_mm256_storeu_ps(outs[col] + i, result[col]);
+		}
+	}
+	return i;
+}
+
+// 1行分(4要素)を256bitレジスタの上下に複製する
+KMATH_TARGET_AVX2 inline __m256 BroadcastRowAVX2(const float* row) {
+	const __m128 r = _mm_loadu_ps(row);
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(r), r, 1);
+}
+
+// 行列の積(AVX2)。2行ずつ計算する
+KMATH_TARGET_AVX2 void MultiplyMatricesAVX2(const Matrix4x4* lhs, const Matrix4x4* rhs, size_t rhsStride, size_t count, Matrix4x4* out) {
+	__m256 r[4];
+	for (int k = 0; k < 4; k++) {
+		r[k] = BroadcastRowAVX2(rhs[0].m[k]);
+	}
+	for (size_t i = 0; i < count; i++) {
+		if (rhsStride != 0) {
+			for (int k = 0; k < 4; k++) {
+				r[k] = BroadcastRowAVX2(rhs[i * rhsStride].m[k]);
+			}
+		}
+		const __m256 rows01 = _mm256_loadu_ps(lhs[i].m[0]);
+		const __m256 rows23 = _mm256_loadu_ps(lhs[i].m[2]);
+		__m256 result01 = _mm256_mul_ps(_mm256_permute_ps(rows01, 0x00), r[0]);
+		__m256 result23 = _mm256_mul_ps(_mm256_permute_ps(rows23, 0x00), r[0]);
+		result01 = _mm256_fmadd_ps(_mm256_permute_ps(rows01, 0x55), r[1], result01);
+		result23 = _mm256_fmadd_ps(_mm256_permute_ps(rows23, 0x55), r[1], result23);
+		result01 = _mm256_fmadd_ps(_mm256_permute_ps(rows01, 0xAA), r[2], result01);
+		result23 = _mm256_fmadd_ps(_mm256_permute_ps(rows23, 0xAA), r[2], result23);
+		result01 = _mm256_fmadd_ps(_mm256_permute_ps(rows01, 0xFF), r[3], result01);
+		result23 = _mm256_fmadd_ps(_mm256_permute_ps(rows23, 0xFF), r[3], result23);
+		_mm256_storeu_ps(out[i].m[0], result01);
+		_mm256_storeu_ps(out[i].m[2], result23);
+	}
+}
+
+#endif // KMATH_SIMD_X86
+
+void MultiplyMatricesImpl(const Matrix4x4* lhs, const Matrix4x4* rhs, size_t rhsStride, size_t count, Matrix4x4* out) {
+	if (count == 0) {
+		return;
+	}
+#if KMATH_SIMD_X86
+	const SimdLevel level = GetSimdLevel();
+	if (level >= SimdLevel::AVX2) {
+		MultiplyMatricesAVX2(lhs, rhs, rhsStride, count, out);
+		return;
+	}
+	if (level >= SimdLevel::SSE41) {
+		MultiplyMatricesSSE41(lhs, rhs, rhsStride, count, out);
+		return;
+	}
+#endif
+	for (size_t i = 0; i < count; i++) {
+		MultiplyOneScalar(lhs[i], rhs[i * rhsStride], out[i]);
+	}
+}
+
+} // namespace
+
+void TransformPoints(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& matrix, float* outX, float* outY, float* outZ) {
+	size_t done = 0;
+#if KMATH_SIMD_X86
+	const SimdLevel level = GetSimdLevel();
+	if (level >= SimdLevel::AVX2) {
+		done = TransformPointsAVX2(inX, inY, inZ, count, matrix, outX, outY, outZ);
+	} else if (level >= SimdLevel::SSE41) {
+		done = TransformPointsSSE41(inX, inY, inZ, count, matrix, outX, outY, outZ);
+	}
+#endif
+	// 端数はスカラーで処理する
+	TransformPointsScalar(inX, inY, inZ, done, count, matrix, outX, outY, outZ);
+}
+
+void TransformPoints(const Vector3SoA& in, const Matrix4x4& matrix, Vector3SoA& out) {
+	out.Resize(in.Size());
+	TransformPoints(in.x.data(), in.y.data(), in.z.data(), in.Size(), matrix, out.x.data(), out.y.data(), out.z.data());
+}
+
+void TransformPoints(const Vector3* in, size_t count, const Matrix4x4& matrix, Vector3* out) {
+	float x[kChunkSize];
+	float y[kChunkSize];
+	float z[kChunkSize];
+	for (size_t begin = 0; begin < count; begin += kChunkSize) {
+		const size_t size = std::min(kChunkSize, count - begin);
+		for (size_t i = 0; i < size; i++) {
+			x[i] = in[begin + i].x;
+			y[i] = in[begin + i].y;
+			z[i] = in[begin + i].z;
+		}
+		TransformPoints(x, y, z, size, matrix, x, y, z);
+		for (size_t i = 0; i < size; i++) {
+			out[begin + i] = Vector3{ x[i], y[i], z[i] };
+		}
+	}
+}
+
+void TransformNormals(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& matrix, float* outX, float* outY, float* outZ) {
+	size_t done = 0;
+#if KMATH_SIMD_X86
+	const SimdLevel level = GetSimdLevel();
+	if (level >= SimdLevel::AVX2) {
+		done = TransformNormalsAVX2(inX, inY, inZ, count, matrix, outX, outY, outZ);
+	} else if (level >= SimdLevel::SSE41) {
+		done = TransformNormalsSSE41(inX, inY, inZ, count, matrix, outX, outY, outZ);
+	}
+#endif
+	// 端数はスカラーで処理する
+	TransformNormalsScalar(inX, inY, inZ, done, count, matrix, outX, outY, outZ);
+}
+
+void TransformNormals(const Vector3SoA& in, const Matrix4x4& matrix, Vector3SoA& out) {
+	out.Resize(in.Size());
+	TransformNormals(in.x.data(), in.y.data(), in.z.data(), in.Size(), matrix, out.x.data(), out.y.data(), out.z.data());
+}
+
+void TransformNormals(const Vector3* in, size_t count, const Matrix4x4& matrix, Vector3* out) {
+	float x[kChunkSize];
+	float y[kChunkSize];
+	float z[kChunkSize];
+	for (size_t begin = 0; begin < count; begin += kChunkSize) {
+		const size_t size = std::min(kChunkSize, count - begin);
+		for (size_t i = 0; i < size; i++) {
+			x[i] = in[begin + i].x;
+			y[i] = in[begin + i].y;
+			z[i] = in[begin + i].z;
+		}
+		TransformNormals(x, y, z, size, matrix, x, y, z);
+		for (size_t i = 0; i < size; i++) {
+			out[begin + i] = Vector3{ x[i], y[i], z[i] };
+		}
+	}
+}
+
+void MultiplyMatrices(const Matrix4x4* lhs, const Matrix4x4* rhs, size_t count, Matrix4x4* out) {
+	MultiplyMatricesImpl(lhs, rhs, 1, count, out);
+}
+
+void MultiplyMatrices(const Matrix4x4* lhs, const Matrix4x4& rhs, size_t count, Matrix4x4* out) {
+	MultiplyMatricesImpl(lhs, &rhs, 0, count, out);
+}
+
+void MakeRotateMatrices(const Vector3* rotates, size_t count, Matrix4x4* out, SinCosPrecision precision) {
+	const Vector3 one = { 1.0f, 1.0f, 1.0f };
+	const Vector3 zero = { 0.0f, 0.0f, 0.0f };
+	ForEachEulerSinCos(count, 1.0f, precision,
+		[rotates](size_t i) -> const Vector3& { return rotates[i]; },
+		[&](size_t i, const float* sin, const float* cos) { WriteAffineMatrix(sin, cos, one, zero, out[i]); });
+}
+
+void MakeAffineMatrices(const Transform* transforms, size_t count, Matrix4x4* out, SinCosPrecision precision) {
+	ForEachEulerSinCos(count, 1.0f, precision,
+		[transforms](size_t i) -> const Vector3& { return transforms[i].rotate; },
+		[&](size_t i, const float* sin, const float* cos) { WriteAffineMatrix(sin, cos, transforms[i].scale, transforms[i].translate, out[i]); });
+}
+
+void MakeAffineMatrices(const Transform* transforms, size_t count, Matrix3x4* out, SinCosPrecision precision) {
+	ForEachEulerSinCos(count, 1.0f, precision,
+		[transforms](size_t i) -> const Vector3& { return transforms[i].rotate; },
+		[&](size_t i, const float* sin, const float* cos) { WriteAffineMatrix(sin, cos, transforms[i].scale, transforms[i].translate, out[i]); });
+}
+
+void MakeRotateQuaternions(const Vector3* rotates, size_t count, Quaternion* out, SinCosPrecision precision) {
+	// 半角のsin/cosを使う(MakeRotateQuaternionと同じ式)
+	ForEachEulerSinCos(count, 0.5f, precision,
+		[rotates](size_t i) -> const Vector3& { return rotates[i]; },
+		[&](size_t i, const float* sin, const float* cos) {
+			const float sx = sin[0], sy = sin[1], sz = sin[2];
+			const float cx = cos[0], cy = cos[1], cz = cos[2];
+			out[i].x = sx * cy * cz - cx * sy * sz;
+			out[i].y = cx * sy * cz + sx * cy * sz;
+			out[i].z = cx * cy * sz - sx * sy * cz;
+			out[i].w = cx * cy * cz + sx * sy * sz;
+		});
+}
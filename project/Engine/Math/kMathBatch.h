@@ -0,0 +1,77 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Matrix3x4.h"
+#include "Quaternion.h"
+#include "Transform.h"
+#include "Vector3.h"
+#include "kMathTrig.h"
+#include <cstddef>
+#include <vector>
+
+// SoAレイアウトのVector3配列(成分ごとに連続した配列を持つ)
+struct Vector3SoA {
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+
+	// 要素数
+	size_t Size() const { return x.size(); }
+	// 要素数を変更
+	void Resize(size_t size) {
+		x.resize(size);
+		y.resize(size);
+		z.resize(size);
+	}
+	// 追加
+	void PushBack(const Vector3& v) {
+		x.push_back(v.x);
+		y.push_back(v.y);
+		z.push_back(v.z);
+	}
+	// Setter
+	void Set(size_t index, const Vector3& v) {
+		x[index] = v.x;
+		y[index] = v.y;
+		z[index] = v.z;
+	}
+	// Getter
+	Vector3 Get(size_t index) const { return Vector3{ x[index], y[index], z[index] }; }
+};
+
+// 以下の関数は入力と出力に同じ配列を渡してもよい
+
+// 座標をまとめて変換する(成分ごとの配列)。結果はMatrixTransformと同じ
+void TransformPoints(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& matrix, float* outX, float* outY, float* outZ);
+
+// 座標をまとめて変換する(SoA)
+void TransformPoints(const Vector3SoA& in, const Matrix4x4& matrix, Vector3SoA& out);
+
+// 座標をまとめて変換する(AoS)
+void TransformPoints(const Vector3* in, size_t count, const Matrix4x4& matrix, Vector3* out);
+
+// ベクトルをまとめて変換する(成分ごとの配列)。結果はTransformNormalと同じ
+void TransformNormals(const float* inX, const float* inY, const float* inZ, size_t count, const Matrix4x4& matrix, float* outX, float* outY, float* outZ);
+
+// ベクトルをまとめて変換する(SoA)
+void TransformNormals(const Vector3SoA& in, const Matrix4x4& matrix, Vector3SoA& out);
+
+// ベクトルをまとめて変換する(AoS)
+void TransformNormals(const Vector3* in, size_t count, const Matrix4x4& matrix, Vector3* out);
+
+// 行列の積をまとめて求める out[i] = lhs[i] * rhs[i]
+void MultiplyMatrices(const Matrix4x4* lhs, const Matrix4x4* rhs, size_t count, Matrix4x4* out);
+
+// 行列の積をまとめて求める out[i] = lhs[i] * rhs (World * ViewProjectionなど)
+void MultiplyMatrices(const Matrix4x4* lhs, const Matrix4x4& rhs, size_t count, Matrix4x4* out);
+
+// オイラー角からまとめて回転行列を求める(MakeRotateXMatrix * MakeRotateYMatrix * MakeRotateZMatrixと同じ)
+void MakeRotateMatrices(const Vector3* rotates, size_t count, Matrix4x4* out, SinCosPrecision precision = SinCosPrecision::Accurate);
+
+// まとめてアフィン変換行列を求める(MakeAffineMatrixと同じ)
+void MakeAffineMatrices(const Transform* transforms, size_t count, Matrix4x4* out, SinCosPrecision precision = SinCosPrecision::Accurate);
+
+// まとめてアフィン変換行列を求める(Matrix3x4版)
+void MakeAffineMatrices(const Transform* transforms, size_t count, Matrix3x4* out, SinCosPrecision precision = SinCosPrecision::Accurate);
+
+// オイラー角からまとめてQuaternionを求める(MakeRotateQuaternionと同じ)
+void MakeRotateQuaternions(const Vector3* rotates, size_t count, Quaternion* out, SinCosPrecision precision = SinCosPrecision::Accurate);
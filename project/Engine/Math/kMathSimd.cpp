@@ -0,0 +1,251 @@
+#include "kMathSimd.h"
+#include <atomic>
+#include <cassert>
+
+#if KMATH_SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+#if KMATH_SIMD_X86
+
+// シャッフル用のマスクを作成
+#define KMATH_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+// 1つのベクトル内の要素を並べ替える
+#define KMATH_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), KMATH_SHUFFLE_MASK(x, y, z, w))
+// 2つのベクトルから要素を取り出して並べる(前半2つはv1、後半2つはv2から)
+#define KMATH_SHUFFLE(v1, v2, x, y, z, w) _mm_shuffle_ps((v1), (v2), KMATH_SHUFFLE_MASK(x, y, z, w))
+
+// 2x2行列(行優先で1つのレジスタに格納)の積 A * B
+KMATH_TARGET_SSE41 inline __m128 Mat2Mul(__m128 a, __m128 b) {
+	return _mm_add_ps(_mm_mul_ps(a, KMATH_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(KMATH_SWIZZLE(a, 1, 0, 3, 2), KMATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// 2x2行列の余因子行列との積 adj(A) * B
+KMATH_TARGET_SSE41 inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(KMATH_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(KMATH_SWIZZLE(a, 1, 1, 2, 2), KMATH_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// 2x2行列と余因子行列の積 A * adj(B)
+KMATH_TARGET_SSE41 inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+	return _mm_sub_ps(_mm_mul_ps(a, KMATH_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(KMATH_SWIZZLE(a, 1, 0, 3, 2), KMATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//  行列の積(SSE4.1)
+KMATH_TARGET_SSE41 Matrix4x4 MultiplySSE41(const Matrix4x4& m1, const Matrix4x4& m2) {
+	const __m128 r0 = _mm_loadu_ps(m2.m[0]);
+	const __m128 r1 = _mm_loadu_ps(m2.m[1]);
+	const __m128 r2 = _mm_loadu_ps(m2.m[2]);
+	const __m128 r3 = _mm_loadu_ps(m2.m[3]);
+
+	Matrix4x4 ans;
+	for (int a = 0; a < 4; a++) {
+		// スカラー版と同じ順番で足し合わせる
+		__m128 row = _mm_mul_ps(_mm_set1_ps(m1.m[a][0]), r0);
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[a][1]), r1));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[a][2]), r2));
+		row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m1.m[a][3]), r3));
+		_mm_storeu_ps(ans.m[a], row);
+	}
+	return ans;
+}
+
+// 逆行列(SSE4.1)
+// 2x2のブロックに分割して余因子を求める
+KMATH_TARGET_SSE41 Matrix4x4 InverseSSE41(const Matrix4x4& m) {
+	const __m128 row0 = _mm_loadu_ps(m.m[0]);
+	const __m128 row1 = _mm_loadu_ps(m.m[1]);
+	const __m128 row2 = _mm_loadu_ps(m.m[2]);
+	const __m128 row3 = _mm_loadu_ps(m.m[3]);
+
+	// | A B |
+	// | C D |
+	const __m128 A = _mm_movelh_ps(row0, row1);
+	const __m128 B = _mm_movehl_ps(row1, row0);
+	const __m128 C = _mm_movelh_ps(row2, row3);
+	const __m128 D = _mm_movehl_ps(row3, row2);
+
+	// 各ブロックの行列式 (|A|, |B|, |C|, |D|)
+	const __m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(KMATH_SHUFFLE(row0, row2, 0, 2, 0, 2), KMATH_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+		_mm_mul_ps(KMATH_SHUFFLE(row0, row2, 1, 3, 1, 3), KMATH_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+	const __m128 detA = KMATH_SWIZZLE(detSub, 0, 0, 0, 0);
+	const __m128 detB = KMATH_SWIZZLE(detSub, 1, 1, 1, 1);
+	const __m128 detC = KMATH_SWIZZLE(detSub, 2, 2, 2, 2);
+	const __m128 detD = KMATH_SWIZZLE(detSub, 3, 3, 3, 3);
+
+	const __m128 DC = Mat2AdjMul(D, C);
+	const __m128 AB = Mat2AdjMul(A, B);
+
+	__m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, DC));
+	__m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, AB));
+	__m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, AB));
+	__m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, DC));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	const __m128 trace = _mm_dp_ps(AB, KMATH_SWIZZLE(DC, 0, 2, 1, 3), 0xFF);
+	detM = _mm_sub_ps(detM, trace);
+	assert(_mm_cvtss_f32(detM) != 0.0f);
+
+	const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+	X = _mm_mul_ps(X, rDetM);
+	Y = _mm_mul_ps(Y, rDetM);
+	Z = _mm_mul_ps(Z, rDetM);
+	W = _mm_mul_ps(W, rDetM);
+
+	// 余因子の並べ替えと格納をまとめて行う
+	Matrix4x4 ans;
+	_mm_storeu_ps(ans.m[0], KMATH_SHUFFLE(X, Y, 3, 1, 3, 1));
+	_mm_storeu_ps(ans.m[1], KMATH_SHUFFLE(X, Y, 2, 0, 2, 0));
+	_mm_storeu_ps(ans.m[2], KMATH_SHUFFLE(Z, W, 3, 1, 3, 1));
+	_mm_storeu_ps(ans.m[3], KMATH_SHUFFLE(Z, W, 2, 0, 2, 0));
+	return ans;
+}
+
+//座標変換(SSE4.1)
+KMATH_TARGET_SSE41 Vector3 MatrixTransformSSE41(const Vector3& vector, const Matrix4x4& matrix) {
+	__m128 v = _mm_mul_ps(_mm_set1_ps(vector.x), _mm_loadu_ps(matrix.m[0]));
+	v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(vector.y), _mm_loadu_ps(matrix.m[1])));
+	v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(vector.z), _mm_loadu_ps(matrix.m[2])));
+	v = _mm_add_ps(v, _mm_loadu_ps(matrix.m[3]));
+	const __m128 w = KMATH_SWIZZLE(v, 3, 3, 3, 3);
+	assert(_mm_cvtss_f32(w) != 0.0f);
+	v = _mm_div_ps(v, w);
+
+	float ans[4];
+	_mm_storeu_ps(ans, v);
+	return Vector3{ ans[0], ans[1], ans[2] };
+}
+
+// 1行分(4要素)を256bitレジスタの上下に複製する
+KMATH_TARGET_AVX2 inline __m256 BroadcastRow(const float* row) {
+	const __m128 r = _mm_loadu_ps(row);
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(r), r, 1);
+}
+
+//  行列の積(AVX2)
+// 2行ずつ256bitレジスタで計算する
+KMATH_TARGET_AVX2 Matrix4x4 MultiplyAVX2(const Matrix4x4& m1, const Matrix4x4& m2) {
+	const __m256 r0 = BroadcastRow(m2.m[0]);
+	const __m256 r1 = BroadcastRow(m2.m[1]);
+	const __m256 r2 = BroadcastRow(m2.m[2]);
+	const __m256 r3 = BroadcastRow(m2.m[3]);
+
+	Matrix4x4 ans;
+	for (int a = 0; a < 4; a += 2) {
+		const __m256 rows = _mm256_loadu_ps(m1.m[a]);
+		__m256 result = _mm256_mul_ps(_mm256_permute_ps(rows, 0x00), r0);
+		result = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0x55), r1, result);
+		result = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xAA), r2, result);
+		result = _mm256_fmadd_ps(_mm256_permute_ps(rows, 0xFF), r3, result);
+		_mm256_storeu_ps(ans.m[a], result);
+	}
+	return ans;
+}
+
+#undef KMATH_SHUFFLE
+#undef KMATH_SWIZZLE
+#undef KMATH_SHUFFLE_MASK
+
+#endif // KMATH_SIMD_X86
+
+// SIMDレベルに対応したカーネルを選ぶ
+MatrixKernels MakeMatrixKernels(SimdLevel level) {
+	MatrixKernels kernels = { MultiplyScalar, InverseScalar, MatrixTransformScalar };
+#if KMATH_SIMD_X86
+	if (level >= SimdLevel::SSE41) {
+		kernels.multiply = MultiplySSE41;
+		kernels.inverse = InverseSSE41;
+		kernels.transform = MatrixTransformSSE41;
+	}
+	if (level >= SimdLevel::AVX2) {
+		// 逆行列と座標変換は1つ分の計算なので256bit化しても速くならない
+		kernels.multiply = MultiplyAVX2;
+	}
+#else
+	(void)level;
+#endif
+	return kernels;
+}
+
+struct KernelState {
+	SimdLevel level;
+	MatrixKernels kernels;
+};
+
+// レベルごとのカーネル(作った後は書き換えない)
+const KernelState& GetKernelState(SimdLevel level) {
+	static const KernelState states[] = {
+		{ SimdLevel::Scalar, MakeMatrixKernels(SimdLevel::Scalar) },
+		{ SimdLevel::SSE41, MakeMatrixKernels(SimdLevel::SSE41) },
+		{ SimdLevel::AVX2, MakeMatrixKernels(SimdLevel::AVX2) },
+	};
+	return states[static_cast<int>(level)];
+}
+
+// 今使っているカーネル(初回呼び出し時にCPUを調べて最上位のものを選ぶ)
+// SetSimdLevelはポインタを差し替えるだけなので、ワーカースレッドがカーネルを使っている途中に呼んでも壊れない
+std::atomic<const KernelState*>& GetCurrentKernelState() {
+	static std::atomic<const KernelState*> current = &GetKernelState(DetectSimdLevel());
+	return current;
+}
+
+} // namespace
+
+SimdLevel DetectSimdLevel() {
+#if KMATH_SIMD_X86
+#if defined(_MSC_VER)
+	int info[4] = {};
+	__cpuid(info, 0);
+	const int maxId = info[0];
+
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	const bool fma = (info[2] & (1 << 12)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+
+	bool avx2 = false;
+	if (maxId >= 7) {
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+	// OSがYMMレジスタを保存するかどうか
+	const bool osAvx = osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6);
+
+	if (avx2 && fma && osAvx) {
+		return SimdLevel::AVX2;
+	}
+	if (sse41) {
+		return SimdLevel::SSE41;
+	}
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		return SimdLevel::AVX2;
+	}
+	if (__builtin_cpu_supports("sse4.1")) {
+		return SimdLevel::SSE41;
+	}
+#endif
+#endif
+	return SimdLevel::Scalar;
+}
+
+SimdLevel GetSimdLevel() {
+	return GetCurrentKernelState().load(std::memory_order_acquire)->level;
+}
+
+void SetSimdLevel(SimdLevel level) {
+	const SimdLevel supported = DetectSimdLevel();
+	if (level > supported) {
+		level = supported;
+	}
+	GetCurrentKernelState().store(&GetKernelState(level), std::memory_order_release);
+}
+
+const MatrixKernels& GetMatrixKernels() {
+	return GetCurrentKernelState().load(std::memory_order_acquire)->kernels;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+
+// x86/x64の場合のみSIMD命令を使用する
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define KMATH_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define KMATH_SIMD_X86 0
+#endif
+
+// MSVCは/arch指定無しでも組み込み関数を使えるが、GCC/Clangは関数単位でターゲットを指定する
+#if KMATH_SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define KMATH_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define KMATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define KMATH_TARGET_SSE41
+#define KMATH_TARGET_AVX2
+#endif
+
+// 使用するSIMD命令セットのレベル
+enum class SimdLevel {
+	Scalar,
+	SSE41,
+	AVX2,
+};
+
+// 行列演算カーネルの関数テーブル
+struct MatrixKernels {
+	Matrix4x4 (*multiply)(const Matrix4x4& m1, const Matrix4x4& m2);
+	Matrix4x4 (*inverse)(const Matrix4x4& m);
+	Vector3 (*transform)(const Vector3& vector, const Matrix4x4& matrix);
+};
+
+// CPUが対応している最上位のSIMDレベルを取得
+SimdLevel DetectSimdLevel();
+
+// 現在使用しているSIMDレベルを取得
+SimdLevel GetSimdLevel();
+
+// 使用するSIMDレベルを変更する(CPUが対応していないレベルは対応している最上位に丸める)
+// 他のスレッドから呼んでもよいが、実行中の処理が新しいレベルに切り替わるのは次にカーネルを取得したときから
+// (1回のまとめた処理の中でレベルが混ざることがあるので、比較・計測以外では起動時に1回だけ呼ぶ)
+void SetSimdLevel(SimdLevel level);
+
+// 現在のSIMDレベルに対応したカーネルを取得
+const MatrixKernels& GetMatrixKernels();
+
+// スカラー版の行列の積(SIMD版との比較用)
+Matrix4x4 MultiplyScalar(const Matrix4x4& m1, const Matrix4x4& m2);
+
+// スカラー版の逆行列(SIMD版との比較用)
+Matrix4x4 InverseScalar(const Matrix4x4& m);
+
+// スカラー版の座標変換(SIMD版との比較用)
+Vector3 MatrixTransformScalar(const Vector3& vector, const Matrix4x4& matrix);
@@ -0,0 +1,240 @@
+#include "kMathTrig.h"
+#include "kMathSimd.h"
+#include <cmath>
+
+namespace {
+
+// π/2を3つに分けたもの(Cody-Waiteの範囲縮小用)
+constexpr float kPiOver2Hi = 1.5703125f;
+constexpr float kPiOver2Mid = 4.837512969970703125e-4f;
+constexpr float kPiOver2Lo = 7.54978995489188216e-8f;
+constexpr float kTwoOverPi = 0.636619772367581343f;
+
+// これより大きい角度は範囲縮小の誤差が大きくなるのでstdに任せる
+constexpr float kRangeLimit = 8192.0f;
+
+// [-π/4, π/4]の多項式の係数
+constexpr float kSin1 = -1.6666654611e-1f;
+constexpr float kSin2 = 8.3321608736e-3f;
+constexpr float kSin3 = -1.9515295891e-4f;
+constexpr float kCos1 = 4.166664568298827e-2f;
+constexpr float kCos2 = -1.388731625493765e-3f;
+constexpr float kCos3 = 2.443315711809948e-5f;
+
+// Fast用(項を減らしたもの)
+constexpr float kFastSin1 = -1.6662756079e-1f;
+constexpr float kFastSin2 = 8.1515894447e-3f;
+constexpr float kFastCos1 = 4.1661167090e-2f;
+constexpr float kFastCos2 = -1.3650475943e-3f;
+
+// sin/cos(スカラー版)
+void SinCosScalar(float x, float& outSin, float& outCos, SinCosPrecision precision) {
+	if (!(std::fabs(x) <= kRangeLimit)) {
+		outSin = std::sin(x);
+		outCos = std::cos(x);
+		return;
+	}
+	// x = j * π/2 + r (|r| <= π/4)
+	// |x| <= kRangeLimitなのでintに収まる(std::nearbyintは遅いので使わない)
+	const float t = x * kTwoOverPi;
+	const int quadrantIndex = static_cast<int>(t + (t >= 0.0f ? 0.5f : -0.5f));
+	const float j = static_cast<float>(quadrantIndex);
+	float r = x - j * kPiOver2Hi;
+	r = r - j * kPiOver2Mid;
+	if (precision == SinCosPrecision::Accurate) {
+		r = r - j * kPiOver2Lo;
+	}
+	const float z = r * r;
+	float s;
+	float c;
+	if (precision == SinCosPrecision::Accurate) {
+		s = r + r * z * (kSin1 + z * (kSin2 + z * kSin3));
+		c = 1.0f - 0.5f * z + z * z * (kCos1 + z * (kCos2 + z * kCos3));
+	} else {
+		s = r + r * z * (kFastSin1 + z * kFastSin2);
+		c = 1.0f - 0.5f * z + z * z * (kFastCos1 + z * kFastCos2);
+	}
+	// 象限に合わせて入れ替えと符号反転をする
+	const int quadrant = quadrantIndex & 3;
+	if (quadrant & 1) {
+		const float tmp = s;
+		s = c;
+		c = tmp;
+	}
+	outSin = (quadrant & 2) ? -s : s;
+	outCos = ((quadrant + 1) & 2) ? -c : c;
+}
+
+void SinCosScalar(const float* radians, size_t begin, size_t count, float* outSin, float* outCos, SinCosPrecision precision) {
+	for (size_t i = begin; i < count; i++) {
+		float s;
+		float c;
+		SinCosScalar(radians[i], s, c, precision);
+		outSin[i] = s;
+		outCos[i] = c;
+	}
+}
+
+#if KMATH_SIMD_X86
+
+// 4要素分のsin/cos(SSE4.1)。|x| <= kRangeLimitであること
+KMATH_TARGET_SSE41 inline void SinCos4SSE41(__m128 x, bool accurate, __m128& outSin, __m128& outCos) {
+	const __m128 j = _mm_round_ps(_mm_mul_ps(x, _mm_set1_ps(kTwoOverPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m128 r = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(kPiOver2Hi)));
+	r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(kPiOver2Mid)));
+	if (accurate) {
+		r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(kPiOver2Lo)));
+	}
+	const __m128 z = _mm_mul_ps(r, r);
+	__m128 ps;
+	__m128 pc;
+	if (accurate) {
+		ps = _mm_add_ps(_mm_set1_ps(kSin2), _mm_mul_ps(z, _mm_set1_ps(kSin3)));
+		ps = _mm_add_ps(_mm_set1_ps(kSin1), _mm_mul_ps(z, ps));
+		pc = _mm_add_ps(_mm_set1_ps(kCos2), _mm_mul_ps(z, _mm_set1_ps(kCos3)));
+		pc = _mm_add_ps(_mm_set1_ps(kCos1), _mm_mul_ps(z, pc));
+	} else {
+		ps = _mm_add_ps(_mm_set1_ps(kFastSin1), _mm_mul_ps(z, _mm_set1_ps(kFastSin2)));
+		pc = _mm_add_ps(_mm_set1_ps(kFastCos1), _mm_mul_ps(z, _mm_set1_ps(kFastCos2)));
+	}
+	const __m128 s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, z), ps));
+	const __m128 c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_mul_ps(_mm_mul_ps(z, z), pc));
+
+	// 象限に合わせて入れ替えと符号反転をする
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128i two = _mm_set1_epi32(2);
+	const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+	const __m128i q = _mm_cvtps_epi32(j);
+	const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+	const __m128 sinSign = _mm_and_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30)), signMask);
+	const __m128 cosSign = _mm_and_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30)), signMask);
+	outSin = _mm_xor_ps(_mm_blendv_ps(s, c, swap), sinSign);
+	outCos = _mm_xor_ps(_mm_blendv_ps(c, s, swap), cosSign);
+}
+
+// 範囲外(またはNaN)の要素があるかどうか
+KMATH_TARGET_SSE41 inline bool IsOutOfRangeSSE41(__m128 x) {
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	return _mm_movemask_ps(_mm_cmpnle_ps(_mm_and_ps(x, absMask), _mm_set1_ps(kRangeLimit))) != 0;
+}
+
+// sin/cos(SSE4.1、4要素ずつ)
+KMATH_TARGET_SSE41 size_t SinCosSSE41(const float* radians, size_t count, float* outSin, float* outCos, SinCosPrecision precision) {
+	const bool accurate = precision == SinCosPrecision::Accurate;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 x = _mm_loadu_ps(radians + i);
+		// 範囲外の要素があればこのブロックはスカラーで処理する
+		if (IsOutOfRangeSSE41(x)) {
+			SinCosScalar(radians, i, i + 4, outSin, outCos, precision);
+			continue;
+		}
+		__m128 s;
+		__m128 c;
+		SinCos4SSE41(x, accurate, s, c);
+		_mm_storeu_ps(outSin + i, s);
+		_mm_storeu_ps(outCos + i, c);
+	}
+	return i;
+}
+
+// x, y, zのsin/cos(SSE4.1)
+KMATH_TARGET_SSE41 bool SinCosVector3SSE41(const Vector3& radians, Vector3& outSin, Vector3& outCos, SinCosPrecision precision) {
+	const __m128 x = _mm_set_ps(0.0f, radians.z, radians.y, radians.x);
+	if (IsOutOfRangeSSE41(x)) {
+		return false;
+	}
+	__m128 s;
+	__m128 c;
+	SinCos4SSE41(x, precision == SinCosPrecision::Accurate, s, c);
+	alignas(16) float sin[4];
+	alignas(16) float cos[4];
+	_mm_store_ps(sin, s);
+	_mm_store_ps(cos, c);
+	outSin = { sin[0], sin[1], sin[2] };
+	outCos = { cos[0], cos[1], cos[2] };
+	return true;
+}
+
+// sin/cos(AVX2、8要素ずつ)
+KMATH_TARGET_AVX2 size_t SinCosAVX2(const float* radians, size_t count, float* outSin, float* outCos, SinCosPrecision precision) {
+	const bool accurate = precision == SinCosPrecision::Accurate;
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(0x80000000u)));
+	const __m256 limit = _mm256_set1_ps(kRangeLimit);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i two = _mm256_set1_epi32(2);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 x = _mm256_loadu_ps(radians + i);
+		// 範囲外の要素があればこのブロックはスカラーで処理する
+		if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_and_ps(x, absMask), limit, _CMP_NLE_UQ)) != 0) {
+			SinCosScalar(radians, i, i + 8, outSin, outCos, precision);
+			continue;
+		}
+		const __m256 j = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kTwoOverPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		__m256 r = _mm256_fnmadd_ps(j, _mm256_set1_ps(kPiOver2Hi), x);
+		r = _mm256_fnmadd_ps(j, _mm256_set1_ps(kPiOver2Mid), r);
+		if (accurate) {
+			r = _mm256_fnmadd_ps(j, _mm256_set1_ps(kPiOver2Lo), r);
+		}
+		const __m256 z = _mm256_mul_ps(r, r);
+		__m256 ps;
+		__m256 pc;
+		if (accurate) {
+			ps = _mm256_fmadd_ps(z, _mm256_set1_ps(kSin3), _mm256_set1_ps(kSin2));
+			ps = _mm256_fmadd_ps(z, ps, _mm256_set1_ps(kSin1));
+			pc = _mm256_fmadd_ps(z, _mm256_set1_ps(kCos3), _mm256_set1_ps(kCos2));
+			pc = _mm256_fmadd_ps(z, pc, _mm256_set1_ps(kCos1));
+		} else {
+			ps = _mm256_fmadd_ps(z, _mm256_set1_ps(kFastSin2), _mm256_set1_ps(kFastSin1));
+			pc = _mm256_fmadd_ps(z, _mm256_set1_ps(kFastCos2), _mm256_set1_ps(kFastCos1));
+		}
+		const __m256 s = _mm256_fmadd_ps(_mm256_mul_ps(r, z), ps, r);
+		const __m256 c = _mm256_fmadd_ps(_mm256_mul_ps(z, z), pc, _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, _mm256_set1_ps(1.0f)));
+
+		// 象限に合わせて入れ替えと符号反転をする
+		const __m256i q = _mm256_cvtps_epi32(j);
+		const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+		const __m256 sinSign = _mm256_and_ps(_mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30)), signMask);
+		const __m256 cosSign = _mm256_and_ps(_mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30)), signMask);
+		const __m256 sinResult = _mm256_blendv_ps(s, c, swap);
+		const __m256 cosResult = _mm256_blendv_ps(c, s, swap);
+		_mm256_storeu_ps(outSin + i, _mm256_xor_ps(sinResult, sinSign));
+		_mm256_storeu_ps(outCos + i, _mm256_xor_ps(cosResult, cosSign));
+	}
+	return i;
+}
+
+#endif
+
+} // namespace
+
+void SinCos(float radian, float& outSin, float& outCos, SinCosPrecision precision) {
+	SinCosScalar(radian, outSin, outCos, precision);
+}
+
+void SinCos(const Vector3& radians, Vector3& outSin, Vector3& outCos, SinCosPrecision precision) {
+#if KMATH_SIMD_X86
+	if (GetSimdLevel() >= SimdLevel::SSE41 && SinCosVector3SSE41(radians, outSin, outCos, precision)) {
+		return;
+	}
+#endif
+	SinCosScalar(radians.x, outSin.x, outCos.x, precision);
+	SinCosScalar(radians.y, outSin.y, outCos.y, precision);
+	SinCosScalar(radians.z, outSin.z, outCos.z, precision);
+}
+
+void SinCos(const float* radians, size_t count, float* outSin, float* outCos, SinCosPrecision precision) {
+	size_t done = 0;
+#if KMATH_SIMD_X86
+	const SimdLevel level = GetSimdLevel();
+	if (level >= SimdLevel::AVX2) {
+		done = SinCosAVX2(radians, count, outSin, outCos, precision);
+	} else if (level >= SimdLevel::SSE41) {
+		done = SinCosSSE41(radians, count, outSin, outCos, precision);
+	}
+#endif
+	// 端数はスカラーで処理する
+	SinCosScalar(radians, done, count, outSin, outCos, precision);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "Vector3.h"
+#include <cstddef>
+
+// sin/cosの精度(どちらも|x| > 8192の場合はstd::sin/std::cosを使う)
+enum class SinCosPrecision {
+	Fast,     // 範囲縮小と多項式を1段ずつ省く。|x| <= 100で誤差5e-6程度
+	Accurate, // std::sin/std::cosとほぼ同じ(誤差1e-7程度)
+};
+
+// sinとcosを同時に求める
+void SinCos(float radian, float& outSin, float& outCos, SinCosPrecision precision = SinCosPrecision::Accurate);
+
+// x, y, zそれぞれのsinとcosを同時に求める(オイラー角用、SSE4.1が使えれば1回で計算する)
+void SinCos(const Vector3& radians, Vector3& outSin, Vector3& outCos, SinCosPrecision precision = SinCosPrecision::Accurate);
+
+// sinとcosをまとめて求める(SIMDレベルに合わせてSSE4.1/AVX2を使う)
+// 入力と出力に同じ配列を渡してもよい
+void SinCos(const float* radians, size_t count, float* outSin, float* outCos, SinCosPrecision precision = SinCosPrecision::Accurate);
@@ -5,7 +5,9 @@
 
 struct TransformationMatrix{
     float32_t4x4 WVP;
-    float32_t4x4 World;
+    // Matrix3x4(4x4のアフィン行列を転置して4列目を省いたもの)
+    float32_t3x4 World;
+    float32_t3x4 WorldInverseTranspose;
 };
 ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
 
@@ -15,20 +17,32 @@ ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
 
 struct VertexShaderInput{
    // float32_t4 position : POSITION0;
-    float32_t4 position : POSITION0;
+    // float3か、境界のAABBで0～1に量子化したもの(戻す行列はWVPとWorldに入っている)
+    float32_t3 position : POSITION0;
+    // 半精度
     float32_t2 texcoord : TEXCOORD0;
-    float32_t3 normal : NORMAL0;
+    // 八面体に写した法線(R16G16_SNORM)
+    float32_t2 normal : NORMAL0;
 };
 
+// 八面体に写した法線を戻す
+float32_t3 DecodeOctahedral(float32_t2 encoded){
+    float32_t3 normal = float32_t3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float32_t t = saturate(-normal.z);
+    normal.xy -= t * (step(0.0f, normal.xy) * 2.0f - 1.0f);
+    return normalize(normal);
+}
+
 VertexShaderOutput main(VertexShaderInput input){
     VertexShaderOutput output;
-    output.position = mul(input.position, gTransformationMatrix.WVP);
+    float32_t4 position = float32_t4(input.position, 1.0f);
+    output.position = mul(position, gTransformationMatrix.WVP);
     
     output.texcoord = input.texcoord;
     
-    output.normal = normalize(mul(input.normal, (float32_t3x3)gTransformationMatrix.World));
+    output.normal = normalize(mul((float32_t3x3)gTransformationMatrix.WorldInverseTranspose, DecodeOctahedral(input.normal)));
     
-    output.worldPosition = mul(input.position, gTransformationMatrix.World).xyz;
+    output.worldPosition = mul(gTransformationMatrix.World, position);
     
     return output;
 }
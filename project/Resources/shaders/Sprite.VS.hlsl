@@ -0,0 +1,30 @@
+#include "object3d.hlsli"
+
+// スプライト用(頂点はSprite::VertexDataのまま。PSはObject3d.PS.hlslを使う)
+
+struct TransformationMatrix{
+    float32_t4x4 WVP;
+    // Matrix3x4(4x4のアフィン行列を転置して4列目を省いたもの)
+    float32_t3x4 World;
+    float32_t3x4 WorldInverseTranspose;
+};
+ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+
+struct VertexShaderInput{
+    float32_t4 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+};
+
+VertexShaderOutput main(VertexShaderInput input){
+    VertexShaderOutput output;
+    output.position = mul(input.position, gTransformationMatrix.WVP);
+
+    output.texcoord = input.texcoord;
+
+    output.normal = normalize(mul((float32_t3x3)gTransformationMatrix.WorldInverseTranspose, input.normal));
+
+    output.worldPosition = mul(gTransformationMatrix.World, input.position);
+
+    return output;
+}